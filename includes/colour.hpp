@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <algorithm>
+#include <cmath>
 
 // RGB -> BGR
 // LSB ( AAAAAAAA ) ( BBBBBBBB ) ( GGGGGGGG ) ( RRRRRRRR ) MSB
@@ -62,6 +63,16 @@ public:
 		return m_a;
 	}
 
+public:
+	// Blends from a at t = 0 to b at t = 1, alpha included.
+	static Colour lerp( const Colour& a, const Colour& b, const float t ) {
+		const auto& mix = [ t ]( const uint8_t x, const uint8_t y ) -> uint8_t {
+			return ( uint8_t ) std::lround( ( float ) x + ( ( float ) y - ( float ) x ) * t );
+		};
+
+		return Colour( mix( a.m_r, b.m_r ), mix( a.m_g, b.m_g ), mix( a.m_b, b.m_b ), mix( a.m_a, b.m_a ) );
+	}
+
 public:
 	const hsl_t to_hsl() const {
 		hsl_t hsl{};
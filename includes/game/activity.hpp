@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <types.hpp>
+#include <memory.hpp>
+
+#include <game/universe.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  // A tile and how many cells changed in it over the window, see Activity::hottest.
+  struct ActiveTile {
+    Tile tile;
+    uint32_t changes;
+  };
+
+  //
+  // How many cells of every tile of a universe changed over the last generations, e.g. to find the few active
+  // regions of a huge universe that has mostly settled.
+  //
+  // Tiles are k_tile_size cells square, which is a word of 64 cells wide. Every generation the changed cells of
+  // every row are counted by tile, by the engine while the row it just wrote is still in the cache (see
+  // Engine::counts_activity) or by comparing the generations afterwards otherwise, and only then added up by
+  // tile. The window slides by buckets: the changes of k_buckets buckets of a number of generations each are kept
+  // per tile, and the oldest bucket is dropped whenever a new one starts.
+  //
+  class Activity {
+  public:
+    static constexpr size_t k_tile_size = 64;
+    static constexpr size_t k_buckets = 8;
+
+  private:
+    Vec2< size_t > m_bounds;
+    Vec2< size_t > m_tiles;
+
+    // Changed cells of every row by tile in the last generation, no more than a tile is wide.
+    std::vector< uint8_t > m_rows;
+
+    // Changed cells by tile in every bucket and over the whole window.
+    std::vector< uint32_t > m_buckets;
+    std::vector< uint32_t > m_totals;
+
+    size_t m_bucket_length;
+    size_t m_bucket;
+
+    // Generations that went into the current bucket.
+    size_t m_filled;
+
+    app::MemoryAccount m_memory;
+
+  public:
+    Activity();
+
+    // Bytes the counts of a universe of the given bounds take up.
+    static const size_t bytes_required( const Vec2< size_t >& bounds );
+
+    // Lays the tiles out for the bounds, nothing has changed afterwards.
+    void init( const Vec2< size_t >& bounds );
+
+    // Forgets every change.
+    void clear();
+
+    // Generations the window spans, rounded up to whole buckets.
+    void set_window( const size_t generations );
+
+    //
+    // Counts the cells that differ between the rows of two generations, called by engines for a row of the grid
+    // (0 based) they just stepped. Both point to the first cell of the row, past the border.
+    //
+    void count_row( const size_t row, const uint8_t* before, const uint8_t* after );
+
+    // The counts of a row by tile, for engines that count changed cells a word at a time.
+    uint8_t* row( const size_t row ) {
+      return m_rows.data() + row * m_tiles.x;
+    }
+
+    //
+    // Adds the changes of the generation the universe was just stepped to. If the engine didn't count them (or
+    // the universe changed its bounds since) the generation is compared with the one before instead.
+    //
+    void advance( const Universe& universe, app::ThreadPool& pool, const bool counted );
+
+  public:
+    const Vec2< size_t >& bounds() const {
+      return m_bounds;
+    }
+
+    const Vec2< size_t >& tiles() const {
+      return m_tiles;
+    }
+
+    const size_t window() const {
+      return m_bucket_length * k_buckets;
+    }
+
+    // Changed cells of a tile over the window.
+    const uint32_t changes( const size_t x, const size_t y ) const {
+      return m_totals[ y * m_tiles.x + x ];
+    }
+
+    // The most changes of any tile over the window.
+    const uint32_t peak() const;
+
+    // The tiles with the most changes over the window, most first, no more than count and none without changes.
+    const std::vector< ActiveTile > hottest( const size_t count ) const;
+
+    // Cells of a tile in 0 based grid coordinates, the last tiles of a row or column may be cut off.
+    const Region region( const Tile& tile ) const;
+  };
+
+}
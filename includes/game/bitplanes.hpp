@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <types.hpp>
+#include <memory.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  class Universe;
+
+  //
+  // The cells of a universe as bit-planes, 64 cells to a word: one plane per binary digit of the state followed by
+  // a plane of the live cells. Every plane has a dead row above and below and a dead word on either side of every
+  // row, and bit i of a word is column i of the word. Bits past the last column are always clear.
+  //
+  // Two generations are kept, so that a step reads the planes of one and writes those of the other. A universe that
+  // is stepped on its planes owns them and only writes them back into its bytes once those are looked at, see
+  // Universe::planes.
+  //
+  class BitPlanes {
+    friend class Universe;
+
+  private:
+    Vec2< size_t > m_bounds;
+    size_t m_digits;
+    size_t m_row_words;
+
+    std::unique_ptr< uint64_t[] > m_words;
+    size_t m_capacity;
+
+    // Which of the two generations is the current one.
+    size_t m_current;
+
+    app::MemoryAccount m_memory;
+
+    // Whether the planes hold the current generation of the universe that owns them.
+    std::atomic< bool > m_valid;
+
+    // Whether the bytes of the current generation and of the one before are behind the planes.
+    std::atomic< bool > m_current_ahead;
+    std::atomic< bool > m_previous_ahead;
+
+    // The bytes are caught up by the first thread that looks at them.
+    std::mutex m_catch_up;
+
+  public:
+    BitPlanes();
+
+    BitPlanes( const BitPlanes& ) = delete;
+    BitPlanes& operator=( const BitPlanes& ) = delete;
+
+    const Vec2< size_t >& bounds() const {
+      return m_bounds;
+    }
+
+    const size_t digits() const {
+      return m_digits;
+    }
+
+    // Words in a row, including the dead word on either side.
+    const size_t row_words() const {
+      return m_row_words;
+    }
+
+    // A row of a plane of the current generation, the live plane is index digits().
+    const uint64_t* plane( const size_t index, const size_t row ) const {
+      return m_words.get() + row_start( m_current, index, row );
+    }
+
+    // A row of a plane of the next generation.
+    uint64_t* next_plane( const size_t index, const size_t row ) {
+      return m_words.get() + row_start( m_current ^ 1, index, row );
+    }
+
+    // Makes the next generation the current one.
+    void swap() {
+      m_current ^= 1;
+    }
+
+  private:
+    const size_t row_start( const size_t generation, const size_t index, const size_t row ) const {
+      return ( ( generation * ( m_digits + 1 ) + index ) * ( m_bounds.y + 2 ) + row ) * m_row_words;
+    }
+
+    // Lays out both generations for the bounds, every word is dead afterwards.
+    void layout( const Vec2< size_t >& bounds, const size_t digits );
+
+    // Packs the padded byte per cell states into the current generation, states past the digits are lost.
+    void pack( const uint8_t* cells, const size_t stride, app::ThreadPool& pool );
+
+    // Writes the current generation, or the one before it, into padded byte per cell states.
+    void unpack( uint8_t* cells, const size_t stride, const bool previous ) const;
+  };
+
+}
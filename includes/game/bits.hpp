@@ -0,0 +1,33 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+// Eight cells are moved between bytes and bits with one multiply, which relies on the byte order.
+static_assert( std::endian::native == std::endian::little );
+
+namespace game {
+
+  constexpr uint64_t k_low_bits = 0x0101010101010101;
+
+  // Gathers the lowest bit of every byte into a byte.
+  inline uint64_t gather( const uint64_t bytes ) {
+    return ( ( bytes & k_low_bits ) * 0x0102040810204080 ) >> 56;
+  }
+
+  // Sets the lowest bit of every byte that isn't zero and clears every other bit.
+  inline uint64_t occupied( uint64_t bytes ) {
+    bytes |= bytes >> 4;
+    bytes |= bytes >> 2;
+    bytes |= bytes >> 1;
+
+    return bytes & k_low_bits;
+  }
+
+  // Spreads the bits of a byte into the lowest bit of every byte, the inverse of gather.
+  inline uint64_t spread( const uint64_t bits ) {
+    const uint64_t masked = ( bits * k_low_bits ) & 0x8040201008040201;
+    return ( ( masked + 0x7F7F7F7F7F7F7F7F ) >> 7 ) & k_low_bits;
+  }
+
+}
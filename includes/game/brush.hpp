@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+
+#include <types.hpp>
+
+#include <game/universe.hpp>
+
+namespace game {
+
+  class Pattern;
+
+  enum class BrushMode {
+    Paint,
+    Erase,
+    Stamp
+  };
+
+  //
+  // Turns mouse samples into spans of cells.
+  //
+  // Samples are gathered as they arrive (possibly several per frame) and rasterised once per frame as
+  // thick line segments, so fast strokes don't leave gaps and each frame costs one batch of writes.
+  //
+  class Brush {
+  private:
+    int m_radius;
+    BrushMode m_mode;
+    const Pattern* m_stamp;
+
+    // Samples in cell coordinates that have not been rasterised yet.
+    std::vector< Vec2i > m_samples;
+
+    bool m_stroking;
+
+    // Whether m_last holds the final sample of the previous batch, so that batches are joined up.
+    bool m_has_last;
+    Vec2i m_last;
+
+    // Half width of the brush for every row offset from its centre.
+    std::vector< int > m_half_widths;
+
+    // Scratch interval per row of a segment.
+    std::vector< Vec2i > m_intervals;
+
+  private:
+    void rasterise_segment( const Vec2i& from, const Vec2i& to, const Vec2< size_t >& bounds, std::vector< Span >& spans );
+
+    void rasterise_stamp( const Vec2i& centre, const Vec2< size_t >& bounds, std::vector< Span >& spans );
+
+  public:
+    Brush();
+
+    void set_radius( const int radius );
+
+    void set_mode( const BrushMode mode ) {
+      m_mode = mode;
+    }
+
+    // The pattern must outlive the brush, or be replaced before the next stroke.
+    void set_stamp( const Pattern* stamp ) {
+      m_stamp = stamp;
+    }
+
+    const int radius() const {
+      return m_radius;
+    }
+
+    const BrushMode mode() const {
+      return m_mode;
+    }
+
+    const bool stroking() const {
+      return m_stroking;
+    }
+
+    void begin_stroke();
+
+    void end_stroke();
+
+    // Adds a sample in cell coordinates, ignored unless a stroke is in progress.
+    void add_sample( const Vec2i& cell );
+
+    //
+    // Converts the samples gathered since the last call into spans clipped to the bounds.
+    // Spans are sorted by row and do not overlap, so they can be written out in a single pass.
+    //
+    void rasterise( const Vec2< size_t >& bounds, std::vector< Span >& spans );
+  };
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <types.hpp>
+#include <memory.hpp>
+
+#include <game/rule.hpp>
+#include <game/universe.hpp>
+
+namespace game {
+
+  //
+  // Which cell every pixel of the texture shows.
+  //
+  // Square cells are a pixel each and need no map. Hexagons and triangles are drawn from a few pixels each,
+  // so the map is built once for the bounds and the topology: every pixel holds the index of the cell that
+  // covers it into the padded cell buffers of the universe, and drawing a frame is one lookup per pixel.
+  // Pixels just outside of the grid, e.g. beside the shifted rows of hexagons, hold a cell of the dead border.
+  //
+  class CellMap {
+  public:
+    // Pixels a hexagon is wide and a row of hexagons is high, about the smallest that still shows their points.
+    static constexpr size_t k_hexagon_width = 6;
+    static constexpr size_t k_hexagon_height = 5;
+
+    // Pixels the base of a triangle is wide and a row of triangles is high, neighbours overlap by half a base.
+    static constexpr size_t k_triangle_width = 4;
+    static constexpr size_t k_triangle_height = 3;
+
+  private:
+    Topology m_topology;
+    Vec2< size_t > m_bounds;
+    Vec2< size_t > m_pixel_bounds;
+
+    // Cell index of every pixel, row by row. Empty for square cells.
+    std::vector< uint32_t > m_cells;
+
+    app::MemoryAccount m_memory;
+
+  public:
+    CellMap();
+
+    // Pixels the texture of a grid takes up.
+    static const Vec2< size_t > pixel_bounds( const Vec2< size_t >& bounds, const Topology topology );
+
+    void build( const Vec2< size_t >& bounds, const Topology topology );
+
+    const Vec2< size_t >& pixel_bounds() const {
+      return m_pixel_bounds;
+    }
+
+    const uint32_t* cells() const {
+      return m_cells.data();
+    }
+
+    // Pixels that show any cell of a region of cells, everything but the region may be included as well.
+    const Region pixels( const Region& cells ) const;
+
+    // Cell that a pixel shows in 0 based grid coordinates, may be out of bounds like the pixel.
+    const Vec2i cell( const Vec2i& pixel ) const;
+  };
+
+}
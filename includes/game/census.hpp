@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <types.hpp>
+
+#include <game/rule.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  class Universe;
+
+  enum class ObjectKind {
+    StillLife,
+    Oscillator,
+    Spaceship,
+
+    // Dies out when run on its own.
+    Dying,
+
+    // Doesn't come back to its first phase within the period limit of the census.
+    Pathological
+  };
+
+  //
+  // A kind of object and how many of it a census found.
+  //
+  // Codes are the apgcodes of Catagolue: xs4_33 is the block, with the population of still lifes after xs, and
+  // the period after xp for oscillators (xp2_7 is the blinker) and after xq for spaceships (xq4_153 is the
+  // glider). The part after the underscore is the extended Wechsler format of the object in the phase and
+  // orientation that has the shortest and then alphabetically first code, so every rotation, reflection and
+  // phase of an object has the same code. Objects that die have the code DIES and ones that don't come back
+  // PATHOLOGICAL.
+  //
+  struct CensusObject {
+    std::string code;
+    ObjectKind kind;
+
+    // One for still lifes, how many generations it takes an object to come back otherwise.
+    size_t period;
+
+    // Cells an object moved by over one period, zero unless it is a spaceship. In the orientation of the first
+    // island of its shape that was run.
+    Vec2< int64_t > displacement;
+
+    // Live cells of the phase the code is of.
+    size_t population;
+
+    size_t count;
+  };
+
+  struct Census {
+    // By count, the most common object first, then by code.
+    std::vector< CensusObject > objects;
+
+    // Number of islands and of the live cells in them.
+    size_t islands;
+    size_t cells;
+  };
+
+  // Generations an island is run on its own for at most to find its period.
+  constexpr size_t k_census_max_period = 1024;
+
+  // Whether a census can be taken under the rule: two states on the square grid, and empty space has to stay empty.
+  const bool census_supports( const Rule& rule );
+
+  // Live cell in 0 based grid coordinates, islands may move past the bounds when they are run on their own.
+  using CellPosition = Vec2< int64_t >;
+
+  //
+  // Splits the live cells of universes into islands and tallies them by object.
+  //
+  // Live cells up to twice the range of the rule apart are in the same island, so no two islands affect the
+  // same cell in the next generation. The islands are labelled with a union-find over the live cells: bands of
+  // rows are labelled on the thread pool, each only linking cells within the band, and the rows along the band
+  // boundaries are linked afterwards. Islands of the same shape are only run once, each distinct shape is run on
+  // its own with the reference engine until it comes back to its first phase, possibly moved, which gives its
+  // period, displacement and code. Objects close enough to touch count as one, like a pseudo still life.
+  //
+  // The object every shape turned out to be is kept, so later censuses only run shapes that no earlier one has
+  // seen, e.g. over the many soups of a search. A taker is used by one thread at a time, but a census may use
+  // the pool. The rule has to be supported, see census_supports.
+  //
+  class CensusTaker {
+  private:
+    Rule m_rule;
+    size_t m_max_period;
+
+    // Objects by the code of the shape of the island that was run, which is the same in every orientation.
+    std::unordered_map< std::string, CensusObject > m_known;
+
+  public:
+    CensusTaker( const Rule& rule, const size_t max_period = k_census_max_period );
+
+    const Rule& rule() const {
+      return m_rule;
+    }
+
+    // Live cells of the universe by island, every island sorted by row.
+    const std::vector< std::vector< CellPosition > > islands( const Universe& universe, app::ThreadPool& pool ) const;
+
+    // The object an island is, with a count of zero.
+    const CensusObject classify( const std::vector< CellPosition >& island );
+
+    const Census take( const Universe& universe, app::ThreadPool& pool );
+  };
+
+  // Takes a single census, see CensusTaker.
+  const Census take_census( const Universe& universe, const Rule& rule, app::ThreadPool& pool, const size_t max_period = k_census_max_period );
+
+}
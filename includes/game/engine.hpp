@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <game/rule.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  class Activity;
+  class Universe;
+
+  //
+  // Advances a universe by one generation.
+  //
+  // Engines are interchangeable implementations of the same rule, so that they can be checked against
+  // each other and benchmarked on the same workloads. Every engine starts out with Conway's Game of Life.
+  //
+  class Engine {
+  protected:
+    Rule m_rule = Rule::life();
+
+    // Where the changed cells of every row go, see counts_activity.
+    Activity* m_activity = nullptr;
+
+  public:
+    virtual ~Engine() = default;
+
+    virtual const char* name() const = 0;
+
+    // Whether the engine can step universes with the rule, e.g. not every engine knows refractory states.
+    virtual const bool supports( const Rule& ) const {
+      return true;
+    }
+
+    // The rule has to be supported.
+    virtual void set_rule( const Rule& rule ) {
+      m_rule = rule;
+    }
+
+    const Rule& rule() const {
+      return m_rule;
+    }
+
+    //
+    // Whether the engine counts the changed cells of every row it steps into the activity set with set_activity,
+    // while the row is still in the cache. Universes of other bounds than the activity aren't counted.
+    //
+    virtual const bool counts_activity() const {
+      return false;
+    }
+
+    // Null stops counting.
+    void set_activity( Activity* activity ) {
+      m_activity = activity;
+    }
+
+    // Computes the next generation of the universe and makes it the current one.
+    virtual void step( Universe& universe, app::ThreadPool& pool ) = 0;
+
+  protected:
+    // The activity to count the rows of the universe into, null if there is none or it has other bounds.
+    Activity* activity( const Universe& universe ) const;
+  };
+
+  // Names of every engine, the first one is the reference that the others are checked against.
+  const std::vector< std::string_view >& engine_names();
+
+  // Creates an engine by name, returns nullptr if there is no such engine.
+  std::unique_ptr< Engine > make_engine( const std::string_view& name );
+
+  // Creates the fastest engine that supports the rule and sets it.
+  std::unique_ptr< Engine > make_engine( const Rule& rule );
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <game/engine.hpp>
+
+#include <game/bitplanes.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace game {
+
+  //
+  // Any rule on the eight cells around a cell, Generations rules included, 64 cells at a time.
+  //
+  // Steps the bit-planes the universe keeps, see BitPlanes: one plane per binary digit of the state plus a plane
+  // of the live cells. Neighbours are counted on the live plane with bitwise adders and the next states are
+  // computed plane by plane, so every operation handles a whole word of cells. The planes stay packed between
+  // steps, the bytes of the universe are only packed when they were written to and only written back when they
+  // are looked at.
+  //
+  // Isotropic non-totalistic rules can't be told apart by counts. Their table is synthesised into a boolean
+  // function of the nine cells of the block instead, a chain of multiplexers that is evaluated on whole words.
+  //
+  // The coin flips of stochastic rules come a word at a time as well, and only mask the births and survivals
+  // before the next states are computed and flip the noise into the live cells after.
+  //
+  class BitplaneEngine : public Engine {
+  private:
+    // Binary digits of the largest state of the rule.
+    size_t m_digits;
+
+    //
+    // A node of the function picks high if the cell of the block given by variable is alive and low if it
+    // isn't, nodes 0 and 1 are the constants. Every node only refers to nodes before it.
+    //
+    struct Node {
+      uint8_t variable;
+      uint16_t low;
+      uint16_t high;
+    };
+
+    // The function of an isotropic rule, nodes 0 and 1 aren't stored.
+    std::vector< Node > m_function;
+    uint16_t m_root;
+
+  public:
+    BitplaneEngine();
+
+    const char* name() const override {
+      return "bitplane";
+    }
+
+    const bool supports( const Rule& rule ) const override {
+      return !rule.larger() && !rule.tabular() && !rule.margolus && rule.square();
+    }
+
+    void set_rule( const Rule& rule ) override;
+
+    const bool counts_activity() const override {
+      return true;
+    }
+
+    void step( Universe& universe, app::ThreadPool& pool ) override;
+
+  private:
+    // Builds m_function from the table of an isotropic rule, shared parts of the function are only built once.
+    void synthesise( const Rule& rule );
+
+    //
+    // Writes the row of the next generation of the planes. Counts the changed cells of the row into the activity as
+    // well unless it is null, a word is a tile wide.
+    //
+    void step_row( BitPlanes& planes, const size_t generation, const size_t row, Activity* activity );
+  };
+
+}
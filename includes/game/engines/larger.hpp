@@ -0,0 +1,73 @@
+#pragma once
+
+#include <game/engine.hpp>
+
+#include <memory.hpp>
+
+#include <cstdint>
+#include <memory>
+
+#include <types.hpp>
+
+namespace game {
+
+  //
+  // Larger than Life rules, at the same cost per cell for every radius.
+  //
+  // Neighbour counts come from prefix sums over the live cells instead of visiting every cell within the
+  // radius. The tables are padded with a halo of dead cells as wide as the radius so that no lookup has to
+  // be bounds checked.
+  //
+  //    Moore: a summed-area table, the count of a square is four lookups.
+  //    von Neumann: prefix sums along both diagonals. Moving one cell to the right adds the wedge on the
+  //    right of the diamond and removes the one on its left, each wedge is two diagonal runs.
+  //
+  class LargerThanLifeEngine : public Engine {
+  private:
+    Vec2< size_t > m_bounds;
+
+    // Width of the dead halo around the tables.
+    size_t m_halo;
+
+    // Padded width of a table row.
+    size_t m_table_stride;
+
+    // The summed-area table, or the down-right diagonal sums followed by the down-left diagonal sums.
+    std::unique_ptr< uint32_t[] > m_tables;
+    size_t m_capacity;
+
+    app::MemoryAccount m_memory;
+
+  public:
+    LargerThanLifeEngine();
+
+    const char* name() const override {
+      return "ltl";
+    }
+
+    const bool supports( const Rule& rule ) const override {
+      return rule.larger();
+    }
+
+    void set_rule( const Rule& rule ) override;
+
+    const bool counts_activity() const override {
+      return true;
+    }
+
+    void step( Universe& universe, app::ThreadPool& pool ) override;
+
+  private:
+    void allocate( const Vec2< size_t >& bounds );
+
+    // Rows of the padded tables.
+    const size_t table_rows() const {
+      return m_bounds.y + 2 * m_halo;
+    }
+
+    void step_moore( Universe& universe, app::ThreadPool& pool );
+
+    void step_von_neumann( Universe& universe, app::ThreadPool& pool );
+  };
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <game/engine.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace game {
+
+  class Universe;
+
+  //
+  // Outer totalistic rules on the hexagonal and triangular grids, Generations rules included, split into bands
+  // of rows that are stepped on the thread pool.
+  //
+  // Both grids are kept in the square rows of the universe, see game::Topology, so every neighbour is on the
+  // same or an adjacent row and a row is swept like on the square grid:
+  //
+  //    Hexagonal: the neighbours on the rows above and below are at the same two columns, which are one
+  //    further right on shifted rows. The shift is picked once per row, not per cell.
+  //    Triangular: the sum of the 5 x 3 block around a cell minus the two outermost cells on the side of its
+  //    point. Which side that is alternates from cell to cell, so the corners of both sides are folded into
+  //    one row beforehand and the count is the same sum for every cell.
+  //
+  class LatticeEngine : public Engine {
+  private:
+    // Next state by state << 4 | count of live neighbours.
+    std::array< uint8_t, 256 * 16 > m_table;
+
+  public:
+    LatticeEngine();
+
+    const char* name() const override {
+      return "lattice";
+    }
+
+    const bool supports( const Rule& rule ) const override {
+      return !rule.square();
+    }
+
+    void set_rule( const Rule& rule ) override;
+
+    const bool counts_activity() const override {
+      return true;
+    }
+
+    void step( Universe& universe, app::ThreadPool& pool ) override;
+
+  private:
+    void step_hexagonal( Universe& universe, app::ThreadPool& pool );
+
+    void step_triangular( Universe& universe, app::ThreadPool& pool );
+  };
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <game/field.hpp>
+#include <game/fft.hpp>
+
+#include <memory.hpp>
+#include <types.hpp>
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  // How the potential of every cell is computed, see LeniaEngine.
+  enum class Convolution {
+    Automatic,
+    Direct,
+    Fourier
+  };
+
+  //
+  // Advances a field under a continuous rule, split into bands of rows that are stepped on the thread pool.
+  //
+  // The potential is the kernel convolved with the field, which is up to ( 2R + 1 )^2 multiplications per cell
+  // when done directly. Large kernels are convolved through the Fourier transform instead: the field is padded
+  // with R zeros in either direction up to powers of two, so that the cyclic convolution of the transform doesn't
+  // wrap around, its rows are transformed as real sequences and then its columns, multiplied with the spectrum of
+  // the kernel and transformed back. The spectrum of the kernel only changes with the rule and the bounds and is
+  // kept between steps. Automatic picks whichever of the two does less work for the radius and bounds.
+  //
+  class LeniaEngine {
+  private:
+    LeniaRule m_rule = LeniaRule::orbium();
+    Convolution m_convolution;
+
+    // Weights of the ( 2R + 1 ) x ( 2R + 1 ) block around a cell, row by row.
+    std::vector< float > m_kernel;
+
+    // Bounds of the field the transforms are laid out for, zero until the first step through the transform.
+    Vec2< size_t > m_bounds;
+    Vec2< size_t > m_padded;
+
+    RealFft m_rows;
+    Fft m_columns;
+
+    // Spectrum of the kernel column by column, already scaled to undo the unnormalised transforms.
+    std::vector< Complex > m_kernel_spectrum;
+
+    // Spectrum of the field row by row, padded.x / 2 + 1 elements each.
+    std::vector< Complex > m_spectrum;
+
+    app::MemoryAccount m_memory;
+
+  public:
+    LeniaEngine( const Convolution convolution = Convolution::Automatic );
+
+    const char* name() const;
+
+    void set_rule( const LeniaRule& rule );
+
+    const LeniaRule& rule() const {
+      return m_rule;
+    }
+
+    // The convolution a step of a field of the bounds goes through, never Automatic.
+    const Convolution convolution( const Vec2< size_t >& bounds ) const;
+
+    // Bytes the engine takes up to step a field of the bounds, the spectra of the transform if it goes through it.
+    const size_t bytes_required( const Vec2< size_t >& bounds ) const;
+
+    // Computes the next generation of the field and makes it the current one.
+    void step( Field& field, app::ThreadPool& pool );
+
+  private:
+    void step_direct( Field& field, app::ThreadPool& pool );
+
+    void step_fourier( Field& field, app::ThreadPool& pool );
+
+    // Size of the transforms for a field of the bounds.
+    const Vec2< size_t > padded( const Vec2< size_t >& bounds ) const;
+
+    // Sizes the transforms for the bounds and computes the spectrum of the kernel.
+    void layout( const Vec2< size_t >& bounds );
+  };
+
+  // Names of every continuous engine, the first one is the reference that the others are checked against.
+  const std::vector< std::string_view >& lenia_engine_names();
+
+  // Creates a continuous engine by name, returns nullptr if there is no such engine.
+  std::unique_ptr< LeniaEngine > make_lenia_engine( const std::string_view& name );
+
+}
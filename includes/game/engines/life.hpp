@@ -0,0 +1,67 @@
+#pragma once
+
+#include <game/engine.hpp>
+
+#include <cstdint>
+
+namespace game {
+
+  //
+  // Any rule, one cell at a time on a single thread.
+  // This is the original stepping loop and the reference every other engine is checked against.
+  // Rule tables are matched transition by transition, without their lookup table.
+  // Block rules look up the whole 2 x 2 block again for every cell of it.
+  //
+  class ScalarLifeEngine : public Engine {
+  public:
+    const char* name() const override {
+      return "scalar";
+    }
+
+    void step( Universe& universe, app::ThreadPool& pool ) override;
+
+  private:
+    // Next state of a cell in its 2 x 2 block under a block rule.
+    const uint8_t match_block( const Universe& universe, const size_t row, const size_t column ) const;
+
+    // Next state under a rule table.
+    const uint8_t match_table( const Universe& universe, const size_t row, const size_t column ) const;
+
+    // Counts the live cells within the radius of a Larger than Life rule one by one.
+    const size_t count_larger( const Universe& universe, const size_t row, const size_t column ) const;
+
+    // Counts the live neighbours on the hexagonal or triangular grid one by one.
+    const size_t count_lattice( const Universe& universe, const size_t row, const size_t column ) const;
+  };
+
+  //
+  // Rules without refractory states, isotropic non-totalistic ones included, split into bands of rows that are
+  // stepped on the thread pool. Every row is swept once with the 3 x 3 block around the current cell, which is
+  // updated by a shift per cell and looked up in the table of the rule.
+  //
+  class LifeEngine : public Engine {
+  private:
+    // Next state by 3 x 3 block of live cells, see Rule::table.
+    uint8_t m_table[ 512 ];
+
+  public:
+    LifeEngine();
+
+    const char* name() const override {
+      return "banded";
+    }
+
+    const bool supports( const Rule& rule ) const override {
+      return !rule.generations() && !rule.larger() && !rule.tabular() && !rule.margolus && !rule.stochastic() && rule.square();
+    }
+
+    void set_rule( const Rule& rule ) override;
+
+    const bool counts_activity() const override {
+      return true;
+    }
+
+    void step( Universe& universe, app::ThreadPool& pool ) override;
+  };
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <game/engine.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace game {
+
+  //
+  // Block rules, split into bands of block rows that are stepped on the thread pool.
+  //
+  // Both rows of a block row are packed into words of 64 cells, so that the left cells of the blocks are on the
+  // even bits. Shifting the right cells down lines up all four cells of every block on the even bits, and every
+  // cell of the next block is a boolean function of those four that is evaluated on whole words: a chain of
+  // multiplexers through the truth table of the rule, whose first level only picks a constant, the top left cell
+  // or its inverse. Shifting the right cells back up interleaves the results into rows again, which are unpacked
+  // straight into the next generation of the universe.
+  //
+  // The blocks of odd generations start a cell further up and left, so packing starts at the border column and
+  // the first block row at the border row instead of moving the cells. Cells of blocks that fall into the border
+  // are computed like the others but never written, the border stays dead.
+  //
+  class MargolusEngine : public Engine {
+  private:
+    //
+    // Word the first level picks for every cell of the next block and every pair of blocks that only differ in
+    // the top left cell: 0 if the cell is dead after both, 1 if it only lives after the block without the top
+    // left cell, 2 if it only lives after the block with it and 3 if it lives after both.
+    //
+    std::array< std::array< uint8_t, 8 >, 4 > m_selectors;
+
+  public:
+    MargolusEngine();
+
+    const char* name() const override {
+      return "margolus";
+    }
+
+    const bool supports( const Rule& rule ) const override {
+      return rule.margolus;
+    }
+
+    void set_rule( const Rule& rule ) override;
+
+    const bool counts_activity() const override {
+      return true;
+    }
+
+    void step( Universe& universe, app::ThreadPool& pool ) override;
+  };
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <game/multiverse.hpp>
+#include <game/rule.hpp>
+
+#include <cstdint>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  //
+  // Steps the 64 lanes of a multiverse at once under a life-like rule, split into bands of rows that are
+  // stepped on the thread pool.
+  //
+  // Every bit of a cell word is a cell of another universe, so a full adder over three words adds up 64 cells
+  // of 64 universes and there is no shifting between neighbours: the neighbours of a cell are just the words
+  // around it. The three cells of every column are summed once into two digits, and three columns of those
+  // into the four digits of the total of the 3 x 3 block, which decides the next state together with the cell
+  // itself. Small universes step as fast per cell as large ones, nothing is spent per universe.
+  //
+  // While the next generation is written over the one before the current one, both are compared with it, which
+  // gives the lanes that changed and the lanes that came back after two generations for nothing.
+  //
+  class MultiverseEngine {
+  private:
+    Rule m_rule = Rule::life();
+
+    // Totals of the 3 x 3 block, the cell itself included, that lead to a live cell whatever the cell is, only
+    // if it is alive and only if it is dead.
+    uint16_t m_totals_any;
+    uint16_t m_totals_alive;
+    uint16_t m_totals_dead;
+
+  public:
+    MultiverseEngine();
+
+    // Two states, the neighbour counts of the eight cells around a cell, no coin flips.
+    static const bool supports( const Rule& rule ) {
+      return rule.states == 2 && rule.square() && !rule.larger() && !rule.isotropic && !rule.tabular() &&
+        !rule.margolus && !rule.stochastic();
+    }
+
+    // The rule has to be supported.
+    void set_rule( const Rule& rule );
+
+    const Rule& rule() const {
+      return m_rule;
+    }
+
+    // Computes the next generation of every lane and makes it the current one.
+    void step( Multiverse& multiverse, app::ThreadPool& pool );
+  };
+
+}
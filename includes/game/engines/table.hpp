@@ -0,0 +1,33 @@
+#pragma once
+
+#include <game/engine.hpp>
+#include <game/rule_table.hpp>
+
+namespace game {
+
+  //
+  // Rule tables such as WireWorld through their lookup table, split into bands of rows on the thread pool.
+  //
+  // On the Moore neighbourhood every row is swept with the packed states of the 3 x 3 block around the current
+  // cell, which is updated by a shift per cell like the block of the banded engine. Von Neumann neighbourhoods
+  // are gathered cell by cell.
+  //
+  class RuleTableEngine : public Engine {
+  public:
+    const char* name() const override {
+      return "table";
+    }
+
+    // Only rule tables small enough to have a lookup table.
+    const bool supports( const Rule& rule ) const override {
+      return rule.tabular() && !rule.rule_table->lookup().empty();
+    }
+
+    const bool counts_activity() const override {
+      return true;
+    }
+
+    void step( Universe& universe, app::ThreadPool& pool ) override;
+  };
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <game/volume.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  //
+  // Advances a volume by one generation, the three dimensional counterpart of game::Engine. Every engine starts
+  // out with Bays' 4555.
+  //
+  class VolumeEngine {
+  protected:
+    VolumeRule m_rule = VolumeRule::bays_4555();
+
+  public:
+    virtual ~VolumeEngine() = default;
+
+    virtual const char* name() const = 0;
+
+    virtual void set_rule( const VolumeRule& rule ) {
+      m_rule = rule;
+    }
+
+    const VolumeRule& rule() const {
+      return m_rule;
+    }
+
+    // Computes the next generation of the volume and makes it the current one.
+    virtual void step( Volume& volume, app::ThreadPool& pool ) = 0;
+  };
+
+  //
+  // Counts the 26 neighbours of every cell one by one, the reference that the other engines are checked against.
+  //
+  class ScalarVolumeEngine : public VolumeEngine {
+  public:
+    const char* name() const override {
+      return "scalar";
+    }
+
+    void step( Volume& volume, app::ThreadPool& pool ) override;
+  };
+
+  //
+  // Counts neighbours 64 cells at a time with bitwise adders, split into bands of slices that are stepped on
+  // the thread pool.
+  //
+  // The count of a cell is the sum of the 3 x 3 blocks around it on its own slice and the slices above and
+  // below, minus the cell itself. The 3 x 3 sums of a slice are four bit-planes that are computed once per
+  // band and kept in a window of three slices: moving on to the next slice adds one slice of sums and reuses
+  // the other two, so every slice of a band is summed once instead of three times.
+  //
+  class SlicedVolumeEngine : public VolumeEngine {
+  private:
+    // Totals of the 27 cells, the cell itself included, that a live cell survives with and a dead one is born with.
+    uint32_t m_survival_totals;
+    uint32_t m_birth_totals;
+
+  public:
+    SlicedVolumeEngine();
+
+    const char* name() const override {
+      return "sliced";
+    }
+
+    void set_rule( const VolumeRule& rule ) override;
+
+    void step( Volume& volume, app::ThreadPool& pool ) override;
+  };
+
+  // Names of every volume engine, the first one is the reference that the others are checked against.
+  const std::vector< std::string_view >& volume_engine_names();
+
+  // Creates a volume engine by name, returns nullptr if there is no such engine.
+  std::unique_ptr< VolumeEngine > make_volume_engine( const std::string_view& name );
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace game {
+
+  using Complex = std::complex< float >;
+
+  //
+  // Iterative radix-2 fast Fourier transform of complex sequences whose length is a power of two.
+  //
+  // Neither direction is normalised, an inverse after a forward transform scales the sequence by its length.
+  // The twiddle factors are computed in double precision once, so long transforms don't accumulate the error
+  // of a recurrence.
+  //
+  class Fft {
+  private:
+    size_t m_size;
+
+    // e^( -2 pi i k / length ) for k < length / 2 of every stage, at length / 2 - 1.
+    std::vector< Complex > m_twiddles;
+
+    // Index of every element after the bit reversal permutation.
+    std::vector< uint32_t > m_reversed;
+
+  public:
+    Fft( const size_t size = 1 );
+
+    const size_t size() const {
+      return m_size;
+    }
+
+    void forward( Complex* data ) const;
+
+    void inverse( Complex* data ) const;
+
+  private:
+    template< bool Inverse >
+    void transform( Complex* data ) const;
+  };
+
+  //
+  // Fourier transform of real sequences whose length is a power of two, at least 2.
+  //
+  // The even and odd elements of a sequence are packed into the real and imaginary parts of a complex sequence
+  // of half the length, transformed, and the two interleaved spectra are separated afterwards. A real sequence
+  // of length n has a spectrum of n / 2 + 1 elements, the others are their complex conjugates.
+  //
+  class RealFft {
+  private:
+    size_t m_size;
+    Fft m_half;
+
+    // e^( -2 pi i k / size ) for k <= size / 2.
+    std::vector< Complex > m_twiddles;
+
+  public:
+    RealFft( const size_t size = 2 );
+
+    const size_t size() const {
+      return m_size;
+    }
+
+    const size_t spectrum_size() const {
+      return m_size / 2 + 1;
+    }
+
+    // Scratch has to hold size / 2 elements.
+    void forward( const float* in, Complex* out, Complex* scratch ) const;
+
+    // Not normalised, the sequence comes out scaled by size / 2. Scratch has to hold size / 2 elements.
+    void inverse( const Complex* in, float* out, Complex* scratch ) const;
+  };
+
+}
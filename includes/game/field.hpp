@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <types.hpp>
+#include <memory.hpp>
+
+#include <game/rule.hpp>
+#include <game/universe.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  //
+  // A continuous rule in the style of Bert Chan's Lenia, e.g. R13,T10,M0.15,S0.015,B1 for Orbium.
+  //
+  // Every cell holds a value in [ 0, 1 ]. The potential of a cell is the weighted sum of the values around it,
+  // under a radial kernel of the radius R that is made of rings of the given peak heights (B, separated by
+  // semicolons) and sums up to one. Every step adds the growth of the potential, a bell around M of width S
+  // scaled to [ -1, 1 ], over T steps per unit of time and clips the value to [ 0, 1 ].
+  //
+  struct LeniaRule {
+    uint32_t radius = 13;
+    uint32_t time = 10;
+    float mu = 0.15F;
+    float sigma = 0.015F;
+    std::vector< float > peaks = { 1.F };
+
+    static constexpr uint32_t k_max_radius = 256;
+
+    static const LeniaRule orbium() {
+      return {};
+    }
+
+    const bool operator==( const LeniaRule& other ) const {
+      return radius == other.radius && time == other.time && mu == other.mu && sigma == other.sigma && peaks == other.peaks;
+    }
+
+    const float growth( const float potential ) const;
+
+    // Weights of the ( 2R + 1 ) x ( 2R + 1 ) block around a cell, row by row, adding up to one.
+    const std::vector< float > kernel() const;
+
+    const std::string to_string() const;
+  };
+
+  // Parses the notation above, returns false if the text isn't a rule. R and M are required, T defaults to 10,
+  // S to 0.015 and B to a single ring.
+  bool parse_lenia_rule( const std::string_view& text, LeniaRule& out );
+
+  // Well known continuous rules, Orbium first.
+  const std::vector< NamedRule >& named_lenia_rules();
+
+  //
+  // The cell store of continuous automata, one float per cell.
+  //
+  // Cells are laid out row by row without a border, everything outside of the bounds is zero.
+  //
+  class Field {
+  private:
+    Vec2< size_t > m_bounds;
+
+    std::unique_ptr< float[] > m_current;
+    std::unique_ptr< float[] > m_next;
+
+    app::MemoryAccount m_memory;
+
+  public:
+    Field();
+
+    // Bytes the cell buffers of a field of the given bounds take up.
+    static const size_t bytes_required( const Vec2< size_t >& bounds ) {
+      return 2 * bounds.x * bounds.y * sizeof( float );
+    }
+
+    void reset();
+
+    // Allocates the buffers for the bounds, every cell is zero afterwards.
+    void init( const Vec2< size_t >& bounds );
+
+    void clear();
+
+    // Gives cells a uniformly random value with probability density and zero otherwise, the same seed always
+    // produces the same field.
+    void randomise( app::ThreadPool& pool, const uint64_t seed, const double density );
+
+    // Writes a batch of spans into both generations, cells of live states become one and the others zero.
+    const Region apply( const std::vector< Span >& spans );
+
+    // Makes the next generation the current one.
+    void swap();
+
+  public:
+    const Vec2< size_t >& bounds() const {
+      return m_bounds;
+    }
+
+    const float* current() const {
+      return m_current.get();
+    }
+
+    float* current() {
+      return m_current.get();
+    }
+
+    float* next() {
+      return m_next.get();
+    }
+
+    // Sum of all values of the current generation.
+    const double mass() const;
+  };
+
+}
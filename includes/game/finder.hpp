@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <types.hpp>
+#include <memory.hpp>
+
+#include <game/pattern.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  class Universe;
+
+  //
+  // Rotations and reflections of a pattern: bit 2 swaps rows and columns, then bit 0 mirrors the columns and bit 1
+  // the rows. Orientation 0 is the pattern as it is.
+  //
+  constexpr size_t k_orientations = 8;
+
+  const Pattern orient( const Pattern& pattern, const size_t orientation );
+
+  // An occurrence of a pattern, the top left cell of the oriented pattern in 0 based grid coordinates.
+  struct PatternMatch {
+    Vec2< size_t > position;
+    Vec2< size_t > bounds;
+    uint8_t orientation;
+  };
+
+  //
+  // Finds every occurrence of a pattern in a universe, in any of its orientations.
+  //
+  // Cells that aren't dead are alive, both in the pattern and in the universe. A match has exactly the cells of the
+  // pattern within its bounds and a margin of dead cells around them, so that e.g. a glider next to debris isn't
+  // taken for a glider. Cells past the bounds of the universe are dead, but the pattern itself has to be inside.
+  //
+  // Every distinct orientation is compiled into a mask of live cells per row of the pattern and its margin, which
+  // have to fit into a word. The universe is packed a bit per cell, and 64 positions of a row are matched at once:
+  // for every cell of the window the packed row is shifted so that the cell of each position lines up, and the
+  // positions where it agrees with the mask are kept. The live cells are tried first since they rule out most
+  // positions. Bands of rows are matched on the thread pool.
+  //
+  class PatternFinder {
+  public:
+    // Cells of the widest orientation of a pattern with its margin on both sides.
+    static constexpr size_t k_max_width = 64;
+
+  private:
+    struct Orientation {
+      uint8_t orientation;
+
+      // Of the oriented pattern, without the margin.
+      Vec2< size_t > bounds;
+
+      // Live cells of every row of the pattern and its margin, bit i is column i.
+      std::vector< uint64_t > rows;
+
+      //
+      // Cells of the window that are tried in turn, live cells first, as row * m_width + column. Each comes with
+      // what the shifted row is XORed with to keep the positions that agree: nothing for a live cell, every bit for a
+      // dead one.
+      //
+      std::vector< uint16_t > cells;
+      std::vector< uint64_t > inverts;
+    };
+
+    std::vector< Orientation > m_orientations;
+    size_t m_margin;
+
+    // Cells of the window of the widest orientation with the margin, on either axis.
+    size_t m_width;
+
+    // The universe a bit per cell with a word of dead cells on the left and two on the right, see pack.
+    std::vector< uint64_t > m_packed;
+    size_t m_row_words;
+
+    app::MemoryAccount m_memory;
+
+  public:
+    PatternFinder();
+
+    //
+    // Compiles the orientations of the pattern with a margin of dead cells. Returns false if the pattern has no
+    // live cells or doesn't fit into a word with the margin, in which case nothing is found until the next one.
+    //
+    bool compile( const Pattern& pattern, const size_t margin, std::string& error );
+
+    // Every occurrence in the universe, row by row and left to right, orientations in order at the same position.
+    const std::vector< PatternMatch > find( const Universe& universe, app::ThreadPool& pool );
+
+    // Orientations that differ from each other, one for a pattern that is the same in all of them.
+    const size_t orientations() const {
+      return m_orientations.size();
+    }
+
+    const size_t margin() const {
+      return m_margin;
+    }
+
+  private:
+    void pack( const Universe& universe, app::ThreadPool& pool );
+  };
+
+}
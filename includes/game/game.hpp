@@ -6,12 +6,34 @@
 #include <dxgi.h>
 #include <d3d11.h>
 
+#include <array>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <types.hpp>
 #include <colour.hpp>
+#include <profiler.hpp>
+#include <memory.hpp>
+
+#include <game/universe.hpp>
+#include <game/engine.hpp>
+#include <game/rule.hpp>
+#include <game/workload.hpp>
+#include <game/pattern.hpp>
+#include <game/brush.hpp>
+#include <game/cell_map.hpp>
+#include <game/census.hpp>
+#include <game/activity.hpp>
+#include <game/finder.hpp>
+#include <game/volume.hpp>
+#include <game/engines/volume.hpp>
+#include <game/field.hpp>
+#include <game/engines/lenia.hpp>
 
 // forward delcarations.
+struct ImDrawList;
+
 namespace app {
   class Application;
   class Window;
@@ -25,6 +47,13 @@ namespace game {
     ID3D11SamplerState* sampler;
   };
 
+  // What the game steps and draws, the cells of the universe by default.
+  enum class Simulation {
+    Grid,
+    Volume,
+    Continuous
+  };
+
   class Game {
   private:
     bool m_draw_debug;
@@ -35,24 +64,88 @@ namespace game {
 
     Vec2< size_t > m_bounds;
 
+    // Bounds the textures were created with.
+    Vec2< size_t > m_texture_bounds;
+
     // Our own custom texture that we write pixel data to.
     ID3D11Texture2D* m_staging;
     ID3D11Texture2D* m_texture;
     ID3D11ShaderResourceView* m_texture_resource;
 
+    // Staging and default texture together.
+    app::MemoryAccount m_texture_memory;
+
     // Texture sampler since we don't want linear interpolation on textures.
     ID3D11SamplerState* m_texture_sampler;
 
     std::unique_ptr< uint32_t[] > m_pixel_buffer;
+    size_t m_pixel_capacity;
+    app::MemoryAccount m_pixel_memory;
+
+    // Pixels of the cells of the rule's topology, the pixel buffer and the textures have its pixel bounds.
+    CellMap m_cell_map;
+
+    Universe m_universe;
+
+    Rule m_rule;
+
+    // Steps the universe, the fastest engine that supports the rule.
+    std::unique_ptr< Engine > m_engine;
+
+    Simulation m_simulation;
+
+    // Why the last switch of the simulation or rule of a volume or field was refused, if it was.
+    std::string m_simulation_status;
+
+    //
+    // Three dimensional cells that are stepped and drawn instead of the universe by the volume simulation. The
+    // volume has the bounds of the universe and m_depth slices, only one of which is drawn, or the nearest live
+    // cell along z of every column when projecting. The brush paints into the drawn slice.
+    //
+    Volume m_volume;
+    size_t m_depth;
+    VolumeRule m_volume_rule;
+    std::unique_ptr< VolumeEngine > m_volume_engine;
 
-    std::unique_ptr< uint8_t[] > m_cells_current;
-    std::unique_ptr< uint8_t[] > m_cells_next;
+    // Temporary values that are used in the volume settings: the drawn slice, whether to project instead, and the
+    // rule input field.
+    int m_slice;
+    bool m_projection;
+    char m_volume_rule_text[ 32 ];
+
+    // Continuous cells that are stepped instead of the universe by the continuous simulation, with its bounds.
+    Field m_field;
+    LeniaRule m_lenia_rule;
+    std::unique_ptr< LeniaEngine > m_lenia_engine;
+
+    // Temporary value that is used in the continuous rule input field.
+    char m_lenia_rule_text[ 64 ];
+
+    // Colour of continuous cells by value, from the dead colour to the alive one.
+    std::array< uint32_t, 256 > m_gradient;
+
+    // Part of the universe that changed since the texture was last uploaded.
+    Region m_dirty;
+
+    // The pixels of m_dirty, once the pixel buffer is up to date.
+    Region m_dirty_pixels;
+
+    Brush m_brush;
+
+    // Scratch buffer for the spans the brush produces every frame.
+    std::vector< Span > m_spans;
+
+    // Patterns that can be used with the stamp brush.
+    std::vector< Pattern > m_stamps;
     
     float m_time_scale;
 
     Colour m_alive_colour;
     Colour m_dead_colour;
 
+    // Colour of every state, refractory states fade from the alive colour to the dead one.
+    std::array< uint32_t, 256 > m_palette;
+
     // Temporary values that are used in ImGui colour picker.
     float m_temp_alive_colour[ 4 ];
     float m_temp_dead_colour[ 4 ];
@@ -60,9 +153,63 @@ namespace game {
     // Temporary values that are used in input fields to update grid size.
     size_t m_temp_size_x;
     size_t m_temp_size_y;
+    size_t m_temp_size_z;
+
+    // Temporary value that is used in the anchor combo box, see game::Anchor.
+    int m_anchor;
+
+    // Temporary values that are used in the brush settings.
+    int m_brush_mode;
+    int m_brush_radius;
+    int m_stamp;
+
+    // Seed and density used by the "Random" button.
+    uint64_t m_seed;
+    float m_density;
+
+    // Index into game::workloads used by the "Load" button.
+    int m_workload;
+
+    // Temporary value that is used in the rule input field, a rule or the path of a .rule file, and why it
+    // was rejected if it was.
+    char m_rule_text[ 260 ];
+    std::string m_rule_status;
 
     bool m_running;
 
+    // Scratch copies of the profiler history used to draw the plots, and the result of the last CSV dump.
+    std::array< std::vector< float >, app::k_phase_count > m_profile_history;
+    std::string m_profile_status;
+
+    // Number of frames a trace records for, zero to record until stopped.
+    int m_trace_frames;
+
+    // Why the last resize was refused, if it was.
+    std::string m_resize_status;
+
+    // Objects of the universe as of the last census, and how long it took or why it was refused.
+    Census m_census;
+    std::string m_census_status;
+
+    //
+    // Changed cells of every tile of the universe over the last generations, only counted while the heat map is on.
+    // Temporary value that is used in the window slider.
+    //
+    Activity m_activity;
+    bool m_heat_map;
+    int m_activity_window;
+
+    //
+    // Occurrences of a pattern in the universe as of the last search, and how long it took or why it was refused.
+    // Temporary values that are used in the pattern input field, the margin slider and the highlight checkbox.
+    //
+    PatternFinder m_finder;
+    std::vector< PatternMatch > m_matches;
+    std::string m_find_status;
+    char m_find_text[ 1024 ];
+    int m_find_margin;
+    bool m_highlight;
+
     RenderCallbackData m_callback_data;
 
   public:
@@ -74,28 +221,89 @@ namespace game {
 
     void init( const Vec2< size_t >& bounds );
 
+    // Changes the grid size while keeping the current pattern.
+    void resize( const Vec2< size_t >& bounds, const Anchor anchor );
+
+    // Bytes the cell buffers, pixel buffer, textures and cell map of a grid of the given bounds take up.
+    static const uint64_t bytes_required( const Vec2< size_t >& bounds, const Topology topology );
+
+    // Same as above for the volume simulation, the volume is on top of the universe.
+    static const uint64_t bytes_required( const Vec3< size_t >& bounds );
+
+    // Bytes a grid of the given bounds takes up under the current simulation, depth is only used by volumes.
+    const uint64_t bytes_required( const Vec2< size_t >& bounds, const size_t depth ) const;
+
     void update( const double t, const double dt );
 
     void draw();
+
+    // Replaces the current pattern with a reproducible random one.
+    void randomise( const uint64_t seed, const float density );
+
+    // Replaces the universe with a workload from the corpus, at the size of the workload.
+    void load( const Workload& workload );
+
+    // Switches to the rule and the fastest engine that supports it, cells in states the rule doesn't have die.
+    void set_rule( const Rule& rule );
+
+    // Switches between stepping the universe and a volume or field of its bounds, which start out empty.
+    void set_simulation( const Simulation simulation );
+
+    // Feeds a mouse position in window coordinates to the brush, called for every mouse move message.
+    void on_mouse_move( const int x, const int y );
   
   private:
     void create_texture_sampler();
 
+    void create_textures();
+
+    void release_textures();
+
+    // Maps the cells to pixels for the bounds and the topology, the pixel buffer and textures follow.
+    void layout_pixels();
+
     void update_texture();
 
     void update_pixel_buffer();
 
+    // Draws the slice or the projection of the volume into the pixel buffer.
+    void update_volume_pixels();
+
+    // Draws the field into the pixel buffer through the gradient.
+    void update_field_pixels();
+
     void draw_debug_metrics();
 
-    const uint8_t get_state( const size_t row, const size_t column );
+    void draw_profiler();
+
+    void draw_tracer();
+
+    void draw_memory();
+
+    void draw_volume();
+
+    void draw_continuous();
+
+    // Takes a census of the universe on request and shows the tally.
+    void draw_census();
+
+    // Turns the heat map on and off and lists the most active tiles.
+    void draw_activity();
+
+    // Shades every tile that changed over the activity window over the texture, the more it changed the redder.
+    void draw_heat_map( ImDrawList* draw_list );
 
-    void set_state( const size_t row, const size_t column, const uint8_t state );
+    // Finds a pattern in the universe on request and lists where.
+    void draw_finder();
 
-    void set_states( const size_t row, const size_t column, const uint8_t state );
+    // Outlines the occurrences of the last search over the texture.
+    void draw_matches( ImDrawList* draw_list );
 
-    void set_pixel( const size_t x, const size_t y, const uint32_t colour );
+    // Marks the whole universe for re-upload.
+    void mark_dirty();
 
-    const size_t num_alive_neighbors( const size_t row, const size_t column );
+    // Converts a position in window coordinates to a cell in 0 based grid coordinates, may be out of bounds.
+    const Vec2i to_cell( const float x, const float y ) const;
 
     const uint32_t alive_colour() const;
     const uint32_t dead_colour() const;
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <types.hpp>
+#include <memory.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  class Universe;
+
+  //
+  // The cell store of 64 independent universes of the same bounds, stepped together by game::MultiverseEngine.
+  //
+  // Every cell is a word whose bit k is the cell of universe k, the lane of the universe. Like a universe the
+  // words are padded with a single cell wide border of dead cells in two buffers, so valid rows and columns are
+  // 1 based, and a lane only ever sees the cells of its own bit. Lanes are loaded from and extracted into
+  // ordinary universes of two states.
+  //
+  class Multiverse {
+  public:
+    static constexpr size_t k_lanes = 64;
+
+  private:
+    Vec2< size_t > m_bounds;
+
+    std::unique_ptr< uint64_t[] > m_cells_current;
+    std::unique_ptr< uint64_t[] > m_cells_next;
+
+    // Steps taken since init, clear or randomise.
+    size_t m_generation;
+
+    // Lanes whose current generation differs from the one before and from the one two generations back.
+    uint64_t m_changed;
+    uint64_t m_changed_twice;
+
+    app::MemoryAccount m_memory;
+
+  public:
+    Multiverse();
+
+    // Bytes the cell buffers of a multiverse of the given bounds take up.
+    static const size_t bytes_required( const Vec2< size_t >& bounds ) {
+      return 2 * ( bounds.x + 2 ) * ( bounds.y + 2 ) * sizeof( uint64_t );
+    }
+
+    // Allocates the buffers for the bounds, every cell of every lane is dead afterwards.
+    void init( const Vec2< size_t >& bounds );
+
+    void clear();
+
+    // Fills every lane with random cells, the same seed always produces the same lanes, see Universe::randomise.
+    void randomise( app::ThreadPool& pool, const uint64_t seed, const double density );
+
+    // Copies a universe of the same bounds into both generations of a lane, states other than dead are alive.
+    void load( const size_t lane, const Universe& universe );
+
+    // Kills every cell of a lane.
+    void clear( const size_t lane );
+
+    // Lays the universe out for the bounds and copies the current generation of a lane into it.
+    void extract( const size_t lane, Universe& universe ) const;
+
+    // Makes the next generation the current one and counts the step, with the lanes the step changed.
+    void swap( const uint64_t changed, const uint64_t changed_twice );
+
+  public:
+    const Vec2< size_t >& bounds() const {
+      return m_bounds;
+    }
+
+    // Number of cells in a padded row.
+    const size_t stride() const {
+      return m_bounds.x + 2;
+    }
+
+    // Number of cells in a padded buffer.
+    const size_t size() const {
+      return stride() * ( m_bounds.y + 2 );
+    }
+
+    const size_t generation() const {
+      return m_generation;
+    }
+
+    uint64_t* current() {
+      return m_cells_current.get();
+    }
+
+    const uint64_t* current() const {
+      return m_cells_current.get();
+    }
+
+    uint64_t* next() {
+      return m_cells_next.get();
+    }
+
+    //
+    // Lanes that changed over the last step, and lanes that aren't the same as two steps ago. Lanes that were
+    // loaded or cleared since count as changed until the next step.
+    //
+    const uint64_t changed() const {
+      return m_changed;
+    }
+
+    const uint64_t changed_twice() const {
+      return m_changed_twice;
+    }
+
+    // Lanes that settled into still lifes and oscillators of period two, the bulk of what soups settle into.
+    const uint64_t stable() const {
+      return ~m_changed_twice;
+    }
+
+    // Lanes with at least one live cell.
+    const uint64_t live() const;
+
+    // Number of live cells of a lane.
+    const size_t population( const size_t lane ) const;
+  };
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <game/universe.hpp>
+#include <game/engine.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  // Where an engine first disagreed with the reference.
+  struct Mismatch {
+    std::string engine;
+    size_t threads;
+
+    // Number of steps taken when the universes first differed, starting at 1.
+    size_t generation;
+
+    // Cell in padded coordinates, so row / column 0 and bounds + 1 are the border.
+    size_t row;
+    size_t column;
+
+    uint8_t expected;
+    uint8_t actual;
+  };
+
+  //
+  // Checks every engine against the reference engine (the first of game::engine_names).
+  //
+  // Every other engine is run for every thread count in lockstep with the reference, and after each
+  // generation the universes are compared bit for bit, border included.
+  //
+  class Oracle {
+  private:
+    struct Candidate {
+      std::unique_ptr< Engine > engine;
+      app::ThreadPool* pool;
+      Universe universe;
+    };
+
+    std::unique_ptr< Engine > m_reference;
+    std::vector< std::unique_ptr< app::ThreadPool > > m_pools;
+    std::vector< Candidate > m_candidates;
+
+    Universe m_expected;
+
+  public:
+    Oracle( const std::vector< size_t >& threads );
+    ~Oracle();
+
+    // Number of engine and thread count combinations that are checked against the reference.
+    const size_t candidates() const {
+      return m_candidates.size();
+    }
+
+    // Switches every engine to the rule, engines that don't support it are skipped until the next switch.
+    void set_rule( const Rule& rule );
+
+    //
+    // Steps a copy of the universe with the reference and every candidate.
+    // Returns the first mismatch of every candidate that disagreed, a candidate stops at its first mismatch.
+    //
+    std::vector< Mismatch > check( const Universe& initial, const size_t generations );
+  };
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <types.hpp>
+
+namespace game {
+
+  //
+  // A small rectangular block of cells, e.g. a glider that can be stamped into a universe.
+  //
+  class Pattern {
+  private:
+    Vec2< size_t > m_bounds;
+    std::vector< uint8_t > m_cells;
+
+  public:
+    Pattern();
+    Pattern( const Vec2< size_t >& bounds );
+
+    //
+    // Parses a pattern in the run length encoded format used by Golly and the LifeWiki.
+    // https://conwaylife.com/wiki/Run_Length_Encoded
+    //
+    // 'b' and '.' are dead, 'o' is alive and 'A'..'X' are the states 1..24 of multi-state patterns.
+    // Returns false if the pattern is malformed, in which case the pattern is left empty.
+    //
+    bool load_rle( const std::string_view& rle );
+
+  public:
+    const Vec2< size_t >& bounds() const {
+      return m_bounds;
+    }
+
+    const uint8_t get( const size_t x, const size_t y ) const {
+      return m_cells[ y * m_bounds.x + x ];
+    }
+
+    void set( const size_t x, const size_t y, const uint8_t state ) {
+      m_cells[ y * m_bounds.x + x ] = state;
+    }
+
+    const size_t population() const;
+  };
+
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <bit>
+
+namespace game {
+
+  //
+  // SplitMix64 finalizer, a cheap stateless 64 bit hash.
+  // Used to derive independent generator states from a seed and a stream index (e.g. a row).
+  //
+  inline uint64_t mix64( uint64_t value ) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    value = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EBULL;
+    return value ^ ( value >> 31 );
+  }
+
+  //
+  // xoshiro256** by David Blackman and Sebastiano Vigna.
+  // https://prng.di.unimi.it/
+  //
+  // Every call yields 64 random bits, which is exactly 64 cells worth of coin flips.
+  //
+  class Xoshiro256 {
+  private:
+    uint64_t m_state[ 4 ];
+
+    static uint64_t rotl( const uint64_t value, const int k ) {
+      return ( value << k ) | ( value >> ( 64 - k ) );
+    }
+
+  public:
+    using result_type = uint64_t;
+
+    Xoshiro256( const uint64_t seed, const uint64_t stream = 0 ) {
+      uint64_t state = seed ^ mix64( stream );
+      for( auto& word : m_state ) {
+        state += 0x9E3779B97F4A7C15ULL;
+        word = mix64( state );
+      }
+    }
+
+    static constexpr result_type min() {
+      return 0;
+    }
+
+    static constexpr result_type max() {
+      return UINT64_MAX;
+    }
+
+    result_type operator()() {
+      const uint64_t result = rotl( m_state[ 1 ] * 5, 7 ) * 9;
+      const uint64_t t = m_state[ 1 ] << 17;
+
+      m_state[ 2 ] ^= m_state[ 0 ];
+      m_state[ 3 ] ^= m_state[ 1 ];
+      m_state[ 1 ] ^= m_state[ 2 ];
+      m_state[ 0 ] ^= m_state[ 3 ];
+
+      m_state[ 2 ] ^= t;
+      m_state[ 3 ] = rotl( m_state[ 3 ], 45 );
+
+      return result;
+    }
+  };
+
+  //
+  // Philox4x32-10 by Salmon, Moraes, Dror and Shaw, "Parallel Random Numbers: As Easy as 1, 2, 3".
+  // https://www.thesalmons.org/john/random123/
+  //
+  // A counter-based generator: every block of 128 random bits is a keyed bijection of a 128 bit counter, so
+  // any block can be computed on its own without stepping through the ones before it. Keyed on a seed and
+  // counting up from a generation and an index, the bits drawn for a cell don't depend on which thread draws
+  // them or in which order. Every call yields half a block, the blocks of an index are counted in the lowest word.
+  //
+  class Philox {
+  private:
+    uint32_t m_counter[ 4 ];
+    uint32_t m_key[ 2 ];
+
+    // The second half of the last block, if it wasn't handed out yet.
+    uint64_t m_spare;
+    bool m_has_spare;
+
+  public:
+    using result_type = uint64_t;
+
+    //
+    //    seed: the key
+    //    generation: only the lowest 32 bits count
+    //    index: e.g. of a word of cells
+    //    stream: tells apart the draws for different purposes at the same index, up to 255
+    //
+    Philox( const uint64_t seed, const uint64_t generation, const uint64_t index, const uint32_t stream = 0 ) :
+      m_counter{ stream << 24, ( uint32_t ) generation, ( uint32_t ) index, ( uint32_t ) ( index >> 32 ) },
+      m_key{ ( uint32_t ) seed, ( uint32_t ) ( seed >> 32 ) },
+      m_spare{},
+      m_has_spare( false )
+    {
+    }
+
+    static constexpr result_type min() {
+      return 0;
+    }
+
+    static constexpr result_type max() {
+      return UINT64_MAX;
+    }
+
+    // The ten rounds of the bijection on a counter, in place.
+    static void block( uint32_t counter[ 4 ], const uint32_t key[ 2 ] ) {
+      uint32_t k0 = key[ 0 ];
+      uint32_t k1 = key[ 1 ];
+
+      for( int round{}; round < 10; ++round ) {
+        const uint64_t p0 = ( uint64_t ) 0xD2511F53 * counter[ 0 ];
+        const uint64_t p1 = ( uint64_t ) 0xCD9E8D57 * counter[ 2 ];
+
+        counter[ 0 ] = ( uint32_t ) ( p1 >> 32 ) ^ counter[ 1 ] ^ k0;
+        counter[ 1 ] = ( uint32_t ) p1;
+        counter[ 2 ] = ( uint32_t ) ( p0 >> 32 ) ^ counter[ 3 ] ^ k1;
+        counter[ 3 ] = ( uint32_t ) p0;
+
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+      }
+    }
+
+    result_type operator()() {
+      if( m_has_spare ) {
+        m_has_spare = false;
+        return m_spare;
+      }
+
+      uint32_t bits[ 4 ] = { m_counter[ 0 ], m_counter[ 1 ], m_counter[ 2 ], m_counter[ 3 ] };
+      block( bits, m_key );
+      ++m_counter[ 0 ];
+
+      m_spare = ( ( uint64_t ) bits[ 3 ] << 32 ) | bits[ 2 ];
+      m_has_spare = true;
+
+      return ( ( uint64_t ) bits[ 1 ] << 32 ) | bits[ 0 ];
+    }
+  };
+
+  // Fixed point precision of densities handed to bernoulli_bits, probabilities are multiples of 1 / 2^16.
+  constexpr uint32_t k_density_bits = 16;
+
+  //
+  // Fixed point precision of the chances of stochastic rules, probabilities are multiples of 1 / 2^32. Fine enough
+  // for the rare noise of a rule to stay what it was written as, a chance of one in a million is a threshold of 4295.
+  //
+  constexpr uint32_t k_chance_bits = 32;
+
+  // Converts a probability in [ 0, 1 ] to a fixed point threshold for bernoulli_bits.
+  inline uint32_t density_threshold( const double density ) {
+    const double clamped = std::min( std::max( density, 0.0 ), 1.0 );
+    return ( uint32_t ) ( clamped * ( double ) ( 1U << k_density_bits ) + 0.5 );
+  }
+
+  // Converts a probability in [ 0, 1 ] to a fixed point threshold for bernoulli_bits< k_chance_bits >.
+  inline uint64_t chance_threshold( const double chance ) {
+    const double clamped = std::min( std::max( chance, 0.0 ), 1.0 );
+    return ( uint64_t ) ( clamped * ( double ) ( ( uint64_t ) 1 << k_chance_bits ) + 0.5 );
+  }
+
+  //
+  // Produces 64 independent coin flips that each come up 1 with probability threshold / 2^Bits.
+  //
+  // Walks the binary expansion of the probability from the least significant set bit upwards:
+  // AND-ing with a fair random word halves the probability, OR-ing with one maps p to ( p + 1 ) / 2.
+  // A density of 0.5 costs a single generator call, the worst case is Bits calls for 64 cells.
+  //
+  template< uint32_t Bits = k_density_bits, typename Generator >
+  uint64_t bernoulli_bits( Generator& generator, const uint64_t threshold ) {
+    if( threshold == 0 ) {
+      return 0;
+    }
+
+    if( threshold >= ( ( uint64_t ) 1 << Bits ) ) {
+      return UINT64_MAX;
+    }
+
+    uint64_t bits{};
+    for( uint32_t bit{ ( uint32_t ) std::countr_zero( threshold ) }; bit < Bits; ++bit ) {
+      bits = ( ( threshold >> bit ) & 1 ) ? ( bits | generator() ) : ( bits & generator() );
+    }
+
+    return bits;
+  }
+
+}
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <game/random.hpp>
+
+namespace game {
+
+  class RuleTable;
+
+  enum class Neighbourhood : uint8_t {
+    // Every cell within the radius in both directions, a square.
+    Moore,
+
+    // Every cell within the radius in Manhattan distance, a diamond.
+    VonNeumann
+  };
+
+  //
+  // Shape of the cells. All of them are stored in the same rows and columns, hexagons in offset rows where
+  // every odd row (0 based) is shifted right by half a cell, and triangles alternate between pointing up and
+  // down along a row, the one at ( 0, 0 ) pointing up.
+  //
+  enum class Topology : uint8_t {
+    // Eight neighbours.
+    Square,
+
+    // Six neighbours, two on the same row and two on either adjacent row.
+    Hexagonal,
+
+    // Twelve neighbours, every triangle that shares a corner with the cell.
+    Triangular
+  };
+
+  // Closed range of neighbour counts.
+  struct Range {
+    uint32_t min;
+    uint32_t max;
+
+    const bool contains( const size_t count ) const {
+      return count >= min && count <= max;
+    }
+
+    const bool operator==( const Range& other ) const {
+      return min == other.min && max == other.max;
+    }
+  };
+
+  //
+  // An outer totalistic rule on the Moore neighbourhood, e.g. B3/S23 for Conway's Game of Life.
+  //
+  // Rules of the Generations family add refractory states: a live cell that doesn't survive passes through
+  // the states 2 .. states - 1, one per generation, before it is dead again. Refractory cells neither count
+  // as live neighbours nor can anything be born into them. Brian's Brain is B2/S/C3.
+  //
+  // Isotropic non-totalistic rules tell apart the arrangements of the live neighbours that aren't rotations or
+  // reflections of each other, written with a letter after the count in Hensel notation: tlife is B3/S2-i34q.
+  //
+  // Larger than Life rules count the live cells within a radius of up to k_max_radius instead, and birth and
+  // survival are ranges of counts. Bosco's Rule is R5,C0,M1,S33..57,B34..45,NM.
+  //
+  // Rules loaded from a rule table such as WireWorld leave all of this to the table, see game::RuleTable.
+  //
+  // Outer totalistic rules, Generations ones included, may also be on a hexagonal or triangular grid, where
+  // the counts go up to 6 and 12. B2/S34H is on hexagons and B4/S345L on triangles.
+  //
+  // Rules of two states on the square grid may also be stochastic: a cell whose count is in B is only born with
+  // a chance, a cell whose count is in S only survives with a chance, and noise flips any cell with a chance after
+  // that. B3/S23/BP0.9/N0.001 is Life where births fail one time in ten and one cell in a thousand flips.
+  //
+  // Block rules in Margolus' partitioning scheme don't look at neighbours at all: the grid is cut into 2 x 2
+  // blocks and every block is replaced as a whole, by the block the rule maps it to. The blocks of odd
+  // generations are offset by one cell in both directions, so information crosses the block boundaries. The
+  // billiard ball machine is MS,D0;8;4;3;2;5;9;7;1;6;10;11;12;13;14;15 in MCell's notation.
+  //
+  struct Rule {
+    // Bit n is set if a dead cell with n live neighbours is born.
+    uint16_t birth;
+
+    // Bit n is set if a live cell with n live neighbours survives.
+    uint16_t survival;
+
+    // Number of states including dead and alive, 2 unless the rule is of the Generations family.
+    uint16_t states;
+
+    // Neither isotropic nor Larger than Life rules are on other grids than the square one.
+    Topology topology = Topology::Square;
+
+    // Larger than Life, zero for rules on the eight cells around a cell.
+    uint8_t radius = 0;
+    Neighbourhood neighbourhood = Neighbourhood::Moore;
+
+    // Whether a live cell counts towards its own neighbours.
+    bool middle = false;
+
+    // Used instead of the masks when the radius isn't zero.
+    Range birth_range = {};
+    Range survival_range = {};
+
+    // Isotropic non-totalistic, the table is used instead of the masks.
+    bool isotropic = false;
+
+    //
+    // Bit n is set if a cell whose 3 x 3 block of live cells is n is alive in the next generation. The cell at
+    // ( dx, dy ) from the centre is bit 3 * ( dx + 1 ) + dy + 1, so the block is laid out column by column
+    // and the cell itself is bit 4.
+    //
+    std::array< uint64_t, 8 > table = {};
+
+    // Set for rules given by a table of transitions, states is the number of states of the table then.
+    std::shared_ptr< const RuleTable > rule_table = nullptr;
+
+    //
+    // Chances of stochastic rules as thresholds of bernoulli_bits< k_chance_bits >, k_certain for transitions
+    // without chance. The coin flips of a cell are drawn from a Philox generator that is keyed on the seed and counts
+    // up from the generation and the word of 64 cells the cell is in, see chances.
+    //
+    uint64_t birth_chance = k_certain;
+    uint64_t survival_chance = k_certain;
+    uint64_t noise = 0;
+    uint64_t seed = 0;
+
+    // Block rules, the masks and the table aren't used then.
+    bool margolus = false;
+
+    //
+    // Block a 2 x 2 block of live cells turns into, by block. Bit 0 of a block is the top left cell, bit 1 the
+    // top right, bit 2 the bottom left and bit 3 the bottom right one. Reversible rules are permutations.
+    //
+    std::array< uint8_t, 16 > blocks = {};
+
+    static constexpr size_t k_max_radius = 50;
+
+    static constexpr uint64_t k_certain = ( uint64_t ) 1 << k_chance_bits;
+
+    static const Rule life() {
+      return { 1 << 3, ( 1 << 2 ) | ( 1 << 3 ), 2 };
+    }
+
+    const bool generations() const {
+      return states > 2 && !tabular();
+    }
+
+    const bool larger() const {
+      return radius != 0;
+    }
+
+    const bool tabular() const {
+      return rule_table != nullptr;
+    }
+
+    const bool square() const {
+      return topology == Topology::Square;
+    }
+
+    const bool stochastic() const {
+      return birth_chance != k_certain || survival_chance != k_certain || noise != 0;
+    }
+
+    const bool operator==( const Rule& other ) const {
+      return birth == other.birth && survival == other.survival && states == other.states && topology == other.topology &&
+        radius == other.radius && neighbourhood == other.neighbourhood && middle == other.middle &&
+        birth_range == other.birth_range && survival_range == other.survival_range &&
+        isotropic == other.isotropic && table == other.table && rule_table == other.rule_table &&
+        birth_chance == other.birth_chance && survival_chance == other.survival_chance && noise == other.noise &&
+        seed == other.seed && margolus == other.margolus && blocks == other.blocks;
+    }
+
+    // Whether a cell is alive in the next generation given its 3 x 3 block of live cells, see table.
+    const bool lives( const size_t block ) const {
+      if( isotropic ) {
+        return ( table[ block >> 6 ] >> ( block & 63 ) ) & 1;
+      }
+
+      const size_t live_neighbors = ( size_t ) std::popcount( block & ~( size_t ) 16 );
+      return ( ( block & 16 ? survival : birth ) >> live_neighbors ) & 1;
+    }
+
+    // State of a cell in the next generation, the cell itself is part of the count if middle is set.
+    const uint8_t next( const uint8_t state, const size_t live_neighbors ) const {
+      if( state == 0 ) {
+        return larger() ? birth_range.contains( live_neighbors ) : ( birth >> live_neighbors ) & 1;
+      }
+
+      if( state == 1 && ( larger() ? survival_range.contains( live_neighbors ) : ( ( survival >> live_neighbors ) & 1 ) != 0 ) ) {
+        return 1;
+      }
+
+      return state + 1 == states ? 0 : state + 1;
+    }
+
+    // Same as next for rules on the eight cells around a cell, from the 3 x 3 block of live cells instead of the count.
+    const uint8_t next_by_block( const uint8_t state, const size_t block ) const {
+      if( state <= 1 && lives( block ) ) {
+        return 1;
+      }
+
+      return state == 0 || state + 1 == states ? 0 : state + 1;
+    }
+
+    //
+    // B3/S23, B2/S/C3 for rules of the Generations family, B3/S2-i34q for isotropic non-totalistic rules,
+    // R5,C0,M1,S33..57,B34..45,NM for Larger than Life or MS,D15;1;2;3;4;5;6;7;8;9;10;11;12;13;14;0 for block
+    // rules. Rule tables go by their name. Hexagonal and triangular rules end in H and L, counts of 10 to 12 are
+    // written A to C. Chances of stochastic rules follow as /BP, /SP and /N parts, the seed isn't written.
+    //
+    const std::string to_string() const;
+
+    //
+    // Coin flips of the 64 cells of a word under a stochastic rule: bit n of birth is set if the cell n may be
+    // born, of survival if it may survive and of noise if it flips afterwards. Rows are split into words of 64
+    // cells from the first column, ( width + 63 ) / 64 words to a row, and the words are numbered row by row.
+    //
+    struct Chances {
+      uint64_t birth;
+      uint64_t survival;
+      uint64_t noise;
+    };
+
+    const Chances chances( const uint64_t generation, const uint64_t word ) const;
+  };
+
+  //
+  // Parses B/S notation (B3/S23, B2/S345/C4), the older S/B notation (23/3, 345/2/4), both with Hensel letters
+  // (B2n3/S23-q), Larger than Life notation (R5,C0,M1,S33..57,B34..45,NM with NN for the von Neumann
+  // neighbourhood) and MCell's notation of block rules (MS,D followed by the 16 blocks the blocks 0 to 15 turn
+  // into), case insensitive. A trailing H puts a rule without letters on the hexagonal grid as in Golly, a
+  // trailing L on the triangular one (B4/S345L), where counts of 10 to 12 are written A to C. Returns false if
+  // the text isn't a rule, has more than 256 states, a count over the neighbours of the grid or a radius over
+  // Rule::k_max_radius. B/S rules of two states on the square grid may end in the chances of stochastic rules,
+  // BP for births, SP for survivals and N for noise, each between 0 and 1 (B3/S23/BP0.9/N0.001), the seed is
+  // left at zero. The names of the rule tables that come with the game are rules as well.
+  //
+  bool parse_rule( const std::string_view& text, Rule& out );
+
+  //
+  // Letters of Hensel notation for a number of live neighbours, in the order they are written: "ce" for 1,
+  // "cekain" for 2 and so on. Empty for 0 and 8, where every arrangement is the same.
+  //
+  const char* hensel_letters( const size_t live_neighbors );
+
+  struct NamedRule {
+    const char* name;
+    const char* rule;
+  };
+
+  // Well known rules, Conway's Game of Life first.
+  const std::vector< NamedRule >& named_rules();
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <game/rule.hpp>
+
+#include <memory.hpp>
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace game {
+
+  //
+  // A rule given as a table of transitions in the format of Golly's .rule files, for automata of up to 256
+  // states such as WireWorld. https://golly.sourceforge.io/Help/formats.html#rule
+  //
+  //    @RULE WireWorld
+  //    @TABLE
+  //    n_states:4
+  //    neighborhood:Moore
+  //    symmetries:permute
+  //    var a={0,1,2,3}
+  //    ...
+  //    1,a,b,c,d,e,f,g,h,2
+  //
+  // A transition lists the state of the cell, those of its neighbours clockwise from north and the next state
+  // of the cell. The first transition that matches wins, a cell that matches none keeps its state. A variable
+  // stands for any of its states, but every occurrence of it in a transition for the same one. Symmetries let
+  // a transition stand for its rotations, reflections or all permutations of the neighbours as well.
+  //
+  // Variables and symmetries are expanded once while loading, into rows of the states every cell of the
+  // neighbourhood may have. The rows are then compiled into a lookup table of the next state by the packed
+  // states of the neighbourhood, unless that table would be too large.
+  //
+  class RuleTable {
+  public:
+    // The lookup table has at most 2^k_max_lookup_bits entries, e.g. 4 states on the Moore neighbourhood.
+    static constexpr size_t k_max_lookup_bits = 24;
+
+    struct Row {
+      // States each cell of the neighbourhood may have, in the order of the file.
+      std::vector< std::bitset< 256 > > inputs;
+      uint8_t output;
+    };
+
+  private:
+    std::string m_name;
+    size_t m_states;
+    Neighbourhood m_neighbourhood;
+
+    std::vector< Row > m_rows;
+
+    //
+    // Next state by neighbourhood, every cell takes up state_bits bits of the index. Moore neighbourhoods are
+    // laid out like Rule::table, column by column, von Neumann ones in the order of the file.
+    //
+    size_t m_state_bits;
+    std::vector< uint8_t > m_lookup;
+    app::MemoryAccount m_memory;
+
+    // ARGB colours of the @COLORS section, zero for states without one.
+    std::vector< uint32_t > m_colours;
+
+  public:
+    RuleTable();
+
+    // Parses the text of a .rule file, returns nullptr and sets the error if it isn't one.
+    static std::shared_ptr< const RuleTable > parse( const std::string_view& text, std::string& error );
+
+  public:
+    const std::string& name() const {
+      return m_name;
+    }
+
+    const size_t states() const {
+      return m_states;
+    }
+
+    const Neighbourhood neighbourhood() const {
+      return m_neighbourhood;
+    }
+
+    // Cells of the neighbourhood including the cell itself.
+    const size_t cells() const {
+      return m_neighbourhood == Neighbourhood::Moore ? 9 : 5;
+    }
+
+    const std::vector< Row >& rows() const {
+      return m_rows;
+    }
+
+    //
+    // Next state of a cell by going through the rows one by one, the states are in the order of the file.
+    // This is what the lookup table is checked against.
+    //
+    const uint8_t match( const uint8_t* states ) const;
+
+    const size_t state_bits() const {
+      return m_state_bits;
+    }
+
+    // Empty if the rule has too many states for a table of at most 2^k_max_lookup_bits entries.
+    const std::vector< uint8_t >& lookup() const {
+      return m_lookup;
+    }
+
+    const uint32_t colour( const size_t state ) const {
+      return state < m_colours.size() ? m_colours[ state ] : 0;
+    }
+
+  private:
+    // Builds the lookup table from the rows.
+    void compile();
+  };
+
+  // Makes a rule of a rule table.
+  const Rule make_rule( const std::shared_ptr< const RuleTable >& table );
+
+  // Reads a .rule file into a rule, returns false and sets the error if it can't.
+  bool load_rule_file( const std::string& path, Rule& out, std::string& error );
+
+  // Looks up a rule table that comes with the game by name, case insensitive, e.g. WireWorld.
+  bool find_builtin_table( const std::string_view& name, Rule& out );
+
+}
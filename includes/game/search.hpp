@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <types.hpp>
+#include <thread_pool.hpp>
+
+#include <game/census.hpp>
+#include <game/engine.hpp>
+#include <game/rule.hpp>
+#include <game/universe.hpp>
+
+namespace game {
+
+  // Hashes the text a search is seeded with, the soups of a search are derived from the hash and their index.
+  const uint64_t hash_seed( const std::string_view& seed );
+
+  // Results of the soups of a search, added up.
+  struct SearchTally {
+    size_t soups = 0;
+
+    // Soups that didn't settle within the generation limit or outgrew the largest universe, censused as they were.
+    size_t unsettled = 0;
+
+    // Generations stepped over all soups.
+    uint64_t generations = 0;
+
+    // Objects by code, spaceships that escaped included.
+    std::unordered_map< std::string, size_t > objects;
+
+    void merge( const SearchTally& other );
+  };
+
+  //
+  // A search as a checkpoint keeps it, enough to resume the search with the soup after the last one.
+  //
+  // Checkpoints are text, a line of the seed, the rule and the size of the soups, one with the counts of the
+  // tally and a line per object with its code and count, the most common object first.
+  //
+  struct SearchCheckpoint {
+    std::string seed;
+    std::string rule;
+    Vec2< size_t > soup_size;
+    SearchTally tally;
+  };
+
+  // Writes next to the path first and replaces the file after, so a checkpoint is never half written.
+  bool save_checkpoint( const std::string& path, const SearchCheckpoint& checkpoint, std::string& error );
+
+  bool load_checkpoint( const std::string& path, SearchCheckpoint& out, std::string& error );
+
+  //
+  // Runs random soups until they settle and adds their census to a tally. Every thread of a search has its own,
+  // nothing is shared between them while a soup runs.
+  //
+  // A soup is a block of random cells in the middle of a universe that is only a little larger. Whenever cells come
+  // close to the edge, the islands there are classified: spaceships are on their way out and are removed and
+  // counted, anything else grows the universe a little in every direction. A soup has settled once the universe
+  // comes back to an earlier generation, which is found with hashes of every few generations, the last k_history
+  // of them.
+  //
+  class SoupSearch {
+  public:
+    // Hashes that are kept, soups with a period that isn't a divisor of k_history times the generations between
+    // hashes don't settle, e.g. oscillators of several periods with a long common multiple.
+    static constexpr size_t k_history = 256;
+
+    static constexpr size_t k_max_generations = 1 << 16;
+
+    // Soups that outgrow a universe this wide or high are censused as they are.
+    static constexpr size_t k_max_side = 4096;
+
+  private:
+    Rule m_rule;
+    Vec2< size_t > m_soup_size;
+    uint32_t m_threshold;
+    size_t m_max_generations;
+
+    std::unique_ptr< Engine > m_engine;
+
+    // A soup is stepped on the thread that runs it.
+    app::ThreadPool m_pool;
+
+    Universe m_universe;
+    CensusTaker m_census;
+
+    // Hashes of the last generations that were hashed, in a ring, the last m_recorded of them are valid.
+    std::array< uint64_t, k_history > m_history;
+    size_t m_recorded;
+
+    // Generations between looks at the edge, and how close cells may come to it before that.
+    size_t m_interval;
+    size_t m_edge;
+
+  public:
+    // The rule has to be supported by the census, see census_supports.
+    SoupSearch( const Rule& rule, const Vec2< size_t >& soup_size, const double density = 0.5, const size_t max_generations = k_max_generations );
+
+    // Runs the soup of the index of the search with the seed, see hash_seed.
+    void run( const uint64_t seed, const uint64_t index, SearchTally& tally );
+
+  private:
+    void place_soup( const uint64_t seed, const uint64_t index );
+
+    // Removes the spaceships at the edge and grows the universe for anything else there, false if it can't grow.
+    const bool contain( SearchTally& tally );
+
+    const uint64_t hash() const;
+  };
+
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <types.hpp>
+#include <memory.hpp>
+#include <thread_pool.hpp>
+
+#include <game/census.hpp>
+#include <game/multiverse.hpp>
+#include <game/engines/multiverse.hpp>
+#include <game/rule.hpp>
+#include <game/universe.hpp>
+
+namespace game {
+
+  // Every combination of B0 to B8 and S0 to S8.
+  constexpr size_t k_life_like_rules = 1 << 18;
+
+  // Bits 0 to 8 of the index are the birth counts and bits 9 to 17 the survival counts, so 6152 is B3/S23.
+  const Rule life_like_rule( const size_t index );
+
+  // Distinct life-like rules in the order of their index, the same count and seed always give the same rules.
+  const std::vector< Rule > sample_life_like_rules( const size_t count, const uint64_t seed );
+
+  //
+  // Periods are tallied in buckets that double in width: 1, 2, 3 - 4, 5 - 8, 9 - 16 and 17 - 32, periods of up to
+  // RuleSurvey::k_max_period are found.
+  //
+  constexpr size_t k_period_buckets = 6;
+
+  // How the soups of a rule behaved, see RuleSurvey.
+  struct SurveyResult {
+    Rule rule;
+    size_t soups;
+
+    size_t died;
+
+    // Soups that reached the edge of their universe with anything that neither moves away nor settles, most of them
+    // because they kept growing.
+    size_t escaped;
+
+    // Soups that sent off at least one spaceship, gliders in Life. Only looked for if census_supports the rule.
+    size_t spaceships;
+    bool censused;
+
+    // Soups that didn't die by the period of their last generation, and the ones that have none up to the limit.
+    std::array< size_t, k_period_buckets > periods;
+    size_t unsettled;
+
+    // Live cells a soup gained per generation over the second half of the run, on average.
+    double growth;
+
+    // Live cells of a universe after the last generation, on average.
+    double density;
+  };
+
+  // Names of the columns of survey_row, separated by commas.
+  const std::string survey_header();
+
+  // A result as a line of comma separated values without the line break, the rule in B/S notation.
+  const std::string survey_row( const SurveyResult& result );
+
+  //
+  // Runs seeded soups under life-like rules, 64 of them at a time in the lanes of a multiverse, and sums up what
+  // became of them. Every thread of a survey has its own, nothing is shared between them while a rule runs.
+  //
+  // Every soup is a block of random cells in the middle of a universe a few times its size, and all soups of a rule
+  // run for the same number of generations. The engine only has to be told the totals that lead to a live cell
+  // for the next rule, and the buffers of the multiverse are kept between rules, so a rule costs no more than its
+  // generations. Every few generations the lanes with cells close to the edge are looked at one by one like the
+  // islands of SoupSearch: spaceships are removed and counted, still lifes and oscillators are left alone, and
+  // anything else escaped and isn't looked for again.
+  //
+  // The last k_max_period generations are kept, and the period of a lane is the first of them it is the same as.
+  // Rules under which every lane comes back after two generations stop early, most rules die out or freeze soon.
+  //
+  class RuleSurvey {
+  public:
+    static constexpr size_t k_max_period = ( size_t ) 1 << ( k_period_buckets - 1 );
+
+    // Islands at the edge with more cells than this aren't run to see whether they are spaceships.
+    static constexpr size_t k_max_spaceship_cells = 64;
+
+    // Generations an island at the edge is run for to come back as a spaceship.
+    static constexpr size_t k_max_spaceship_period = 64;
+
+  private:
+    Vec2< size_t > m_soup_size;
+    size_t m_generations;
+    size_t m_batches;
+    uint32_t m_threshold;
+
+    MultiverseEngine m_engine;
+
+    // The multiverse is stepped on the thread that runs the rule.
+    app::ThreadPool m_pool;
+
+    Multiverse m_multiverse;
+
+    // A lane with cells close to the edge, split into islands.
+    Universe m_lane;
+
+    // The cells within the edge at the last look, row by row, so that ash that settled there is only looked at once.
+    std::vector< uint64_t > m_edge_cells;
+
+    // The last generations of a batch, generation g in the slot g % k_max_period.
+    std::vector< uint64_t > m_history;
+    app::MemoryAccount m_memory;
+
+  public:
+    // Soups are rounded up to a multiple of the lanes of a multiverse.
+    RuleSurvey( const Vec2< size_t >& soup_size, const size_t generations, const size_t soups, const double density = 0.5 );
+
+    // Rules of two states on the eight cells around a cell without coin flips, see MultiverseEngine::supports.
+    static const bool supports( const Rule& rule ) {
+      return MultiverseEngine::supports( rule );
+    }
+
+    const size_t soups() const {
+      return m_batches * Multiverse::k_lanes;
+    }
+
+    //
+    // Runs the soups of the rule, seeded with the hash_seed of the rule in B/S notation so that they don't depend on
+    // the rules around it.
+    //
+    const SurveyResult run( const Rule& rule );
+
+    // Lays out the soups of a batch as run does, in the lanes of the multiverse, e.g. to run them another way.
+    void place_soups( const uint64_t seed, const size_t batch );
+
+    const Multiverse& multiverse() const {
+      return m_multiverse;
+    }
+
+  private:
+    // Lanes whose cells within the edge changed since the last look, see m_edge_cells.
+    const uint64_t changed_near_edge();
+
+    //
+    // Removes the spaceships at the edge from the lanes, returns the lanes that had anything there that neither
+    // moves nor settled.
+    //
+    const uint64_t contain( const uint64_t lanes, CensusTaker& census, uint64_t& spaceships );
+
+    // Live cells of every lane together.
+    const uint64_t population( const uint64_t* cells ) const;
+
+    //
+    // Tallies the periods of the live lanes into the result, from the generations that were kept unless the batch
+    // stopped early because every lane had settled into a period of one or two.
+    //
+    void tally_periods( const uint64_t live, const bool settled, SurveyResult& result ) const;
+  };
+
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include <types.hpp>
+#include <memory.hpp>
+
+#include <game/bitplanes.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  class Pattern;
+
+  // Which point of the existing pattern stays put when the universe is resized.
+  enum class Anchor {
+    TopLeft,
+    Centre
+  };
+
+  // Half open rectangle of cells in 0 based grid coordinates (i.e. without the border).
+  struct Region {
+    size_t left;
+    size_t top;
+    size_t right;
+    size_t bottom;
+
+    const bool empty() const {
+      return left >= right || top >= bottom;
+    }
+
+    void merge( const Region& other ) {
+      if( other.empty() ) {
+        return;
+      }
+
+      if( empty() ) {
+        *this = other;
+        return;
+      }
+
+      left = std::min( left, other.left );
+      top = std::min( top, other.top );
+      right = std::max( right, other.right );
+      bottom = std::max( bottom, other.bottom );
+    }
+  };
+
+  // A horizontal run of cells [ begin, end ) on a row that are all set to the same state, in 0 based grid coordinates.
+  struct Span {
+    size_t row;
+    size_t begin;
+    size_t end;
+    uint8_t state;
+  };
+
+  //
+  // The cell store.
+  //
+  // Cells are stored one byte per cell in two buffers (current and next generation) that are padded
+  // with a single cell wide border of dead cells, so neighbor lookups never have to bounds check.
+  // Valid rows and columns are therefore 1 based.
+  //
+  // Engines that step bit-planes keep them in the universe between steps, see planes. The bytes are only written
+  // from the planes once something looks at them, every accessor of the bytes catches them up first and every
+  // write to them leaves the planes to be packed again.
+  //
+  class Universe {
+  private:
+    Vec2< size_t > m_bounds;
+
+    // Number of cells each buffer can hold, may be larger than the padded bounds after shrinking.
+    size_t m_capacity;
+
+    std::unique_ptr< uint8_t[] > m_cells_current;
+    std::unique_ptr< uint8_t[] > m_cells_next;
+
+    // Steps taken since the cells were last laid out, rules that depend on time such as block rules read it.
+    size_t m_generation;
+
+    app::MemoryAccount m_memory;
+
+    // Null until an engine steps the planes.
+    std::unique_ptr< BitPlanes > m_planes;
+
+  public:
+    Universe();
+
+    // Bytes the cell buffers of a universe of the given bounds take up.
+    static const size_t bytes_required( const Vec2< size_t >& bounds ) {
+      return 2 * ( bounds.x + 2 ) * ( bounds.y + 2 );
+    }
+
+    void reset();
+
+    void init( const Vec2< size_t >& bounds );
+
+    //
+    // Changes the bounds while keeping the existing pattern, cells that fall outside of the new bounds are lost.
+    // The buffers are only reallocated when the new bounds exceed their capacity.
+    //
+    void resize( const Vec2< size_t >& bounds, const Anchor anchor );
+
+    // Kills every cell without touching the allocations.
+    void clear();
+
+    // Becomes an exact copy of another universe, the allocations are reused if they are large enough.
+    void copy( const Universe& other );
+
+    // Writes the live cells of a pattern into both generations, clipped to the bounds.
+    void place( const Pattern& pattern, const Vec2i& origin );
+
+    //
+    // Fills the universe with random cells.
+    //
+    //    seed: the same seed always produces the same universe, no matter how many threads are used
+    //    density: probability of a cell being alive, [ 0, 1 ]
+    //
+    void randomise( app::ThreadPool& pool, const uint64_t seed, const double density );
+
+    //
+    // Writes a batch of spans into both generations, spans are expected to be clipped to the bounds.
+    // Returns the region that was touched.
+    //
+    const Region apply( const std::vector< Span >& spans );
+
+    // Makes the next generation the current one and counts the step.
+    void swap();
+
+    //
+    // The cells as bit-planes of the given number of digits, see BitPlanes. They are packed from the bytes unless
+    // they already hold the current generation, i.e. were stepped last and the bytes weren't written to since.
+    //
+    BitPlanes& planes( const size_t digits, app::ThreadPool& pool );
+
+    // Counts a step that was taken on the planes, the bytes of both generations fall behind them.
+    void step_planes();
+
+  public:
+    const Vec2< size_t >& bounds() const {
+      return m_bounds;
+    }
+
+    // Number of cells in a padded row.
+    const size_t stride() const {
+      return m_bounds.x + 2;
+    }
+
+    // Number of cells in a padded buffer.
+    const size_t size() const {
+      return stride() * ( m_bounds.y + 2 );
+    }
+
+    const size_t capacity() const {
+      return m_capacity;
+    }
+
+    // Zero after init, clear and randomise, copied along with the cells.
+    const size_t generation() const {
+      return m_generation;
+    }
+
+    uint8_t* current() {
+      detach( false );
+      return m_cells_current.get();
+    }
+
+    const uint8_t* current() const {
+      catch_up( false );
+      return m_cells_current.get();
+    }
+
+    // The generation before the current one after a step.
+    uint8_t* next() {
+      detach( true );
+      return m_cells_next.get();
+    }
+
+    const uint8_t* next() const {
+      catch_up( true );
+      return m_cells_next.get();
+    }
+
+    const uint8_t get_state( const size_t row, const size_t column ) const;
+
+    // Sets the state in the next generation.
+    void set_state( const size_t row, const size_t column, const uint8_t state );
+
+    // Sets the state in both generations.
+    void set_states( const size_t row, const size_t column, const uint8_t state );
+
+    // Refractory states of Generations rules don't count as alive, see game::Rule.
+    const size_t num_alive_neighbors( const size_t row, const size_t column ) const;
+
+    // The live cells of the 3 x 3 block around a cell as an index into game::Rule::table.
+    const size_t live_block( const size_t row, const size_t column ) const;
+
+    // Kills cells whose state doesn't exist under a rule with the given number of states.
+    void restrict_states( const size_t states );
+
+    // Number of cells in the current generation that aren't dead.
+    const size_t population() const;
+
+  private:
+    // Writes the planes into the bytes of the current generation, or the one before, if they are behind.
+    void catch_up( const bool previous ) const {
+      if( m_planes != nullptr && ( previous ? m_planes->m_previous_ahead : m_planes->m_current_ahead ).load( std::memory_order_acquire ) ) {
+        write_back( previous );
+      }
+    }
+
+    void write_back( const bool previous ) const;
+
+    // Catches up the bytes that are about to be written to, the planes have to be packed again afterwards.
+    void detach( const bool previous ) {
+      catch_up( previous );
+
+      if( m_planes != nullptr ) {
+        m_planes->m_valid.store( false, std::memory_order_relaxed );
+      }
+    }
+  };
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <types.hpp>
+#include <memory.hpp>
+
+#include <game/rule.hpp>
+#include <game/universe.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  //
+  // A life-like rule in three dimensions on the 26 cells around a cell, in Carter Bays' notation: 4555 is
+  // survival with 4 to 5 live neighbours and birth with 5 to 5. Counts over 9 are written with slashes,
+  // e.g. 4/5/5/5.
+  //
+  struct VolumeRule {
+    Range survival;
+    Range birth;
+
+    static constexpr size_t k_neighbours = 26;
+
+    static const VolumeRule bays_4555() {
+      return { { 4, 5 }, { 5, 5 } };
+    }
+
+    const bool operator==( const VolumeRule& other ) const {
+      return survival == other.survival && birth == other.birth;
+    }
+
+    const bool next( const bool alive, const size_t live_neighbors ) const {
+      return alive ? survival.contains( live_neighbors ) : birth.contains( live_neighbors );
+    }
+
+    const std::string to_string() const;
+  };
+
+  // Parses Bays' notation, returns false if the text isn't a rule or a count is over 26.
+  bool parse_volume_rule( const std::string_view& text, VolumeRule& out );
+
+  // Well known rules in three dimensions, 4555 first.
+  const std::vector< NamedRule >& named_volume_rules();
+
+  //
+  // The cell store of three dimensional automata.
+  //
+  // Cells are one bit each, packed into words along x: a row of cells at ( y, z ) is row_words() words and
+  // the rows follow each other by y, then by z. Bits past the bounds in the last word of a row are always
+  // zero. There is no border, everything outside of the bounds is dead.
+  //
+  class Volume {
+  private:
+    Vec3< size_t > m_bounds;
+    size_t m_row_words;
+
+    // Number of words in each buffer.
+    size_t m_words;
+
+    std::unique_ptr< uint64_t[] > m_words_current;
+    std::unique_ptr< uint64_t[] > m_words_next;
+
+    app::MemoryAccount m_memory;
+
+  public:
+    Volume();
+
+    static const size_t row_words( const size_t width ) {
+      return ( width + 63 ) / 64;
+    }
+
+    // Bytes the cell buffers of a volume of the given bounds take up.
+    static const size_t bytes_required( const Vec3< size_t >& bounds ) {
+      return 2 * row_words( bounds.x ) * bounds.y * bounds.z * sizeof( uint64_t );
+    }
+
+    void reset();
+
+    // Allocates the buffers for the bounds, every cell is dead afterwards.
+    void init( const Vec3< size_t >& bounds );
+
+    void clear();
+
+    // Fills the volume with random cells, the same seed always produces the same volume.
+    void randomise( app::ThreadPool& pool, const uint64_t seed, const double density );
+
+    // Writes a batch of spans into both generations of the slice at depth z, see Universe::apply.
+    const Region apply( const std::vector< Span >& spans, const size_t z );
+
+    // Makes the next generation the current one.
+    void swap();
+
+  public:
+    const Vec3< size_t >& bounds() const {
+      return m_bounds;
+    }
+
+    const size_t row_words() const {
+      return m_row_words;
+    }
+
+    // Bits of the last word of a row that are within the bounds.
+    const uint64_t last_word_mask() const {
+      const size_t used = m_bounds.x % 64;
+      return used == 0 ? UINT64_MAX : ( ( uint64_t ) 1 << used ) - 1;
+    }
+
+    const uint64_t* row( const size_t y, const size_t z ) const {
+      return m_words_current.get() + ( z * m_bounds.y + y ) * m_row_words;
+    }
+
+    uint64_t* next_row( const size_t y, const size_t z ) {
+      return m_words_next.get() + ( z * m_bounds.y + y ) * m_row_words;
+    }
+
+    // Dead for cells outside of the bounds, coordinates are 0 based.
+    const bool get( const ptrdiff_t x, const ptrdiff_t y, const ptrdiff_t z ) const;
+
+    // Sets a cell in both generations.
+    void set( const size_t x, const size_t y, const size_t z, const bool alive );
+
+    // Number of live cells in the current generation.
+    const size_t population() const;
+  };
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <types.hpp>
+
+namespace app {
+  class ThreadPool;
+}
+
+namespace game {
+
+  class Universe;
+
+  enum class WorkloadKind {
+    // A pattern placed in the centre of the universe.
+    Pattern,
+
+    // Random cells of a given density.
+    Soup,
+
+    // Every cell of the universe covered by still lifes that never change.
+    StillLifeField
+  };
+
+  struct Checkpoint {
+    size_t generation;
+    size_t population;
+  };
+
+  //
+  // A reproducible starting universe for benchmarks and checks.
+  //
+  // Workloads are referred to by their id, so an id must never be reused for a different workload or
+  // results stop being comparable across releases. Add a new workload instead.
+  //
+  struct Workload {
+    const char* id;
+    const char* description;
+    WorkloadKind kind;
+
+    // Run length encoded pattern, used by WorkloadKind::Pattern.
+    const char* rle;
+
+    // Used by WorkloadKind::Soup.
+    double density;
+    uint64_t seed;
+
+    Vec2< size_t > size;
+
+    // Population the reference engine reaches at fixed generations, only holds at the default size.
+    std::array< Checkpoint, 3 > checkpoints;
+  };
+
+  const std::vector< Workload >& workloads();
+
+  // Returns nullptr if there is no such workload.
+  const Workload* find_workload( const std::string_view& id );
+
+  // Initialises the universe with the workload at its default size, returns false if its pattern is malformed.
+  bool load_workload( const Workload& workload, Universe& universe, app::ThreadPool& pool );
+
+  // Same as above at another size, the checkpoints of the workload don't apply then.
+  bool load_workload( const Workload& workload, const Vec2< size_t >& size, Universe& universe, app::ThreadPool& pool );
+
+}
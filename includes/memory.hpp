@@ -0,0 +1,114 @@
+#pragma once
+
+#include <singleton.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace app {
+
+  // Subsystems that own large allocations.
+  enum class MemoryCategory {
+    Cells,
+    Pixels,
+    Textures,
+    Rules,
+    Count
+  };
+
+  constexpr size_t k_memory_category_count = ( size_t ) MemoryCategory::Count;
+
+  //
+  // Running totals of the large allocations of every subsystem, e.g. the cell buffers of a universe.
+  // Small allocations aren't worth tracking, the point is to see what a grid of a given size costs.
+  //
+  class MemoryTracker : public Singleton< MemoryTracker > {
+  private:
+    std::array< std::atomic< int64_t >, k_memory_category_count > m_bytes;
+
+  public:
+    MemoryTracker();
+
+    static const char* name( const MemoryCategory category );
+
+    // Physical memory that can be allocated without paging, zero if it can't be queried.
+    static const uint64_t available_physical();
+
+    static const uint64_t total_physical();
+
+  public:
+    void add( const MemoryCategory category, const int64_t bytes ) {
+      m_bytes[ ( size_t ) category ].fetch_add( bytes, std::memory_order_relaxed );
+    }
+
+    const uint64_t bytes( const MemoryCategory category ) const {
+      return ( uint64_t ) m_bytes[ ( size_t ) category ].load( std::memory_order_relaxed );
+    }
+
+    const uint64_t total() const;
+  };
+
+  //
+  // The bytes of one allocation as seen by the tracker, kept alongside the allocation itself.
+  // Moving an account moves its bytes, destroying it gives them back.
+  //
+  class MemoryAccount {
+  private:
+    MemoryCategory m_category;
+    size_t m_bytes;
+
+  public:
+    MemoryAccount( const MemoryCategory category ) :
+      m_category( category ),
+      m_bytes{}
+    {
+    }
+
+    MemoryAccount( MemoryAccount&& other ) noexcept :
+      m_category( other.m_category ),
+      m_bytes( other.m_bytes )
+    {
+      other.m_bytes = 0;
+    }
+
+    MemoryAccount& operator=( MemoryAccount&& other ) noexcept {
+      if( this != &other ) {
+        set( 0 );
+        m_category = other.m_category;
+        m_bytes = other.m_bytes;
+        other.m_bytes = 0;
+      }
+
+      return *this;
+    }
+
+    ~MemoryAccount() {
+      set( 0 );
+    }
+
+    MemoryAccount( const MemoryAccount& ) = delete;
+    MemoryAccount& operator=( const MemoryAccount& ) = delete;
+
+    // Changes the size of the allocation.
+    void set( const size_t bytes ) {
+      if( bytes != m_bytes ) {
+        MemoryTracker::get()->add( m_category, ( int64_t ) bytes - ( int64_t ) m_bytes );
+        m_bytes = bytes;
+      }
+    }
+
+    const size_t bytes() const {
+      return m_bytes;
+    }
+  };
+
+  // Whether allocations totalling the given bytes, replacing everything tracked so far, fit into physical memory
+  // with some headroom left, i.e. won't page. Always true if the available memory can't be queried.
+  const bool fits_in_memory( const uint64_t required );
+
+  // Formats a number of bytes with a binary unit, e.g. "1.50 GiB".
+  std::string format_bytes( const uint64_t bytes );
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace app {
+
+  enum class HardwareCounter {
+    Cycles,
+    Instructions,
+    L1DMisses,
+    LLCMisses,
+    DTLBMisses,
+    BranchMisses,
+    Count
+  };
+
+  constexpr size_t k_hardware_counter_count = ( size_t ) HardwareCounter::Count;
+
+  struct CounterSample {
+    std::array< uint64_t, k_hardware_counter_count > values;
+
+    // Whether a counter could be opened and was actually scheduled while counting.
+    std::array< bool, k_hardware_counter_count > valid;
+
+    const uint64_t operator[]( const HardwareCounter counter ) const {
+      return values[ ( size_t ) counter ];
+    }
+
+    const bool has( const HardwareCounter counter ) const {
+      return valid[ ( size_t ) counter ];
+    }
+  };
+
+  //
+  // Hardware performance counters of the calling thread and of every thread it creates afterwards,
+  // so the thread pool has to be created after the counters for its workers to be included.
+  //
+  // Counters are read through perf_event_open on Linux. Elsewhere, or when the kernel refuses
+  // (perf_event_paranoid, virtual machines without a PMU), the counters are simply unavailable.
+  // When the PMU is shared the counts are scaled up by the fraction of time they were scheduled.
+  //
+  class PerfCounters {
+  private:
+    std::array< int, k_hardware_counter_count > m_fds;
+
+  public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters( const PerfCounters& ) = delete;
+    PerfCounters& operator=( const PerfCounters& ) = delete;
+
+    static const char* name( const HardwareCounter counter );
+
+  public:
+    // Whether at least one counter is available.
+    const bool available() const;
+
+    const bool available( const HardwareCounter counter ) const {
+      return m_fds[ ( size_t ) counter ] >= 0;
+    }
+
+    // Resets and starts every available counter.
+    void start();
+
+    // Stops the counters and returns what they counted since start.
+    const CounterSample stop();
+  };
+
+}
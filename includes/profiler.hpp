@@ -0,0 +1,125 @@
+#pragma once
+
+#include <singleton.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace app {
+
+  // Parts of a frame that are timed individually.
+  enum class Phase {
+    Update,
+    PixelBuffer,
+    TextureMap,
+    TextureCopy,
+    ImGui,
+    Present,
+    Count
+  };
+
+  constexpr size_t k_phase_count = ( size_t ) Phase::Count;
+
+  struct PhaseStatistics {
+    float last;
+    float p50;
+    float p95;
+    float p99;
+    float max;
+  };
+
+  //
+  // Collects how long each phase of a frame took over the last k_history frames.
+  //
+  // Timings are accumulated per frame (a phase may run several times, e.g. physics updates) and
+  // committed into a ring buffer per phase by end_frame. Nothing in here takes a lock, scopes may be
+  // timed from any thread while the history is being read.
+  //
+  class Profiler : public Singleton< Profiler > {
+  public:
+    static constexpr size_t k_history = 256;
+
+  private:
+    inline static std::atomic< bool > s_enabled{ false };
+
+    // Nanoseconds spent in every phase during the current frame.
+    std::array< std::atomic< int64_t >, k_phase_count > m_accumulators;
+
+    // Milliseconds spent in every phase, indexed by frame modulo k_history.
+    std::array< std::array< std::atomic< float >, k_history >, k_phase_count > m_history;
+
+    // Number of frames committed so far.
+    std::atomic< size_t > m_frames;
+
+  public:
+    Profiler();
+
+    static const bool enabled() {
+      return s_enabled.load( std::memory_order_relaxed );
+    }
+
+    static void set_enabled( const bool enabled ) {
+      s_enabled.store( enabled, std::memory_order_relaxed );
+    }
+
+    static const char* name( const Phase phase );
+
+  public:
+    void add( const Phase phase, const int64_t nanoseconds ) {
+      m_accumulators[ ( size_t ) phase ].fetch_add( nanoseconds, std::memory_order_relaxed );
+    }
+
+    // Commits the timings of the current frame, called once at the end of every frame.
+    void end_frame();
+
+    // Forgets all history.
+    void clear();
+
+    // Number of frames that are available in the history.
+    const size_t samples() const;
+
+    // Copies the history of a phase in milliseconds, oldest frame first.
+    void history( const Phase phase, std::vector< float >& out ) const;
+
+    const PhaseStatistics statistics( const Phase phase ) const;
+
+    // Writes the history of every phase as one row per frame, returns false if the file couldn't be written.
+    bool dump_csv( const std::string_view& path ) const;
+  };
+
+  //
+  // Times the enclosing scope and attributes it to a phase.
+  // When the profiler is disabled this costs a relaxed load and a branch.
+  //
+  class ProfileScope {
+  private:
+    Phase m_phase;
+    bool m_active;
+    std::chrono::steady_clock::time_point m_start;
+
+  public:
+    ProfileScope( const Phase phase ) :
+      m_phase( phase ),
+      m_active( Profiler::enabled() )
+    {
+      if( m_active ) {
+        m_start = std::chrono::steady_clock::now();
+      }
+    }
+
+    ~ProfileScope() {
+      if( m_active ) {
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        Profiler::get()->add( m_phase, std::chrono::duration_cast< std::chrono::nanoseconds >( elapsed ).count() );
+      }
+    }
+
+    ProfileScope( const ProfileScope& ) = delete;
+    ProfileScope& operator=( const ProfileScope& ) = delete;
+  };
+
+}
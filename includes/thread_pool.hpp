@@ -0,0 +1,81 @@
+#pragma once
+
+#include <singleton.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace app {
+
+  //
+  // A fixed set of worker threads that cooperatively chew through a range of work.
+  //
+  // The calling thread always participates in a dispatch, so a pool of N threads spawns N - 1 workers.
+  // Dispatches are not re-entrant, a routine must not call back into the pool it is running on.
+  //
+  class ThreadPool : public Singleton< ThreadPool > {
+  public:
+    //
+    // Invoked with a half open range of the dispatched work.
+    //
+    //    begin: first index (inclusive)
+    //    end: last index (exclusive)
+    //
+    using range_routine_t = std::function< void( const size_t begin, const size_t end ) >;
+
+  private:
+    std::vector< std::thread > m_workers;
+
+    // Serializes dispatches from different threads.
+    std::mutex m_dispatch_mutex;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    // State of the current dispatch.
+    const range_routine_t* m_routine;
+    size_t m_count;
+    size_t m_grain;
+    std::atomic< size_t > m_next;
+
+    // Number of workers that have not yet finished the current dispatch.
+    size_t m_pending;
+
+    // Bumped for every dispatch so that sleeping workers know there is new work.
+    size_t m_generation;
+
+    bool m_stopping;
+
+  private:
+    void worker();
+
+    void run();
+
+  public:
+    ThreadPool();
+    ThreadPool( const size_t threads );
+    ~ThreadPool();
+
+    ThreadPool( const ThreadPool& ) = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+
+  public:
+    // Total number of threads that take part in a dispatch, including the caller.
+    const size_t threads() const {
+      return m_workers.size() + 1;
+    }
+
+    //
+    // Splits [ 0, count ) into chunks of grain indices and blocks until all of them have been processed.
+    // A grain of zero picks a chunk size that gives every thread a few chunks to balance the load.
+    //
+    void parallel_for( const size_t count, const range_routine_t& routine, const size_t grain = 0 );
+  };
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <types.hpp>
+
+//
+// Benchmark results saved to disk so that a later build can be compared against them.
+//
+namespace tools {
+
+  // Both of these sort their argument.
+  double median( std::vector< double >& values );
+  double median_absolute_deviation( std::vector< double >& values );
+
+  struct BaselineEntry {
+    std::string engine;
+    std::string workload;
+    Vec2< size_t > size;
+    size_t threads;
+
+    // Over every repetition, in millions of cell updates per second.
+    double median;
+    double mad;
+    size_t repetitions;
+
+    // Peak of the tracked memory.
+    uint64_t memory;
+
+    // Identifies the configuration, entries of two runs with the same key are compared.
+    const std::string key() const;
+  };
+
+  struct Thresholds {
+    // Largest drop in median throughput that passes, in percent.
+    double slowdown = 5.0;
+
+    // Largest growth in memory that passes, in percent.
+    double memory_growth = 0.0;
+
+    // A drop also has to be larger than this many (scaled) MADs of both runs, so noisy configurations
+    // don't fail on their own jitter.
+    double noise = 3.0;
+  };
+
+  // The baseline is JSON of the form { "version": 1, "results": [ { "engine": "banded", ... }, ... ] }.
+  bool save_baseline( const std::string_view& path, const std::vector< BaselineEntry >& entries );
+
+  // Returns false if the file can't be read or isn't a baseline.
+  bool load_baseline( const std::string_view& path, std::vector< BaselineEntry >& entries );
+
+  //
+  // Prints a table of every entry of the current run next to its baseline, returns false if any of
+  // them regressed. Entries without a baseline are listed but never fail.
+  //
+  bool compare_baseline( const std::vector< BaselineEntry >& baseline, const std::vector< BaselineEntry >& current, const Thresholds& thresholds );
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <types.hpp>
+
+//
+// Command line parsing shared by the headless tools.
+//
+namespace tools {
+
+  template< typename T >
+  bool parse_number( const std::string_view& text, T& out ) {
+    const auto result = std::from_chars( text.data(), text.data() + text.size(), out );
+    return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+  }
+
+  // Parses a grid size of the form WxH.
+  inline bool parse_size( const std::string_view& text, Vec2< size_t >& out ) {
+    const size_t separator = text.find( 'x' );
+    if( separator == std::string_view::npos ) {
+      return false;
+    }
+
+    return parse_number( text.substr( 0, separator ), out.x ) && parse_number( text.substr( separator + 1 ), out.y ) &&
+      out.x != 0 && out.y != 0;
+  }
+
+  // Parses a volume size of the form WxHxD.
+  inline bool parse_size( const std::string_view& text, Vec3< size_t >& out ) {
+    const size_t separator = text.rfind( 'x' );
+    if( separator == std::string_view::npos ) {
+      return false;
+    }
+
+    Vec2< size_t > plane{};
+    if( !parse_size( text.substr( 0, separator ), plane ) || !parse_number( text.substr( separator + 1 ), out.z ) || out.z == 0 ) {
+      return false;
+    }
+
+    out.x = plane.x;
+    out.y = plane.y;
+    return true;
+  }
+
+  // Splits a comma separated list.
+  inline std::vector< std::string_view > split( const std::string_view& text ) {
+    std::vector< std::string_view > parts;
+
+    size_t begin{};
+    while( begin <= text.size() ) {
+      const size_t end = std::min( text.find( ',', begin ), text.size() );
+      if( end > begin ) {
+        parts.push_back( text.substr( begin, end - begin ) );
+      }
+
+      begin = end + 1;
+    }
+
+    return parts;
+  }
+
+  //
+  // Walks the arguments of main as --name value pairs.
+  //
+  //    while( arguments.next() ) {
+  //      if( arguments.is( "--size" ) ) ...
+  //    }
+  //
+  class Arguments {
+  private:
+    int m_count;
+    char** m_values;
+    int m_index;
+
+    // Option the arguments are at, stays put while its value is consumed.
+    std::string_view m_name;
+
+  public:
+    Arguments( const int argc, char** argv ) :
+      m_count( argc ),
+      m_values( argv ),
+      m_index( 0 )
+    {
+    }
+
+    bool next() {
+      if( ++m_index >= m_count ) {
+        return false;
+      }
+
+      m_name = m_values[ m_index ];
+      return true;
+    }
+
+    const std::string_view& name() const {
+      return m_name;
+    }
+
+    const bool is( const std::string_view& name ) const {
+      return this->name() == name;
+    }
+
+    // Consumes the value of the current option, returns false if there is none.
+    bool value( std::string_view& out ) {
+      if( m_index + 1 >= m_count ) {
+        return false;
+      }
+
+      out = m_values[ ++m_index ];
+      return true;
+    }
+  };
+
+}
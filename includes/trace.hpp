@@ -0,0 +1,144 @@
+#pragma once
+
+#include <singleton.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace app {
+
+  //
+  // Records timestamped zones and counters from every thread and writes them out in the Chrome trace-event
+  // JSON format, which can be opened in https://ui.perfetto.dev or chrome://tracing.
+  //
+  // Every thread appends to its own fixed size buffer, so recording never takes a lock. Events that don't fit
+  // into a buffer are dropped and counted. Buffers are only read while recording is stopped, so start and
+  // stop are meant to be called between frames when no work is in flight on the thread pool.
+  //
+  class Tracer : public Singleton< Tracer > {
+  public:
+    static constexpr size_t k_events_per_thread = 1 << 16;
+
+  private:
+    struct Event {
+      const char* name;
+      int64_t start;
+
+      // Duration of a zone in nanoseconds, unused by counters.
+      int64_t duration;
+
+      // Value of a counter, unused by zones.
+      double value;
+    };
+
+    struct ThreadBuffer {
+      uint32_t id;
+      std::string name;
+      std::unique_ptr< Event[] > events;
+      std::atomic< size_t > count;
+      std::atomic< size_t > dropped;
+    };
+
+    inline static std::atomic< bool > s_recording{ false };
+
+    // Buffer of the calling thread, registered on first use.
+    inline static thread_local ThreadBuffer* t_buffer{};
+
+    // Guards the list of buffers, taken once per thread and when flushing.
+    std::mutex m_mutex;
+    std::vector< std::unique_ptr< ThreadBuffer > > m_buffers;
+
+    // Frames left until the recording stops by itself, zero if it runs until stopped.
+    size_t m_frames_left;
+
+    int64_t m_started;
+
+    std::string m_path;
+    std::string m_status;
+
+  private:
+    ThreadBuffer* buffer();
+
+    void push( const Event& event );
+
+  public:
+    Tracer();
+
+    static const bool recording() {
+      return s_recording.load( std::memory_order_relaxed );
+    }
+
+    // Nanoseconds on the steady clock.
+    static int64_t now() {
+      return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+  public:
+    // Names the calling thread in the trace.
+    void set_thread_name( const std::string_view& name );
+
+    //
+    // Starts a new recording, throwing away the previous one.
+    //
+    //    path: file the trace is written to when the recording stops
+    //    frames: number of frames after which the recording stops by itself, zero to record until stopped
+    //
+    void start( const std::string_view& path, const size_t frames = 0 );
+
+    // Stops the recording and writes it out.
+    void stop();
+
+    // Called once at the end of every frame.
+    void end_frame();
+
+    void zone( const char* name, const int64_t start, const int64_t end ) {
+      push( { name, start, end - start, 0.0 } );
+    }
+
+    void counter( const char* name, const double value ) {
+      push( { name, now(), -1, value } );
+    }
+
+    // Outcome of the last recording, e.g. where it was written to.
+    const std::string& status() const {
+      return m_status;
+    }
+  };
+
+  //
+  // Records the enclosing scope as a zone, the name must outlive the recording (i.e. a string literal).
+  //
+  class TraceZone {
+  private:
+    const char* m_name;
+    bool m_active;
+    int64_t m_start;
+
+  public:
+    TraceZone( const char* name ) :
+      m_name( name ),
+      m_active( Tracer::recording() ),
+      m_start{}
+    {
+      if( m_active ) {
+        m_start = Tracer::now();
+      }
+    }
+
+    ~TraceZone() {
+      if( m_active ) {
+        Tracer::get()->zone( m_name, m_start, Tracer::now() );
+      }
+    }
+
+    TraceZone( const TraceZone& ) = delete;
+    TraceZone& operator=( const TraceZone& ) = delete;
+  };
+
+}
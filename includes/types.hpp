@@ -16,6 +16,17 @@ struct Vec2 {
   }
 };
 
+template< typename T >
+struct Vec3 {
+  T x;
+  T y;
+  T z;
+
+  const bool operator==( const Vec3< T >& other ) const {
+    return x == other.x && y == other.y && z == other.z;
+  }
+};
+
 using Vec2i = Vec2< int >;
 using Vec2f = Vec2< float >;
 
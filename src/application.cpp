@@ -1,5 +1,7 @@
 #include <application.hpp>
 
+#include <trace.hpp>
+
 #define NOMINMAX
 #include <windows.h>
 
@@ -52,10 +54,14 @@ void app::Application::exec( render_routine_t render_routine, physics_routine_t
     
     current_time = new_time;
 
+    app::TraceZone frame_zone( "Frame" );
+
     //
     // Physics update
     //
     {
+      app::TraceZone zone( "Physics" );
+
       accumulator += m_delta_time;
 
       // Allow the interval to be scaled by a factor - this way we can better debug physics updates and such.
@@ -79,11 +85,18 @@ void app::Application::exec( render_routine_t render_routine, physics_routine_t
     //
     // Render update
     //
-    render_routine( *this, m_delta_time );
+    {
+      app::TraceZone zone( "Render" );
+      render_routine( *this, m_delta_time );
+    }
 
     // Update frame metrics.
     m_frame_count++;
     m_frame_measure = ( m_frame_measure * 0.9F ) + ( m_delta_time * ( 1.F - 0.9F ) );
+
+    if( app::Tracer::recording() ) {
+      app::Tracer::get()->counter( "Frame time (ms)", m_delta_time * 1e3 );
+    }
   }
 }
 
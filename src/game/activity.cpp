@@ -0,0 +1,196 @@
+#include <game/activity.hpp>
+
+#include <game/bits.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+  // Generations a bucket spans unless the window is set.
+  constexpr size_t k_default_bucket_length = 8;
+
+  //
+  // Cells of the span of a tile whose state differs, eight at a time. The bytes of the differences are added up in
+  // the lanes of a word, no more than eight in each for a tile, and the lanes are added up by a single multiply.
+  //
+  size_t changed_cells( const uint8_t* before, const uint8_t* after, const size_t count ) {
+    uint64_t lanes{};
+    size_t offset{};
+
+    for( ; offset + 8 <= count; offset += 8 ) {
+      uint64_t a;
+      uint64_t b;
+      std::memcpy( &a, before + offset, 8 );
+      std::memcpy( &b, after + offset, 8 );
+
+      lanes += game::occupied( a ^ b );
+    }
+
+    if( offset < count ) {
+      uint64_t a{};
+      uint64_t b{};
+      std::memcpy( &a, before + offset, count - offset );
+      std::memcpy( &b, after + offset, count - offset );
+
+      lanes += game::occupied( a ^ b );
+    }
+
+    return ( size_t ) ( ( lanes * game::k_low_bits ) >> 56 );
+  }
+
+}
+
+game::Activity::Activity() :
+  m_bounds{},
+  m_tiles{},
+  m_bucket_length( k_default_bucket_length ),
+  m_bucket{},
+  m_filled{},
+  m_memory( app::MemoryCategory::Cells )
+{
+}
+
+const size_t game::Activity::bytes_required( const Vec2< size_t >& bounds ) {
+  const size_t columns = ( bounds.x + k_tile_size - 1 ) / k_tile_size;
+  const size_t tiles = columns * ( ( bounds.y + k_tile_size - 1 ) / k_tile_size );
+
+  return columns * bounds.y + ( k_buckets + 1 ) * tiles * sizeof( uint32_t );
+}
+
+void game::Activity::init( const Vec2< size_t >& bounds ) {
+  m_bounds = bounds;
+  m_tiles = { ( bounds.x + k_tile_size - 1 ) / k_tile_size, ( bounds.y + k_tile_size - 1 ) / k_tile_size };
+
+  const size_t tiles = m_tiles.x * m_tiles.y;
+
+  m_rows.assign( m_tiles.x * bounds.y, 0 );
+  m_buckets.assign( k_buckets * tiles, 0 );
+  m_totals.assign( tiles, 0 );
+  m_memory.set( bytes_required( bounds ) );
+
+  m_bucket = 0;
+  m_filled = 0;
+}
+
+void game::Activity::clear() {
+  std::fill( m_buckets.begin(), m_buckets.end(), 0 );
+  std::fill( m_totals.begin(), m_totals.end(), 0 );
+
+  m_bucket = 0;
+  m_filled = 0;
+}
+
+void game::Activity::set_window( const size_t generations ) {
+  m_bucket_length = std::max< size_t >( 1, ( generations + k_buckets - 1 ) / k_buckets );
+  clear();
+}
+
+void game::Activity::count_row( const size_t row, const uint8_t* before, const uint8_t* after ) {
+  uint8_t* counts = m_rows.data() + row * m_tiles.x;
+
+  for( size_t tile{}; tile < m_tiles.x; ++tile ) {
+    const size_t first = tile * k_tile_size;
+    counts[ tile ] = ( uint8_t ) changed_cells( before + first, after + first, std::min( k_tile_size, m_bounds.x - first ) );
+  }
+}
+
+void game::Activity::advance( const Universe& universe, app::ThreadPool& pool, const bool counted ) {
+  app::TraceZone zone( "Activity::advance" );
+
+  bool compare = !counted;
+
+  if( !( universe.bounds() == m_bounds ) ) {
+    init( universe.bounds() );
+    compare = true;
+  }
+
+  const size_t stride = universe.stride();
+
+  // The generation before the one that was just stepped to is still in the other buffer.
+  if( compare ) {
+    pool.parallel_for( m_bounds.y, [ & ]( const size_t begin, const size_t end ) {
+      for( size_t row{ begin }; row < end; ++row ) {
+        const size_t offset = ( row + 1 ) * stride + 1;
+        count_row( row, universe.next() + offset, universe.current() + offset );
+      }
+    } );
+  }
+
+  uint32_t* bucket = m_buckets.data() + m_bucket * m_tiles.x * m_tiles.y;
+
+  // A tile row at a time, so that every tile is added to by one thread.
+  pool.parallel_for( m_tiles.y, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t y{ begin }; y < end; ++y ) {
+      uint32_t* totals = m_totals.data() + y * m_tiles.x;
+      uint32_t* counts = bucket + y * m_tiles.x;
+
+      const size_t last = std::min( ( y + 1 ) * k_tile_size, m_bounds.y );
+
+      for( size_t row{ y * k_tile_size }; row < last; ++row ) {
+        const uint8_t* changes = m_rows.data() + row * m_tiles.x;
+
+        for( size_t x{}; x < m_tiles.x; ++x ) {
+          counts[ x ] += changes[ x ];
+          totals[ x ] += changes[ x ];
+        }
+      }
+    }
+  } );
+
+  if( ++m_filled < m_bucket_length ) {
+    return;
+  }
+
+  // The oldest bucket leaves the window and is filled again from now on.
+  m_filled = 0;
+  m_bucket = ( m_bucket + 1 ) % k_buckets;
+
+  uint32_t* oldest = m_buckets.data() + m_bucket * m_tiles.x * m_tiles.y;
+
+  for( size_t tile{}; tile < m_totals.size(); ++tile ) {
+    m_totals[ tile ] -= oldest[ tile ];
+    oldest[ tile ] = 0;
+  }
+}
+
+const uint32_t game::Activity::peak() const {
+  return m_totals.empty() ? 0 : *std::max_element( m_totals.begin(), m_totals.end() );
+}
+
+const std::vector< game::ActiveTile > game::Activity::hottest( const size_t count ) const {
+  std::vector< ActiveTile > tiles;
+
+  for( size_t y{}; y < m_tiles.y; ++y ) {
+    for( size_t x{}; x < m_tiles.x; ++x ) {
+      const uint32_t changes = m_totals[ y * m_tiles.x + x ];
+      if( changes != 0 ) {
+        tiles.push_back( { { ( int ) x, ( int ) y }, changes } );
+      }
+    }
+  }
+
+  const size_t kept = std::min( count, tiles.size() );
+
+  // Ties go to the tile that comes first row by row, so the list doesn't jump around.
+  std::partial_sort( tiles.begin(), tiles.begin() + ( ptrdiff_t ) kept, tiles.end(), []( const ActiveTile& a, const ActiveTile& b ) {
+    if( a.changes != b.changes ) {
+      return a.changes > b.changes;
+    }
+
+    return a.tile.y != b.tile.y ? a.tile.y < b.tile.y : a.tile.x < b.tile.x;
+  } );
+
+  tiles.resize( kept );
+  return tiles;
+}
+
+const game::Region game::Activity::region( const Tile& tile ) const {
+  const size_t left = ( size_t ) tile.x * k_tile_size;
+  const size_t top = ( size_t ) tile.y * k_tile_size;
+
+  return { left, top, std::min( left + k_tile_size, m_bounds.x ), std::min( top + k_tile_size, m_bounds.y ) };
+}
@@ -0,0 +1,109 @@
+#include <game/bitplanes.hpp>
+
+#include <game/bits.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+game::BitPlanes::BitPlanes() :
+  m_bounds{},
+  m_digits( 1 ),
+  m_row_words{},
+  m_capacity{},
+  m_current{},
+  m_memory( app::MemoryCategory::Cells ),
+  m_valid( false ),
+  m_current_ahead( false ),
+  m_previous_ahead( false )
+{
+}
+
+void game::BitPlanes::layout( const Vec2< size_t >& bounds, const size_t digits ) {
+  m_bounds = bounds;
+  m_digits = digits;
+  m_row_words = ( bounds.x + 63 ) / 64 + 2;
+  m_current = 0;
+
+  const size_t size = 2 * ( digits + 1 ) * ( bounds.y + 2 ) * m_row_words;
+
+  if( size > m_capacity ) {
+    m_capacity = size;
+    m_words.reset();
+    m_words = std::make_unique< uint64_t[] >( m_capacity );
+    m_memory.set( m_capacity * sizeof( uint64_t ) );
+  }
+  else {
+    std::fill_n( m_words.get(), size, 0 );
+  }
+}
+
+void game::BitPlanes::pack( const uint8_t* cells, const size_t stride, app::ThreadPool& pool ) {
+  app::TraceZone zone( "BitPlanes::pack" );
+
+  const size_t columns = m_bounds.x;
+
+  pool.parallel_for( m_bounds.y, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin + 1 }; row <= end; ++row ) {
+      const uint8_t* states = cells + row * stride + 1;
+
+      for( size_t word{ 1 }; word + 1 < m_row_words; ++word ) {
+        const size_t first = ( word - 1 ) * 64;
+        const size_t count = std::min< size_t >( 64, columns - first );
+
+        uint64_t digits[ 8 ]{};
+
+        for( size_t offset{}; offset < count; offset += 8 ) {
+          uint64_t bytes{};
+          std::memcpy( &bytes, states + first + offset, std::min< size_t >( 8, count - offset ) );
+
+          for( size_t digit{}; digit < m_digits; ++digit ) {
+            digits[ digit ] |= gather( bytes >> digit ) << offset;
+          }
+        }
+
+        // Alive is state 1, every higher digit has to be clear.
+        uint64_t live = digits[ 0 ];
+
+        for( size_t digit{}; digit < m_digits; ++digit ) {
+          m_words[ row_start( m_current, digit, row ) + word ] = digits[ digit ];
+
+          if( digit > 0 ) {
+            live &= ~digits[ digit ];
+          }
+        }
+
+        m_words[ row_start( m_current, m_digits, row ) + word ] = live;
+      }
+    }
+  } );
+}
+
+void game::BitPlanes::unpack( uint8_t* cells, const size_t stride, const bool previous ) const {
+  app::TraceZone zone( "BitPlanes::unpack" );
+
+  const size_t columns = m_bounds.x;
+  const size_t generation = previous ? m_current ^ 1 : m_current;
+
+  for( size_t row{ 1 }; row <= m_bounds.y; ++row ) {
+    uint8_t* states = cells + row * stride + 1;
+
+    for( size_t word{ 1 }; word + 1 < m_row_words; ++word ) {
+      const size_t first = ( word - 1 ) * 64;
+      const size_t count = std::min< size_t >( 64, columns - first );
+
+      // Eight cells at a time.
+      for( size_t offset{}; offset < count; offset += 8 ) {
+        uint64_t bytes{};
+
+        for( size_t digit{}; digit < m_digits; ++digit ) {
+          bytes |= spread( ( m_words[ row_start( generation, digit, row ) + word ] >> offset ) & 0xFF ) << digit;
+        }
+
+        std::memcpy( states + first + offset, &bytes, std::min< size_t >( 8, count - offset ) );
+      }
+    }
+  }
+}
@@ -0,0 +1,212 @@
+#include <game/brush.hpp>
+
+#include <game/pattern.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+game::Brush::Brush() :
+  m_radius{},
+  m_mode{ BrushMode::Paint },
+  m_stamp{},
+  m_stroking{ false },
+  m_has_last{ false },
+  m_last{}
+{
+  set_radius( 0 );
+}
+
+void game::Brush::set_radius( const int radius ) {
+  m_radius = std::max( radius, 0 );
+
+  // Offset the radius by half a cell so small brushes come out round instead of diamond shaped.
+  const float r = ( float ) m_radius + 0.5F;
+
+  m_half_widths.resize( m_radius + 1 );
+  for( int dy{}; dy <= m_radius; ++dy ) {
+    m_half_widths[ dy ] = ( int ) std::sqrt( r * r - ( float ) ( dy * dy ) );
+  }
+}
+
+void game::Brush::begin_stroke() {
+  m_stroking = true;
+  m_has_last = false;
+  m_samples.clear();
+}
+
+void game::Brush::end_stroke() {
+  // Samples that are still pending get rasterised on the next call, they were made while the button was down.
+  m_stroking = false;
+}
+
+void game::Brush::add_sample( const Vec2i& cell ) {
+  if( !m_stroking ) {
+    return;
+  }
+
+  if( !m_samples.empty() && m_samples.back() == cell ) {
+    return;
+  }
+
+  m_samples.push_back( cell );
+}
+
+void game::Brush::rasterise( const Vec2< size_t >& bounds, std::vector< Span >& spans ) {
+  spans.clear();
+
+  if( m_samples.empty() ) {
+    return;
+  }
+
+  if( m_mode == BrushMode::Stamp ) {
+    // Stamps are placed once where the stroke started rather than smeared along it.
+    if( !m_has_last && m_stamp != nullptr ) {
+      rasterise_stamp( m_samples.front(), bounds, spans );
+    }
+  }
+  else {
+    size_t i{};
+    Vec2i from = m_has_last ? m_last : m_samples[ i++ ];
+
+    // A click without movement still paints a dot.
+    if( !m_has_last ) {
+      rasterise_segment( from, from, bounds, spans );
+    }
+
+    for( ; i < m_samples.size(); ++i ) {
+      rasterise_segment( from, m_samples[ i ], bounds, spans );
+      from = m_samples[ i ];
+    }
+
+    // Consecutive segments overlap around their shared end points, merge them so every cell is written once.
+    std::sort( spans.begin(), spans.end(), []( const Span& a, const Span& b ) {
+      return a.row != b.row ? a.row < b.row : a.begin < b.begin;
+    } );
+
+    size_t merged{};
+    for( size_t j{ 1 }; j < spans.size(); ++j ) {
+      Span& last = spans[ merged ];
+      const Span& span = spans[ j ];
+
+      if( span.row == last.row && span.begin <= last.end ) {
+        last.end = std::max( last.end, span.end );
+      }
+      else {
+        spans[ ++merged ] = span;
+      }
+    }
+
+    if( !spans.empty() ) {
+      spans.resize( merged + 1 );
+    }
+  }
+
+  m_has_last = true;
+  m_last = m_samples.back();
+  m_samples.clear();
+}
+
+void game::Brush::rasterise_segment( const Vec2i& from, const Vec2i& to, const Vec2< size_t >& bounds, std::vector< Span >& spans ) {
+  const uint8_t state = m_mode == BrushMode::Erase ? 0 : 1;
+
+  //
+  // The segment swept by a round brush is convex, so it covers a single interval on every row.
+  // Walk the centre line with Bresenham and widen the interval of every row the brush touches.
+  //
+  const int top = std::min( from.y, to.y ) - m_radius;
+  const int bottom = std::max( from.y, to.y ) + m_radius;
+
+  m_intervals.assign( bottom - top + 1, { INT_MAX, INT_MIN } );
+
+  int x = from.x;
+  int y = from.y;
+
+  const int dx = std::abs( to.x - x );
+  const int dy = -std::abs( to.y - y );
+  const int sx = x < to.x ? 1 : -1;
+  const int sy = y < to.y ? 1 : -1;
+
+  int error = dx + dy;
+
+  for( ;; ) {
+    for( int offset{ -m_radius }; offset <= m_radius; ++offset ) {
+      const int half_width = m_half_widths[ std::abs( offset ) ];
+
+      auto& interval = m_intervals[ y + offset - top ];
+      interval.x = std::min( interval.x, x - half_width );
+      interval.y = std::max( interval.y, x + half_width );
+    }
+
+    if( x == to.x && y == to.y ) {
+      break;
+    }
+
+    const int e2 = 2 * error;
+
+    if( e2 >= dy ) {
+      error += dy;
+      x += sx;
+    }
+
+    if( e2 <= dx ) {
+      error += dx;
+      y += sy;
+    }
+  }
+
+  for( size_t i{}; i < m_intervals.size(); ++i ) {
+    const int row = top + ( int ) i;
+    if( row < 0 || row >= ( int ) bounds.y ) {
+      continue;
+    }
+
+    const auto& interval = m_intervals[ i ];
+
+    const int begin = std::max( interval.x, 0 );
+    const int end = std::min( interval.y + 1, ( int ) bounds.x );
+
+    if( begin >= end ) {
+      continue;
+    }
+
+    spans.push_back( { ( size_t ) row, ( size_t ) begin, ( size_t ) end, state } );
+  }
+}
+
+void game::Brush::rasterise_stamp( const Vec2i& centre, const Vec2< size_t >& bounds, std::vector< Span >& spans ) {
+  const auto& size = m_stamp->bounds();
+
+  const int left = centre.x - ( int ) size.x / 2;
+  const int top = centre.y - ( int ) size.y / 2;
+
+  // Only live cells are written, so stamps can be layered on top of an existing pattern.
+  for( size_t y{}; y < size.y; ++y ) {
+    const int row = top + ( int ) y;
+    if( row < 0 || row >= ( int ) bounds.y ) {
+      continue;
+    }
+
+    size_t x{};
+    while( x < size.x ) {
+      const uint8_t state = m_stamp->get( x, y );
+      if( state == 0 ) {
+        ++x;
+        continue;
+      }
+
+      const size_t begin = x;
+      while( x < size.x && m_stamp->get( x, y ) == state ) {
+        ++x;
+      }
+
+      const int first = std::max( left + ( int ) begin, 0 );
+      const int last = std::min( left + ( int ) x, ( int ) bounds.x );
+
+      if( first < last ) {
+        spans.push_back( { ( size_t ) row, ( size_t ) first, ( size_t ) last, state } );
+      }
+    }
+  }
+}
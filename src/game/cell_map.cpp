@@ -0,0 +1,160 @@
+#include <game/cell_map.hpp>
+
+#include <trace.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+game::CellMap::CellMap() :
+  m_topology( Topology::Square ),
+  m_bounds{},
+  m_pixel_bounds{},
+  m_memory( app::MemoryCategory::Pixels )
+{
+}
+
+const Vec2< size_t > game::CellMap::pixel_bounds( const Vec2< size_t >& bounds, const Topology topology ) {
+  switch( topology ) {
+    case Topology::Hexagonal:
+      // Shifted rows stick out by half a hexagon on the right.
+      return { bounds.x * k_hexagon_width + k_hexagon_width / 2, bounds.y * k_hexagon_height };
+
+    case Topology::Triangular:
+      return { ( bounds.x + 1 ) * k_triangle_width / 2, bounds.y * k_triangle_height };
+
+    default:
+      return bounds;
+  }
+}
+
+void game::CellMap::build( const Vec2< size_t >& bounds, const Topology topology ) {
+  app::TraceZone zone( "CellMap::build" );
+
+  m_topology = topology;
+  m_bounds = bounds;
+  m_pixel_bounds = pixel_bounds( bounds, topology );
+
+  if( topology == Topology::Square ) {
+    m_cells.clear();
+    m_cells.shrink_to_fit();
+    m_memory.set( 0 );
+    return;
+  }
+
+  m_cells.resize( m_pixel_bounds.x * m_pixel_bounds.y );
+  m_memory.set( m_cells.size() * sizeof( uint32_t ) );
+
+  const size_t stride = bounds.x + 2;
+
+  // Index of a cell in 0 based grid coordinates, cells beyond the grid end up in the border.
+  const auto index = [ & ]( const ptrdiff_t row, const ptrdiff_t column ) -> uint32_t {
+    const size_t y = ( size_t ) std::clamp< ptrdiff_t >( row + 1, 0, ( ptrdiff_t ) bounds.y + 1 );
+    const size_t x = ( size_t ) std::clamp< ptrdiff_t >( column + 1, 0, ( ptrdiff_t ) bounds.x + 1 );
+    return ( uint32_t ) ( y * stride + x );
+  };
+
+  const double width = ( double ) k_hexagon_width;
+  const double height = ( double ) ( topology == Topology::Hexagonal ? k_hexagon_height : k_triangle_height );
+  const double half = ( double ) k_triangle_width / 2.0;
+
+  // The rows of regular hexagons are squeezed to the row height, distances are taken before the squeeze.
+  const double squeeze = width * std::sqrt( 3.0 ) / 2.0 / height;
+
+  for( size_t y{}; y < m_pixel_bounds.y; ++y ) {
+    const double py = ( double ) y + 0.5;
+    const ptrdiff_t band = ( ptrdiff_t ) std::floor( py / height );
+
+    for( size_t x{}; x < m_pixel_bounds.x; ++x ) {
+      const double px = ( double ) x + 0.5;
+
+      ptrdiff_t best_row{};
+      ptrdiff_t best_column{};
+
+      if( topology == Topology::Hexagonal ) {
+        // The nearest centre, which is on the row of the pixel or one next to it.
+        double nearest = std::numeric_limits< double >::max();
+
+        for( ptrdiff_t row{ band - 1 }; row <= band + 1; ++row ) {
+          const double shift = ( row & 1 ) != 0 ? 0.5 : 0.0;
+          const ptrdiff_t column = ( ptrdiff_t ) std::floor( px / width - shift );
+
+          const double dx = px - ( ( double ) column + 0.5 + shift ) * width;
+          const double dy = ( py - ( ( double ) row + 0.5 ) * height ) * squeeze;
+
+          if( dx * dx + dy * dy < nearest ) {
+            nearest = dx * dx + dy * dy;
+            best_row = row;
+            best_column = column;
+          }
+        }
+      }
+      else {
+        // One of the two triangles that overlap the pixel's half of a base, the one it is further inside of.
+        const double fy = ( py - ( double ) band * height ) / height;
+        const ptrdiff_t slot = ( ptrdiff_t ) std::floor( px / half );
+
+        double inside = std::numeric_limits< double >::lowest();
+
+        for( ptrdiff_t column{ slot - 1 }; column <= slot; ++column ) {
+          const bool up = ( ( band + column ) & 1 ) == 0;
+          const double reach = ( up ? fy : 1.0 - fy ) * half;
+          const double margin = reach - std::abs( px - ( ( double ) column + 1.0 ) * half );
+
+          if( margin > inside ) {
+            inside = margin;
+            best_row = band;
+            best_column = column;
+          }
+        }
+      }
+
+      m_cells[ y * m_pixel_bounds.x + x ] = index( best_row, best_column );
+    }
+  }
+}
+
+const game::Region game::CellMap::pixels( const Region& cells ) const {
+  if( cells.empty() || m_topology == Topology::Square ) {
+    return cells;
+  }
+
+  if( m_topology == Topology::Hexagonal ) {
+    // The points of a hexagon reach into the rows above and below.
+    return {
+      cells.left * k_hexagon_width,
+      ( cells.top == 0 ? 0 : cells.top - 1 ) * k_hexagon_height,
+      std::min( m_pixel_bounds.x, ( cells.right + 1 ) * k_hexagon_width ),
+      std::min( m_pixel_bounds.y, ( cells.bottom + 1 ) * k_hexagon_height )
+    };
+  }
+
+  return {
+    cells.left * k_triangle_width / 2,
+    cells.top * k_triangle_height,
+    std::min( m_pixel_bounds.x, ( cells.right + 1 ) * k_triangle_width / 2 ),
+    cells.bottom * k_triangle_height
+  };
+}
+
+const Vec2i game::CellMap::cell( const Vec2i& pixel ) const {
+  if( m_topology == Topology::Square ) {
+    return pixel;
+  }
+
+  const bool inside = pixel.x >= 0 && pixel.y >= 0 && ( size_t ) pixel.x < m_pixel_bounds.x && ( size_t ) pixel.y < m_pixel_bounds.y;
+
+  // Only whether a pixel outside of the texture is out of bounds matters, not the exact cell.
+  if( !inside ) {
+    return {
+      ( int ) std::floor( ( double ) pixel.x * ( double ) m_bounds.x / ( double ) m_pixel_bounds.x ),
+      ( int ) std::floor( ( double ) pixel.y * ( double ) m_bounds.y / ( double ) m_pixel_bounds.y )
+    };
+  }
+
+  const size_t stride = m_bounds.x + 2;
+  const uint32_t index = m_cells[ ( size_t ) pixel.y * m_pixel_bounds.x + ( size_t ) pixel.x ];
+
+  return { ( int ) ( index % stride ) - 1, ( int ) ( index / stride ) - 1 };
+}
@@ -0,0 +1,590 @@
+#include <game/census.hpp>
+#include <game/engine.hpp>
+#include <game/universe.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+  using Cell = game::CellPosition;
+
+  // Bands of rows per thread that are labelled on their own, a few to balance the load.
+  constexpr size_t k_bands_per_thread = 4;
+
+  // How much larger than its first phase the bounding box of an island may get before it counts as pathological.
+  constexpr int64_t k_max_growth = 16;
+  constexpr int64_t k_min_area = 4096;
+
+  // Digits of the extended Wechsler format, a column of five cells is one digit.
+  constexpr char k_digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+  //
+  // The live cells of a universe and the union-find over them.
+  //
+  // Live cells are numbered row by row, left to right, offsets[ y ] is the first cell of the row y. Every cell
+  // is linked to a cell of a lower number, so the root of an island is always its first cell.
+  //
+  struct Labels {
+    std::vector< size_t > offsets;
+    std::vector< uint32_t > columns;
+    std::vector< uint32_t > rows;
+    std::vector< uint32_t > parent;
+
+    // Finds the root of a cell, halving the path to it on the way.
+    const uint32_t find( uint32_t cell ) {
+      while( parent[ cell ] != cell ) {
+        parent[ cell ] = parent[ parent[ cell ] ];
+        cell = parent[ cell ];
+      }
+
+      return cell;
+    }
+
+    void unite( const uint32_t a, const uint32_t b ) {
+      const uint32_t root_a = find( a );
+      const uint32_t root_b = find( b );
+
+      if( root_a < root_b ) {
+        parent[ root_b ] = root_a;
+      }
+      else if( root_b < root_a ) {
+        parent[ root_a ] = root_b;
+      }
+    }
+
+    // Links the cells of the row y with the cells of the rows [ from, to ) that are at most reach columns away.
+    void link_rows( const size_t y, const size_t from, const size_t to, const uint32_t reach ) {
+      for( size_t row{ from }; row < to; ++row ) {
+        size_t first = offsets[ row ];
+        const size_t last = offsets[ row + 1 ];
+
+        for( size_t cell{ offsets[ y ] }; cell < offsets[ y + 1 ]; ++cell ) {
+          const uint32_t column = columns[ cell ];
+
+          // Both rows are sorted, so the cells that are too far to the left stay behind for the next cell.
+          while( first < last && columns[ first ] + reach < column ) {
+            ++first;
+          }
+
+          for( size_t other{ first }; other < last && columns[ other ] <= column + reach; ++other ) {
+            unite( ( uint32_t ) cell, ( uint32_t ) other );
+          }
+        }
+      }
+    }
+
+    // Links the cells of the row y with the cells before them on the same row that are at most reach columns away.
+    void link_row( const size_t y, const uint32_t reach ) {
+      for( size_t cell{ offsets[ y ] + 1 }; cell < offsets[ y + 1 ]; ++cell ) {
+        if( columns[ cell ] - columns[ cell - 1 ] <= reach ) {
+          unite( ( uint32_t ) cell, ( uint32_t ) cell - 1 );
+        }
+      }
+    }
+  };
+
+  // Smallest corner of the bounding box of the cells, which have to be sorted by row.
+  const Cell origin( const std::vector< Cell >& cells ) {
+    Cell corner = { cells.front().x, cells.front().y };
+
+    for( const auto& cell : cells ) {
+      corner.x = std::min( corner.x, cell.x );
+    }
+
+    return corner;
+  }
+
+  const Cell extent( const std::vector< Cell >& cells, const Cell& corner ) {
+    Cell size = { 0, cells.back().y - corner.y + 1 };
+
+    for( const auto& cell : cells ) {
+      size.x = std::max( size.x, cell.x - corner.x + 1 );
+    }
+
+    return size;
+  }
+
+  //
+  // Extended Wechsler format of a grid of cells: the rows are cut into strips of five, every column of a strip
+  // is a digit with the top cell as its lowest bit, and strips are separated by z. Runs of zero digits are
+  // written w for two, x for three and y followed by a digit for 4 to 39, zeros at the end of a strip are left out.
+  //
+  const std::string wechsler( const std::vector< uint8_t >& grid, const size_t width, const size_t height ) {
+    std::string code;
+
+    for( size_t top{}; top < height; top += 5 ) {
+      if( top != 0 ) {
+        code += 'z';
+      }
+
+      size_t zeros{};
+
+      for( size_t x{}; x < width; ++x ) {
+        size_t digit{};
+        for( size_t y{ top }; y < std::min( top + 5, height ); ++y ) {
+          digit |= ( size_t ) grid[ y * width + x ] << ( y - top );
+        }
+
+        if( digit == 0 ) {
+          ++zeros;
+          continue;
+        }
+
+        for( ; zeros >= 40; zeros -= 39 ) {
+          code += "yz";
+        }
+
+        if( zeros == 1 ) {
+          code += '0';
+        }
+        else if( zeros == 2 ) {
+          code += 'w';
+        }
+        else if( zeros == 3 ) {
+          code += 'x';
+        }
+        else if( zeros != 0 ) {
+          code += 'y';
+          code += k_digits[ zeros - 4 ];
+        }
+
+        zeros = 0;
+        code += k_digits[ digit ];
+      }
+    }
+
+    return code;
+  }
+
+  // Whether the first code comes before the second one, the shorter one first as in apgsearch.
+  const bool before( const std::string& a, const std::string& b ) {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+  }
+
+  // The first code of the eight rotations and reflections of the cells, which have to be sorted by row.
+  const std::string canonical( const std::vector< Cell >& cells ) {
+    const Cell corner = origin( cells );
+    const Cell size = extent( cells, corner );
+
+    std::string best;
+    std::vector< uint8_t > grid( ( size_t ) ( size.x * size.y ) );
+
+    for( size_t orientation{}; orientation < 8; ++orientation ) {
+      const bool transposed = ( orientation & 4 ) != 0;
+      const int64_t width = transposed ? size.y : size.x;
+      const int64_t height = transposed ? size.x : size.y;
+
+      std::fill( grid.begin(), grid.end(), 0 );
+
+      for( const auto& cell : cells ) {
+        int64_t x = cell.x - corner.x;
+        int64_t y = cell.y - corner.y;
+
+        if( transposed ) {
+          std::swap( x, y );
+        }
+
+        if( orientation & 1 ) {
+          x = width - 1 - x;
+        }
+
+        if( orientation & 2 ) {
+          y = height - 1 - y;
+        }
+
+        grid[ ( size_t ) ( y * width + x ) ] = 1;
+      }
+
+      const std::string code = wechsler( grid, ( size_t ) width, ( size_t ) height );
+      if( best.empty() || before( code, best ) ) {
+        best = code;
+      }
+    }
+
+    return best;
+  }
+
+  // Whether two sets of cells sorted by row are the same but for a translation.
+  const bool same_shape( const std::vector< Cell >& a, const std::vector< Cell >& b ) {
+    if( a.size() != b.size() ) {
+      return false;
+    }
+
+    const Cell corner_a = origin( a );
+    const Cell corner_b = origin( b );
+
+    for( size_t i{}; i < a.size(); ++i ) {
+      if( a[ i ].x - corner_a.x != b[ i ].x - corner_b.x || a[ i ].y - corner_a.y != b[ i ].y - corner_b.y ) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  //
+  // Steps a set of live cells on its own with the reference engine, in a universe just large enough for the
+  // cells that may be born around them. The universe is laid out again for every generation, so the cells can
+  // move and grow in any direction.
+  //
+  class Isolation {
+  private:
+    std::unique_ptr< game::Engine > m_engine;
+
+    // The engine is stepped from inside a dispatch of the shared pool, which isn't re-entrant.
+    app::ThreadPool m_pool;
+
+    game::Universe m_universe;
+
+    // Cells around the live cells that may be born in the next generation.
+    int64_t m_margin;
+
+  public:
+    Isolation( const game::Rule& rule ) :
+      m_engine( game::make_engine( game::engine_names().front() ) ),
+      m_pool( 1 ),
+      m_margin( rule.larger() ? rule.radius : 1 )
+    {
+      m_engine->set_rule( rule );
+    }
+
+    // Replaces the cells with the next generation, sorted by row.
+    void step( std::vector< Cell >& cells ) {
+      const Cell corner = origin( cells );
+      const Cell size = extent( cells, corner );
+
+      m_universe.init( { ( size_t ) ( size.x + 2 * m_margin ), ( size_t ) ( size.y + 2 * m_margin ) } );
+
+      for( const auto& cell : cells ) {
+        m_universe.set_states( ( size_t ) ( cell.y - corner.y + m_margin + 1 ), ( size_t ) ( cell.x - corner.x + m_margin + 1 ), 1 );
+      }
+
+      m_engine->step( m_universe, m_pool );
+
+      cells.clear();
+
+      const uint8_t* current = m_universe.current();
+      const size_t stride = m_universe.stride();
+
+      for( size_t row{ 1 }; row <= m_universe.bounds().y; ++row ) {
+        for( size_t column{ 1 }; column <= m_universe.bounds().x; ++column ) {
+          if( current[ row * stride + column ] == 1 ) {
+            cells.push_back( { ( int64_t ) column - 1 - m_margin + corner.x, ( int64_t ) row - 1 - m_margin + corner.y } );
+          }
+        }
+      }
+    }
+  };
+
+  // Runs an island on its own until it comes back to its first phase and names the object it is.
+  const game::CensusObject run_alone( Isolation& isolation, const std::vector< Cell >& island, const size_t max_period ) {
+    game::CensusObject object = { "PATHOLOGICAL", game::ObjectKind::Pathological, 0, {}, island.size(), 0 };
+
+    const Cell corner = origin( island );
+    const Cell size = extent( island, corner );
+    const int64_t max_area = std::max( k_max_growth * size.x * size.y, k_min_area );
+
+    std::vector< std::vector< Cell > > phases = { island };
+    std::vector< Cell > cells = island;
+
+    for( size_t generation{ 1 }; generation <= max_period; ++generation ) {
+      isolation.step( cells );
+
+      if( cells.empty() ) {
+        object.code = "DIES";
+        object.kind = game::ObjectKind::Dying;
+        object.period = generation;
+        return object;
+      }
+
+      if( same_shape( cells, island ) ) {
+        const Cell moved = origin( cells );
+        object.period = generation;
+        object.displacement = { moved.x - corner.x, moved.y - corner.y };
+        break;
+      }
+
+      const Cell grown = extent( cells, origin( cells ) );
+      if( grown.x * grown.y > max_area ) {
+        return object;
+      }
+
+      phases.push_back( cells );
+    }
+
+    if( object.period == 0 ) {
+      return object;
+    }
+
+    std::string best;
+    for( const auto& phase : phases ) {
+      const std::string code = canonical( phase );
+
+      if( best.empty() || before( code, best ) ) {
+        best = code;
+        object.population = phase.size();
+      }
+    }
+
+    if( object.displacement.x != 0 || object.displacement.y != 0 ) {
+      object.kind = game::ObjectKind::Spaceship;
+      object.code = "xq" + std::to_string( object.period ) + "_" + best;
+    }
+    else if( object.period > 1 ) {
+      object.kind = game::ObjectKind::Oscillator;
+      object.code = "xp" + std::to_string( object.period ) + "_" + best;
+    }
+    else {
+      object.kind = game::ObjectKind::StillLife;
+      object.code = "xs" + std::to_string( object.population ) + "_" + best;
+    }
+
+    return object;
+  }
+
+}
+
+const bool game::census_supports( const Rule& rule ) {
+  if( rule.states != 2 || !rule.square() || rule.tabular() || rule.margolus || rule.stochastic() ) {
+    return false;
+  }
+
+  if( rule.larger() ) {
+    return !rule.birth_range.contains( 0 );
+  }
+
+  return !rule.lives( 0 );
+}
+
+game::CensusTaker::CensusTaker( const Rule& rule, const size_t max_period ) :
+  m_rule( rule ),
+  m_max_period( max_period )
+{
+}
+
+const std::vector< std::vector< game::CellPosition > > game::CensusTaker::islands( const Universe& universe, app::ThreadPool& pool ) const {
+  app::TraceZone zone( "CensusTaker::islands" );
+
+  const size_t rows = universe.bounds().y;
+  const size_t columns = universe.bounds().x;
+  const size_t stride = universe.stride();
+  const uint8_t* current = universe.current();
+
+  if( rows == 0 || current == nullptr ) {
+    return {};
+  }
+
+  // Cells that far apart or closer are born from the same cells, see the range of the rule.
+  const uint32_t reach = 2 * ( m_rule.larger() ? m_rule.radius : 1 );
+
+  Labels labels;
+  labels.offsets.assign( rows + 1, 0 );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t y{ begin }; y < end; ++y ) {
+      const uint8_t* row = current + ( y + 1 ) * stride + 1;
+
+      size_t count{};
+      for( size_t x{}; x < columns; ++x ) {
+        count += row[ x ] != 0;
+      }
+
+      labels.offsets[ y + 1 ] = count;
+    }
+  } );
+
+  std::partial_sum( labels.offsets.begin(), labels.offsets.end(), labels.offsets.begin() );
+
+  const size_t cells = labels.offsets.back();
+  if( cells == 0 ) {
+    return {};
+  }
+
+  labels.columns.resize( cells );
+  labels.rows.resize( cells );
+  labels.parent.resize( cells );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t y{ begin }; y < end; ++y ) {
+      const uint8_t* row = current + ( y + 1 ) * stride + 1;
+      size_t cell = labels.offsets[ y ];
+
+      for( size_t x{}; x < columns; ++x ) {
+        if( row[ x ] != 0 ) {
+          labels.columns[ cell ] = ( uint32_t ) x;
+          labels.rows[ cell ] = ( uint32_t ) y;
+          labels.parent[ cell ] = ( uint32_t ) cell;
+          ++cell;
+        }
+      }
+    }
+  } );
+
+  //
+  // Every band only links cells within itself, so the parents a band changes are all its own. The rows at the
+  // top of every band are linked with the rows of the band above afterwards, which is a small part of the work.
+  //
+  const size_t bands = std::min( rows, pool.threads() * k_bands_per_thread );
+  const size_t band_rows = ( rows + bands - 1 ) / bands;
+
+  pool.parallel_for( bands, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t band{ begin }; band < end; ++band ) {
+      const size_t first = band * band_rows;
+      const size_t last = std::min( first + band_rows, rows );
+
+      for( size_t y{ first }; y < last; ++y ) {
+        labels.link_row( y, reach );
+        labels.link_rows( y, std::max( first, y - std::min< size_t >( y, reach ) ), y, reach );
+      }
+    }
+  }, 1 );
+
+  for( size_t first{ band_rows }; first < rows; first += band_rows ) {
+    for( size_t y{ first }; y < std::min( first + reach, rows ); ++y ) {
+      labels.link_rows( y, y - std::min< size_t >( y, reach ), first, reach );
+    }
+  }
+
+  //
+  // The parent of every cell comes before it, so a single pass in order numbers the islands: a root gets the
+  // next number and every other cell the number its parent already got.
+  //
+  size_t count{};
+  for( size_t cell{}; cell < cells; ++cell ) {
+    const uint32_t parent = labels.parent[ cell ];
+    labels.parent[ cell ] = parent == cell ? ( uint32_t ) count++ : labels.parent[ parent ];
+  }
+
+  std::vector< size_t > sizes( count );
+  for( size_t cell{}; cell < cells; ++cell ) {
+    ++sizes[ labels.parent[ cell ] ];
+  }
+
+  std::vector< std::vector< CellPosition > > out( count );
+  for( size_t island{}; island < count; ++island ) {
+    out[ island ].reserve( sizes[ island ] );
+  }
+
+  // In order of the cells, so every island comes out sorted by row.
+  for( size_t cell{}; cell < cells; ++cell ) {
+    out[ labels.parent[ cell ] ].push_back( { ( int64_t ) labels.columns[ cell ], ( int64_t ) labels.rows[ cell ] } );
+  }
+
+  return out;
+}
+
+const game::CensusObject game::CensusTaker::classify( const std::vector< CellPosition >& island ) {
+  const std::string shape = canonical( island );
+
+  const auto it = m_known.find( shape );
+  if( it != m_known.end() ) {
+    return it->second;
+  }
+
+  Isolation isolation( m_rule );
+  const CensusObject object = run_alone( isolation, island, m_max_period );
+
+  m_known.emplace( shape, object );
+  return object;
+}
+
+const game::Census game::CensusTaker::take( const Universe& universe, app::ThreadPool& pool ) {
+  app::TraceZone zone( "CensusTaker::take" );
+
+  Census census{};
+
+  const std::vector< std::vector< CellPosition > > islands = this->islands( universe, pool );
+  census.islands = islands.size();
+
+  for( const auto& island : islands ) {
+    census.cells += island.size();
+  }
+
+  // Islands of the same shape in any orientation behave the same, so only one of them is run.
+  std::vector< std::string > shapes( islands.size() );
+
+  pool.parallel_for( islands.size(), [ & ]( const size_t begin, const size_t end ) {
+    for( size_t island{ begin }; island < end; ++island ) {
+      shapes[ island ] = canonical( islands[ island ] );
+    }
+  } );
+
+  struct Shape {
+    size_t island;
+    size_t count;
+  };
+
+  std::vector< Shape > distinct;
+  {
+    std::unordered_map< std::string, size_t > indices;
+
+    for( size_t island{}; island < islands.size(); ++island ) {
+      const auto [ it, inserted ] = indices.try_emplace( shapes[ island ], distinct.size() );
+      if( inserted ) {
+        distinct.push_back( { island, 0 } );
+      }
+
+      ++distinct[ it->second ].count;
+    }
+  }
+
+  // Shapes an earlier census ran are looked up, the others are run on the pool and remembered.
+  std::vector< CensusObject > objects( distinct.size() );
+  std::vector< size_t > unknown;
+
+  for( size_t i{}; i < distinct.size(); ++i ) {
+    const auto it = m_known.find( shapes[ distinct[ i ].island ] );
+
+    if( it != m_known.end() ) {
+      objects[ i ] = it->second;
+    }
+    else {
+      unknown.push_back( i );
+    }
+  }
+
+  {
+    app::TraceZone run_zone( "CensusTaker::take run" );
+
+    pool.parallel_for( unknown.size(), [ & ]( const size_t begin, const size_t end ) {
+      Isolation isolation( m_rule );
+
+      for( size_t i{ begin }; i < end; ++i ) {
+        objects[ unknown[ i ] ] = run_alone( isolation, islands[ distinct[ unknown[ i ] ].island ], m_max_period );
+      }
+    } );
+  }
+
+  for( const size_t i : unknown ) {
+    m_known.emplace( shapes[ distinct[ i ].island ], objects[ i ] );
+  }
+
+  // Different phases of an object are different shapes but have the same code.
+  std::unordered_map< std::string, size_t > tally;
+
+  for( size_t i{}; i < distinct.size(); ++i ) {
+    const auto [ it, inserted ] = tally.try_emplace( objects[ i ].code, census.objects.size() );
+    if( inserted ) {
+      census.objects.push_back( objects[ i ] );
+      census.objects.back().count = 0;
+    }
+
+    census.objects[ it->second ].count += distinct[ i ].count;
+  }
+
+  std::sort( census.objects.begin(), census.objects.end(), []( const CensusObject& a, const CensusObject& b ) {
+    return a.count != b.count ? a.count > b.count : a.code < b.code;
+  } );
+
+  return census;
+}
+
+const game::Census game::take_census( const Universe& universe, const Rule& rule, app::ThreadPool& pool, const size_t max_period ) {
+  CensusTaker taker( rule, max_period );
+  return taker.take( universe, pool );
+}
@@ -0,0 +1,93 @@
+#include <game/engine.hpp>
+
+#include <game/activity.hpp>
+#include <game/universe.hpp>
+
+#include <game/engines/life.hpp>
+#include <game/engines/bitplane.hpp>
+#include <game/engines/larger.hpp>
+#include <game/engines/lattice.hpp>
+#include <game/engines/margolus.hpp>
+#include <game/engines/table.hpp>
+
+game::Activity* game::Engine::activity( const Universe& universe ) const {
+  return m_activity != nullptr && m_activity->bounds() == universe.bounds() ? m_activity : nullptr;
+}
+
+const std::vector< std::string_view >& game::engine_names() {
+  static const std::vector< std::string_view > names = {
+    "scalar",
+    "banded",
+    "bitplane",
+    "ltl",
+    "table",
+    "lattice",
+    "margolus"
+  };
+
+  return names;
+}
+
+std::unique_ptr< game::Engine > game::make_engine( const std::string_view& name ) {
+  if( name == "scalar" ) {
+    return std::make_unique< ScalarLifeEngine >();
+  }
+
+  if( name == "banded" ) {
+    return std::make_unique< LifeEngine >();
+  }
+
+  if( name == "bitplane" ) {
+    return std::make_unique< BitplaneEngine >();
+  }
+
+  if( name == "ltl" ) {
+    return std::make_unique< LargerThanLifeEngine >();
+  }
+
+  if( name == "table" ) {
+    return std::make_unique< RuleTableEngine >();
+  }
+
+  if( name == "lattice" ) {
+    return std::make_unique< LatticeEngine >();
+  }
+
+  if( name == "margolus" ) {
+    return std::make_unique< MargolusEngine >();
+  }
+
+  return nullptr;
+}
+
+std::unique_ptr< game::Engine > game::make_engine( const Rule& rule ) {
+  std::unique_ptr< Engine > engine = std::make_unique< LifeEngine >();
+
+  if( !engine->supports( rule ) ) {
+    engine = std::make_unique< BitplaneEngine >();
+  }
+
+  if( !engine->supports( rule ) ) {
+    engine = std::make_unique< LargerThanLifeEngine >();
+  }
+
+  if( !engine->supports( rule ) ) {
+    engine = std::make_unique< RuleTableEngine >();
+  }
+
+  if( !engine->supports( rule ) ) {
+    engine = std::make_unique< LatticeEngine >();
+  }
+
+  if( !engine->supports( rule ) ) {
+    engine = std::make_unique< MargolusEngine >();
+  }
+
+  // Rule tables with too many states for a lookup table.
+  if( !engine->supports( rule ) ) {
+    engine = std::make_unique< ScalarLifeEngine >();
+  }
+
+  engine->set_rule( rule );
+  return engine;
+}
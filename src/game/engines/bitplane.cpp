@@ -0,0 +1,261 @@
+#include <game/engines/bitplane.hpp>
+
+#include <game/activity.hpp>
+#include <game/universe.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+
+namespace {
+
+  //
+  // The cells of the block in the order the function decides on them, clockwise from north and the cell itself
+  // last. Neighbours next to each other in the ring tend to lead to the same decisions, which keeps the
+  // function small: around 50 nodes for most rules.
+  //
+  constexpr uint8_t k_order[ 9 ] = { 3, 6, 7, 8, 5, 2, 1, 0, 4 };
+
+  // Nodes a reduced function of nine variables can have at most, no more than 2^n after n decisions and no more
+  // than there are functions of the remaining variables: 1 + 2 + 4 + 8 + 16 + 32 + 64 + 12 + 2.
+  constexpr size_t k_max_nodes = 141;
+
+  // Cells whose neighbour count, given as binary digits, is set in the mask.
+  uint64_t matches( const uint16_t mask, const uint64_t n0, const uint64_t n1, const uint64_t n2, const uint64_t n3 ) {
+    uint64_t result{};
+
+    for( size_t count{}; count <= 8; ++count ) {
+      if( ( ( mask >> count ) & 1 ) == 0 ) {
+        continue;
+      }
+
+      result |= ( count & 1 ? n0 : ~n0 ) & ( count & 2 ? n1 : ~n1 ) & ( count & 4 ? n2 : ~n2 ) & ( count & 8 ? n3 : ~n3 );
+    }
+
+    return result;
+  }
+
+}
+
+game::BitplaneEngine::BitplaneEngine() :
+  m_digits( 1 ),
+  m_root{}
+{
+}
+
+void game::BitplaneEngine::set_rule( const Rule& rule ) {
+  Engine::set_rule( rule );
+
+  if( rule.isotropic ) {
+    synthesise( rule );
+  }
+
+  // The planes of a universe are laid out again on the next step if the digits changed.
+  m_digits = std::max< size_t >( 1, std::bit_width( ( unsigned ) rule.states - 1 ) );
+}
+
+void game::BitplaneEngine::synthesise( const Rule& rule ) {
+  m_function.clear();
+
+  // Nodes by variable and children, so that equal parts of the function end up as the same node.
+  std::unordered_map< uint32_t, uint16_t > unique;
+
+  const auto build = [ & ]( const auto& self, const size_t depth, const size_t block ) -> uint16_t {
+    if( depth == 9 ) {
+      return rule.lives( block );
+    }
+
+    const uint8_t variable = k_order[ depth ];
+    const uint16_t low = self( self, depth + 1, block );
+    const uint16_t high = self( self, depth + 1, block | ( ( size_t ) 1 << variable ) );
+
+    // The cell makes no difference here.
+    if( low == high ) {
+      return low;
+    }
+
+    const uint32_t key = ( ( uint32_t ) variable << 20 ) | ( ( uint32_t ) low << 10 ) | high;
+
+    const auto found = unique.find( key );
+    if( found != unique.end() ) {
+      return found->second;
+    }
+
+    m_function.push_back( { variable, low, high } );
+
+    const uint16_t node = ( uint16_t ) ( m_function.size() + 1 );
+    unique.emplace( key, node );
+    return node;
+  };
+
+  m_root = build( build, 0, 0 );
+}
+
+void game::BitplaneEngine::step_row( BitPlanes& planes, const size_t generation, const size_t row, Activity* activity ) {
+  const size_t columns = planes.bounds().x;
+  const size_t row_words = planes.row_words();
+
+  const uint64_t* above = planes.plane( m_digits, row - 1 );
+  const uint64_t* cells = planes.plane( m_digits, row );
+  const uint64_t* below = planes.plane( m_digits, row + 1 );
+
+  // Bit i of a word is column i of the word, so the west neighbours are shifted up and the east ones down.
+  const auto west = [ & ]( const uint64_t* words, const size_t word ) {
+    return ( words[ word ] << 1 ) | ( words[ word - 1 ] >> 63 );
+  };
+
+  const auto east = [ & ]( const uint64_t* words, const size_t word ) {
+    return ( words[ word ] >> 1 ) | ( words[ word + 1 ] << 63 );
+  };
+
+  const uint16_t last = m_rule.states - 1;
+
+  for( size_t word{ 1 }; word + 1 < row_words; ++word ) {
+    const uint64_t above_west = west( above, word );
+    const uint64_t above_east = east( above, word );
+    const uint64_t below_west = west( below, word );
+    const uint64_t below_east = east( below, word );
+    const uint64_t side_west = west( cells, word );
+    const uint64_t side_east = east( cells, word );
+
+    // Cells that would be born if they were dead and that would survive if they were alive.
+    uint64_t birth{};
+    uint64_t survival{};
+
+    if( m_rule.isotropic ) {
+      // The variables of the function in the layout of Rule::table.
+      const uint64_t block[ 9 ] = {
+        above_west, side_west, below_west, above[ word ], cells[ word ], below[ word ], above_east, side_east, below_east
+      };
+
+      uint64_t values[ 2 + k_max_nodes ];
+      values[ 0 ] = 0;
+      values[ 1 ] = ~0ULL;
+
+      for( size_t node{}; node < m_function.size(); ++node ) {
+        const Node& decision = m_function[ node ];
+        const uint64_t select = block[ decision.variable ];
+
+        values[ node + 2 ] = ( select & values[ decision.high ] ) | ( ~select & values[ decision.low ] );
+      }
+
+      // The cell itself is one of the variables, so one function covers both.
+      birth = survival = values[ m_root ];
+    }
+    else {
+      //
+      // Live neighbour count as four binary digits n0 .. n3. The three cells above and the three below are
+      // summed with full adders, the two beside the cell with a half adder, then the partial sums are added.
+      //
+      const uint64_t above_sum = above_west ^ above[ word ] ^ above_east;
+      const uint64_t above_carry = ( above_west & above[ word ] ) | ( above_east & ( above_west ^ above[ word ] ) );
+
+      const uint64_t below_sum = below_west ^ below[ word ] ^ below_east;
+      const uint64_t below_carry = ( below_west & below[ word ] ) | ( below_east & ( below_west ^ below[ word ] ) );
+
+      const uint64_t side_sum = side_west ^ side_east;
+      const uint64_t side_carry = side_west & side_east;
+
+      const uint64_t n0 = above_sum ^ below_sum ^ side_sum;
+      const uint64_t ones_carry = ( above_sum & below_sum ) | ( side_sum & ( above_sum ^ below_sum ) );
+
+      const uint64_t twos = above_carry ^ below_carry ^ side_carry;
+      const uint64_t twos_carry = ( above_carry & below_carry ) | ( side_carry & ( above_carry ^ below_carry ) );
+
+      const uint64_t n1 = twos ^ ones_carry;
+      const uint64_t fours_carry = twos & ones_carry;
+
+      const uint64_t n2 = twos_carry ^ fours_carry;
+      const uint64_t n3 = twos_carry & fours_carry;
+
+      birth = matches( m_rule.birth, n0, n1, n2, n3 );
+      survival = matches( m_rule.survival, n0, n1, n2, n3 );
+    }
+
+    // Stochastic rules only let the transitions whose coin flips came up happen.
+    Rule::Chances chances{};
+    if( m_rule.stochastic() ) {
+      chances = m_rule.chances( generation, ( row - 1 ) * ( row_words - 2 ) + word - 1 );
+      birth &= chances.birth;
+      survival &= chances.survival;
+    }
+
+    //
+    // Dead cells are born, live cells survive, and every other cell that isn't dead moves on to the next
+    // state, wrapping around to dead after the last one.
+    //
+    uint64_t digits[ 8 ]{};
+    uint64_t occupied{};
+    uint64_t is_last = ~0ULL;
+
+    for( size_t digit{}; digit < m_digits; ++digit ) {
+      digits[ digit ] = planes.plane( digit, row )[ word ];
+      occupied |= digits[ digit ];
+      is_last &= ( last >> digit ) & 1 ? digits[ digit ] : ~digits[ digit ];
+    }
+
+    const uint64_t born = ~occupied & birth;
+    const uint64_t kept = cells[ word ] & survival;
+
+    const uint64_t advancing = occupied & ~kept;
+    const uint64_t wrapping = advancing & is_last;
+
+    uint64_t carry = advancing;
+    for( size_t digit{}; digit < m_digits; ++digit ) {
+      const uint64_t value = digits[ digit ];
+
+      digits[ digit ] = ( value ^ carry ) & ~wrapping;
+      carry &= value;
+    }
+
+    digits[ 0 ] |= born;
+
+    // Noise flips cells between dead and alive, there are only two states under stochastic rules.
+    digits[ 0 ] ^= chances.noise;
+
+    // Cells past the last column stay dead, so that they are never counted as neighbours.
+    const size_t first = ( word - 1 ) * 64;
+    const size_t count = std::min< size_t >( 64, columns - first );
+    const uint64_t inside = count < 64 ? ( ( uint64_t ) 1 << count ) - 1 : ~0ULL;
+
+    uint64_t live = digits[ 0 ] & inside;
+    uint64_t changed{};
+
+    for( size_t digit{}; digit < m_digits; ++digit ) {
+      const uint64_t value = digits[ digit ] & inside;
+
+      changed |= value ^ planes.plane( digit, row )[ word ];
+      planes.next_plane( digit, row )[ word ] = value;
+
+      // Alive is state 1, every higher digit has to be clear.
+      if( digit > 0 ) {
+        live &= ~value;
+      }
+    }
+
+    planes.next_plane( m_digits, row )[ word ] = live;
+
+    if( activity != nullptr ) {
+      activity->row( row - 1 )[ word - 1 ] = ( uint8_t ) std::popcount( changed );
+    }
+  }
+}
+
+void game::BitplaneEngine::step( Universe& universe, app::ThreadPool& pool ) {
+  app::TraceZone zone( "BitplaneEngine::step" );
+
+  BitPlanes& planes = universe.planes( m_digits, pool );
+  Activity* activity = Engine::activity( universe );
+
+  pool.parallel_for( planes.bounds().y, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin + 1 }; row <= end; ++row ) {
+      step_row( planes, universe.generation(), row, activity );
+    }
+  } );
+
+  planes.swap();
+  universe.step_planes();
+}
@@ -0,0 +1,293 @@
+#include <game/engines/larger.hpp>
+
+#include <game/activity.hpp>
+#include <game/universe.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+//
+// The tables are indexed in padded coordinates, cell ( row, column ) in 0 based grid coordinates is at
+// ( row + halo, column + halo ). The halo is one wider than the radius so that the lookups just outside of
+// a neighbourhood stay inside of the tables too.
+//
+// Sums are unsigned 32 bit and may wrap around on huge grids, the differences taken from them stay exact
+// as long as a single neighbourhood has fewer than 2^32 cells.
+//
+
+game::LargerThanLifeEngine::LargerThanLifeEngine() :
+  m_bounds{},
+  m_halo{},
+  m_table_stride{},
+  m_capacity{},
+  m_memory( app::MemoryCategory::Cells )
+{
+}
+
+void game::LargerThanLifeEngine::set_rule( const Rule& rule ) {
+  const bool layout = rule.radius != m_rule.radius || rule.neighbourhood != m_rule.neighbourhood;
+
+  Engine::set_rule( rule );
+
+  if( layout ) {
+    // The tables are laid out again on the next step.
+    m_bounds = {};
+  }
+}
+
+void game::LargerThanLifeEngine::allocate( const Vec2< size_t >& bounds ) {
+  m_bounds = bounds;
+  m_halo = ( size_t ) m_rule.radius + 1;
+  m_table_stride = bounds.x + 2 * m_halo;
+
+  const size_t tables = m_rule.neighbourhood == Neighbourhood::Moore ? 1 : 2;
+  const size_t size = tables * table_rows() * m_table_stride;
+
+  // Every entry is written while building the tables, so they don't need to be cleared.
+  if( size > m_capacity ) {
+    m_capacity = size;
+    m_tables = std::make_unique< uint32_t[] >( m_capacity );
+    m_memory.set( m_capacity * sizeof( uint32_t ) );
+  }
+}
+
+void game::LargerThanLifeEngine::step_moore( Universe& universe, app::ThreadPool& pool ) {
+  const size_t radius = m_rule.radius;
+  const size_t halo = m_halo;
+  const size_t rows = m_bounds.y;
+  const size_t columns = m_bounds.x;
+  const size_t stride = m_table_stride;
+  const size_t table_rows = this->table_rows();
+
+  uint32_t* table = m_tables.get();
+
+  //
+  // table[ p ][ q ] is the number of live cells in padded rows 0 .. p and columns 0 .. q. Every row is
+  // summed on its own first, then the rows are added up column by column.
+  //
+  pool.parallel_for( table_rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t p{ begin }; p < end; ++p ) {
+      uint32_t* sums = table + p * stride;
+
+      if( p < halo || p >= halo + rows ) {
+        std::fill_n( sums, stride, 0 );
+        continue;
+      }
+
+      const uint8_t* cells = universe.current() + ( p - halo + 1 ) * universe.stride() + 1;
+
+      std::fill_n( sums, halo, 0 );
+
+      uint32_t running{};
+      for( size_t column{}; column < columns; ++column ) {
+        running += cells[ column ] == 1;
+        sums[ halo + column ] = running;
+      }
+
+      std::fill_n( sums + halo + columns, halo, running );
+    }
+  } );
+
+  pool.parallel_for( stride, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t p{ 1 }; p < table_rows; ++p ) {
+      const uint32_t* above = table + ( p - 1 ) * stride;
+      uint32_t* sums = table + p * stride;
+
+      for( size_t q{ begin }; q < end; ++q ) {
+        sums[ q ] += above[ q ];
+      }
+    }
+  } );
+
+  Activity* activity = Engine::activity( universe );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin }; row < end; ++row ) {
+      const size_t p = row + halo;
+
+      // The square spans padded rows p - radius .. p + radius.
+      const uint32_t* top = table + ( p - radius - 1 ) * stride;
+      const uint32_t* bottom = table + ( p + radius ) * stride;
+
+      const uint8_t* cells = universe.current() + ( row + 1 ) * universe.stride() + 1;
+      uint8_t* out = universe.next() + ( row + 1 ) * universe.stride() + 1;
+
+      for( size_t column{}; column < columns; ++column ) {
+        const size_t q = column + halo;
+
+        uint32_t count = bottom[ q + radius ] - top[ q + radius ] - bottom[ q - radius - 1 ] + top[ q - radius - 1 ];
+        if( !m_rule.middle ) {
+          count -= cells[ column ] == 1;
+        }
+
+        out[ column ] = m_rule.next( cells[ column ], count );
+      }
+
+      if( activity != nullptr ) {
+        activity->count_row( row, cells, out );
+      }
+    }
+  } );
+}
+
+void game::LargerThanLifeEngine::step_von_neumann( Universe& universe, app::ThreadPool& pool ) {
+  const size_t radius = m_rule.radius;
+  const size_t halo = m_halo;
+  const size_t rows = m_bounds.y;
+  const size_t columns = m_bounds.x;
+  const size_t stride = m_table_stride;
+  const size_t table_rows = this->table_rows();
+
+  // down_right[ p ][ q ] sums the live cells at ( p - k, q - k ), down_left[ p ][ q ] those at ( p - k, q + k ).
+  uint32_t* down_right = m_tables.get();
+  uint32_t* down_left = down_right + table_rows * stride;
+
+  {
+    app::TraceZone zone( "Diagonal sums" );
+
+    //
+    // Every row continues the sums of the row above, so the rows are split into a band per thread that is summed
+    // as if nothing was above it. The last row of every band is then finished from the band above, in order, and
+    // the other rows of a band from its last row, shifted along the diagonals by how far apart the rows are.
+    //
+    const size_t band = ( table_rows + pool.threads() - 1 ) / pool.threads();
+
+    // Adds the sums of a finished row to a later one that only summed the rows below the finished one.
+    const auto carry = [ & ]( const size_t from, const size_t p ) {
+      const size_t shift = std::min( p - from, stride );
+
+      const uint32_t* right_from = down_right + from * stride;
+      const uint32_t* left_from = down_left + from * stride;
+
+      uint32_t* right = down_right + p * stride;
+      uint32_t* left = down_left + p * stride;
+
+      for( size_t q{ shift }; q < stride; ++q ) {
+        right[ q ] += right_from[ q - shift ];
+      }
+
+      for( size_t q{}; q + shift < stride; ++q ) {
+        left[ q ] += left_from[ q + shift ];
+      }
+    };
+
+    pool.parallel_for( table_rows, [ & ]( const size_t begin, const size_t end ) {
+      for( size_t p{ begin }; p < end; ++p ) {
+        const bool interior = p >= halo && p < halo + rows;
+        const uint8_t* cells = interior ? universe.current() + ( p - halo + 1 ) * universe.stride() + 1 : nullptr;
+
+        uint32_t* right = down_right + p * stride;
+        uint32_t* left = down_left + p * stride;
+
+        if( p == begin ) {
+          for( size_t q{}; q < stride; ++q ) {
+            const uint32_t live = interior && q >= halo && q < halo + columns && cells[ q - halo ] == 1;
+
+            right[ q ] = live;
+            left[ q ] = live;
+          }
+
+          continue;
+        }
+
+        const uint32_t* right_above = right - stride;
+        const uint32_t* left_above = left - stride;
+
+        for( size_t q{}; q < stride; ++q ) {
+          const uint32_t live = interior && q >= halo && q < halo + columns && cells[ q - halo ] == 1;
+
+          right[ q ] = live + ( q > 0 ? right_above[ q - 1 ] : 0 );
+          left[ q ] = live + ( q + 1 < stride ? left_above[ q + 1 ] : 0 );
+        }
+      }
+    }, band );
+
+    for( size_t begin{ band }; begin < table_rows; begin += band ) {
+      carry( begin - 1, std::min( begin + band, table_rows ) - 1 );
+    }
+
+    pool.parallel_for( table_rows, [ & ]( const size_t begin, const size_t end ) {
+      // Nothing is above the first band.
+      if( begin == 0 ) {
+        return;
+      }
+
+      for( size_t p{ begin }; p + 1 < end; ++p ) {
+        carry( begin - 1, p );
+      }
+    }, band );
+  }
+
+  Activity* activity = Engine::activity( universe );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin }; row < end; ++row ) {
+      const size_t p = row + halo;
+
+      const uint32_t* right = down_right + p * stride;
+      const uint32_t* right_above = down_right + ( p - radius - 1 ) * stride;
+      const uint32_t* right_below = down_right + ( p + radius ) * stride;
+
+      const uint32_t* left = down_left + p * stride;
+      const uint32_t* left_above = down_left + ( p - radius - 1 ) * stride;
+      const uint32_t* left_below = down_left + ( p + radius ) * stride;
+
+      const uint8_t* cells = universe.current() + ( row + 1 ) * universe.stride() + 1;
+      uint8_t* out = universe.next() + ( row + 1 ) * universe.stride() + 1;
+
+      //
+      // The diamond starts out entirely in the halo on the left, where it is empty, and slides right.
+      //    Entering on the right: ( p - k, q + radius - k ) and ( p + k, q + radius - k ).
+      //    Leaving on the left:   ( p - k, q - 1 - radius + k ) and ( p + k, q - 1 - radius + k ).
+      //
+      uint32_t count{};
+
+      for( ptrdiff_t column{ -( ptrdiff_t ) radius }; column < ( ptrdiff_t ) columns; ++column ) {
+        const size_t q = ( size_t ) ( column + ( ptrdiff_t ) halo );
+
+        count += right[ q + radius ] - right_above[ q - 1 ] + left_below[ q ] - left[ q + radius ];
+
+        // Diamonds centred further left than the first column only reach into the halo.
+        if( column >= 1 ) {
+          const size_t previous = q - 1;
+          count -= left[ previous - radius ] - left_above[ previous + 1 ] + right_below[ previous ] - right[ previous - radius ];
+        }
+
+        if( column < 0 ) {
+          continue;
+        }
+
+        uint32_t live_neighbors = count;
+        if( !m_rule.middle ) {
+          live_neighbors -= cells[ column ] == 1;
+        }
+
+        out[ column ] = m_rule.next( cells[ column ], live_neighbors );
+      }
+
+      if( activity != nullptr ) {
+        activity->count_row( row, cells, out );
+      }
+    }
+  } );
+}
+
+void game::LargerThanLifeEngine::step( Universe& universe, app::ThreadPool& pool ) {
+  app::TraceZone zone( "LargerThanLifeEngine::step" );
+
+  if( !( universe.bounds() == m_bounds ) ) {
+    allocate( universe.bounds() );
+  }
+
+  if( m_rule.neighbourhood == Neighbourhood::Moore ) {
+    step_moore( universe, pool );
+  }
+  else {
+    step_von_neumann( universe, pool );
+  }
+
+  universe.swap();
+}
@@ -0,0 +1,131 @@
+#include <game/engines/lattice.hpp>
+
+#include <game/activity.hpp>
+#include <game/universe.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <vector>
+
+game::LatticeEngine::LatticeEngine() {
+  set_rule( m_rule );
+}
+
+void game::LatticeEngine::set_rule( const Rule& rule ) {
+  Engine::set_rule( rule );
+
+  m_table.fill( 0 );
+
+  for( size_t state{}; state < rule.states; ++state ) {
+    for( size_t count{}; count <= 12; ++count ) {
+      m_table[ ( state << 4 ) | count ] = rule.next( ( uint8_t ) state, count );
+    }
+  }
+}
+
+void game::LatticeEngine::step_hexagonal( Universe& universe, app::ThreadPool& pool ) {
+  const size_t rows = universe.bounds().y;
+  const size_t columns = universe.bounds().x;
+  const size_t stride = universe.stride();
+
+  const uint8_t* current = universe.current();
+  uint8_t* next = universe.next();
+
+  Activity* activity = Engine::activity( universe );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin + 1 }; row <= end; ++row ) {
+      // Odd rows in 0 based grid coordinates are shifted right, the rows around them are one column further right.
+      const size_t shift = row % 2 == 0 ? 1 : 0;
+
+      const uint8_t* above = current + ( row - 1 ) * stride + shift;
+      const uint8_t* cells = current + row * stride;
+      const uint8_t* below = current + ( row + 1 ) * stride + shift;
+
+      uint8_t* out = next + row * stride;
+
+      for( size_t column{ 1 }; column <= columns; ++column ) {
+        const size_t count =
+          ( above[ column - 1 ] == 1 ) + ( above[ column ] == 1 ) +
+          ( cells[ column - 1 ] == 1 ) + ( cells[ column + 1 ] == 1 ) +
+          ( below[ column - 1 ] == 1 ) + ( below[ column ] == 1 );
+
+        out[ column ] = m_table[ ( ( size_t ) cells[ column ] << 4 ) | count ];
+      }
+
+      if( activity != nullptr ) {
+        activity->count_row( row - 1, cells + 1, out + 1 );
+      }
+    }
+  } );
+}
+
+void game::LatticeEngine::step_triangular( Universe& universe, app::ThreadPool& pool ) {
+  const size_t rows = universe.bounds().y;
+  const size_t columns = universe.bounds().x;
+  const size_t stride = universe.stride();
+
+  const uint8_t* current = universe.current();
+  uint8_t* next = universe.next();
+
+  Activity* activity = Engine::activity( universe );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    //
+    // Column x of the universe is at x + 1, so that the two columns past the border on either side are
+    // inside as well. Those stay zero, only the border and the cells between are written.
+    //    sums: live cells of the column on the three rows.
+    //    corners: live cell of the column on the side of the point of a triangle in that column.
+    //
+    std::vector< uint8_t > sums( columns + 4 );
+    std::vector< uint8_t > corners( columns + 4 );
+
+    for( size_t row{ begin + 1 }; row <= end; ++row ) {
+      const uint8_t* above = current + ( row - 1 ) * stride;
+      const uint8_t* cells = current + row * stride;
+      const uint8_t* below = current + ( row + 1 ) * stride;
+
+      uint8_t* out = next + row * stride;
+
+      // Triangles whose row and column add up to an even number point up.
+      const size_t parity = row % 2;
+
+      for( size_t x{}; x <= columns + 1; ++x ) {
+        const uint8_t top = above[ x ] == 1;
+        const uint8_t bottom = below[ x ] == 1;
+
+        sums[ x + 1 ] = ( uint8_t ) ( top + ( cells[ x ] == 1 ) + bottom );
+        corners[ x + 1 ] = ( x % 2 == parity ) ? top : bottom;
+      }
+
+      // The row on the side of the point only reaches one column out, the cells two columns out are taken off.
+      for( size_t column{ 1 }; column <= columns; ++column ) {
+        const size_t p = column + 1;
+
+        const size_t count =
+          sums[ p - 2 ] + sums[ p - 1 ] + sums[ p ] + sums[ p + 1 ] + sums[ p + 2 ] -
+          ( cells[ column ] == 1 ) - corners[ p - 2 ] - corners[ p + 2 ];
+
+        out[ column ] = m_table[ ( ( size_t ) cells[ column ] << 4 ) | count ];
+      }
+
+      if( activity != nullptr ) {
+        activity->count_row( row - 1, cells + 1, out + 1 );
+      }
+    }
+  } );
+}
+
+void game::LatticeEngine::step( Universe& universe, app::ThreadPool& pool ) {
+  app::TraceZone zone( "LatticeEngine::step" );
+
+  if( m_rule.topology == Topology::Hexagonal ) {
+    step_hexagonal( universe, pool );
+  }
+  else {
+    step_triangular( universe, pool );
+  }
+
+  universe.swap();
+}
@@ -0,0 +1,322 @@
+#include <game/engines/lenia.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+  // Columns that are transformed together, so that gathering them reads whole cache lines of every row.
+  constexpr size_t k_column_block = 8;
+
+  //
+  // Multiplications per cell of the direct convolution that cost about as much as one butterfly per cell and
+  // level of the transform, measured on 2048 x 2048 fields. A step through the transform pads the field, goes
+  // forward and back in both directions and is about log2 of the padded size butterflies per padded cell.
+  //
+  constexpr double k_direct_per_butterfly = 5.0;
+
+  // Adds the growth of the potentials to a row of cells.
+  void grow( const game::LeniaRule& rule, const float* cells, const float* potentials, float* out, const size_t columns ) {
+    const float dt = 1.F / ( float ) rule.time;
+
+    for( size_t x{}; x < columns; ++x ) {
+      out[ x ] = std::clamp( cells[ x ] + dt * rule.growth( potentials[ x ] ), 0.F, 1.F );
+    }
+  }
+
+}
+
+game::LeniaEngine::LeniaEngine( const Convolution convolution ) :
+  m_convolution( convolution ),
+  m_bounds{},
+  m_padded{},
+  m_memory( app::MemoryCategory::Cells )
+{
+  set_rule( m_rule );
+}
+
+const char* game::LeniaEngine::name() const {
+  switch( m_convolution ) {
+    case Convolution::Direct:
+      return "direct";
+
+    case Convolution::Fourier:
+      return "fft";
+
+    default:
+      return "auto";
+  }
+}
+
+void game::LeniaEngine::set_rule( const LeniaRule& rule ) {
+  m_rule = rule;
+  m_kernel = rule.kernel();
+
+  // The spectrum of the kernel is computed again on the next step through the transform.
+  m_bounds = {};
+}
+
+const game::Convolution game::LeniaEngine::convolution( const Vec2< size_t >& bounds ) const {
+  if( m_convolution != Convolution::Automatic ) {
+    return m_convolution;
+  }
+
+  const Vec2< size_t > size = padded( bounds );
+  const double padded = ( double ) size.x * ( double ) size.y;
+
+  const double side = 2.0 * m_rule.radius + 1.0;
+
+  // The corners of the block are outside of the circle of the kernel and skipped.
+  const double direct = side * side * std::numbers::pi / 4.0 * ( double ) bounds.x * ( double ) bounds.y;
+  const double fourier = k_direct_per_butterfly * padded * std::log2( padded );
+
+  return direct <= fourier ? Convolution::Direct : Convolution::Fourier;
+}
+
+const size_t game::LeniaEngine::bytes_required( const Vec2< size_t >& bounds ) const {
+  if( convolution( bounds ) == Convolution::Direct ) {
+    return 0;
+  }
+
+  const Vec2< size_t > size = padded( bounds );
+  return 2 * ( size.x / 2 + 1 ) * size.y * sizeof( Complex );
+}
+
+const Vec2< size_t > game::LeniaEngine::padded( const Vec2< size_t >& bounds ) const {
+  // A potential only reaches R cells out, so R zeros past the field keep the cyclic convolution from wrapping.
+  return {
+    std::bit_ceil( std::max< size_t >( bounds.x + m_rule.radius, 2 ) ),
+    std::bit_ceil( bounds.y + m_rule.radius )
+  };
+}
+
+void game::LeniaEngine::step( Field& field, app::ThreadPool& pool ) {
+  app::TraceZone zone( "LeniaEngine::step" );
+
+  if( convolution( field.bounds() ) == Convolution::Direct ) {
+    step_direct( field, pool );
+  }
+  else {
+    step_fourier( field, pool );
+  }
+
+  field.swap();
+}
+
+void game::LeniaEngine::step_direct( Field& field, app::ThreadPool& pool ) {
+  const size_t columns = field.bounds().x;
+  const size_t rows = field.bounds().y;
+  const ptrdiff_t radius = ( ptrdiff_t ) m_rule.radius;
+  const size_t side = 2 * m_rule.radius + 1;
+
+  const float* current = field.current();
+  float* next = field.next();
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    std::vector< float > potentials( columns );
+
+    for( size_t y{ begin }; y < end; ++y ) {
+      std::fill( potentials.begin(), potentials.end(), 0.F );
+
+      // Every weight of the kernel is added for the whole row at once, which vectorises.
+      for( ptrdiff_t dy{ -radius }; dy <= radius; ++dy ) {
+        const ptrdiff_t source = ( ptrdiff_t ) y + dy;
+        if( source < 0 || source >= ( ptrdiff_t ) rows ) {
+          continue;
+        }
+
+        const float* cells = current + ( size_t ) source * columns;
+        const float* weights = m_kernel.data() + ( size_t ) ( dy + radius ) * side;
+
+        for( ptrdiff_t dx{ -radius }; dx <= radius; ++dx ) {
+          const float weight = weights[ dx + radius ];
+          if( weight == 0.F ) {
+            continue;
+          }
+
+          const size_t first = ( size_t ) std::max< ptrdiff_t >( 0, -dx );
+          const size_t last = ( size_t ) std::clamp< ptrdiff_t >( ( ptrdiff_t ) columns - dx, 0, ( ptrdiff_t ) columns );
+
+          for( size_t x{ first }; x < last; ++x ) {
+            potentials[ x ] += weight * cells[ ( ptrdiff_t ) x + dx ];
+          }
+        }
+      }
+
+      grow( m_rule, current + y * columns, potentials.data(), next + y * columns, columns );
+    }
+  } );
+}
+
+void game::LeniaEngine::layout( const Vec2< size_t >& bounds ) {
+  app::TraceZone zone( "LeniaEngine::layout" );
+
+  m_bounds = bounds;
+
+  m_padded = padded( bounds );
+
+  m_rows = RealFft( m_padded.x );
+  m_columns = Fft( m_padded.y );
+
+  const size_t spectrum_width = m_rows.spectrum_size();
+
+  m_spectrum.assign( spectrum_width * m_padded.y, {} );
+  m_kernel_spectrum.assign( spectrum_width * m_padded.y, {} );
+  m_memory.set( ( m_spectrum.size() + m_kernel_spectrum.size() ) * sizeof( Complex ) );
+
+  // The kernel is centred on the first cell, offsets to the left and up wrap around to the end.
+  const ptrdiff_t radius = ( ptrdiff_t ) m_rule.radius;
+  const size_t side = 2 * m_rule.radius + 1;
+
+  std::vector< float > row( m_padded.x );
+  std::vector< Complex > scratch( std::max( m_padded.x / 2, m_padded.y ) );
+
+  for( size_t y{}; y < m_padded.y; ++y ) {
+    std::fill( row.begin(), row.end(), 0.F );
+
+    for( ptrdiff_t dy{ -radius }; dy <= radius; ++dy ) {
+      if( ( size_t ) ( ( dy + ( ptrdiff_t ) m_padded.y ) % ( ptrdiff_t ) m_padded.y ) != y ) {
+        continue;
+      }
+
+      for( ptrdiff_t dx{ -radius }; dx <= radius; ++dx ) {
+        row[ ( size_t ) ( ( dx + ( ptrdiff_t ) m_padded.x ) % ( ptrdiff_t ) m_padded.x ) ] += m_kernel[ ( size_t ) ( dy + radius ) * side + ( size_t ) ( dx + radius ) ];
+      }
+    }
+
+    m_rows.forward( row.data(), m_spectrum.data() + y * spectrum_width, scratch.data() );
+  }
+
+  // Both transforms and their inverses are unnormalised, the inverse along a row halves its length.
+  const float scale = 1.F / ( ( float ) m_padded.y * ( float ) ( m_padded.x / 2 ) );
+
+  for( size_t column{}; column < spectrum_width; ++column ) {
+    Complex* out = m_kernel_spectrum.data() + column * m_padded.y;
+
+    for( size_t y{}; y < m_padded.y; ++y ) {
+      out[ y ] = m_spectrum[ y * spectrum_width + column ];
+    }
+
+    m_columns.forward( out );
+
+    for( size_t y{}; y < m_padded.y; ++y ) {
+      out[ y ] *= scale;
+    }
+  }
+}
+
+void game::LeniaEngine::step_fourier( Field& field, app::ThreadPool& pool ) {
+  if( !( m_bounds == field.bounds() ) ) {
+    layout( field.bounds() );
+  }
+
+  const size_t columns = field.bounds().x;
+  const size_t rows = field.bounds().y;
+  const size_t spectrum_width = m_rows.spectrum_size();
+
+  const float* current = field.current();
+  float* next = field.next();
+
+  // Rows past the field are zero and so are their spectra.
+  pool.parallel_for( m_padded.y, [ & ]( const size_t begin, const size_t end ) {
+    std::vector< float > row( m_padded.x );
+    std::vector< Complex > scratch( m_padded.x / 2 );
+
+    for( size_t y{ begin }; y < end; ++y ) {
+      Complex* out = m_spectrum.data() + y * spectrum_width;
+
+      if( y >= rows ) {
+        std::fill_n( out, spectrum_width, Complex{} );
+        continue;
+      }
+
+      std::copy_n( current + y * columns, columns, row.begin() );
+      m_rows.forward( row.data(), out, scratch.data() );
+    }
+  } );
+
+  // Every column is transformed, multiplied with the kernel and transformed back before it is written out again.
+  // Only the rows of the field are needed after that.
+  const size_t blocks = ( spectrum_width + k_column_block - 1 ) / k_column_block;
+
+  pool.parallel_for( blocks, [ & ]( const size_t begin, const size_t end ) {
+    std::vector< Complex > block( k_column_block * m_padded.y );
+
+    for( size_t index{ begin }; index < end; ++index ) {
+      const size_t first = index * k_column_block;
+      const size_t count = std::min( k_column_block, spectrum_width - first );
+
+      for( size_t y{}; y < m_padded.y; ++y ) {
+        const Complex* in = m_spectrum.data() + y * spectrum_width + first;
+
+        for( size_t i{}; i < count; ++i ) {
+          block[ i * m_padded.y + y ] = in[ i ];
+        }
+      }
+
+      for( size_t i{}; i < count; ++i ) {
+        Complex* column = block.data() + i * m_padded.y;
+        const Complex* kernel = m_kernel_spectrum.data() + ( first + i ) * m_padded.y;
+
+        m_columns.forward( column );
+
+        for( size_t y{}; y < m_padded.y; ++y ) {
+          const Complex a = column[ y ];
+          const Complex b = kernel[ y ];
+          column[ y ] = { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+        }
+
+        m_columns.inverse( column );
+      }
+
+      for( size_t y{}; y < rows; ++y ) {
+        Complex* out = m_spectrum.data() + y * spectrum_width + first;
+
+        for( size_t i{}; i < count; ++i ) {
+          out[ i ] = block[ i * m_padded.y + y ];
+        }
+      }
+    }
+  } );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    std::vector< float > potentials( m_padded.x );
+    std::vector< Complex > scratch( m_padded.x / 2 );
+
+    for( size_t y{ begin }; y < end; ++y ) {
+      m_rows.inverse( m_spectrum.data() + y * spectrum_width, potentials.data(), scratch.data() );
+      grow( m_rule, current + y * columns, potentials.data(), next + y * columns, columns );
+    }
+  } );
+}
+
+const std::vector< std::string_view >& game::lenia_engine_names() {
+  static const std::vector< std::string_view > names = {
+    "direct",
+    "fft",
+    "auto"
+  };
+
+  return names;
+}
+
+std::unique_ptr< game::LeniaEngine > game::make_lenia_engine( const std::string_view& name ) {
+  if( name == "direct" ) {
+    return std::make_unique< LeniaEngine >( Convolution::Direct );
+  }
+
+  if( name == "fft" ) {
+    return std::make_unique< LeniaEngine >( Convolution::Fourier );
+  }
+
+  if( name == "auto" ) {
+    return std::make_unique< LeniaEngine >( Convolution::Automatic );
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,250 @@
+#include <game/engines/life.hpp>
+
+#include <game/activity.hpp>
+#include <game/rule_table.hpp>
+#include <game/universe.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <cstdlib>
+
+void game::ScalarLifeEngine::step( Universe& universe, app::ThreadPool& ) {
+  //
+  // Conway's Game of Life (B3/S23)
+  //    1. Any live cell with fewer than two live neighbors dies, as if by underpopulation.
+  //    2. Any live cell with two or three live neighbors lives on to the next generation.
+  //    3. Any live cell with more than three live neighbors dies, as if by overpopulation.
+  //    4. Any dead cell with exactly three live neighbors becomes a live cell, as if by reproduction.
+  //
+  // Other rules only change the numbers, see game::Rule.
+  //
+  const size_t rows = universe.bounds().y;
+  const size_t columns = universe.bounds().x;
+
+  // Coin flips of the word of 64 cells the current cell is in, under stochastic rules.
+  const size_t words = ( columns + 63 ) / 64;
+  Rule::Chances chances{};
+
+  for( size_t row{ 1 }; row <= rows; ++row ) {
+    for( size_t column{ 1 }; column <= columns; ++column ) {
+      const uint8_t state = universe.get_state( row, column );
+
+      if( m_rule.tabular() ) {
+        universe.set_state( row, column, match_table( universe, row, column ) );
+        continue;
+      }
+
+      if( m_rule.margolus ) {
+        universe.set_state( row, column, match_block( universe, row, column ) );
+        continue;
+      }
+
+      uint8_t next{};
+      if( m_rule.isotropic ) {
+        next = m_rule.next_by_block( state, universe.live_block( row, column ) );
+      }
+      else {
+        size_t live_neighbors{};
+        if( m_rule.larger() ) {
+          live_neighbors = count_larger( universe, row, column );
+        }
+        else if( !m_rule.square() ) {
+          live_neighbors = count_lattice( universe, row, column );
+        }
+        else {
+          live_neighbors = universe.num_alive_neighbors( row, column );
+        }
+
+        next = m_rule.next( state, live_neighbors );
+      }
+
+      if( m_rule.stochastic() ) {
+        const size_t bit = ( column - 1 ) % 64;
+        if( bit == 0 ) {
+          chances = m_rule.chances( universe.generation(), ( row - 1 ) * words + ( column - 1 ) / 64 );
+        }
+
+        // A birth or survival only happens if its coin flip comes up, noise flips the cell afterwards.
+        if( next == 1 ) {
+          next = ( ( state == 0 ? chances.birth : chances.survival ) >> bit ) & 1;
+        }
+
+        next ^= ( chances.noise >> bit ) & 1;
+      }
+
+      universe.set_state( row, column, next );
+    }
+  }
+
+  universe.swap();
+}
+
+const uint8_t game::ScalarLifeEngine::match_block( const Universe& universe, const size_t row, const size_t column ) const {
+  //
+  // Blocks start on odd padded rows and columns in even generations and on even ones in odd generations, so
+  // the blocks along the top and left edges of odd generations and along the bottom and right edges of grids of
+  // the other parity take in the border, which is always dead.
+  //
+  const size_t phase = universe.generation() & 1;
+  const size_t top = row - ( ( row - 1 + phase ) & 1 );
+  const size_t left = column - ( ( column - 1 + phase ) & 1 );
+
+  size_t block{};
+  for( size_t dy{}; dy < 2; ++dy ) {
+    for( size_t dx{}; dx < 2; ++dx ) {
+      if( universe.get_state( top + dy, left + dx ) == 1 ) {
+        block |= ( size_t ) 1 << ( 2 * dy + dx );
+      }
+    }
+  }
+
+  return ( m_rule.blocks[ block ] >> ( 2 * ( row - top ) + column - left ) ) & 1;
+}
+
+const uint8_t game::ScalarLifeEngine::match_table( const Universe& universe, const size_t row, const size_t column ) const {
+  // The cell and its neighbours clockwise from north, in the order of the transitions.
+  const int moore[ 9 ][ 2 ] = { { 0, 0 }, { -1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 }, { 1, 0 }, { 1, -1 }, { 0, -1 }, { -1, -1 } };
+  const int von_neumann[ 5 ][ 2 ] = { { 0, 0 }, { -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 } };
+
+  const RuleTable& table = *m_rule.rule_table;
+  const bool is_moore = table.neighbourhood() == Neighbourhood::Moore;
+
+  uint8_t states[ 9 ];
+  for( size_t cell{}; cell < table.cells(); ++cell ) {
+    const int* offset = is_moore ? moore[ cell ] : von_neumann[ cell ];
+    states[ cell ] = universe.get_state( ( size_t ) ( ( int ) row + offset[ 0 ] ), ( size_t ) ( ( int ) column + offset[ 1 ] ) );
+  }
+
+  return table.match( states );
+}
+
+const size_t game::ScalarLifeEngine::count_larger( const Universe& universe, const size_t row, const size_t column ) const {
+  const int radius = m_rule.radius;
+  const int rows = ( int ) universe.bounds().y;
+  const int columns = ( int ) universe.bounds().x;
+
+  size_t count{};
+
+  // The border is only one cell wide, so everything further out is skipped here.
+  for( int dy{ -radius }; dy <= radius; ++dy ) {
+    const int y = ( int ) row + dy;
+    if( y < 1 || y > rows ) {
+      continue;
+    }
+
+    const int reach = m_rule.neighbourhood == Neighbourhood::Moore ? radius : radius - std::abs( dy );
+
+    for( int dx{ -reach }; dx <= reach; ++dx ) {
+      const int x = ( int ) column + dx;
+      if( x < 1 || x > columns || ( dx == 0 && dy == 0 && !m_rule.middle ) ) {
+        continue;
+      }
+
+      count += universe.get_state( ( size_t ) y, ( size_t ) x ) == 1;
+    }
+  }
+
+  return count;
+}
+
+const size_t game::ScalarLifeEngine::count_lattice( const Universe& universe, const size_t row, const size_t column ) const {
+  const int rows = ( int ) universe.bounds().y;
+  const int columns = ( int ) universe.bounds().x;
+
+  // Odd rows in 0 based grid coordinates are shifted right by half a cell, which is even rows here.
+  const int shift = row % 2 == 0 ? 1 : 0;
+  const int hexagonal[ 6 ][ 2 ] = { { -1, shift - 1 }, { -1, shift }, { 0, -1 }, { 0, 1 }, { 1, shift - 1 }, { 1, shift } };
+
+  // Three triangles on the side of the point of the cell, five on the side of its base and four beside it.
+  const bool up = ( row + column ) % 2 == 0;
+  int triangular[ 12 ][ 2 ]{};
+  size_t neighbours{};
+
+  for( int dy{ -1 }; dy <= 1; ++dy ) {
+    const int reach = ( dy == -1 && up ) || ( dy == 1 && !up ) ? 1 : 2;
+
+    for( int dx{ -reach }; dx <= reach; ++dx ) {
+      if( dx != 0 || dy != 0 ) {
+        triangular[ neighbours ][ 0 ] = dy;
+        triangular[ neighbours ][ 1 ] = dx;
+        ++neighbours;
+      }
+    }
+  }
+
+  const bool is_hexagonal = m_rule.topology == Topology::Hexagonal;
+  const size_t count = is_hexagonal ? 6 : 12;
+
+  size_t live{};
+  for( size_t i{}; i < count; ++i ) {
+    const int* offset = is_hexagonal ? hexagonal[ i ] : triangular[ i ];
+    const int y = ( int ) row + offset[ 0 ];
+    const int x = ( int ) column + offset[ 1 ];
+
+    // Triangles reach two columns out, past the border.
+    if( y < 1 || y > rows || x < 1 || x > columns ) {
+      continue;
+    }
+
+    live += universe.get_state( ( size_t ) y, ( size_t ) x ) == 1;
+  }
+
+  return live;
+}
+
+game::LifeEngine::LifeEngine() {
+  set_rule( m_rule );
+}
+
+void game::LifeEngine::set_rule( const Rule& rule ) {
+  Engine::set_rule( rule );
+
+  for( size_t block{}; block < 512; ++block ) {
+    m_table[ block ] = rule.lives( block );
+  }
+}
+
+void game::LifeEngine::step( Universe& universe, app::ThreadPool& pool ) {
+  app::TraceZone zone( "LifeEngine::step" );
+
+  const size_t rows = universe.bounds().y;
+  const size_t columns = universe.bounds().x;
+  const size_t stride = universe.stride();
+
+  const uint8_t* current = universe.current();
+  uint8_t* next = universe.next();
+
+  // Counted while the rows just written are still in the cache.
+  Activity* activity = Engine::activity( universe );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin + 1 }; row <= end; ++row ) {
+      const uint8_t* above = current + ( row - 1 ) * stride;
+      const uint8_t* cells = current + row * stride;
+      const uint8_t* below = current + ( row + 1 ) * stride;
+
+      uint8_t* out = next + row * stride;
+
+      // Three bits for the cells of a column, top to bottom.
+      const auto bits = [ & ]( const size_t column ) -> size_t {
+        return above[ column ] | ( cells[ column ] << 1 ) | ( below[ column ] << 2 );
+      };
+
+      // The 3 x 3 block around the current cell, every step shifts out the left column and shifts in a new one.
+      size_t block = ( bits( 0 ) << 3 ) | ( bits( 1 ) << 6 );
+
+      for( size_t column{ 1 }; column <= columns; ++column ) {
+        block = ( block >> 3 ) | ( bits( column + 1 ) << 6 );
+
+        out[ column ] = m_table[ block ];
+      }
+
+      if( activity != nullptr ) {
+        activity->count_row( row - 1, cells + 1, out + 1 );
+      }
+    }
+  } );
+
+  universe.swap();
+}
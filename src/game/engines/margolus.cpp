@@ -0,0 +1,153 @@
+#include <game/engines/margolus.hpp>
+
+#include <game/bits.hpp>
+#include <game/activity.hpp>
+#include <game/universe.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+  constexpr uint64_t k_even_bits = 0x5555555555555555;
+
+  // high where the bits of condition are set and low elsewhere.
+  uint64_t select( const uint64_t condition, const uint64_t high, const uint64_t low ) {
+    return low ^ ( ( low ^ high ) & condition );
+  }
+
+  // Packs a row of cells into words, the lowest bit of every word is its first cell.
+  void pack( const uint8_t* cells, const size_t count, uint64_t* words ) {
+    for( size_t first{}; first < count; first += 64 ) {
+      const size_t length = std::min< size_t >( 64, count - first );
+
+      uint64_t word{};
+      for( size_t offset{}; offset < length; offset += 8 ) {
+        uint64_t bytes{};
+        std::memcpy( &bytes, cells + first + offset, std::min< size_t >( 8, length - offset ) );
+
+        word |= game::gather( bytes ) << offset;
+      }
+
+      words[ first / 64 ] = word;
+    }
+  }
+
+  // Unpacks whole words into a cell per byte, the inverse of pack.
+  void unpack( const uint64_t* words, const size_t count, uint8_t* cells ) {
+    for( size_t word{}; word < count; ++word ) {
+      for( size_t offset{}; offset < 64; offset += 8 ) {
+        const uint64_t bytes = game::spread( ( words[ word ] >> offset ) & 0xFF );
+        std::memcpy( cells + word * 64 + offset, &bytes, 8 );
+      }
+    }
+  }
+
+}
+
+game::MargolusEngine::MargolusEngine() :
+  m_selectors{}
+{
+}
+
+void game::MargolusEngine::set_rule( const Rule& rule ) {
+  Engine::set_rule( rule );
+
+  for( size_t cell{}; cell < 4; ++cell ) {
+    for( size_t pair{}; pair < 8; ++pair ) {
+      const uint8_t without = ( rule.blocks[ 2 * pair ] >> cell ) & 1;
+      const uint8_t with = ( rule.blocks[ 2 * pair + 1 ] >> cell ) & 1;
+
+      m_selectors[ cell ][ pair ] = ( uint8_t ) ( without | ( with << 1 ) );
+    }
+  }
+}
+
+void game::MargolusEngine::step( Universe& universe, app::ThreadPool& pool ) {
+  app::TraceZone zone( "MargolusEngine::step" );
+
+  const size_t rows = universe.bounds().y;
+  const size_t columns = universe.bounds().x;
+  const size_t stride = universe.stride();
+
+  // Padded row and column of the top left cell of the first block, see Rule::blocks.
+  const size_t phase = universe.generation() & 1;
+  const size_t first = 1 - phase;
+
+  // Whole blocks from the first one until every cell of the grid is covered.
+  const size_t block_rows = ( rows + phase + 1 ) / 2;
+  const size_t width = ( columns + phase + 1 ) & ~( size_t ) 1;
+  const size_t words = ( width + 63 ) / 64;
+
+  const uint8_t* current = universe.current();
+  uint8_t* next = universe.next();
+
+  Activity* activity = Engine::activity( universe );
+
+  pool.parallel_for( block_rows, [ & ]( const size_t begin, const size_t end ) {
+    std::vector< uint64_t > top( words );
+    std::vector< uint64_t > bottom( words );
+    std::vector< uint8_t > cells( words * 64 );
+
+    for( size_t block_row{ begin }; block_row < end; ++block_row ) {
+      const size_t row = first + 2 * block_row;
+
+      pack( current + row * stride + first, width, top.data() );
+      pack( current + ( row + 1 ) * stride + first, width, bottom.data() );
+
+      for( size_t word{}; word < words; ++word ) {
+        const uint64_t a = top[ word ] & k_even_bits;
+        const uint64_t b = ( top[ word ] >> 1 ) & k_even_bits;
+        const uint64_t c = bottom[ word ] & k_even_bits;
+        const uint64_t d = ( bottom[ word ] >> 1 ) & k_even_bits;
+
+        const uint64_t choices[ 4 ] = { 0, ~a, a, UINT64_MAX };
+
+        uint64_t next_cells[ 4 ];
+        for( size_t cell{}; cell < 4; ++cell ) {
+          const auto& selectors = m_selectors[ cell ];
+
+          uint64_t level[ 8 ];
+          for( size_t pair{}; pair < 8; ++pair ) {
+            level[ pair ] = choices[ selectors[ pair ] ];
+          }
+
+          // Every level halves the candidates on the next cell of the block.
+          for( size_t i{}; i < 4; ++i ) {
+            level[ i ] = select( b, level[ 2 * i + 1 ], level[ 2 * i ] );
+          }
+
+          for( size_t i{}; i < 2; ++i ) {
+            level[ i ] = select( c, level[ 2 * i + 1 ], level[ 2 * i ] );
+          }
+
+          next_cells[ cell ] = select( d, level[ 1 ], level[ 0 ] ) & k_even_bits;
+        }
+
+        top[ word ] = next_cells[ 0 ] | ( next_cells[ 1 ] << 1 );
+        bottom[ word ] = next_cells[ 2 ] | ( next_cells[ 3 ] << 1 );
+      }
+
+      // Bit 0 is the first column of the blocks, a cell left of the grid in odd generations.
+      for( size_t dy{}; dy < 2; ++dy ) {
+        const size_t target = row + dy;
+        if( target == 0 || target > rows ) {
+          continue;
+        }
+
+        unpack( dy == 0 ? top.data() : bottom.data(), words, cells.data() );
+        std::memcpy( next + target * stride + 1, cells.data() + phase, columns );
+
+        if( activity != nullptr ) {
+          activity->count_row( target - 1, current + target * stride + 1, next + target * stride + 1 );
+        }
+      }
+    }
+  } );
+
+  universe.swap();
+}
@@ -0,0 +1,149 @@
+#include <game/engines/multiverse.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <atomic>
+
+namespace {
+
+  // Adds three one digit numbers, bit by bit.
+  void add( const uint64_t a, const uint64_t b, const uint64_t c, uint64_t& sum, uint64_t& carry ) {
+    sum = a ^ b ^ c;
+    carry = ( a & b ) | ( c & ( a ^ b ) );
+  }
+
+}
+
+game::MultiverseEngine::MultiverseEngine() {
+  set_rule( m_rule );
+}
+
+void game::MultiverseEngine::set_rule( const Rule& rule ) {
+  m_rule = rule;
+
+  m_totals_any = 0;
+  m_totals_alive = 0;
+  m_totals_dead = 0;
+
+  // A live cell counts itself in the total.
+  for( size_t total{}; total <= 9; ++total ) {
+    const bool born = total <= 8 && ( ( rule.birth >> total ) & 1 );
+    const bool survives = total >= 1 && ( ( rule.survival >> ( total - 1 ) ) & 1 );
+    const uint16_t bit = ( uint16_t ) ( 1 << total );
+
+    if( born && survives ) {
+      m_totals_any |= bit;
+    }
+    else if( survives ) {
+      m_totals_alive |= bit;
+    }
+    else if( born ) {
+      m_totals_dead |= bit;
+    }
+  }
+}
+
+void game::MultiverseEngine::step( Multiverse& multiverse, app::ThreadPool& pool ) {
+  app::TraceZone zone( "MultiverseEngine::step" );
+
+  const size_t columns = multiverse.bounds().x;
+  const size_t stride = multiverse.stride();
+  const uint64_t* current = multiverse.current();
+  uint64_t* next = multiverse.next();
+
+  //
+  // Only the totals that lead to a live cell are compared with, each as the four digits it has, in three groups
+  // by whether the cell has to be alive, dead or either. Most rules have a few of them: Life has 3 whatever the
+  // cell is and 4 if it is alive.
+  //
+  struct Totals {
+    uint64_t digits[ 10 ][ 4 ];
+    size_t count;
+
+    Totals( const uint16_t mask ) :
+      count{}
+    {
+      for( size_t total{}; total <= 9; ++total ) {
+        if( ( ( mask >> total ) & 1 ) == 0 ) {
+          continue;
+        }
+
+        for( size_t digit{}; digit < 4; ++digit ) {
+          digits[ count ][ digit ] = ( total >> digit ) & 1 ? UINT64_MAX : 0;
+        }
+
+        ++count;
+      }
+    }
+
+    // Cells whose total, given as binary digits, is one of the group.
+    uint64_t matches( const uint64_t n0, const uint64_t n1, const uint64_t n2, const uint64_t n3 ) const {
+      uint64_t result{};
+
+      for( size_t i{}; i < count; ++i ) {
+        result |= ~( ( n0 ^ digits[ i ][ 0 ] ) | ( n1 ^ digits[ i ][ 1 ] ) | ( n2 ^ digits[ i ][ 2 ] ) | ( n3 ^ digits[ i ][ 3 ] ) );
+      }
+
+      return result;
+    }
+  };
+
+  const Totals any( m_totals_any );
+  const Totals alive_only( m_totals_alive );
+  const Totals dead_only( m_totals_dead );
+
+  std::atomic< uint64_t > changed{};
+  std::atomic< uint64_t > changed_twice{};
+
+  pool.parallel_for( multiverse.bounds().y, [ & ]( const size_t begin, const size_t end ) {
+    uint64_t band_changed{};
+    uint64_t band_changed_twice{};
+
+    for( size_t row{ begin + 1 }; row <= end; ++row ) {
+      const uint64_t* above = current + ( row - 1 ) * stride;
+      const uint64_t* cells = current + row * stride;
+      const uint64_t* below = current + ( row + 1 ) * stride;
+      uint64_t* out = next + row * stride;
+
+      // Sums of the three cells of the columns west of, at and east of the cell, as ones and twos.
+      uint64_t west_ones, west_twos, ones, twos;
+      add( above[ 0 ], cells[ 0 ], below[ 0 ], west_ones, west_twos );
+      add( above[ 1 ], cells[ 1 ], below[ 1 ], ones, twos );
+
+      for( size_t column{ 1 }; column <= columns; ++column ) {
+        uint64_t east_ones, east_twos;
+        add( above[ column + 1 ], cells[ column + 1 ], below[ column + 1 ], east_ones, east_twos );
+
+        // The ones are added up into a one and a two, which joins the twos.
+        uint64_t n0, carry, pairs, fours;
+        add( west_ones, ones, east_ones, n0, carry );
+        add( west_twos, twos, east_twos, pairs, fours );
+
+        const uint64_t n1 = pairs ^ carry;
+        const uint64_t n2 = fours ^ ( pairs & carry );
+        const uint64_t n3 = fours & pairs & carry;
+
+        const uint64_t alive = cells[ column ];
+
+        const uint64_t value = any.matches( n0, n1, n2, n3 ) | ( alive & alive_only.matches( n0, n1, n2, n3 ) ) |
+          ( ~alive & dead_only.matches( n0, n1, n2, n3 ) );
+
+        // What is overwritten is the generation before the current one.
+        band_changed |= value ^ alive;
+        band_changed_twice |= value ^ out[ column ];
+        out[ column ] = value;
+
+        west_ones = ones;
+        west_twos = twos;
+        ones = east_ones;
+        twos = east_twos;
+      }
+    }
+
+    changed.fetch_or( band_changed, std::memory_order_relaxed );
+    changed_twice.fetch_or( band_changed_twice, std::memory_order_relaxed );
+  } );
+
+  multiverse.swap( changed.load(), changed_twice.load() );
+}
@@ -0,0 +1,68 @@
+#include <game/engines/table.hpp>
+
+#include <game/activity.hpp>
+#include <game/universe.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+void game::RuleTableEngine::step( Universe& universe, app::ThreadPool& pool ) {
+  app::TraceZone zone( "RuleTableEngine::step" );
+
+  const RuleTable& table = *m_rule.rule_table;
+  const uint8_t* lookup = table.lookup().data();
+  const size_t bits = table.state_bits();
+  const bool moore = table.neighbourhood() == Neighbourhood::Moore;
+
+  const size_t rows = universe.bounds().y;
+  const size_t columns = universe.bounds().x;
+  const size_t stride = universe.stride();
+
+  const uint8_t* current = universe.current();
+  uint8_t* next = universe.next();
+
+  Activity* activity = Engine::activity( universe );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin + 1 }; row <= end; ++row ) {
+      const uint8_t* above = current + ( row - 1 ) * stride;
+      const uint8_t* cells = current + row * stride;
+      const uint8_t* below = current + ( row + 1 ) * stride;
+
+      uint8_t* out = next + row * stride;
+
+      if( !moore ) {
+        // The cell, north, east, south and west.
+        for( size_t column{ 1 }; column <= columns; ++column ) {
+          const size_t index = cells[ column ] |
+            ( ( size_t ) above[ column ] << bits ) |
+            ( ( size_t ) cells[ column + 1 ] << ( 2 * bits ) ) |
+            ( ( size_t ) below[ column ] << ( 3 * bits ) ) |
+            ( ( size_t ) cells[ column - 1 ] << ( 4 * bits ) );
+
+          out[ column ] = lookup[ index ];
+        }
+      }
+      else {
+        // The states of a column, top to bottom.
+        const auto states = [ & ]( const size_t column ) -> size_t {
+          return above[ column ] | ( ( size_t ) cells[ column ] << bits ) | ( ( size_t ) below[ column ] << ( 2 * bits ) );
+        };
+
+        size_t block = ( states( 0 ) << ( 3 * bits ) ) | ( states( 1 ) << ( 6 * bits ) );
+
+        for( size_t column{ 1 }; column <= columns; ++column ) {
+          block = ( block >> ( 3 * bits ) ) | ( states( column + 1 ) << ( 6 * bits ) );
+
+          out[ column ] = lookup[ block ];
+        }
+      }
+
+      if( activity != nullptr ) {
+        activity->count_row( row - 1, cells + 1, out + 1 );
+      }
+    }
+  } );
+
+  universe.swap();
+}
@@ -0,0 +1,243 @@
+#include <game/engines/volume.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <array>
+#include <utility>
+
+namespace {
+
+  // Sums of three cells, two binary digits per cell.
+  struct Sum2 {
+    uint64_t bits[ 2 ];
+  };
+
+  // Sums of a 3 x 3 block, four binary digits per cell.
+  struct Sum4 {
+    uint64_t bits[ 4 ];
+  };
+
+  // Adds three one digit numbers, bit by bit.
+  void add( const uint64_t a, const uint64_t b, const uint64_t c, uint64_t& sum, uint64_t& carry ) {
+    sum = a ^ b ^ c;
+    carry = ( a & b ) | ( c & ( a ^ b ) );
+  }
+
+  // Cells whose total of 27 cells, given as binary digits, is set in the mask.
+  uint64_t matches( const uint32_t mask, const uint64_t ( &total )[ 5 ] ) {
+    uint64_t result{};
+
+    for( size_t count{}; count <= game::VolumeRule::k_neighbours + 1; ++count ) {
+      if( ( ( mask >> count ) & 1 ) == 0 ) {
+        continue;
+      }
+
+      uint64_t equal = UINT64_MAX;
+      for( size_t digit{}; digit < 5; ++digit ) {
+        equal &= ( count >> digit ) & 1 ? total[ digit ] : ~total[ digit ];
+      }
+
+      result |= equal;
+    }
+
+    return result;
+  }
+
+  //
+  // The 3 x 3 sums around every cell of slice z, all zero for the dead slices outside of the volume.
+  // The sums of three cells along x are taken first and kept in rows, then three rows of those are added up.
+  //
+  void sum_slice( const game::Volume& volume, const ptrdiff_t z, std::vector< Sum2 >& rows, std::vector< Sum4 >& sums ) {
+    const size_t row_words = volume.row_words();
+    const size_t height = volume.bounds().y;
+
+    if( z < 0 || ( size_t ) z >= volume.bounds().z ) {
+      std::fill( sums.begin(), sums.end(), Sum4{} );
+      return;
+    }
+
+    for( size_t y{}; y < height; ++y ) {
+      const uint64_t* cells = volume.row( y, ( size_t ) z );
+      Sum2* out = rows.data() + y * row_words;
+
+      // Bit i of a word is cell i of the word, so the west neighbours are shifted up and the east ones down.
+      for( size_t word{}; word < row_words; ++word ) {
+        const uint64_t west = ( cells[ word ] << 1 ) | ( word > 0 ? cells[ word - 1 ] >> 63 : 0 );
+        const uint64_t east = ( cells[ word ] >> 1 ) | ( word + 1 < row_words ? cells[ word + 1 ] << 63 : 0 );
+
+        add( west, cells[ word ], east, out[ word ].bits[ 0 ], out[ word ].bits[ 1 ] );
+      }
+    }
+
+    static constexpr Sum2 k_dead{};
+
+    for( size_t y{}; y < height; ++y ) {
+      Sum4* out = sums.data() + y * row_words;
+
+      for( size_t word{}; word < row_words; ++word ) {
+        const Sum2& above = y > 0 ? rows[ ( y - 1 ) * row_words + word ] : k_dead;
+        const Sum2& here = rows[ y * row_words + word ];
+        const Sum2& below = y + 1 < height ? rows[ ( y + 1 ) * row_words + word ] : k_dead;
+
+        // The ones are added up into a one and a two, which joins the twos.
+        uint64_t ones, twos, pairs, fours;
+        add( above.bits[ 0 ], here.bits[ 0 ], below.bits[ 0 ], ones, twos );
+        add( above.bits[ 1 ], here.bits[ 1 ], below.bits[ 1 ], pairs, fours );
+
+        out[ word ].bits[ 0 ] = ones;
+        out[ word ].bits[ 1 ] = pairs ^ twos;
+        out[ word ].bits[ 2 ] = fours ^ ( pairs & twos );
+        out[ word ].bits[ 3 ] = fours & pairs & twos;
+      }
+    }
+  }
+
+}
+
+void game::ScalarVolumeEngine::step( Volume& volume, app::ThreadPool& pool ) {
+  app::TraceZone zone( "ScalarVolumeEngine::step" );
+
+  const Vec3< size_t > bounds = volume.bounds();
+
+  pool.parallel_for( bounds.z, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t z{ begin }; z < end; ++z ) {
+      for( size_t y{}; y < bounds.y; ++y ) {
+        uint64_t* out = volume.next_row( y, z );
+
+        for( size_t x{}; x < bounds.x; ++x ) {
+          size_t count{};
+
+          for( ptrdiff_t dz{ -1 }; dz <= 1; ++dz ) {
+            for( ptrdiff_t dy{ -1 }; dy <= 1; ++dy ) {
+              for( ptrdiff_t dx{ -1 }; dx <= 1; ++dx ) {
+                if( dx != 0 || dy != 0 || dz != 0 ) {
+                  count += volume.get( ( ptrdiff_t ) x + dx, ( ptrdiff_t ) y + dy, ( ptrdiff_t ) z + dz );
+                }
+              }
+            }
+          }
+
+          const uint64_t bit = ( uint64_t ) 1 << ( x % 64 );
+          if( m_rule.next( volume.get( x, y, z ), count ) ) {
+            out[ x / 64 ] |= bit;
+          }
+          else {
+            out[ x / 64 ] &= ~bit;
+          }
+        }
+      }
+    }
+  } );
+
+  volume.swap();
+}
+
+game::SlicedVolumeEngine::SlicedVolumeEngine() {
+  set_rule( m_rule );
+}
+
+void game::SlicedVolumeEngine::set_rule( const VolumeRule& rule ) {
+  VolumeEngine::set_rule( rule );
+
+  m_survival_totals = 0;
+  m_birth_totals = 0;
+
+  // A live cell counts itself in the total.
+  for( size_t count{}; count <= VolumeRule::k_neighbours; ++count ) {
+    if( rule.survival.contains( count ) ) {
+      m_survival_totals |= ( uint32_t ) 1 << ( count + 1 );
+    }
+
+    if( rule.birth.contains( count ) ) {
+      m_birth_totals |= ( uint32_t ) 1 << count;
+    }
+  }
+}
+
+void game::SlicedVolumeEngine::step( Volume& volume, app::ThreadPool& pool ) {
+  app::TraceZone zone( "SlicedVolumeEngine::step" );
+
+  const Vec3< size_t > bounds = volume.bounds();
+  const size_t row_words = volume.row_words();
+  const uint64_t last_word_mask = volume.last_word_mask();
+
+  // One band per thread, every band sums two slices more than it steps.
+  const size_t grain = ( bounds.z + pool.threads() - 1 ) / pool.threads();
+
+  pool.parallel_for( bounds.z, [ & ]( const size_t begin, const size_t end ) {
+    std::vector< Sum2 > rows( bounds.y * row_words );
+
+    // The sums of the slices below, at and above the one that is being stepped.
+    std::array< std::vector< Sum4 >, 3 > window;
+    for( auto& sums : window ) {
+      sums.resize( bounds.y * row_words );
+    }
+
+    sum_slice( volume, ( ptrdiff_t ) begin - 1, rows, window[ 0 ] );
+    sum_slice( volume, ( ptrdiff_t ) begin, rows, window[ 1 ] );
+
+    for( size_t z{ begin }; z < end; ++z ) {
+      sum_slice( volume, ( ptrdiff_t ) z + 1, rows, window[ 2 ] );
+
+      for( size_t y{}; y < bounds.y; ++y ) {
+        const uint64_t* cells = volume.row( y, z );
+        uint64_t* out = volume.next_row( y, z );
+
+        const Sum4* below = window[ 0 ].data() + y * row_words;
+        const Sum4* here = window[ 1 ].data() + y * row_words;
+        const Sum4* above = window[ 2 ].data() + y * row_words;
+
+        for( size_t word{}; word < row_words; ++word ) {
+          // The three sums are added up digit by digit into sums and carries, which are added up in turn.
+          uint64_t sums[ 4 ], carries[ 4 ];
+          for( size_t digit{}; digit < 4; ++digit ) {
+            add( below[ word ].bits[ digit ], here[ word ].bits[ digit ], above[ word ].bits[ digit ], sums[ digit ], carries[ digit ] );
+          }
+
+          // No more than 27, so the last carry is always clear.
+          uint64_t total[ 5 ];
+          uint64_t carry{};
+
+          total[ 0 ] = sums[ 0 ];
+          for( size_t digit{ 1 }; digit < 4; ++digit ) {
+            add( sums[ digit ], carries[ digit - 1 ], carry, total[ digit ], carry );
+          }
+
+          total[ 4 ] = carries[ 3 ] ^ carry;
+
+          const uint64_t alive = cells[ word ];
+          out[ word ] = ( alive & matches( m_survival_totals, total ) ) | ( ~alive & matches( m_birth_totals, total ) );
+        }
+
+        out[ row_words - 1 ] &= last_word_mask;
+      }
+
+      std::swap( window[ 0 ], window[ 1 ] );
+      std::swap( window[ 1 ], window[ 2 ] );
+    }
+  }, grain );
+
+  volume.swap();
+}
+
+const std::vector< std::string_view >& game::volume_engine_names() {
+  static const std::vector< std::string_view > names = {
+    "scalar",
+    "sliced"
+  };
+
+  return names;
+}
+
+std::unique_ptr< game::VolumeEngine > game::make_volume_engine( const std::string_view& name ) {
+  if( name == "scalar" ) {
+    return std::make_unique< ScalarVolumeEngine >();
+  }
+
+  if( name == "sliced" ) {
+    return std::make_unique< SlicedVolumeEngine >();
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,137 @@
+#include <game/fft.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace {
+
+  // Without the checks for infinities std::complex does in its operator, which keep it from being vectorised.
+  game::Complex multiply( const game::Complex a, const game::Complex b ) {
+    return { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+  }
+
+  std::vector< game::Complex > twiddles( const size_t size, const size_t count ) {
+    std::vector< game::Complex > result( count );
+
+    for( size_t k{}; k < count; ++k ) {
+      const double angle = -2.0 * std::numbers::pi * ( double ) k / ( double ) size;
+      result[ k ] = { ( float ) std::cos( angle ), ( float ) std::sin( angle ) };
+    }
+
+    return result;
+  }
+
+}
+
+game::Fft::Fft( const size_t size ) :
+  m_size( size ),
+  m_twiddles( size > 1 ? size - 1 : 0 ),
+  m_reversed( size )
+{
+  const int bits = std::countr_zero( size );
+
+  for( size_t i{}; i < size; ++i ) {
+    size_t reversed{};
+    for( int bit{}; bit < bits; ++bit ) {
+      reversed |= ( ( i >> bit ) & 1 ) << ( bits - 1 - bit );
+    }
+
+    m_reversed[ i ] = ( uint32_t ) reversed;
+  }
+
+  // The factors of a stage follow each other so that its butterflies read them in order.
+  for( size_t half{ 1 }; half < size; half *= 2 ) {
+    const auto factors = twiddles( 2 * half, half );
+    std::copy( factors.begin(), factors.end(), m_twiddles.begin() + ( half - 1 ) );
+  }
+}
+
+template< bool Inverse >
+void game::Fft::transform( Complex* data ) const {
+  for( size_t i{}; i < m_size; ++i ) {
+    if( i < m_reversed[ i ] ) {
+      std::swap( data[ i ], data[ m_reversed[ i ] ] );
+    }
+  }
+
+  for( size_t half{ 1 }; half < m_size; half *= 2 ) {
+    const Complex* factors = m_twiddles.data() + ( half - 1 );
+
+    for( size_t block{}; block < m_size; block += 2 * half ) {
+      Complex* low = data + block;
+      Complex* high = data + block + half;
+
+      for( size_t i{}; i < half; ++i ) {
+        const Complex twiddle = Inverse ? std::conj( factors[ i ] ) : factors[ i ];
+
+        const Complex even = low[ i ];
+        const Complex odd = multiply( high[ i ], twiddle );
+
+        low[ i ] = even + odd;
+        high[ i ] = even - odd;
+      }
+    }
+  }
+}
+
+void game::Fft::forward( Complex* data ) const {
+  transform< false >( data );
+}
+
+void game::Fft::inverse( Complex* data ) const {
+  transform< true >( data );
+}
+
+game::RealFft::RealFft( const size_t size ) :
+  m_size( size ),
+  m_half( size / 2 ),
+  m_twiddles( twiddles( size, size / 2 + 1 ) )
+{
+}
+
+void game::RealFft::forward( const float* in, Complex* out, Complex* scratch ) const {
+  const size_t half = m_size / 2;
+
+  for( size_t k{}; k < half; ++k ) {
+    scratch[ k ] = { in[ 2 * k ], in[ 2 * k + 1 ] };
+  }
+
+  m_half.forward( scratch );
+
+  // The spectra of the even and odd elements are the conjugate symmetric and antisymmetric parts.
+  for( size_t k{}; k <= half; ++k ) {
+    const Complex z = scratch[ k % half ];
+    const Complex mirrored = std::conj( scratch[ ( half - k ) % half ] );
+
+    const Complex difference = z - mirrored;
+
+    // The odd spectrum is the antisymmetric part divided by 2i.
+    const Complex even = 0.5F * ( z + mirrored );
+    const Complex odd = { 0.5F * difference.imag(), -0.5F * difference.real() };
+
+    out[ k ] = even + multiply( m_twiddles[ k ], odd );
+  }
+}
+
+void game::RealFft::inverse( const Complex* in, float* out, Complex* scratch ) const {
+  const size_t half = m_size / 2;
+
+  for( size_t k{}; k < half; ++k ) {
+    const Complex mirrored = std::conj( in[ half - k ] );
+
+    const Complex even = 0.5F * ( in[ k ] + mirrored );
+    const Complex odd = multiply( 0.5F * ( in[ k ] - mirrored ), std::conj( m_twiddles[ k ] ) );
+
+    scratch[ k ] = even + Complex{ -odd.imag(), odd.real() };
+  }
+
+  m_half.inverse( scratch );
+
+  for( size_t k{}; k < half; ++k ) {
+    out[ 2 * k ] = scratch[ k ].real();
+    out[ 2 * k + 1 ] = scratch[ k ].imag();
+  }
+}
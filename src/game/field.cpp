@@ -0,0 +1,267 @@
+#include <game/field.hpp>
+#include <game/random.hpp>
+
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace {
+
+  bool parse_float( const std::string_view& text, float& out ) {
+    const char* end = text.data() + text.size();
+    const auto result = std::from_chars( text.data(), end, out );
+    return !text.empty() && result.ec == std::errc{} && result.ptr == end && std::isfinite( out );
+  }
+
+  bool parse_unsigned( const std::string_view& text, uint32_t& out ) {
+    const char* end = text.data() + text.size();
+    const auto result = std::from_chars( text.data(), end, out );
+    return !text.empty() && result.ec == std::errc{} && result.ptr == end;
+  }
+
+  // Shortest text that reads back as the same float.
+  std::string format_float( const float value ) {
+    char buffer[ 32 ];
+    const auto result = std::to_chars( buffer, buffer + sizeof( buffer ), value );
+    return std::string( buffer, result.ptr );
+  }
+
+  // Smooth bump over [ 0, 1 ] that peaks at one in the middle, the exponential core of Lenia's kernel rings.
+  double bump( const double r ) {
+    if( r <= 0.0 || r >= 1.0 ) {
+      return 0.0;
+    }
+
+    return std::exp( 4.0 - 1.0 / ( r * ( 1.0 - r ) ) );
+  }
+
+}
+
+const float game::LeniaRule::growth( const float potential ) const {
+  const float distance = ( potential - mu ) / sigma;
+  return 2.F * std::exp( -0.5F * distance * distance ) - 1.F;
+}
+
+const std::vector< float > game::LeniaRule::kernel() const {
+  const ptrdiff_t r = ( ptrdiff_t ) radius;
+  const size_t size = 2 * radius + 1;
+
+  std::vector< double > weights( size * size );
+  double total{};
+
+  for( ptrdiff_t dy{ -r }; dy <= r; ++dy ) {
+    for( ptrdiff_t dx{ -r }; dx <= r; ++dx ) {
+      // Distance from the centre in radii, split into as many rings as there are peaks.
+      const double distance = std::sqrt( ( double ) ( dx * dx + dy * dy ) ) / ( double ) radius;
+      if( distance >= 1.0 ) {
+        continue;
+      }
+
+      const double rings = distance * ( double ) peaks.size();
+      const size_t ring = std::min( ( size_t ) rings, peaks.size() - 1 );
+
+      const double weight = peaks[ ring ] * bump( rings - ( double ) ring );
+
+      weights[ ( size_t ) ( dy + r ) * size + ( size_t ) ( dx + r ) ] = weight;
+      total += weight;
+    }
+  }
+
+  std::vector< float > kernel( weights.size() );
+  for( size_t i{}; i < weights.size(); ++i ) {
+    kernel[ i ] = total > 0.0 ? ( float ) ( weights[ i ] / total ) : 0.F;
+  }
+
+  return kernel;
+}
+
+const std::string game::LeniaRule::to_string() const {
+  std::string text = "R" + std::to_string( radius ) + ",T" + std::to_string( time ) + ",M" + format_float( mu ) + ",S" + format_float( sigma ) + ",B";
+
+  for( size_t i{}; i < peaks.size(); ++i ) {
+    text += ( i == 0 ? "" : ";" ) + format_float( peaks[ i ] );
+  }
+
+  return text;
+}
+
+bool game::parse_lenia_rule( const std::string_view& text, LeniaRule& out ) {
+  LeniaRule rule;
+
+  bool radius = false;
+  bool mu = false;
+
+  size_t begin{};
+  while( begin <= text.size() ) {
+    const size_t end = std::min( text.find( ',', begin ), text.size() );
+    const std::string_view part = text.substr( begin, end - begin );
+    begin = end + 1;
+
+    if( part.empty() ) {
+      return false;
+    }
+
+    const std::string_view value = part.substr( 1 );
+
+    switch( part[ 0 ] ) {
+      case 'R':
+        if( !parse_unsigned( value, rule.radius ) || rule.radius == 0 || rule.radius > LeniaRule::k_max_radius ) {
+          return false;
+        }
+
+        radius = true;
+        break;
+
+      case 'T':
+        if( !parse_unsigned( value, rule.time ) || rule.time == 0 ) {
+          return false;
+        }
+
+        break;
+
+      case 'M':
+        if( !parse_float( value, rule.mu ) ) {
+          return false;
+        }
+
+        mu = true;
+        break;
+
+      case 'S':
+        if( !parse_float( value, rule.sigma ) || rule.sigma <= 0.F ) {
+          return false;
+        }
+
+        break;
+
+      case 'B': {
+        rule.peaks.clear();
+
+        size_t first{};
+        while( first <= value.size() ) {
+          const size_t last = std::min( value.find( ';', first ), value.size() );
+
+          float peak{};
+          if( !parse_float( value.substr( first, last - first ), peak ) || peak < 0.F ) {
+            return false;
+          }
+
+          rule.peaks.push_back( peak );
+          first = last + 1;
+        }
+
+        break;
+      }
+
+      default:
+        return false;
+    }
+  }
+
+  if( !radius || !mu ) {
+    return false;
+  }
+
+  out = rule;
+  return true;
+}
+
+const std::vector< game::NamedRule >& game::named_lenia_rules() {
+  static const std::vector< NamedRule > rules = {
+    { "Orbium", "R13,T10,M0.15,S0.015,B1" }
+  };
+
+  return rules;
+}
+
+game::Field::Field() :
+  m_bounds{},
+  m_memory( app::MemoryCategory::Cells )
+{
+}
+
+void game::Field::reset() {
+  m_bounds = {};
+  m_current.reset();
+  m_next.reset();
+  m_memory.set( 0 );
+}
+
+void game::Field::init( const Vec2< size_t >& bounds ) {
+  m_bounds = bounds;
+
+  // Release the old buffers first so the peak isn't both of them.
+  m_current.reset();
+  m_next.reset();
+
+  m_current = std::make_unique< float[] >( bounds.x * bounds.y );
+  m_next = std::make_unique< float[] >( bounds.x * bounds.y );
+  m_memory.set( bytes_required( bounds ) );
+}
+
+void game::Field::clear() {
+  if( m_current ) {
+    std::fill_n( m_current.get(), m_bounds.x * m_bounds.y, 0.F );
+    std::fill_n( m_next.get(), m_bounds.x * m_bounds.y, 0.F );
+  }
+}
+
+void game::Field::randomise( app::ThreadPool& pool, const uint64_t seed, const double density ) {
+  if( !m_current ) {
+    return;
+  }
+
+  const uint32_t threshold = density_threshold( density );
+
+  // Every row draws from its own stream, like the rows of Universe::randomise.
+  pool.parallel_for( m_bounds.y, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin }; row < end; ++row ) {
+      Xoshiro256 generator{ seed, row };
+      float* cells = m_current.get() + row * m_bounds.x;
+
+      for( size_t column{}; column < m_bounds.x; column += 64 ) {
+        const uint64_t live = bernoulli_bits( generator, threshold );
+        const size_t count = std::min< size_t >( 64, m_bounds.x - column );
+
+        for( size_t i{}; i < count; ++i ) {
+          // The top 24 bits are exactly representable as a float in [ 0, 1 ).
+          cells[ column + i ] = ( ( live >> i ) & 1 ) != 0 ? ( float ) ( generator() >> 40 ) * 0x1.0p-24F : 0.F;
+        }
+      }
+    }
+  } );
+
+  std::copy_n( m_current.get(), m_bounds.x * m_bounds.y, m_next.get() );
+}
+
+const game::Region game::Field::apply( const std::vector< Span >& spans ) {
+  Region region{};
+
+  for( const auto& span : spans ) {
+    const float value = span.state != 0 ? 1.F : 0.F;
+    const size_t offset = span.row * m_bounds.x;
+
+    std::fill( m_current.get() + offset + span.begin, m_current.get() + offset + span.end, value );
+    std::fill( m_next.get() + offset + span.begin, m_next.get() + offset + span.end, value );
+
+    region.merge( { span.begin, span.row, span.end, span.row + 1 } );
+  }
+
+  return region;
+}
+
+void game::Field::swap() {
+  std::swap( m_current, m_next );
+}
+
+const double game::Field::mass() const {
+  double mass{};
+
+  for( size_t i{}; i < m_bounds.x * m_bounds.y; ++i ) {
+    mass += m_current[ i ];
+  }
+
+  return mass;
+}
@@ -0,0 +1,267 @@
+#include <game/finder.hpp>
+
+#include <game/bits.hpp>
+#include <game/universe.hpp>
+
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+
+namespace {
+
+  // Rows of positions whose windows are shifted together, see PatternFinder::find.
+  constexpr size_t k_band_rows = 32;
+
+  // Cells of the window that are tried between looking at whether any position is left.
+  constexpr size_t k_probes = 4;
+
+}
+
+const game::Pattern game::orient( const Pattern& pattern, const size_t orientation ) {
+  const bool transposed = ( orientation & 4 ) != 0;
+  const Vec2< size_t >& bounds = pattern.bounds();
+
+  Pattern oriented( transposed ? Vec2< size_t >{ bounds.y, bounds.x } : bounds );
+
+  for( size_t y{}; y < bounds.y; ++y ) {
+    for( size_t x{}; x < bounds.x; ++x ) {
+      size_t column = transposed ? y : x;
+      size_t row = transposed ? x : y;
+
+      if( orientation & 1 ) {
+        column = oriented.bounds().x - 1 - column;
+      }
+
+      if( orientation & 2 ) {
+        row = oriented.bounds().y - 1 - row;
+      }
+
+      oriented.set( column, row, pattern.get( x, y ) );
+    }
+  }
+
+  return oriented;
+}
+
+game::PatternFinder::PatternFinder() :
+  m_margin{},
+  m_width{},
+  m_row_words{},
+  m_memory( app::MemoryCategory::Cells )
+{
+}
+
+bool game::PatternFinder::compile( const Pattern& pattern, const size_t margin, std::string& error ) {
+  m_orientations.clear();
+  m_margin = margin;
+
+  if( pattern.population() == 0 ) {
+    error = "The pattern has no live cells";
+    return false;
+  }
+
+  const Vec2< size_t >& bounds = pattern.bounds();
+  m_width = std::max( bounds.x, bounds.y ) + 2 * margin;
+
+  if( m_width > k_max_width ) {
+    error = "The pattern and its margin are wider than " + std::to_string( k_max_width ) + " cells";
+    return false;
+  }
+
+  for( size_t orientation{}; orientation < k_orientations; ++orientation ) {
+    const Pattern oriented = orient( pattern, orientation );
+
+    Orientation entry{ ( uint8_t ) orientation, oriented.bounds(), std::vector< uint64_t >( oriented.bounds().y + 2 * margin ), {}, {} };
+
+    for( size_t y{}; y < oriented.bounds().y; ++y ) {
+      for( size_t x{}; x < oriented.bounds().x; ++x ) {
+        if( oriented.get( x, y ) != 0 ) {
+          entry.rows[ y + margin ] |= ( uint64_t ) 1 << ( x + margin );
+        }
+      }
+    }
+
+    // Symmetric patterns look the same in several orientations, which would only find the same cells again.
+    const bool seen = std::any_of( m_orientations.begin(), m_orientations.end(), [ & ]( const Orientation& other ) {
+      return other.bounds == entry.bounds && other.rows == entry.rows;
+    } );
+
+    if( seen ) {
+      continue;
+    }
+
+    const size_t width = entry.bounds.x + 2 * margin;
+
+    for( const bool live : { true, false } ) {
+      for( size_t row{}; row < entry.rows.size(); ++row ) {
+        for( size_t column{}; column < width; ++column ) {
+          if( ( ( entry.rows[ row ] >> column ) & 1 ) == live ) {
+            entry.cells.push_back( ( uint16_t ) ( row * m_width + column ) );
+            entry.inverts.push_back( live ? 0 : UINT64_MAX );
+          }
+        }
+      }
+    }
+
+    // Trying a cell again changes nothing, so the last one fills up the last group.
+    while( entry.cells.size() % k_probes != 0 ) {
+      entry.cells.push_back( entry.cells.back() );
+      entry.inverts.push_back( entry.inverts.back() );
+    }
+
+    m_orientations.push_back( std::move( entry ) );
+  }
+
+  return true;
+}
+
+void game::PatternFinder::pack( const Universe& universe, app::ThreadPool& pool ) {
+  app::TraceZone zone( "PatternFinder::pack" );
+
+  const size_t rows = universe.bounds().y;
+  const size_t columns = universe.bounds().x;
+  const size_t words = ( columns + 63 ) / 64;
+
+  m_row_words = words + 3;
+  m_packed.resize( rows * m_row_words );
+  m_memory.set( m_packed.size() * sizeof( uint64_t ) );
+
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin }; row < end; ++row ) {
+      const uint8_t* cells = universe.current() + ( row + 1 ) * universe.stride() + 1;
+      uint64_t* out = m_packed.data() + row * m_row_words;
+
+      out[ 0 ] = 0;
+
+      for( size_t word{}; word < words; ++word ) {
+        const size_t first = word * 64;
+        const size_t count = std::min< size_t >( 64, columns - first );
+
+        uint64_t bits{};
+
+        if( count == 64 ) {
+          for( size_t offset{}; offset < 64; offset += 8 ) {
+            uint64_t bytes;
+            std::memcpy( &bytes, cells + first + offset, 8 );
+
+            bits |= gather( occupied( bytes ) ) << offset;
+          }
+        }
+        else {
+          for( size_t offset{}; offset < count; offset += 8 ) {
+            uint64_t bytes{};
+            std::memcpy( &bytes, cells + first + offset, std::min< size_t >( 8, count - offset ) );
+
+            bits |= gather( occupied( bytes ) ) << offset;
+          }
+        }
+
+        out[ word + 1 ] = bits;
+      }
+
+      out[ words + 1 ] = 0;
+      out[ words + 2 ] = 0;
+    }
+  } );
+}
+
+const std::vector< game::PatternMatch > game::PatternFinder::find( const Universe& universe, app::ThreadPool& pool ) {
+  app::TraceZone zone( "PatternFinder::find" );
+
+  std::vector< PatternMatch > matches;
+  if( m_orientations.empty() ) {
+    return matches;
+  }
+
+  pack( universe, pool );
+
+  const Vec2< size_t >& bounds = universe.bounds();
+
+  // The window of every orientation fits into a square of this side.
+  const size_t width = m_width;
+
+  // Rows of the margin above and below the universe.
+  const std::vector< uint64_t > dead( m_row_words );
+
+  std::mutex mutex;
+
+  pool.parallel_for( bounds.y, [ & ]( const size_t begin, const size_t end ) {
+    std::vector< PatternMatch > found;
+
+    //
+    // The packed rows that the windows of a band of positions cover, shifted by every column of the window: bit j of
+    // shifts[ t * width + c ] is column c of the window of position first + j on row t of the band. The shifts are
+    // made once for every orientation and every row of the window that needs them.
+    //
+    std::vector< uint64_t > shifts( ( k_band_rows + width ) * width );
+
+    for( size_t band{ begin }; band < end; band += k_band_rows ) {
+      const size_t band_end = std::min( band + k_band_rows, end );
+      const size_t rows = band_end - band + width - 1;
+
+      for( size_t first{}; first < bounds.x; first += 64 ) {
+        for( size_t t{}; t < rows; ++t ) {
+          const size_t source = band + t - m_margin;
+          const uint64_t* words = band + t >= m_margin && source < bounds.y ? m_packed.data() + source * m_row_words : dead.data();
+
+          // Packed column first + j - margin + c, past the word on the left.
+          for( size_t column{}; column < width; ++column ) {
+            const size_t offset = first + 64 - m_margin + column;
+            const size_t word = offset / 64;
+            const size_t shift = offset % 64;
+
+            shifts[ t * width + column ] = shift == 0 ? words[ word ] : ( words[ word ] >> shift ) | ( words[ word + 1 ] << ( 64 - shift ) );
+          }
+        }
+
+        for( size_t y{ band }; y < band_end; ++y ) {
+          const uint64_t* window = shifts.data() + ( y - band ) * width;
+
+          for( const auto& orientation : m_orientations ) {
+            if( orientation.bounds.x > bounds.x || y + orientation.bounds.y > bounds.y ) {
+              continue;
+            }
+
+            const size_t positions = bounds.x - orientation.bounds.x + 1;
+            if( first >= positions ) {
+              continue;
+            }
+
+            uint64_t candidates = positions - first >= 64 ? UINT64_MAX : ( ( uint64_t ) 1 << ( positions - first ) ) - 1;
+
+            const uint16_t* cells = orientation.cells.data();
+            const uint64_t* inverts = orientation.inverts.data();
+
+            for( size_t cell{}; cell < orientation.cells.size() && candidates != 0; cell += k_probes ) {
+              for( size_t i{ cell }; i < cell + k_probes; ++i ) {
+                candidates &= window[ cells[ i ] ] ^ inverts[ i ];
+              }
+            }
+
+            while( candidates != 0 ) {
+              found.push_back( { { first + ( size_t ) std::countr_zero( candidates ), y }, orientation.bounds, orientation.orientation } );
+              candidates &= candidates - 1;
+            }
+          }
+        }
+      }
+    }
+
+    std::lock_guard< std::mutex > lock( mutex );
+    matches.insert( matches.end(), found.begin(), found.end() );
+  } );
+
+  std::sort( matches.begin(), matches.end(), []( const PatternMatch& a, const PatternMatch& b ) {
+    if( a.position.y != b.position.y ) {
+      return a.position.y < b.position.y;
+    }
+
+    return a.position.x != b.position.x ? a.position.x < b.position.x : a.orientation < b.orientation;
+  } );
+
+  return matches;
+}
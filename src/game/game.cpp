@@ -1,4 +1,6 @@
 #include <game/game.hpp>
+#include <game/rule_table.hpp>
+
 
 #include <application.hpp>
 #include <window.hpp>
@@ -6,16 +8,19 @@
 #include <ext/imgui/imgui.h>
 
 #include <colour.hpp>
+#include <thread_pool.hpp>
+#include <profiler.hpp>
+#include <trace.hpp>
 
+#include <chrono>
 #include <memory>
 #include <random>
 #include <algorithm>
+#include <bit>
 #include <functional>
-
-template< typename T >
-T clamp( const T value, const T min, const T max ) {
-  return std::max( std::min( value, max ), min );
-}
+#include <cmath>
+#include <cstdio>
+#include <iterator>
 
 //
 // TODO:  Optimizations are needed.
@@ -32,19 +37,80 @@ T clamp( const T value, const T min, const T max ) {
 //    use a bit operations to represent 8 cells in a single bytem we only need a 0 or 1 for dead or alive
 //
 
+namespace {
+
+  struct Stamp {
+    const char* name;
+    const char* rle;
+  };
+
+  // Matches of a search that are outlined at most, the list of matches shows all of them.
+  constexpr size_t k_max_highlights = 65536;
+
+  // Patterns that are offered by the stamp brush and the finder.
+  constexpr Stamp k_stamps[] = {
+    { "Glider", "bo$2bo$3o!" },
+    { "Lightweight Spaceship", "bo2bo$o4b$o3bo$4o!" },
+    { "R-pentomino", "b2o$2o$bo!" },
+    { "Pulsar", "2b3o3b3o2b2$o4bobo4bo$o4bobo4bo$o4bobo4bo$2b3o3b3o2b2$2b3o3b3o2b$o4bobo4bo$o4bobo4bo$o4bobo4bo2$2b3o3b3o!" },
+    { "Gosper Glider Gun", "24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o4bobo$10bo5bo7bo$11bo3bo$12b2o!" }
+  };
+
+}
+
 game::Game::Game( app::Application* app, app::Window* window ) :
   m_app( app ),
   m_window( window ),
   m_temp_alive_colour{ 1.F, 1.F, 1.F, 1.F },
   m_temp_dead_colour{ 0.F, 0.F, 0.F, 1.F },
   m_bounds{},
+  m_texture_bounds{},
   m_staging{},
   m_texture{},
-  m_texture_resource{}
+  m_texture_resource{},
+  m_texture_memory( app::MemoryCategory::Textures ),
+  m_pixel_memory( app::MemoryCategory::Pixels )
 {
   m_draw_debug = true;
   m_time_scale = 1.F;
   m_running = false;
+  m_seed = 1;
+  m_density = 0.5F;
+  m_workload = 0;
+  m_anchor = ( int ) Anchor::Centre;
+  m_pixel_capacity = 0;
+  m_dirty = {};
+  m_dirty_pixels = {};
+  m_brush_mode = ( int ) BrushMode::Paint;
+  m_brush_radius = 0;
+  m_stamp = 0;
+  m_trace_frames = 120;
+  m_rule = Rule::life();
+  m_engine = make_engine( m_rule );
+  m_rule_text[ 0 ] = '\0';
+  m_simulation = Simulation::Grid;
+  m_depth = 64;
+  m_temp_size_z = m_depth;
+  m_volume_rule = VolumeRule::bays_4555();
+  m_volume_engine = make_volume_engine( "sliced" );
+  m_slice = 0;
+  m_projection = false;
+  m_volume_rule_text[ 0 ] = '\0';
+  m_lenia_rule = LeniaRule::orbium();
+  m_lenia_engine = make_lenia_engine( "auto" );
+  m_lenia_rule_text[ 0 ] = '\0';
+  m_census = {};
+  m_heat_map = false;
+  m_activity_window = ( int ) m_activity.window();
+  m_find_margin = 1;
+  m_highlight = true;
+  std::snprintf( m_find_text, sizeof( m_find_text ), "%s", k_stamps[ 0 ].rle );
+
+  for( const auto& stamp : k_stamps ) {
+    m_stamps.emplace_back().load_rle( stamp.rle );
+  }
+
+  m_brush.set_stamp( &m_stamps[ m_stamp ] );
 
   update_colours();
 }
@@ -59,150 +125,122 @@ game::Game::~Game() {
 }
 
 void game::Game::reset() {
-  if( m_staging ) {
-    m_staging->Release();
-    m_staging = nullptr;
-  }
-
-  if( m_texture ) {
-    m_texture->Release();
-    m_texture = nullptr;
-  }
-
-  if( m_texture_resource ) {
-    m_texture_resource->Release();
-    m_texture_resource = nullptr;
-  }
-
-  if( m_pixel_buffer ) {
-    m_pixel_buffer.release();
-    m_pixel_buffer = nullptr;
-  }
+  release_textures();
 
-  if( m_cells_current ) {
-    m_cells_current.release();
-    m_cells_current = nullptr;
-  }
+  m_pixel_buffer.reset();
+  m_pixel_capacity = 0;
+  m_pixel_memory.set( 0 );
 
-  if( m_cells_next ) {
-    m_cells_next.release();
-    m_cells_next = nullptr;
-  }
+  m_universe.reset();
+  m_volume.reset();
+  m_field.reset();
 }
 
 void game::Game::init( const Vec2< size_t >& bounds ) {
   create_texture_sampler();
 
-  auto& renderer = m_window->renderer();
-  auto device = renderer.device();
-  auto context = renderer.context();
-
   m_bounds = bounds;
 
   // Just update these so the UI reflects it.
   m_temp_size_x = m_bounds.x;
   m_temp_size_y = m_bounds.y;
 
-  m_pixel_buffer = std::make_unique< uint32_t[] >( m_bounds.x * m_bounds.y );
-  memset( m_pixel_buffer.get(), dead_colour(), sizeof( uint32_t ) * m_bounds.x * m_bounds.y );
+  m_universe.init( m_bounds );
 
-  m_cells_current = std::make_unique< uint8_t[] >( ( m_bounds.x + 2 ) * ( m_bounds.y + 2 ) );
-  memset( m_cells_current.get(), 0, m_bounds.x * m_bounds.y );
+  layout_pixels();
 
-  m_cells_next = std::make_unique< uint8_t[] >( ( m_bounds.x + 2 ) * ( m_bounds.y + 2 ) );
-  memset( m_cells_next.get(), 0, m_bounds.x * m_bounds.y );
+  mark_dirty();
+}
 
-  HRESULT hr = S_OK;
+void game::Game::resize( const Vec2< size_t >& bounds, const Anchor anchor ) {
+  if( bounds.x == 0 || bounds.y == 0 ) {
+    return;
+  }
 
-  {
-    D3D11_TEXTURE2D_DESC textureDescription{};
-    memset( &textureDescription, 0, sizeof( textureDescription ) );
+  m_universe.resize( bounds, anchor );
 
-    textureDescription.Width = m_bounds.x;
-    textureDescription.Height = m_bounds.y;
-    textureDescription.ArraySize = 1;
-    textureDescription.SampleDesc.Count = 1;
-    textureDescription.SampleDesc.Quality = 0;
-    textureDescription.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDescription.Usage = D3D11_USAGE_STAGING;
-    textureDescription.BindFlags = 0;
-    textureDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE | D3D11_CPU_ACCESS_READ;
-    textureDescription.MiscFlags = 0;
-    textureDescription.MipLevels = 1;
+  m_bounds = bounds;
 
-    if( FAILED( hr = device->CreateTexture2D( &textureDescription, nullptr, &m_staging ) ) ) {
-      return;
-    }
+  // Neither the volume nor the field keep their cells, there is no telling which slices to keep and continuous
+  // patterns don't survive being cut anyway.
+  switch( m_simulation ) {
+    case Simulation::Volume:
+      m_volume.init( { m_bounds.x, m_bounds.y, m_depth } );
+      m_slice = std::min( m_slice, ( int ) m_depth - 1 );
+      break;
+
+    case Simulation::Continuous:
+      m_field.init( m_bounds );
+      break;
+
+    default:
+      break;
   }
 
-  {
-    D3D11_TEXTURE2D_DESC textureDescription{};
-    memset( &textureDescription, 0, sizeof( textureDescription ) );
+  m_temp_size_x = m_bounds.x;
+  m_temp_size_y = m_bounds.y;
 
-    textureDescription.Width = m_bounds.x;
-    textureDescription.Height = m_bounds.y;
-    textureDescription.ArraySize = 1;
-    textureDescription.SampleDesc.Count = 1;
-    textureDescription.SampleDesc.Quality = 0;
-    textureDescription.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDescription.Usage = D3D11_USAGE_DEFAULT;
-    textureDescription.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-    textureDescription.CPUAccessFlags = 0;
-    textureDescription.MiscFlags = 0;
-    textureDescription.MipLevels = 1;
+  layout_pixels();
 
-    if( FAILED( hr = device->CreateTexture2D( &textureDescription, nullptr, &m_texture ) ) ) {
-      return;
-    }
+  mark_dirty();
+}
 
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
-    ZeroMemory( &srvDesc, sizeof( srvDesc ) );
-    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels = textureDescription.MipLevels;
-    srvDesc.Texture2D.MostDetailedMip = 0;
-    if( FAILED( hr = device->CreateShaderResourceView( m_texture, &srvDesc, &m_texture_resource ) ) ) {
-      return;
-    }
+const uint64_t game::Game::bytes_required( const Vec2< size_t >& bounds, const Topology topology ) {
+  const Vec2< size_t > pixel_bounds = CellMap::pixel_bounds( bounds, topology );
+  const uint64_t pixels = ( uint64_t ) pixel_bounds.x * ( uint64_t ) pixel_bounds.y;
+
+  // Cell buffers, the pixel buffer, two RGBA8 textures and the cell map, which square cells don't need.
+  const uint64_t map = topology == Topology::Square ? 0 : pixels * sizeof( uint32_t );
+  return Universe::bytes_required( bounds ) + pixels * sizeof( uint32_t ) + pixels * 8 + map;
+}
+
+const uint64_t game::Game::bytes_required( const Vec3< size_t >& bounds ) {
+  return bytes_required( { bounds.x, bounds.y }, Topology::Square ) + Volume::bytes_required( bounds );
+}
+
+const uint64_t game::Game::bytes_required( const Vec2< size_t >& bounds, const size_t depth ) const {
+  switch( m_simulation ) {
+    case Simulation::Volume:
+      return bytes_required( { bounds.x, bounds.y, depth } );
+
+    case Simulation::Continuous:
+      // The field is on top of the universe, and so are the spectra if the engine goes through the transform.
+      return bytes_required( bounds, Topology::Square ) + Field::bytes_required( bounds ) + m_lenia_engine->bytes_required( bounds );
+
+    default:
+      return bytes_required( bounds, m_rule.topology );
   }
 }
 
 void game::Game::update( const double t, const double dt ) {
-  //
-  // Conway's Game of Life
-  //    1. Any live cell with fewer than two live neighbors dies, as if by underpopulation.
-  //    2. Any live cell with two or three live neighbors lives on to the next generation.
-  //    3. Any live cell with more than three live neighbors dies, as if by overpopulation.
-  //    4. Any dead cell with exactly three live neighbors becomes a live cell, as if by reproduction.
-  //
-
   m_app->set_time_scale( m_time_scale );
 
   if( !m_running ) {
     return;
   }
 
-  const size_t rows = m_bounds.x;
-  const size_t columns = m_bounds.y;
+  app::ProfileScope scope( app::Phase::Update );
+  app::TraceZone zone( "Game::update" );
 
-  for( size_t column{ 1 }; column <= columns; ++column ) {
-    for( size_t row{ 1 }; row <= rows; ++row ) {
-      const uint8_t state = get_state( row, column );
-      const size_t live_neighbors = num_alive_neighbors( row, column );
+  switch( m_simulation ) {
+    case Simulation::Volume:
+      m_volume_engine->step( m_volume, *app::ThreadPool::get() );
+      break;
 
-      if( live_neighbors == 3 ) {
-        set_state( row, column, 1 );
-      } 
-      else if( live_neighbors == 2 ) {
-        set_state( row, column, state );
-      }
-      else if( !( live_neighbors == 3 || live_neighbors == 2 ) ) {
-        set_state( row, column, 0 );
+    case Simulation::Continuous:
+      m_lenia_engine->step( m_field, *app::ThreadPool::get() );
+      break;
+
+    default:
+      m_engine->step( m_universe, *app::ThreadPool::get() );
+
+      if( m_heat_map ) {
+        m_activity.advance( m_universe, *app::ThreadPool::get(), m_engine->counts_activity() );
       }
-    }
+      break;
   }
 
-  std::swap( m_cells_current, m_cells_next );
+  mark_dirty();
 }
 
 void game::Game::draw() {
@@ -216,20 +254,47 @@ void game::Game::draw() {
     m_running = !m_running;
   }
 
+  if( ImGui::IsKeyPressed( ImGuiKey_T ) ) {
+    if( app::Tracer::recording() ) {
+      app::Tracer::get()->stop();
+    }
+    else {
+      app::Tracer::get()->start( "trace.json", ( size_t ) m_trace_frames );
+    }
+  }
+
   draw_debug_metrics();
 
   const auto& mouse = ImGui::GetMousePos();
 
-  // If the game is not running, let the user select which pixels are alive before the simulation begins again.
-  if( !m_running ) {
-    const float remapped_mouse_x = clamp( ( mouse.x / m_window->width() ) * m_bounds.x, 0.F, ( float ) m_bounds.x );
-    const float remapped_mouse_y = clamp( ( mouse.y / m_window->height() ) * m_bounds.y, 0.F, ( float ) m_bounds.y );
+  // If the game is not running, let the user paint cells before the simulation begins again.
+  const bool painting = !m_running && ImGui::IsMouseDown( ImGuiMouseButton_Left ) && !ImGui::GetIO().WantCaptureMouse;
+
+  if( painting && !m_brush.stroking() ) {
+    m_brush.begin_stroke();
+  }
+  else if( !painting && m_brush.stroking() ) {
+    m_brush.end_stroke();
+  }
+
+  // Mouse move messages only arrive when the mouse moves, so sample the current position as well.
+  m_brush.add_sample( to_cell( mouse.x, mouse.y ) );
 
-    if( ImGui::IsMouseDown( ImGuiMouseButton_Left ) ) {
-      const size_t row = ( size_t ) remapped_mouse_y;
-      const size_t column = ( size_t ) remapped_mouse_x;
+  // Everything that was painted since the last frame is written out in one batch.
+  m_brush.rasterise( m_bounds, m_spans );
+  if( !m_spans.empty() ) {
+    switch( m_simulation ) {
+      case Simulation::Volume:
+        m_dirty.merge( m_volume.apply( m_spans, ( size_t ) m_slice ) );
+        break;
 
-      set_states( row + 1, column + 1, 1 );
+      case Simulation::Continuous:
+        m_dirty.merge( m_field.apply( m_spans ) );
+        break;
+
+      default:
+        m_dirty.merge( m_universe.apply( m_spans ) );
+        break;
     }
   }
 
@@ -260,6 +325,116 @@ void game::Game::draw() {
     { 0.F, 0.F },
     { ( float ) m_window->width(), ( float ) m_window->height() }
   );
+
+  draw_heat_map( draw_list );
+  draw_matches( draw_list );
+}
+
+void game::Game::randomise( const uint64_t seed, const float density ) {
+  app::TraceZone zone( "Game::randomise" );
+
+  switch( m_simulation ) {
+    case Simulation::Volume:
+      m_volume.randomise( *app::ThreadPool::get(), seed, density );
+      break;
+
+    case Simulation::Continuous:
+      m_field.randomise( *app::ThreadPool::get(), seed, density );
+      break;
+
+    default:
+      m_universe.randomise( *app::ThreadPool::get(), seed, density );
+      m_activity.clear();
+      m_matches.clear();
+      break;
+  }
+
+  // Stochastic rules draw their coin flips from the same seed, so a soup plays out the same way every time.
+  if( m_rule.stochastic() ) {
+    m_rule.seed = seed;
+    m_engine->set_rule( m_rule );
+  }
+
+  mark_dirty();
+}
+
+void game::Game::load( const Workload& workload ) {
+  set_simulation( Simulation::Grid );
+
+  resize( workload.size, Anchor::TopLeft );
+
+  game::load_workload( workload, m_universe, *app::ThreadPool::get() );
+  m_activity.clear();
+  m_matches.clear();
+
+  mark_dirty();
+}
+
+void game::Game::set_rule( const Rule& rule ) {
+  const bool layout = rule.topology != m_rule.topology;
+
+  m_rule = rule;
+  m_rule.seed = m_seed;
+  m_engine = make_engine( m_rule );
+  m_engine->set_activity( m_heat_map ? &m_activity : nullptr );
+
+  m_universe.restrict_states( m_rule.states );
+
+  if( layout ) {
+    layout_pixels();
+  }
+
+  update_colours();
+  mark_dirty();
+}
+
+void game::Game::set_simulation( const Simulation simulation ) {
+  if( simulation == m_simulation ) {
+    return;
+  }
+
+  if( simulation == Simulation::Volume ) {
+    const Vec3< size_t > bounds = { m_bounds.x, m_bounds.y, std::max< size_t >( m_temp_size_z, 1 ) };
+
+    if( !app::fits_in_memory( bytes_required( bounds ) ) ) {
+      m_simulation_status = "Refused " + std::to_string( bounds.z ) + " slices, it would page";
+      return;
+    }
+
+    m_depth = bounds.z;
+    m_slice = std::min( m_slice, ( int ) m_depth - 1 );
+  }
+
+  if( simulation == Simulation::Continuous ) {
+    const uint64_t required = bytes_required( m_bounds, Topology::Square ) + Field::bytes_required( m_bounds ) + m_lenia_engine->bytes_required( m_bounds );
+
+    if( !app::fits_in_memory( required ) ) {
+      m_simulation_status = "Refused a continuous field, it would page";
+      return;
+    }
+  }
+
+  // Only the cells of the universe outlive a switch, the others start out empty again.
+  m_volume.reset();
+  m_field.reset();
+
+  if( simulation == Simulation::Volume ) {
+    m_volume.init( { m_bounds.x, m_bounds.y, m_depth } );
+  }
+  else if( simulation == Simulation::Continuous ) {
+    m_field.init( m_bounds );
+  }
+
+  m_simulation = simulation;
+  m_simulation_status.clear();
+
+  layout_pixels();
+
+  mark_dirty();
+}
+
+void game::Game::on_mouse_move( const int x, const int y ) {
+  m_brush.add_sample( to_cell( ( float ) x, ( float ) y ) );
 }
 
 void game::Game::create_texture_sampler() {
@@ -279,145 +454,1084 @@ void game::Game::create_texture_sampler() {
   m_window->renderer().device()->CreateSamplerState( &desc, &m_texture_sampler );
 }
 
-void game::Game::update_texture() {
-  //
-  // Copies the pixel buffer to the staging textures buffer.
-  //
+void game::Game::layout_pixels() {
+  // Volumes are drawn slice by slice and fields cell by cell, both on the square grid.
+  m_cell_map.build( m_bounds, m_simulation == Simulation::Grid ? m_rule.topology : Topology::Square );
 
-  auto& renderer = m_window->renderer();
-  auto device = renderer.device();
-  auto context = renderer.context();
+  const Vec2< size_t >& pixel_bounds = m_cell_map.pixel_bounds();
 
-  if( m_staging == nullptr || m_texture == nullptr ) {
-    return;
+  // The pixel buffer is rebuilt every frame so its contents don't need to survive, only its allocation.
+  const size_t pixels = pixel_bounds.x * pixel_bounds.y;
+  if( pixels > m_pixel_capacity ) {
+    m_pixel_capacity = pixels;
+    m_pixel_buffer = std::make_unique< uint32_t[] >( m_pixel_capacity );
+    m_pixel_memory.set( m_pixel_capacity * sizeof( uint32_t ) );
   }
 
-  D3D11_MAPPED_SUBRESOURCE subresource;
-  if( FAILED( context->Map(
-    m_staging,
-    0,
-    D3D11_MAP_WRITE,
-    0,
-    &subresource
-  ) ) ) {
-    return;
+  if( !( m_texture_bounds == pixel_bounds ) ) {
+    release_textures();
+    create_textures();
   }
+}
 
-  if( subresource.pData == nullptr ) {
-    return;
-  }
+void game::Game::create_textures() {
+  auto device = m_window->renderer().device();
 
-  memcpy(
-    subresource.pData,
-    m_pixel_buffer.get(),
-    sizeof( uint32_t ) * m_bounds.x * m_bounds.y
-  );
+  const Vec2< size_t >& pixel_bounds = m_cell_map.pixel_bounds();
 
-  context->Unmap( m_staging, 0 );
+  HRESULT hr = S_OK;
 
-  //
-  // Copy the staging texture to the texture that has a shader resource bound to it.
-  //
-  context->CopyResource( m_texture, m_staging );
-}
+  {
+    D3D11_TEXTURE2D_DESC textureDescription{};
+    memset( &textureDescription, 0, sizeof( textureDescription ) );
 
-void game::Game::update_pixel_buffer() {
-  const size_t rows = m_bounds.x;
-  const size_t columns = m_bounds.y;
+    textureDescription.Width = ( UINT ) pixel_bounds.x;
+    textureDescription.Height = ( UINT ) pixel_bounds.y;
+    textureDescription.ArraySize = 1;
+    textureDescription.SampleDesc.Count = 1;
+    textureDescription.SampleDesc.Quality = 0;
+    textureDescription.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    textureDescription.Usage = D3D11_USAGE_STAGING;
+    textureDescription.BindFlags = 0;
+    textureDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE | D3D11_CPU_ACCESS_READ;
+    textureDescription.MiscFlags = 0;
+    textureDescription.MipLevels = 1;
 
-  for( size_t column{ 1 }; column <= columns; ++column ) {
-    for( size_t row{ 1 }; row <= rows; ++row ) {
-      const uint8_t state = get_state( row, column );
-      const uint32_t colour = ( state == 1 ) ? alive_colour() : dead_colour();
-      set_pixel( row, column, colour );
+    if( FAILED( hr = device->CreateTexture2D( &textureDescription, nullptr, &m_staging ) ) ) {
+      return;
     }
   }
-}
-
-void game::Game::draw_debug_metrics() {
-  if( !m_draw_debug ) {
-    return;
-  }
 
-  ImGui::Begin( "Settings" );
   {
-    ImGui::Text( "FPS: %.2f (%.8f)", m_app->frames_per_second(), m_app->delta_time() );
-
-    ImGui::Checkbox( "Run", &m_running );
-    ImGui::SliderFloat( "Time Scale", &m_time_scale, 0.01F, 2.F );
-
-    ImGui::InputScalar( "Grid Size X", ImGuiDataType_U64, &m_temp_size_x );
-    ImGui::InputScalar( "Grid Size Y", ImGuiDataType_U64, &m_temp_size_y );
+    D3D11_TEXTURE2D_DESC textureDescription{};
+    memset( &textureDescription, 0, sizeof( textureDescription ) );
 
-    if( ImGui::Button( "Reset" ) ) {
-      m_running = false;
+    textureDescription.Width = ( UINT ) pixel_bounds.x;
+    textureDescription.Height = ( UINT ) pixel_bounds.y;
+    textureDescription.ArraySize = 1;
+    textureDescription.SampleDesc.Count = 1;
+    textureDescription.SampleDesc.Quality = 0;
+    textureDescription.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    textureDescription.Usage = D3D11_USAGE_DEFAULT;
+    textureDescription.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    textureDescription.CPUAccessFlags = 0;
+    textureDescription.MiscFlags = 0;
+    textureDescription.MipLevels = 1;
 
-      reset();
-      init( { m_temp_size_x, m_temp_size_y } );
+    if( FAILED( hr = device->CreateTexture2D( &textureDescription, nullptr, &m_texture ) ) ) {
+      return;
     }
 
-    if( ImGui::Button( "Random" ) ) {
-      m_running = false;
-
-      reset();
-      init( m_bounds );
-
-      std::random_device r;
-      std::default_random_engine e1( r() );
-      std::uniform_int_distribution< int > uniform_dist( 0, 1 );
-
-      for( size_t column{ 1 }; column <= m_bounds.y; ++column ) {
-        for( size_t row{ 1 }; row <= m_bounds.x; ++row ) {
-          set_states( row, column, uniform_dist( e1 ) );
-        }
-      }
-
-      m_running = true;
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+    ZeroMemory( &srvDesc, sizeof( srvDesc ) );
+    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = textureDescription.MipLevels;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    if( FAILED( hr = device->CreateShaderResourceView( m_texture, &srvDesc, &m_texture_resource ) ) ) {
+      return;
     }
+  }
 
-    {
-      bool update = false;
-
-      update = update || ImGui::ColorPicker4( "Alive Colour", m_temp_alive_colour );
-      update = update || ImGui::ColorPicker4( "Dead Colour", m_temp_dead_colour );
+  m_texture_bounds = pixel_bounds;
 
-      if( update ) {
-        update_colours();
-      }
-    }
+  // Both textures are RGBA8, what the driver pads them to isn't visible from here.
+  m_texture_memory.set( 2 * pixel_bounds.x * pixel_bounds.y * 4 );
+}
 
-    ImGui::End();
+void game::Game::release_textures() {
+  if( m_staging ) {
+    m_staging->Release();
+    m_staging = nullptr;
   }
-}
 
-const uint8_t game::Game::get_state( const size_t row, const size_t column ) {
-  return m_cells_current[ row * ( m_bounds.x + 2 ) + column ];
-}
+  if( m_texture ) {
+    m_texture->Release();
+    m_texture = nullptr;
+  }
 
-void game::Game::set_state( const size_t row, const size_t column, const uint8_t state ) {
-  m_cells_next[ row * ( m_bounds.x + 2 ) + column ] = state;
-}
+  if( m_texture_resource ) {
+    m_texture_resource->Release();
+    m_texture_resource = nullptr;
+  }
 
-void game::Game::set_states( const size_t row, const size_t column, const uint8_t state ) {
-  m_cells_current[ row * ( m_bounds.x + 2 ) + column ] = state;
-  m_cells_next[ row * ( m_bounds.x + 2 ) + column ] = state;
-}
+  m_texture_bounds = {};
 
-void game::Game::set_pixel( const size_t x, const size_t y, const uint32_t colour ) {
-  const size_t index = ( x - 1 ) * m_bounds.x + ( y - 1 );
-  m_pixel_buffer[ index ] = colour;
+  m_texture_memory.set( 0 );
 }
 
-const size_t game::Game::num_alive_neighbors( const size_t row, const size_t column ) {
-  return m_cells_current[ ( row - 1 ) * ( m_bounds.x + 2 ) + ( column ) ] +
-    m_cells_current[ ( row ) * ( m_bounds.x + 2 ) + ( column - 1 ) ] +
-    m_cells_current[ ( row - 1 ) * ( m_bounds.x + 2 ) + ( column - 1 ) ] +
-    m_cells_current[ ( row + 1 ) * ( m_bounds.x + 2 ) + ( column ) ] +
-    m_cells_current[ ( row ) * ( m_bounds.x + 2 ) + ( column + 1 ) ] +
-    m_cells_current[ ( row + 1 ) * ( m_bounds.x + 2 ) + ( column + 1 ) ] +
-    m_cells_current[ ( row + 1 ) * ( m_bounds.x + 2 ) + ( column - 1 ) ] +
-    m_cells_current[ ( row - 1 ) * ( m_bounds.x + 2 ) + ( column + 1 ) ];
-}
+void game::Game::update_texture() {
+  //
+  // Copies the dirty part of the pixel buffer to the staging textures buffer.
+  //
+
+  auto& renderer = m_window->renderer();
+  auto context = renderer.context();
+
+  if( m_staging == nullptr || m_texture == nullptr || m_dirty_pixels.empty() ) {
+    return;
+  }
+
+  const Region& dirty = m_dirty_pixels;
+  const size_t pixel_width = m_cell_map.pixel_bounds().x;
+
+  {
+    app::ProfileScope scope( app::Phase::TextureMap );
+    app::TraceZone zone( "Texture Map" );
+
+    D3D11_MAPPED_SUBRESOURCE subresource;
+    if( FAILED( context->Map(
+      m_staging,
+      0,
+      D3D11_MAP_WRITE,
+      0,
+      &subresource
+    ) ) ) {
+      return;
+    }
+
+    if( subresource.pData == nullptr ) {
+      return;
+    }
+
+    // Rows of the mapped texture may be padded, so copy them one at a time.
+    const size_t width = dirty.right - dirty.left;
+
+    for( size_t row{ dirty.top }; row < dirty.bottom; ++row ) {
+      memcpy(
+        ( uint8_t* ) subresource.pData + row * subresource.RowPitch + dirty.left * sizeof( uint32_t ),
+        m_pixel_buffer.get() + row * pixel_width + dirty.left,
+        sizeof( uint32_t ) * width
+      );
+    }
+
+    context->Unmap( m_staging, 0 );
+  }
+
+  //
+  // Copy the dirty part of the staging texture to the texture that has a shader resource bound to it.
+  //
+  app::ProfileScope scope( app::Phase::TextureCopy );
+  app::TraceZone zone( "Texture Copy" );
+
+  D3D11_BOX box{};
+  box.left = ( UINT ) dirty.left;
+  box.top = ( UINT ) dirty.top;
+  box.front = 0;
+  box.right = ( UINT ) dirty.right;
+  box.bottom = ( UINT ) dirty.bottom;
+  box.back = 1;
+
+  context->CopySubresourceRegion( m_texture, 0, box.left, box.top, 0, m_staging, 0, &box );
+
+  m_dirty = {};
+  m_dirty_pixels = {};
+}
+
+void game::Game::update_pixel_buffer() {
+  if( m_dirty.empty() ) {
+    return;
+  }
+
+  app::ProfileScope scope( app::Phase::PixelBuffer );
+  app::TraceZone zone( "Pixel Buffer" );
+
+  if( app::Tracer::recording() ) {
+    app::Tracer::get()->counter( "Dirty cells", ( double ) ( ( m_dirty.right - m_dirty.left ) * ( m_dirty.bottom - m_dirty.top ) ) );
+  }
+
+  m_dirty_pixels = m_cell_map.pixels( m_dirty );
+
+  if( m_simulation == Simulation::Volume ) {
+    update_volume_pixels();
+    return;
+  }
+
+  if( m_simulation == Simulation::Continuous ) {
+    update_field_pixels();
+    return;
+  }
+
+  if( m_rule.square() ) {
+    for( size_t row{ m_dirty.top }; row < m_dirty.bottom; ++row ) {
+      const uint8_t* cells = m_universe.current() + ( row + 1 ) * m_universe.stride() + 1;
+      uint32_t* pixels = m_pixel_buffer.get() + row * m_bounds.x;
+
+      for( size_t column{ m_dirty.left }; column < m_dirty.right; ++column ) {
+        pixels[ column ] = m_palette[ cells[ column ] ];
+      }
+    }
+
+    return;
+  }
+
+  // Every pixel looks up its cell in the map, the cell indices already include the border.
+  const uint8_t* cells = m_universe.current();
+  const uint32_t* map = m_cell_map.cells();
+  const size_t pixel_width = m_cell_map.pixel_bounds().x;
+
+  for( size_t row{ m_dirty_pixels.top }; row < m_dirty_pixels.bottom; ++row ) {
+    const uint32_t* indices = map + row * pixel_width;
+    uint32_t* pixels = m_pixel_buffer.get() + row * pixel_width;
+
+    for( size_t x{ m_dirty_pixels.left }; x < m_dirty_pixels.right; ++x ) {
+      pixels[ x ] = m_palette[ cells[ indices[ x ] ] ];
+    }
+  }
+}
+
+void game::Game::update_volume_pixels() {
+  const uint32_t dead = m_palette[ 0 ];
+
+  if( !m_projection ) {
+    const uint32_t alive = m_palette[ 1 ];
+
+    for( size_t row{ m_dirty.top }; row < m_dirty.bottom; ++row ) {
+      const uint64_t* words = m_volume.row( row, ( size_t ) m_slice );
+      uint32_t* pixels = m_pixel_buffer.get() + row * m_bounds.x;
+
+      for( size_t column{ m_dirty.left }; column < m_dirty.right; ++column ) {
+        pixels[ column ] = ( ( words[ column / 64 ] >> ( column % 64 ) ) & 1 ) != 0 ? alive : dead;
+      }
+    }
+
+    return;
+  }
+
+  // Nearer slices are drawn in colours closer to the alive colour, the furthest ones fade into the dead colour.
+  std::vector< uint32_t > shades( m_depth );
+  for( size_t z{}; z < m_depth; ++z ) {
+    shades[ z ] = Colour::lerp( m_alive_colour, m_dead_colour, ( float ) z / ( float ) m_depth ).argb();
+  }
+
+  for( size_t row{ m_dirty.top }; row < m_dirty.bottom; ++row ) {
+    uint32_t* pixels = m_pixel_buffer.get() + row * m_bounds.x;
+    std::fill( pixels + m_dirty.left, pixels + m_dirty.right, dead );
+
+    // Walks into the volume a word of columns at a time until every column of the word has hit a live cell.
+    for( size_t word{ m_dirty.left / 64 }; word < ( m_dirty.right + 63 ) / 64; ++word ) {
+      uint64_t remaining = UINT64_MAX;
+
+      for( size_t z{}; z < m_depth && remaining != 0; ++z ) {
+        uint64_t hits = m_volume.row( row, z )[ word ] & remaining;
+        remaining &= ~hits;
+
+        for( ; hits != 0; hits &= hits - 1 ) {
+          pixels[ word * 64 + ( size_t ) std::countr_zero( hits ) ] = shades[ z ];
+        }
+      }
+    }
+  }
+}
+
+void game::Game::update_field_pixels() {
+  for( size_t row{ m_dirty.top }; row < m_dirty.bottom; ++row ) {
+    const float* cells = m_field.current() + row * m_bounds.x;
+    uint32_t* pixels = m_pixel_buffer.get() + row * m_bounds.x;
+
+    for( size_t column{ m_dirty.left }; column < m_dirty.right; ++column ) {
+      pixels[ column ] = m_gradient[ ( size_t ) ( cells[ column ] * 255.F + 0.5F ) ];
+    }
+  }
+}
+
+void game::Game::draw_profiler() {
+  if( !ImGui::CollapsingHeader( "Profiler" ) ) {
+    return;
+  }
+
+  auto profiler = app::Profiler::get();
+
+  bool enabled = app::Profiler::enabled();
+  if( ImGui::Checkbox( "Enabled", &enabled ) ) {
+    app::Profiler::set_enabled( enabled );
+  }
+
+  ImGui::SameLine();
+  if( ImGui::Button( "Clear##profiler" ) ) {
+    profiler->clear();
+  }
+
+  ImGui::SameLine();
+  if( ImGui::Button( "Dump CSV" ) ) {
+    m_profile_status = profiler->dump_csv( "profile.csv" ) ? "Wrote profile.csv" : "Failed to write profile.csv";
+  }
+
+  if( !m_profile_status.empty() ) {
+    ImGui::TextUnformatted( m_profile_status.c_str() );
+  }
+
+  // Colour of every phase in the plot, in the order of app::Phase.
+  static constexpr ImU32 k_phase_colours[ app::k_phase_count ] = {
+    IM_COL32( 230, 85, 70, 255 ),
+    IM_COL32( 240, 170, 60, 255 ),
+    IM_COL32( 90, 190, 90, 255 ),
+    IM_COL32( 60, 170, 200, 255 ),
+    IM_COL32( 140, 110, 220, 255 ),
+    IM_COL32( 150, 150, 150, 255 )
+  };
+
+  if( ImGui::BeginTable( "Phases", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg ) ) {
+    ImGui::TableSetupColumn( "Phase" );
+    ImGui::TableSetupColumn( "Last (ms)" );
+    ImGui::TableSetupColumn( "p50" );
+    ImGui::TableSetupColumn( "p95" );
+    ImGui::TableSetupColumn( "p99" );
+    ImGui::TableSetupColumn( "Max" );
+    ImGui::TableHeadersRow();
+
+    for( size_t phase{}; phase < app::k_phase_count; ++phase ) {
+      const auto statistics = profiler->statistics( ( app::Phase ) phase );
+
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextColored( ImGui::ColorConvertU32ToFloat4( k_phase_colours[ phase ] ), "%s", app::Profiler::name( ( app::Phase ) phase ) );
+      ImGui::TableNextColumn();
+      ImGui::Text( "%.3f", statistics.last );
+      ImGui::TableNextColumn();
+      ImGui::Text( "%.3f", statistics.p50 );
+      ImGui::TableNextColumn();
+      ImGui::Text( "%.3f", statistics.p95 );
+      ImGui::TableNextColumn();
+      ImGui::Text( "%.3f", statistics.p99 );
+      ImGui::TableNextColumn();
+      ImGui::Text( "%.3f", statistics.max );
+    }
+
+    ImGui::EndTable();
+  }
+
+  //
+  // Stacked plot, one bar per frame with the phases stacked bottom up.
+  //
+  size_t frames = app::Profiler::k_history;
+  for( size_t phase{}; phase < app::k_phase_count; ++phase ) {
+    profiler->history( ( app::Phase ) phase, m_profile_history[ phase ] );
+    frames = std::min( frames, m_profile_history[ phase ].size() );
+  }
+
+  float peak = 0.F;
+  for( size_t frame{}; frame < frames; ++frame ) {
+    float total = 0.F;
+    for( const auto& history : m_profile_history ) {
+      total += history[ history.size() - frames + frame ];
+    }
+
+    peak = std::max( peak, total );
+  }
+
+  const float width = std::max( ImGui::GetContentRegionAvail().x, 1.F );
+  const float height = 120.F;
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  const float bar = width / ( float ) app::Profiler::k_history;
+
+  ImDrawList* draw_list = ImGui::GetWindowDrawList();
+  draw_list->AddRectFilled( origin, { origin.x + width, origin.y + height }, IM_COL32( 20, 20, 20, 255 ) );
+
+  if( peak > 0.F ) {
+    for( size_t frame{}; frame < frames; ++frame ) {
+      const float x = origin.x + ( float ) frame * bar;
+      float y = origin.y + height;
+
+      for( size_t phase{}; phase < app::k_phase_count; ++phase ) {
+        const auto& history = m_profile_history[ phase ];
+        const float h = history[ history.size() - frames + frame ] / peak * height;
+
+        draw_list->AddRectFilled( { x, y - h }, { x + bar, y }, k_phase_colours[ phase ] );
+        y -= h;
+      }
+    }
+  }
+
+  ImGui::Dummy( { width, height } );
+  ImGui::Text( "Peak frame: %.3f ms over %zu frames", peak, frames );
+}
+
+void game::Game::draw_tracer() {
+  if( !ImGui::CollapsingHeader( "Trace" ) ) {
+    return;
+  }
+
+  auto tracer = app::Tracer::get();
+
+  ImGui::InputInt( "Frames##trace", &m_trace_frames );
+  m_trace_frames = std::max( m_trace_frames, 0 );
+
+  if( app::Tracer::recording() ) {
+    if( ImGui::Button( "Stop (T)" ) ) {
+      tracer->stop();
+    }
+  }
+  else if( ImGui::Button( "Record (T)" ) ) {
+    tracer->start( "trace.json", ( size_t ) m_trace_frames );
+  }
+
+  if( !tracer->status().empty() ) {
+    ImGui::TextUnformatted( tracer->status().c_str() );
+  }
+}
+
+void game::Game::draw_memory() {
+  if( !ImGui::CollapsingHeader( "Memory" ) ) {
+    return;
+  }
+
+  auto tracker = app::MemoryTracker::get();
+  const double cells = ( double ) m_bounds.x * ( double ) m_bounds.y;
+
+  if( ImGui::BeginTable( "Memory", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg ) ) {
+    ImGui::TableSetupColumn( "Subsystem" );
+    ImGui::TableSetupColumn( "Bytes" );
+    ImGui::TableSetupColumn( "Bytes/cell" );
+    ImGui::TableHeadersRow();
+
+    const auto row = [ & ]( const char* name, const uint64_t bytes ) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted( name );
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted( app::format_bytes( bytes ).c_str() );
+      ImGui::TableNextColumn();
+      ImGui::Text( "%.2f", cells == 0.0 ? 0.0 : ( double ) bytes / cells );
+    };
+
+    for( size_t category{}; category < app::k_memory_category_count; ++category ) {
+      row( app::MemoryTracker::name( ( app::MemoryCategory ) category ), tracker->bytes( ( app::MemoryCategory ) category ) );
+    }
+
+    row( "Total", tracker->total() );
+
+    ImGui::EndTable();
+  }
+
+  ImGui::Text( "Physical: %s available of %s",
+    app::format_bytes( app::MemoryTracker::available_physical() ).c_str(),
+    app::format_bytes( app::MemoryTracker::total_physical() ).c_str() );
+}
+
+void game::Game::draw_volume() {
+  if( m_simulation != Simulation::Volume || !ImGui::CollapsingHeader( "Volume" ) ) {
+    return;
+  }
+
+  if( ImGui::SliderInt( "Slice", &m_slice, 0, ( int ) m_depth - 1 ) ) {
+    mark_dirty();
+  }
+
+  if( ImGui::Checkbox( "Projection", &m_projection ) ) {
+    mark_dirty();
+  }
+
+  const auto& rules = game::named_volume_rules();
+
+  const char* preview = "Custom";
+  for( const auto& named : rules ) {
+    VolumeRule rule;
+    if( parse_volume_rule( named.rule, rule ) && rule == m_volume_rule ) {
+      preview = named.name;
+    }
+  }
+
+  VolumeRule rule;
+  bool update = false;
+
+  if( ImGui::BeginCombo( "Volume Rule", preview ) ) {
+    for( const auto& named : rules ) {
+      if( ImGui::Selectable( named.name, named.name == preview ) ) {
+        update = parse_volume_rule( named.rule, rule );
+      }
+    }
+
+    ImGui::EndCombo();
+  }
+
+  ImGui::InputTextWithHint( "##volume_rule", m_volume_rule.to_string().c_str(), m_volume_rule_text, sizeof( m_volume_rule_text ) );
+  ImGui::SameLine();
+  if( ImGui::Button( "Set Volume Rule" ) ) {
+    update = parse_volume_rule( m_volume_rule_text, rule );
+
+    if( !update ) {
+      m_simulation_status = "Not a rule, expected e.g. 4555 or 4/5/10/12";
+    }
+  }
+
+  if( update ) {
+    m_volume_rule = rule;
+    m_volume_engine->set_rule( m_volume_rule );
+    m_simulation_status.clear();
+  }
+
+  ImGui::Text( "%s on the %s engine, %zu slices", m_volume_rule.to_string().c_str(), m_volume_engine->name(), m_depth );
+}
+
+void game::Game::draw_continuous() {
+  if( m_simulation != Simulation::Continuous || !ImGui::CollapsingHeader( "Continuous" ) ) {
+    return;
+  }
+
+  const auto& rules = game::named_lenia_rules();
+
+  const char* preview = "Custom";
+  for( const auto& named : rules ) {
+    LeniaRule rule;
+    if( parse_lenia_rule( named.rule, rule ) && rule == m_lenia_rule ) {
+      preview = named.name;
+    }
+  }
+
+  LeniaRule rule;
+  bool update = false;
+
+  if( ImGui::BeginCombo( "Continuous Rule", preview ) ) {
+    for( const auto& named : rules ) {
+      if( ImGui::Selectable( named.name, named.name == preview ) ) {
+        update = parse_lenia_rule( named.rule, rule );
+      }
+    }
+
+    ImGui::EndCombo();
+  }
+
+  ImGui::InputTextWithHint( "##lenia_rule", m_lenia_rule.to_string().c_str(), m_lenia_rule_text, sizeof( m_lenia_rule_text ) );
+  ImGui::SameLine();
+  if( ImGui::Button( "Set Continuous Rule" ) ) {
+    update = parse_lenia_rule( m_lenia_rule_text, rule );
+
+    if( !update ) {
+      m_simulation_status = "Not a rule, expected e.g. R13,T10,M0.15,S0.015,B1";
+    }
+  }
+
+  if( update ) {
+    m_lenia_rule = rule;
+    m_lenia_engine->set_rule( m_lenia_rule );
+    m_simulation_status.clear();
+  }
+
+  const bool direct = m_lenia_engine->convolution( m_bounds ) == Convolution::Direct;
+  ImGui::Text( "%s on the %s engine (%s convolution)", m_lenia_rule.to_string().c_str(), m_lenia_engine->name(), direct ? "direct" : "fourier" );
+}
+
+void game::Game::draw_census() {
+  if( m_simulation != Simulation::Grid || !ImGui::CollapsingHeader( "Census" ) ) {
+    return;
+  }
+
+  if( ImGui::Button( "Take Census" ) ) {
+    if( !census_supports( m_rule ) ) {
+      m_census = {};
+      m_census_status = "No census under " + m_rule.to_string() + ", it needs two states on the square grid and empty space that stays empty";
+    }
+    else {
+      const auto start = std::chrono::steady_clock::now();
+      m_census = take_census( m_universe, m_rule, *app::ThreadPool::get() );
+      const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+      m_census_status = std::to_string( m_census.islands ) + " islands of " + std::to_string( m_census.cells ) + " cells in " +
+        std::to_string( ( int ) ( seconds * 1000.0 ) ) + " ms";
+    }
+  }
+
+  if( !m_census_status.empty() ) {
+    ImGui::TextUnformatted( m_census_status.c_str() );
+  }
+
+  if( m_census.objects.empty() ) {
+    return;
+  }
+
+  if( ImGui::BeginTable( "Census", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, { 0.F, 300.F } ) ) {
+    ImGui::TableSetupScrollFreeze( 0, 1 );
+    ImGui::TableSetupColumn( "Object" );
+    ImGui::TableSetupColumn( "Count" );
+    ImGui::TableSetupColumn( "Period" );
+    ImGui::TableSetupColumn( "Displacement" );
+    ImGui::TableHeadersRow();
+
+    ImGuiListClipper clipper;
+    clipper.Begin( ( int ) m_census.objects.size() );
+
+    while( clipper.Step() ) {
+      for( int i{ clipper.DisplayStart }; i < clipper.DisplayEnd; ++i ) {
+        const auto& object = m_census.objects[ ( size_t ) i ];
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted( object.code.c_str() );
+        ImGui::TableNextColumn();
+        ImGui::Text( "%zu", object.count );
+        ImGui::TableNextColumn();
+        ImGui::Text( "%zu", object.period );
+        ImGui::TableNextColumn();
+        ImGui::Text( "%lld, %lld", ( long long ) object.displacement.x, ( long long ) object.displacement.y );
+      }
+    }
+
+    ImGui::EndTable();
+  }
+}
+
+void game::Game::mark_dirty() {
+  m_dirty = { 0, 0, m_bounds.x, m_bounds.y };
+}
+
+void game::Game::draw_activity() {
+  if( m_simulation != Simulation::Grid || !ImGui::CollapsingHeader( "Activity" ) ) {
+    return;
+  }
+
+  if( ImGui::Checkbox( "Heat Map", &m_heat_map ) ) {
+    m_activity.clear();
+    m_engine->set_activity( m_heat_map ? &m_activity : nullptr );
+  }
+
+  if( ImGui::SliderInt( "Window", &m_activity_window, ( int ) Activity::k_buckets, 4096, "%d generations", ImGuiSliderFlags_Logarithmic ) ) {
+    m_activity.set_window( ( size_t ) m_activity_window );
+  }
+
+  if( !m_heat_map ) {
+    return;
+  }
+
+  ImGui::Text(
+    "%s, the most active tile changed %u times in %zu generations",
+    m_engine->counts_activity() ? "Counted while stepping" : "Compared after stepping",
+    m_activity.peak(),
+    m_activity.window()
+  );
+
+  const auto tiles = m_activity.hottest( 64 );
+  if( tiles.empty() ) {
+    return;
+  }
+
+  if( ImGui::BeginTable( "Activity", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, { 0.F, 200.F } ) ) {
+    ImGui::TableSetupScrollFreeze( 0, 1 );
+    ImGui::TableSetupColumn( "Tile" );
+    ImGui::TableSetupColumn( "Cells" );
+    ImGui::TableSetupColumn( "Changes" );
+    ImGui::TableHeadersRow();
+
+    for( const auto& tile : tiles ) {
+      const Region region = m_activity.region( tile.tile );
+
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text( "%d, %d", tile.tile.x, tile.tile.y );
+      ImGui::TableNextColumn();
+      ImGui::Text( "%zu, %zu to %zu, %zu", region.left, region.top, region.right, region.bottom );
+      ImGui::TableNextColumn();
+      ImGui::Text( "%u", tile.changes );
+    }
+
+    ImGui::EndTable();
+  }
+}
+
+void game::Game::draw_heat_map( ImDrawList* draw_list ) {
+  if( !m_heat_map || m_simulation != Simulation::Grid || !( m_activity.bounds() == m_bounds ) ) {
+    return;
+  }
+
+  const uint32_t peak = m_activity.peak();
+  if( peak == 0 ) {
+    return;
+  }
+
+  const Vec2< size_t >& pixels = m_cell_map.pixel_bounds();
+  const float scale_x = ( float ) m_window->width() / ( float ) pixels.x;
+  const float scale_y = ( float ) m_window->height() / ( float ) pixels.y;
+
+  for( size_t y{}; y < m_activity.tiles().y; ++y ) {
+    for( size_t x{}; x < m_activity.tiles().x; ++x ) {
+      const uint32_t changes = m_activity.changes( x, y );
+      if( changes == 0 ) {
+        continue;
+      }
+
+      // Quiet tiles still show a little, so that nothing that moves is missed.
+      const int alpha = 32 + ( int ) ( 160.0 * changes / peak );
+      const Region region = m_cell_map.pixels( m_activity.region( { ( int ) x, ( int ) y } ) );
+
+      draw_list->AddRectFilled(
+        { region.left * scale_x, region.top * scale_y },
+        { region.right * scale_x, region.bottom * scale_y },
+        IM_COL32( 255, 48, 0, alpha )
+      );
+    }
+  }
+}
+
+void game::Game::draw_finder() {
+  if( m_simulation != Simulation::Grid || !ImGui::CollapsingHeader( "Find" ) ) {
+    return;
+  }
+
+  if( ImGui::BeginCombo( "Preset", nullptr, ImGuiComboFlags_NoPreview ) ) {
+    for( const auto& stamp : k_stamps ) {
+      if( ImGui::Selectable( stamp.name ) ) {
+        std::snprintf( m_find_text, sizeof( m_find_text ), "%s", stamp.rle );
+      }
+    }
+
+    ImGui::EndCombo();
+  }
+
+  ImGui::InputText( "Pattern", m_find_text, sizeof( m_find_text ) );
+  ImGui::SliderInt( "Margin", &m_find_margin, 0, 8 );
+  ImGui::Checkbox( "Highlight", &m_highlight );
+
+  if( ImGui::Button( "Find" ) ) {
+    Pattern pattern;
+    std::string error;
+
+    m_matches.clear();
+
+    if( !pattern.load_rle( m_find_text ) ) {
+      m_find_status = "The pattern isn't in run length encoding, e.g. bo$2bo$3o!";
+    }
+    else if( !m_finder.compile( pattern, ( size_t ) m_find_margin, error ) ) {
+      m_find_status = error;
+    }
+    else {
+      const auto start = std::chrono::steady_clock::now();
+      m_matches = m_finder.find( m_universe, *app::ThreadPool::get() );
+      const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+      m_find_status = std::to_string( m_matches.size() ) + " matches in " + std::to_string( m_finder.orientations() ) + " orientations in " +
+        std::to_string( ( int ) ( seconds * 1000.0 ) ) + " ms";
+    }
+  }
+
+  if( !m_find_status.empty() ) {
+    ImGui::TextUnformatted( m_find_status.c_str() );
+  }
+
+  if( m_matches.empty() ) {
+    return;
+  }
+
+  if( ImGui::BeginTable( "Matches", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, { 0.F, 200.F } ) ) {
+    ImGui::TableSetupScrollFreeze( 0, 1 );
+    ImGui::TableSetupColumn( "Cell" );
+    ImGui::TableSetupColumn( "Size" );
+    ImGui::TableSetupColumn( "Orientation" );
+    ImGui::TableHeadersRow();
+
+    ImGuiListClipper clipper;
+    clipper.Begin( ( int ) m_matches.size() );
+
+    while( clipper.Step() ) {
+      for( int i{ clipper.DisplayStart }; i < clipper.DisplayEnd; ++i ) {
+        const auto& match = m_matches[ ( size_t ) i ];
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text( "%zu, %zu", match.position.x, match.position.y );
+        ImGui::TableNextColumn();
+        ImGui::Text( "%zu x %zu", match.bounds.x, match.bounds.y );
+        ImGui::TableNextColumn();
+        ImGui::Text( "%u", ( unsigned ) match.orientation );
+      }
+    }
+
+    ImGui::EndTable();
+  }
+}
+
+void game::Game::draw_matches( ImDrawList* draw_list ) {
+  if( !m_highlight || m_simulation != Simulation::Grid ) {
+    return;
+  }
+
+  const Vec2< size_t >& pixels = m_cell_map.pixel_bounds();
+  const float scale_x = ( float ) m_window->width() / ( float ) pixels.x;
+  const float scale_y = ( float ) m_window->height() / ( float ) pixels.y;
+
+  const size_t count = std::min( m_matches.size(), k_max_highlights );
+
+  for( size_t i{}; i < count; ++i ) {
+    const auto& match = m_matches[ i ];
+
+    // Matches of a search before the universe shrank.
+    if( match.position.x + match.bounds.x > m_bounds.x || match.position.y + match.bounds.y > m_bounds.y ) {
+      continue;
+    }
+
+    const Region region = m_cell_map.pixels( {
+      match.position.x,
+      match.position.y,
+      match.position.x + match.bounds.x,
+      match.position.y + match.bounds.y
+    } );
+
+    // A pixel out on every side, so that a match stays visible however small the cells are drawn.
+    draw_list->AddRect(
+      { region.left * scale_x - 1.F, region.top * scale_y - 1.F },
+      { region.right * scale_x + 1.F, region.bottom * scale_y + 1.F },
+      IM_COL32( 0, 200, 255, 255 )
+    );
+  }
+}
+
+const Vec2i game::Game::to_cell( const float x, const float y ) const {
+  const Vec2< size_t >& pixels = m_cell_map.pixel_bounds();
+
+  return m_cell_map.cell( {
+    ( int ) std::floor( ( x / m_window->width() ) * pixels.x ),
+    ( int ) std::floor( ( y / m_window->height() ) * pixels.y )
+  } );
+}
+
+void game::Game::draw_debug_metrics() {
+  if( !m_draw_debug ) {
+    return;
+  }
+
+  ImGui::Begin( "Settings" );
+  {
+    ImGui::Text( "FPS: %.2f (%.8f)", m_app->frames_per_second(), m_app->delta_time() );
+
+    ImGui::Checkbox( "Run", &m_running );
+    ImGui::SliderFloat( "Time Scale", &m_time_scale, 0.01F, 2.F );
+
+    int simulation = ( int ) m_simulation;
+    if( ImGui::Combo( "Simulation", &simulation, "Grid\0Volume\0Continuous\0" ) ) {
+      set_simulation( ( Simulation ) simulation );
+    }
+
+    if( !m_simulation_status.empty() ) {
+      ImGui::TextUnformatted( m_simulation_status.c_str() );
+    }
+
+    ImGui::InputScalar( "Grid Size X", ImGuiDataType_U64, &m_temp_size_x );
+    ImGui::InputScalar( "Grid Size Y", ImGuiDataType_U64, &m_temp_size_y );
+
+    if( m_simulation == Simulation::Volume ) {
+      ImGui::InputScalar( "Grid Size Z", ImGuiDataType_U64, &m_temp_size_z );
+    }
+
+    ImGui::Combo( "Anchor", &m_anchor, "Top Left\0Centre\0" );
+
+    {
+      const Vec2< size_t > size = { m_temp_size_x, m_temp_size_y };
+      const size_t depth = m_simulation == Simulation::Volume ? std::max< size_t >( m_temp_size_z, 1 ) : 1;
+
+      const uint64_t required = bytes_required( size, depth );
+      const bool fits = app::fits_in_memory( required );
+
+      ImGui::Text( "Needs %s (%.1f bytes/cell)", app::format_bytes( required ).c_str(),
+        size.x * size.y == 0 ? 0.0 : ( double ) required / ( ( double ) size.x * ( double ) size.y * ( double ) depth ) );
+
+      if( !fits ) {
+        ImGui::TextColored( { 1.F, 0.4F, 0.4F, 1.F }, "Won't fit into %s of available memory", app::format_bytes( app::MemoryTracker::available_physical() ).c_str() );
+      }
+
+      if( ImGui::Button( "Resize" ) ) {
+        if( fits ) {
+          m_resize_status.clear();
+
+          if( m_simulation == Simulation::Volume ) {
+            m_depth = depth;
+          }
+
+          resize( size, ( Anchor ) m_anchor );
+        }
+        else {
+          m_resize_status = "Refused " + std::to_string( size.x ) + "x" + std::to_string( size.y ) + ", it would page";
+        }
+      }
+
+      if( !m_resize_status.empty() ) {
+        ImGui::TextUnformatted( m_resize_status.c_str() );
+      }
+    }
+
+    ImGui::SameLine();
+    if( ImGui::Button( "Clear" ) ) {
+      m_running = false;
+
+      switch( m_simulation ) {
+        case Simulation::Volume:
+          m_volume.clear();
+          break;
+
+        case Simulation::Continuous:
+          m_field.clear();
+          break;
+
+        default:
+          m_universe.clear();
+          break;
+      }
+
+      mark_dirty();
+    }
+
+    ImGui::InputScalar( "Seed", ImGuiDataType_U64, &m_seed );
+    ImGui::SameLine();
+    if( ImGui::Button( "New Seed" ) ) {
+      std::random_device r;
+      m_seed = ( ( uint64_t ) r() << 32 ) | r();
+    }
+
+    ImGui::SliderFloat( "Density", &m_density, 0.F, 1.F );
+
+    if( ImGui::Button( "Random" ) ) {
+      randomise( m_seed, m_density );
+
+      m_running = true;
+    }
+
+    {
+      const auto& workloads = game::workloads();
+
+      if( ImGui::BeginCombo( "Workload", workloads[ m_workload ].id ) ) {
+        for( int i{}; i < ( int ) workloads.size(); ++i ) {
+          if( ImGui::Selectable( workloads[ i ].id, i == m_workload ) ) {
+            m_workload = i;
+          }
+
+          if( ImGui::IsItemHovered() ) {
+            ImGui::SetTooltip( "%s", workloads[ i ].description );
+          }
+        }
+
+        ImGui::EndCombo();
+      }
+
+      ImGui::SameLine();
+      if( ImGui::Button( "Load" ) ) {
+        m_running = false;
+
+        load( workloads[ m_workload ] );
+      }
+    }
+
+    {
+      const auto& rules = game::named_rules();
+
+      // A rule typed in by hand may not have a name.
+      const char* preview = "Custom";
+      for( const auto& named : rules ) {
+        Rule rule;
+        if( !parse_rule( named.rule, rule ) ) {
+          continue;
+        }
+
+        // The notation doesn't carry the seed of stochastic rules.
+        rule.seed = m_rule.seed;
+        if( rule == m_rule ) {
+          preview = named.name;
+        }
+      }
+
+      if( ImGui::BeginCombo( "Rule", preview ) ) {
+        for( const auto& named : rules ) {
+          if( ImGui::Selectable( named.name, named.name == preview ) ) {
+            Rule rule;
+            parse_rule( named.rule, rule );
+            set_rule( rule );
+
+            m_rule_status.clear();
+          }
+
+          if( ImGui::IsItemHovered() ) {
+            ImGui::SetTooltip( "%s", named.rule );
+          }
+        }
+
+        ImGui::EndCombo();
+      }
+
+      ImGui::InputTextWithHint( "##rule", m_rule.to_string().c_str(), m_rule_text, sizeof( m_rule_text ) );
+      ImGui::SameLine();
+      if( ImGui::Button( "Set Rule" ) ) {
+        const std::string_view text = m_rule_text;
+
+        Rule rule;
+        std::string error;
+
+        if( parse_rule( text, rule ) ) {
+          set_rule( rule );
+          m_rule_status.clear();
+        }
+        else if( text.ends_with( ".rule" ) ) {
+          if( load_rule_file( m_rule_text, rule, error ) ) {
+            set_rule( rule );
+            m_rule_status.clear();
+          }
+          else {
+            m_rule_status = error;
+          }
+        }
+        else {
+          m_rule_status = "Not a rule, expected e.g. B3/S23, B2/S/C3, B2/S34H, R5,C0,M1,S33..57,B34..45,NM, MS,D0;8;4;3;2;5;9;7;1;6;10;11;12;13;14;15 or a .rule file";
+        }
+      }
+
+      ImGui::Text( "%s on the %s engine", m_rule.to_string().c_str(), m_engine->name() );
+
+      if( !m_rule_status.empty() ) {
+        ImGui::TextUnformatted( m_rule_status.c_str() );
+      }
+    }
+
+    {
+      bool update = false;
+
+      update |= ImGui::Combo( "Brush", &m_brush_mode, "Paint\0Erase\0Stamp\0" );
+      update |= ImGui::SliderInt( "Brush Radius", &m_brush_radius, 0, 64 );
+
+      if( ImGui::BeginCombo( "Stamp", k_stamps[ m_stamp ].name ) ) {
+        for( int i{}; i < ( int ) m_stamps.size(); ++i ) {
+          if( ImGui::Selectable( k_stamps[ i ].name, i == m_stamp ) ) {
+            m_stamp = i;
+            update = true;
+          }
+        }
+
+        ImGui::EndCombo();
+      }
+
+      if( update ) {
+        m_brush.set_mode( ( BrushMode ) m_brush_mode );
+        m_brush.set_radius( m_brush_radius );
+        m_brush.set_stamp( &m_stamps[ m_stamp ] );
+      }
+    }
+
+    {
+      bool update = false;
+
+      update |= ImGui::ColorPicker4( "Alive Colour", m_temp_alive_colour );
+      update |= ImGui::ColorPicker4( "Dead Colour", m_temp_dead_colour );
+
+      if( update ) {
+        update_colours();
+        mark_dirty();
+      }
+    }
+
+    draw_volume();
+
+    draw_continuous();
+
+    draw_census();
+
+    draw_activity();
+
+    draw_finder();
+
+    draw_profiler();
+
+    draw_tracer();
+
+    draw_memory();
+
+    ImGui::End();
+  }
+}
 
 const uint32_t game::Game::alive_colour() const {
   return m_alive_colour.argb();
@@ -441,4 +1555,38 @@ void game::Game::update_colours() {
     ( uint8_t ) ( m_temp_dead_colour[ 2 ] * 255.F ),
     ( uint8_t ) ( m_temp_dead_colour[ 3 ] * 255.F )
   };
+
+  m_palette.fill( dead_colour() );
+  m_palette[ 1 ] = alive_colour();
+
+  for( size_t state{ 2 }; state < m_rule.states; ++state ) {
+    m_palette[ state ] = Colour::lerp( m_alive_colour, m_dead_colour, ( float ) ( state - 1 ) / ( float ) ( m_rule.states - 1 ) ).argb();
+  }
+
+  // Continuous values go from the dead colour through a few fixed ones to the alive colour, so small differences
+  // in value stay visible.
+  const Colour stops[] = {
+    m_dead_colour,
+    Colour{ 32, 64, 160, 255 },
+    Colour{ 64, 192, 192, 255 },
+    Colour{ 240, 224, 96, 255 },
+    m_alive_colour
+  };
+
+  constexpr size_t segments = std::size( stops ) - 1;
+
+  for( size_t value{}; value < m_gradient.size(); ++value ) {
+    const float t = ( float ) value / ( float ) ( m_gradient.size() - 1 ) * ( float ) segments;
+    const size_t segment = std::min( ( size_t ) t, segments - 1 );
+
+    m_gradient[ value ] = Colour::lerp( stops[ segment ], stops[ segment + 1 ], t - ( float ) segment ).argb();
+  }
+
+  // Rule tables may come with colours of their own.
+  for( size_t state{ 1 }; m_rule.tabular() && state < m_rule.states; ++state ) {
+    const uint32_t colour = m_rule.rule_table->colour( state );
+    if( colour != 0 ) {
+      m_palette[ state ] = colour;
+    }
+  }
 }
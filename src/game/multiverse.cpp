@@ -0,0 +1,148 @@
+#include <game/multiverse.hpp>
+
+#include <game/random.hpp>
+#include <game/universe.hpp>
+
+#include <thread_pool.hpp>
+
+#include <cstring>
+#include <utility>
+
+game::Multiverse::Multiverse() :
+  m_bounds{},
+  m_generation{},
+  m_changed{},
+  m_changed_twice{},
+  m_memory( app::MemoryCategory::Cells )
+{
+}
+
+void game::Multiverse::init( const Vec2< size_t >& bounds ) {
+  m_bounds = bounds;
+
+  m_cells_current = std::make_unique< uint64_t[] >( size() );
+  m_cells_next = std::make_unique< uint64_t[] >( size() );
+  m_memory.set( bytes_required( bounds ) );
+
+  m_generation = 0;
+  m_changed = UINT64_MAX;
+  m_changed_twice = UINT64_MAX;
+}
+
+void game::Multiverse::clear() {
+  m_generation = 0;
+  m_changed = UINT64_MAX;
+  m_changed_twice = UINT64_MAX;
+
+  if( m_cells_current ) {
+    std::memset( m_cells_current.get(), 0, size() * sizeof( uint64_t ) );
+    std::memset( m_cells_next.get(), 0, size() * sizeof( uint64_t ) );
+  }
+}
+
+void game::Multiverse::randomise( app::ThreadPool& pool, const uint64_t seed, const double density ) {
+  if( !m_cells_current ) {
+    return;
+  }
+
+  const uint32_t threshold = density_threshold( density );
+
+  m_generation = 0;
+  m_changed = UINT64_MAX;
+  m_changed_twice = UINT64_MAX;
+
+  // A word of random bits per cell, a stream per row like Universe::randomise.
+  pool.parallel_for( m_bounds.y, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin }; row < end; ++row ) {
+      Xoshiro256 generator{ seed, row };
+
+      uint64_t* out = m_cells_current.get() + ( row + 1 ) * stride() + 1;
+
+      for( size_t column{}; column < m_bounds.x; ++column ) {
+        out[ column ] = bernoulli_bits( generator, threshold );
+      }
+    }
+  } );
+
+  std::memcpy( m_cells_next.get(), m_cells_current.get(), size() * sizeof( uint64_t ) );
+}
+
+void game::Multiverse::load( const size_t lane, const Universe& universe ) {
+  const uint64_t bit = ( uint64_t ) 1 << lane;
+
+  for( size_t row{ 1 }; row <= m_bounds.y; ++row ) {
+    const uint8_t* cells = universe.current() + row * universe.stride();
+    uint64_t* current = m_cells_current.get() + row * stride();
+    uint64_t* next = m_cells_next.get() + row * stride();
+
+    for( size_t column{ 1 }; column <= m_bounds.x; ++column ) {
+      const uint64_t live = cells[ column ] != 0 ? bit : 0;
+
+      current[ column ] = ( current[ column ] & ~bit ) | live;
+      next[ column ] = ( next[ column ] & ~bit ) | live;
+    }
+  }
+
+  m_changed |= bit;
+  m_changed_twice |= bit;
+}
+
+void game::Multiverse::clear( const size_t lane ) {
+  const uint64_t keep = ~( ( uint64_t ) 1 << lane );
+
+  for( size_t cell{}; cell < size(); ++cell ) {
+    m_cells_current[ cell ] &= keep;
+    m_cells_next[ cell ] &= keep;
+  }
+
+  m_changed |= ~keep;
+  m_changed_twice |= ~keep;
+}
+
+void game::Multiverse::extract( const size_t lane, Universe& universe ) const {
+  if( !( universe.bounds() == m_bounds ) ) {
+    universe.init( m_bounds );
+  }
+  else {
+    universe.clear();
+  }
+
+  for( size_t row{ 1 }; row <= m_bounds.y; ++row ) {
+    const uint64_t* cells = m_cells_current.get() + row * stride();
+
+    for( size_t column{ 1 }; column <= m_bounds.x; ++column ) {
+      if( ( cells[ column ] >> lane ) & 1 ) {
+        universe.set_states( row, column, 1 );
+      }
+    }
+  }
+}
+
+void game::Multiverse::swap( const uint64_t changed, const uint64_t changed_twice ) {
+  std::swap( m_cells_current, m_cells_next );
+
+  ++m_generation;
+  m_changed = changed;
+  m_changed_twice = changed_twice;
+}
+
+const uint64_t game::Multiverse::live() const {
+  uint64_t live{};
+
+  // The border is dead, so the whole buffer can be folded.
+  for( size_t cell{}; cell < size(); ++cell ) {
+    live |= m_cells_current[ cell ];
+  }
+
+  return live;
+}
+
+const size_t game::Multiverse::population( const size_t lane ) const {
+  size_t population{};
+
+  for( size_t cell{}; cell < size(); ++cell ) {
+    population += ( m_cells_current[ cell ] >> lane ) & 1;
+  }
+
+  return population;
+}
@@ -0,0 +1,96 @@
+#include <game/oracle.hpp>
+
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+game::Oracle::Oracle( const std::vector< size_t >& threads ) {
+  const auto& names = engine_names();
+
+  m_reference = make_engine( names.front() );
+
+  for( const size_t count : threads ) {
+    m_pools.push_back( std::make_unique< app::ThreadPool >( count ) );
+  }
+
+  for( size_t i{ 1 }; i < names.size(); ++i ) {
+    for( const auto& pool : m_pools ) {
+      m_candidates.push_back( { make_engine( names[ i ] ), pool.get(), {} } );
+    }
+  }
+}
+
+game::Oracle::~Oracle() {}
+
+void game::Oracle::set_rule( const Rule& rule ) {
+  m_reference->set_rule( rule );
+
+  for( auto& candidate : m_candidates ) {
+    if( candidate.engine->supports( rule ) ) {
+      candidate.engine->set_rule( rule );
+    }
+  }
+}
+
+std::vector< game::Mismatch > game::Oracle::check( const Universe& initial, const size_t generations ) {
+  std::vector< Mismatch > mismatches;
+
+  m_expected.copy( initial );
+
+  // Engines that don't support the rule never get to run.
+  std::vector< bool > failed( m_candidates.size(), false );
+  for( size_t i{}; i < m_candidates.size(); ++i ) {
+    failed[ i ] = !m_candidates[ i ].engine->supports( m_reference->rule() );
+
+    if( !failed[ i ] ) {
+      m_candidates[ i ].universe.copy( initial );
+    }
+  }
+
+  const size_t size = initial.size();
+  const size_t stride = initial.stride();
+
+  for( size_t generation{ 1 }; generation <= generations; ++generation ) {
+    m_reference->step( m_expected, *m_pools.front() );
+
+    const uint8_t* expected = m_expected.current();
+
+    for( size_t i{}; i < m_candidates.size(); ++i ) {
+      if( failed[ i ] ) {
+        continue;
+      }
+
+      auto& candidate = m_candidates[ i ];
+      candidate.engine->step( candidate.universe, *candidate.pool );
+
+      const uint8_t* actual = candidate.universe.current();
+      if( memcmp( expected, actual, size ) == 0 ) {
+        continue;
+      }
+
+      size_t index{};
+      while( expected[ index ] == actual[ index ] ) {
+        ++index;
+      }
+
+      mismatches.push_back( {
+        candidate.engine->name(),
+        candidate.pool->threads(),
+        generation,
+        index / stride,
+        index % stride,
+        expected[ index ],
+        actual[ index ]
+      } );
+
+      failed[ i ] = true;
+    }
+
+    if( std::find( failed.begin(), failed.end(), false ) == failed.end() ) {
+      break;
+    }
+  }
+
+  return mismatches;
+}
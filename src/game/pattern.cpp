@@ -0,0 +1,114 @@
+#include <game/pattern.hpp>
+
+#include <algorithm>
+
+game::Pattern::Pattern() :
+  m_bounds{}
+{
+}
+
+game::Pattern::Pattern( const Vec2< size_t >& bounds ) :
+  m_bounds( bounds ),
+  m_cells( bounds.x * bounds.y )
+{
+}
+
+bool game::Pattern::load_rle( const std::string_view& rle ) {
+  struct Run {
+    size_t x;
+    size_t y;
+    size_t length;
+    uint8_t state;
+  };
+
+  std::vector< Run > runs;
+
+  size_t x{};
+  size_t y{};
+  size_t width{};
+  size_t count{};
+  bool header = true;
+  bool done = false;
+
+  m_bounds = {};
+  m_cells.clear();
+
+  //
+  // First pass collects the runs and the extents, the header line ("x = 3, y = 3, rule = B3/S23") is only
+  // used to tell it apart from the body, the bounds are derived from the runs themselves.
+  //
+  size_t line_begin{};
+  while( line_begin < rle.size() && !done ) {
+    size_t line_end = rle.find( '\n', line_begin );
+    if( line_end == std::string_view::npos ) {
+      line_end = rle.size();
+    }
+
+    const std::string_view line = rle.substr( line_begin, line_end - line_begin );
+    line_begin = line_end + 1;
+
+    const size_t first = line.find_first_not_of( " \t\r" );
+    if( first == std::string_view::npos || line[ first ] == '#' ) {
+      continue;
+    }
+
+    if( header && line[ first ] == 'x' ) {
+      header = false;
+      continue;
+    }
+
+    header = false;
+
+    for( const char c : line ) {
+      if( c >= '0' && c <= '9' ) {
+        count = count * 10 + ( c - '0' );
+        continue;
+      }
+
+      const size_t length = std::max< size_t >( count, 1 );
+      count = 0;
+
+      if( c == 'b' || c == '.' ) {
+        x += length;
+      }
+      else if( c == 'o' || ( c >= 'A' && c <= 'X' ) ) {
+        runs.push_back( { x, y, length, ( uint8_t ) ( c == 'o' ? 1 : c - 'A' + 1 ) } );
+        x += length;
+      }
+      else if( c == '$' ) {
+        y += length;
+        x = 0;
+      }
+      else if( c == '!' ) {
+        done = true;
+        break;
+      }
+      else if( c == ' ' || c == '\t' || c == '\r' ) {
+        continue;
+      }
+      else {
+        return false;
+      }
+
+      width = std::max( width, x );
+    }
+  }
+
+  size_t height{};
+  for( const auto& run : runs ) {
+    height = std::max( height, run.y + 1 );
+  }
+
+  m_bounds = { width, height };
+  m_cells.assign( width * height, 0 );
+
+  for( const auto& run : runs ) {
+    std::fill_n( m_cells.begin() + run.y * width + run.x, run.length, run.state );
+  }
+
+  return true;
+}
+
+const size_t game::Pattern::population() const {
+  return m_cells.size() - std::count( m_cells.begin(), m_cells.end(), 0 );
+}
@@ -0,0 +1,670 @@
+#include <game/rule.hpp>
+#include <game/rule_table.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+
+namespace {
+
+  // The eight neighbours of a cell clockwise from north, as bits of an arrangement of live neighbours.
+  enum Neighbour : uint8_t {
+    N = 1 << 0,
+    NE = 1 << 1,
+    E = 1 << 2,
+    SE = 1 << 3,
+    S = 1 << 4,
+    SW = 1 << 5,
+    W = 1 << 6,
+    NW = 1 << 7
+  };
+
+  // Bit of game::Rule::table for every neighbour.
+  constexpr size_t k_block_bits[ 8 ] = { 3, 6, 7, 8, 5, 2, 1, 0 };
+
+  constexpr const char* k_letters[ 5 ] = { "", "ce", "cekain", "cekainyqjr", "cekainyqjrtwz" };
+
+  //
+  // One arrangement of every letter of up to four live neighbours, the others are its rotations and
+  // reflections. The arrangements of five to eight neighbours are the complements of those of three to none.
+  //
+  constexpr uint8_t k_arrangements[ 5 ][ 13 ] = {
+    { 0 },
+    { NE, N },
+    { NE | SE, N | E, N | SE, N | NE, N | S, NE | SW },
+    {
+      NE | SE | SW, N | E | S, N | E | SW, N | NE | E, N | NE | NW,
+      N | NE | SE, N | SE | SW, N | NE | SW, N | NE | W, N | NE | S
+    },
+    {
+      NE | SE | SW | NW, N | E | S | W, N | E | SE | SW, N | NE | E | SE, N | NE | SE | S,
+      NE | E | SE | SW, N | NE | SE | SW, N | NE | E | SW, N | E | S | SW, N | NE | E | S,
+      N | SE | S | SW, NE | E | S | SW, N | NE | S | SW
+    }
+  };
+
+  const uint8_t arrangement( const size_t live_neighbors, const size_t letter ) {
+    return live_neighbors <= 4 ?
+      k_arrangements[ live_neighbors ][ letter ] :
+      ( uint8_t ) ~k_arrangements[ 8 - live_neighbors ][ letter ];
+  }
+
+  // Index of game::Rule::table for a cell and an arrangement of its live neighbours.
+  const size_t block( const bool alive, const uint8_t neighbours ) {
+    size_t index = alive ? 16 : 0;
+
+    for( size_t i{}; i < 8; ++i ) {
+      if( ( neighbours >> i ) & 1 ) {
+        index |= ( size_t ) 1 << k_block_bits[ i ];
+      }
+    }
+
+    return index;
+  }
+
+  // Sets the table entries of an arrangement and of all of its rotations and reflections.
+  void set_symmetric( game::Rule& rule, const bool alive, const uint8_t neighbours ) {
+    uint8_t reflected{};
+    for( size_t i{}; i < 8; ++i ) {
+      if( ( neighbours >> i ) & 1 ) {
+        reflected |= 1 << ( ( 8 - i ) % 8 );
+      }
+    }
+
+    for( uint8_t rotated : { neighbours, reflected } ) {
+      for( size_t turn{}; turn < 4; ++turn ) {
+        const size_t index = block( alive, rotated );
+        rule.table[ index >> 6 ] |= ( uint64_t ) 1 << ( index & 63 );
+
+        rotated = ( uint8_t ) ( ( rotated << 2 ) | ( rotated >> 6 ) );
+      }
+    }
+  }
+
+  // Parses a run of neighbour counts on the hexagonal or triangular grid straight into the masks.
+  bool parse_lattice_counts( const std::string_view& text, const bool alive, game::Rule& rule ) {
+    const size_t neighbours = rule.topology == game::Topology::Hexagonal ? 6 : 12;
+
+    for( const char c : text ) {
+      size_t count{};
+      if( c >= '0' && c <= '9' ) {
+        count = ( size_t ) ( c - '0' );
+      }
+      else if( c >= 'A' && c <= 'C' ) {
+        count = 10 + ( size_t ) ( c - 'A' );
+      }
+      else {
+        return false;
+      }
+
+      if( count > neighbours ) {
+        return false;
+      }
+
+      ( alive ? rule.survival : rule.birth ) |= ( uint16_t ) ( 1 << count );
+    }
+
+    return true;
+  }
+
+  //
+  // Parses a run of neighbour counts such as "345" into the half of the rule table of dead or live cells.
+  // Hensel letters after a count pick some of its arrangements, "2n" only n and "2-n" every one but n.
+  //
+  bool parse_counts( const std::string_view& text, const bool alive, game::Rule& rule ) {
+    if( !rule.square() ) {
+      return parse_lattice_counts( text, alive, rule );
+    }
+
+    size_t i{};
+    while( i < text.size() ) {
+      const char c = text[ i++ ];
+      if( c < '0' || c > '8' ) {
+        return false;
+      }
+
+      const size_t live_neighbors = ( size_t ) ( c - '0' );
+      const std::string_view letters = game::hensel_letters( live_neighbors );
+
+      const bool exclude = i < text.size() && text[ i ] == '-';
+      if( exclude ) {
+        ++i;
+      }
+
+      uint16_t picked{};
+      while( i < text.size() && std::isalpha( ( unsigned char ) text[ i ] ) ) {
+        const size_t letter = letters.find( ( char ) std::tolower( ( unsigned char ) text[ i++ ] ) );
+        if( letter == std::string_view::npos ) {
+          return false;
+        }
+
+        picked |= 1 << letter;
+      }
+
+      if( exclude && picked == 0 ) {
+        return false;
+      }
+
+      for( size_t letter{}; letter < std::max< size_t >( 1, letters.size() ); ++letter ) {
+        if( picked == 0 || ( ( picked >> letter ) & 1 ) != exclude ) {
+          set_symmetric( rule, alive, arrangement( live_neighbors, letter ) );
+        }
+      }
+    }
+
+    return true;
+  }
+
+  // The rule is only isotropic if the table can't be written as masks, i.e. if some letters of a count are missing.
+  const game::Rule finish( game::Rule rule ) {
+    if( !rule.square() ) {
+      return rule;
+    }
+
+    uint16_t masks[ 2 ]{};
+    uint16_t seen[ 2 ]{};
+
+    for( size_t index{}; index < 512; ++index ) {
+      const size_t alive = ( index >> 4 ) & 1;
+      const size_t live_neighbors = ( size_t ) std::popcount( index & ~( size_t ) 16 );
+      const uint16_t bit = ( uint16_t ) ( 1 << live_neighbors );
+      const bool lives = ( rule.table[ index >> 6 ] >> ( index & 63 ) ) & 1;
+
+      if( ( seen[ alive ] & bit ) && ( ( masks[ alive ] & bit ) != 0 ) != lives ) {
+        rule.isotropic = true;
+        return rule;
+      }
+
+      seen[ alive ] |= bit;
+      masks[ alive ] |= lives ? bit : 0;
+    }
+
+    rule.birth = masks[ 0 ];
+    rule.survival = masks[ 1 ];
+    rule.table = {};
+    return rule;
+  }
+
+  bool parse_states( const std::string_view& text, uint16_t& out ) {
+    if( text.empty() ) {
+      return false;
+    }
+
+    size_t states{};
+    for( const char c : text ) {
+      if( !std::isdigit( ( unsigned char ) c ) ) {
+        return false;
+      }
+
+      states = states * 10 + ( size_t ) ( c - '0' );
+      if( states > 256 ) {
+        return false;
+      }
+    }
+
+    out = ( uint16_t ) states;
+    return states >= 2;
+  }
+
+  bool parse_unsigned( const std::string_view& text, size_t& out ) {
+    if( text.empty() || text.size() > 9 ) {
+      return false;
+    }
+
+    out = 0;
+    for( const char c : text ) {
+      if( !std::isdigit( ( unsigned char ) c ) ) {
+        return false;
+      }
+
+      out = out * 10 + ( size_t ) ( c - '0' );
+    }
+
+    return true;
+  }
+
+  // Parses a range of counts such as "34..58".
+  bool parse_range( const std::string_view& text, game::Range& out ) {
+    const size_t separator = text.find( ".." );
+    if( separator == std::string_view::npos ) {
+      return false;
+    }
+
+    size_t min{};
+    size_t max{};
+    if( !parse_unsigned( text.substr( 0, separator ), min ) || !parse_unsigned( text.substr( separator + 2 ), max ) ) {
+      return false;
+    }
+
+    out = { ( uint32_t ) min, ( uint32_t ) max };
+    return true;
+  }
+
+  //
+  // Larger than Life notation, the parts are separated by commas and may come in any order:
+  //    R radius, C states (0 for 2), M whether the cell counts itself, S and B ranges, N neighbourhood.
+  //
+  bool parse_larger( const std::string& text, game::Rule& out ) {
+    game::Rule rule{ 0, 0, 2 };
+
+    bool radius = false;
+    bool birth = false;
+    bool survival = false;
+
+    size_t begin{};
+    while( begin <= text.size() ) {
+      const size_t end = std::min( text.find( ',', begin ), text.size() );
+      const std::string_view part = std::string_view( text ).substr( begin, end - begin );
+      begin = end + 1;
+
+      if( part.empty() ) {
+        return false;
+      }
+
+      const std::string_view value = part.substr( 1 );
+      size_t number{};
+
+      switch( part[ 0 ] ) {
+        case 'R':
+          if( !parse_unsigned( value, number ) || number == 0 || number > game::Rule::k_max_radius ) {
+            return false;
+          }
+
+          rule.radius = ( uint8_t ) number;
+          radius = true;
+          break;
+
+        case 'C':
+          if( !parse_unsigned( value, number ) || number == 1 || number > 256 ) {
+            return false;
+          }
+
+          rule.states = ( uint16_t ) std::max< size_t >( 2, number );
+          break;
+
+        case 'M':
+          if( value != "0" && value != "1" ) {
+            return false;
+          }
+
+          rule.middle = value == "1";
+          break;
+
+        case 'S':
+          if( !parse_range( value, rule.survival_range ) ) {
+            return false;
+          }
+
+          survival = true;
+          break;
+
+        case 'B':
+          if( !parse_range( value, rule.birth_range ) ) {
+            return false;
+          }
+
+          birth = true;
+          break;
+
+        case 'N':
+          if( value == "M" ) {
+            rule.neighbourhood = game::Neighbourhood::Moore;
+          }
+          else if( value == "N" ) {
+            rule.neighbourhood = game::Neighbourhood::VonNeumann;
+          }
+          else {
+            return false;
+          }
+          break;
+
+        default:
+          return false;
+      }
+    }
+
+    if( !radius || !birth || !survival ) {
+      return false;
+    }
+
+    out = rule;
+    return true;
+  }
+
+  //
+  // Parses a chance of a stochastic rule between 0 and 1 into a threshold of bernoulli_bits. A chance that is
+  // neither impossible nor certain has to stay that way, rather than silently turning the rule into another one.
+  //
+  bool parse_chance( const std::string_view& text, uint64_t& out ) {
+    double chance{};
+    const auto result = std::from_chars( text.data(), text.data() + text.size(), chance );
+    if( text.empty() || result.ec != std::errc{} || result.ptr != text.data() + text.size() || !( chance >= 0.0 && chance <= 1.0 ) ) {
+      return false;
+    }
+
+    out = game::chance_threshold( chance );
+    return ( out != 0 || chance == 0.0 ) && ( out != game::Rule::k_certain || chance == 1.0 );
+  }
+
+  // The fewest digits that read back as the same threshold, so that a chance is written the way it was typed.
+  std::string format_chance( const uint64_t threshold ) {
+    const double chance = ( double ) threshold / ( double ) game::Rule::k_certain;
+
+    char buffer[ 32 ];
+    for( int precision{ 1 };; ++precision ) {
+      const auto result = std::to_chars( buffer, buffer + sizeof( buffer ), chance, std::chars_format::general, precision );
+
+      uint64_t parsed{};
+      if( precision == 17 || ( parse_chance( { buffer, ( size_t ) ( result.ptr - buffer ) }, parsed ) && parsed == threshold ) ) {
+        return std::string( buffer, result.ptr );
+      }
+    }
+  }
+
+  // MCell's notation of block rules, the text after MS,D is the 16 blocks separated by semicolons.
+  bool parse_margolus( const std::string& text, game::Rule& out ) {
+    game::Rule rule{ 0, 0, 2 };
+    rule.margolus = true;
+
+    const std::string_view prefix = "MS,D";
+    if( !text.starts_with( prefix ) ) {
+      return false;
+    }
+
+    size_t begin = prefix.size();
+    for( size_t block{}; block < rule.blocks.size(); ++block ) {
+      const size_t end = std::min( text.find( ';', begin ), text.size() );
+
+      size_t value{};
+      if( !parse_unsigned( std::string_view( text ).substr( begin, end - begin ), value ) || value > 15 ) {
+        return false;
+      }
+
+      // The last block has to end the text, every other one a semicolon.
+      if( ( block + 1 == rule.blocks.size() ) != ( end == text.size() ) ) {
+        return false;
+      }
+
+      rule.blocks[ block ] = ( uint8_t ) value;
+      begin = end + 1;
+    }
+
+    out = rule;
+    return true;
+  }
+
+  void append_counts( std::string& out, const uint16_t mask ) {
+    for( int count{}; count <= 12; ++count ) {
+      if( ( mask >> count ) & 1 ) {
+        out.push_back( ( char ) ( count < 10 ? '0' + count : 'A' + count - 10 ) );
+      }
+    }
+  }
+
+  // Writes the letters that are set, or those that aren't after a minus if that is shorter.
+  void append_letters( std::string& out, const game::Rule& rule, const bool alive ) {
+    for( size_t count{}; count <= 8; ++count ) {
+      const std::string_view letters = game::hensel_letters( count );
+
+      std::string set;
+      std::string unset;
+      for( size_t letter{}; letter < std::max< size_t >( 1, letters.size() ); ++letter ) {
+        const char name = letters.empty() ? ' ' : letters[ letter ];
+        ( rule.lives( block( alive, arrangement( count, letter ) ) ) ? set : unset ).push_back( name );
+      }
+
+      if( set.empty() ) {
+        continue;
+      }
+
+      out.push_back( ( char ) ( '0' + count ) );
+
+      if( unset.empty() ) {
+        continue;
+      }
+
+      out += unset.size() < set.size() ? "-" + unset : set;
+    }
+  }
+
+}
+
+const std::string game::Rule::to_string() const {
+  if( tabular() ) {
+    return rule_table->name();
+  }
+
+  if( margolus ) {
+    std::string text = "MS,D";
+
+    for( size_t block{}; block < blocks.size(); ++block ) {
+      text += ( block == 0 ? "" : ";" ) + std::to_string( blocks[ block ] );
+    }
+
+    return text;
+  }
+
+  if( larger() ) {
+    return "R" + std::to_string( radius ) +
+      ",C" + std::to_string( generations() ? states : 0 ) +
+      ",M" + std::to_string( middle ? 1 : 0 ) +
+      ",S" + std::to_string( survival_range.min ) + ".." + std::to_string( survival_range.max ) +
+      ",B" + std::to_string( birth_range.min ) + ".." + std::to_string( birth_range.max ) +
+      ( neighbourhood == Neighbourhood::Moore ? ",NM" : ",NN" );
+  }
+
+  std::string text = "B";
+  if( isotropic ) {
+    append_letters( text, *this, false );
+  }
+  else {
+    append_counts( text, birth );
+  }
+
+  text += "/S";
+  if( isotropic ) {
+    append_letters( text, *this, true );
+  }
+  else {
+    append_counts( text, survival );
+  }
+
+  if( generations() ) {
+    text += "/C" + std::to_string( states );
+  }
+
+  if( birth_chance != k_certain ) {
+    text += "/BP" + format_chance( birth_chance );
+  }
+
+  if( survival_chance != k_certain ) {
+    text += "/SP" + format_chance( survival_chance );
+  }
+
+  if( noise != 0 ) {
+    text += "/N" + format_chance( noise );
+  }
+
+  if( topology == Topology::Hexagonal ) {
+    text += "H";
+  }
+  else if( topology == Topology::Triangular ) {
+    text += "L";
+  }
+
+  return text;
+}
+
+const game::Rule::Chances game::Rule::chances( const uint64_t generation, const uint64_t word ) const {
+  // A stream per kind of chance, so none of them shares coin flips with another.
+  Philox births( seed, generation, word, 0 );
+  Philox survivals( seed, generation, word, 1 );
+  Philox flips( seed, generation, word, 2 );
+
+  return {
+    bernoulli_bits< k_chance_bits >( births, birth_chance ),
+    bernoulli_bits< k_chance_bits >( survivals, survival_chance ),
+    bernoulli_bits< k_chance_bits >( flips, noise )
+  };
+}
+
+bool game::parse_rule( const std::string_view& text, Rule& out ) {
+  if( find_builtin_table( text, out ) ) {
+    return true;
+  }
+
+  std::string compact;
+  for( const char c : text ) {
+    if( !std::isspace( ( unsigned char ) c ) ) {
+      compact.push_back( ( char ) std::toupper( ( unsigned char ) c ) );
+    }
+  }
+
+  if( compact.starts_with( "MS," ) ) {
+    return parse_margolus( compact, out );
+  }
+
+  if( compact.find( ',' ) != std::string::npos ) {
+    return parse_larger( compact, out );
+  }
+
+  // Golly's suffix for the hexagonal grid and LifeViewer's for the triangular one, Hensel letters don't use either.
+  Topology topology = Topology::Square;
+  if( compact.ends_with( 'H' ) || compact.ends_with( 'L' ) ) {
+    topology = compact.back() == 'H' ? Topology::Hexagonal : Topology::Triangular;
+    compact.pop_back();
+  }
+
+  std::vector< std::string > parts{ 1 };
+
+  for( const char c : compact ) {
+    if( c == '/' ) {
+      parts.emplace_back();
+    }
+    else {
+      parts.back().push_back( c );
+    }
+  }
+
+  // Chances of stochastic rules come last.
+  uint64_t chances[ 3 ] = { Rule::k_certain, Rule::k_certain, 0 };
+  bool stochastic = false;
+
+  while( parts.size() > 2 ) {
+    const std::string_view part = parts.back();
+
+    if( part.starts_with( "BP" ) || part.starts_with( "SP" ) ) {
+      if( !parse_chance( part.substr( 2 ), chances[ part[ 0 ] == 'B' ? 0 : 1 ] ) ) {
+        return false;
+      }
+    }
+    else if( part.starts_with( 'N' ) ) {
+      if( !parse_chance( part.substr( 1 ), chances[ 2 ] ) ) {
+        return false;
+      }
+    }
+    else {
+      break;
+    }
+
+    stochastic = true;
+    parts.pop_back();
+  }
+
+  if( parts.size() < 2 || parts.size() > 3 ) {
+    return false;
+  }
+
+  Rule rule{ 0, 0, 2, topology };
+  rule.birth_chance = chances[ 0 ];
+  rule.survival_chance = chances[ 1 ];
+  rule.noise = chances[ 2 ];
+
+  // Chances are only defined for rules of two states on the square grid.
+  if( stochastic && ( parts.size() == 3 || topology != Topology::Square ) ) {
+    return false;
+  }
+
+  // S/B notation has no letters, the third part is the number of states.
+  if( parts[ 0 ].empty() || std::isdigit( ( unsigned char ) parts[ 0 ][ 0 ] ) ) {
+    if( !parse_counts( parts[ 0 ], true, rule ) || !parse_counts( parts[ 1 ], false, rule ) ) {
+      return false;
+    }
+
+    if( parts.size() == 3 && !parse_states( parts[ 2 ], rule.states ) ) {
+      return false;
+    }
+
+    out = finish( rule );
+    return true;
+  }
+
+  bool birth = false;
+  bool survival = false;
+  bool states = false;
+
+  for( size_t i{}; i < parts.size(); ++i ) {
+    const std::string_view part = parts[ i ];
+    if( part.empty() ) {
+      return false;
+    }
+
+    bool valid = false;
+
+    if( part[ 0 ] == 'B' && !birth ) {
+      valid = birth = parse_counts( part.substr( 1 ), false, rule );
+    }
+    else if( part[ 0 ] == 'S' && !survival ) {
+      valid = survival = parse_counts( part.substr( 1 ), true, rule );
+    }
+    else if( ( part[ 0 ] == 'C' || part[ 0 ] == 'G' ) && !states ) {
+      valid = states = parse_states( part.substr( 1 ), rule.states );
+    }
+    else if( i == 2 && !states ) {
+      // B2/S/3
+      valid = states = parse_states( part, rule.states );
+    }
+
+    if( !valid ) {
+      return false;
+    }
+  }
+
+  if( !birth || !survival ) {
+    return false;
+  }
+
+  out = finish( rule );
+  return true;
+}
+
+const char* game::hensel_letters( const size_t live_neighbors ) {
+  return live_neighbors <= 8 ? k_letters[ std::min( live_neighbors, 8 - live_neighbors ) ] : "";
+}
+
+const std::vector< game::NamedRule >& game::named_rules() {
+  static const std::vector< NamedRule > rules = {
+    { "Life", "B3/S23" },
+    { "HighLife", "B36/S23" },
+    { "Seeds", "B2/S" },
+    { "Day & Night", "B3678/S34678" },
+    { "Brian's Brain", "B2/S/C3" },
+    { "Star Wars", "B2/S345/C4" },
+    { "Frogs", "B34/S12/C3" },
+    { "Bloomerang", "B34678/S234/C24" },
+    { "tlife", "B3/S2-i34q" },
+    { "Hexagonal B2/S34", "B2/S34H" },
+    { "Triangular B4/S345", "B4/S345L" },
+    { "WireWorld", "WireWorld" },
+    { "Bosco's Rule", "R5,C0,M1,S33..57,B34..45,NM" },
+    { "Bugs", "R5,C0,M1,S34..58,B34..45,NM" },
+    { "Majority", "R4,C0,M1,S41..81,B41..81,NM" },
+    { "Noisy Life", "B3/S23/N0.001" },
+    { "Critters", "MS,D15;14;13;3;11;5;6;1;7;9;10;2;12;4;8;0" },
+    { "Tron", "MS,D15;1;2;3;4;5;6;7;8;9;10;11;12;13;14;0" },
+    { "Billiard Ball Machine", "MS,D0;8;4;3;2;5;9;7;1;6;10;11;12;13;14;15" }
+  };
+
+  return rules;
+}
@@ -0,0 +1,704 @@
+#include <game/rule_table.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+namespace {
+
+  // Rows a rule table may expand into, permutations of many different neighbours add up quickly.
+  constexpr size_t k_max_rows = 1 << 20;
+
+  // Cell of the block in the layout of game::Rule::table for every cell of a Moore neighbourhood in file order.
+  constexpr size_t k_moore_blocks[ 9 ] = { 4, 3, 6, 7, 8, 5, 2, 1, 0 };
+
+  using States = std::bitset< 256 >;
+
+  // A cell of a transition, named variables that occur more than once are bound.
+  struct Token {
+    States states;
+    std::string variable;
+  };
+
+  std::string_view trim( std::string_view text ) {
+    while( !text.empty() && std::isspace( ( unsigned char ) text.front() ) ) {
+      text.remove_prefix( 1 );
+    }
+
+    while( !text.empty() && std::isspace( ( unsigned char ) text.back() ) ) {
+      text.remove_suffix( 1 );
+    }
+
+    return text;
+  }
+
+  bool parse_number( const std::string_view& text, size_t& out ) {
+    if( text.empty() || text.size() > 3 ) {
+      return false;
+    }
+
+    out = 0;
+    for( const char c : text ) {
+      if( !std::isdigit( ( unsigned char ) c ) ) {
+        return false;
+      }
+
+      out = out * 10 + ( size_t ) ( c - '0' );
+    }
+
+    return true;
+  }
+
+  // Splits at commas that aren't inside of braces.
+  std::vector< std::string > split( const std::string_view& text ) {
+    std::vector< std::string > parts{ 1 };
+    size_t depth{};
+
+    for( const char c : text ) {
+      if( c == ',' && depth == 0 ) {
+        parts.emplace_back();
+        continue;
+      }
+
+      depth += c == '{';
+      depth -= c == '}' && depth > 0;
+
+      parts.back().push_back( c );
+    }
+
+    for( auto& part : parts ) {
+      part = std::string( trim( part ) );
+    }
+
+    return parts;
+  }
+
+  // Order of the sets of states, only used to find the distinct permutations of a transition.
+  const bool less( const States& a, const States& b ) {
+    for( size_t state{ 256 }; state-- > 0; ) {
+      if( a[ state ] != b[ state ] ) {
+        return b[ state ];
+      }
+    }
+
+    return false;
+  }
+
+  //
+  // Permutations of the neighbours a symmetry stands for, the identity first: image[ i ] is the neighbour
+  // whose states go to neighbour i. Empty if the symmetry doesn't exist for the neighbourhood.
+  //
+  std::vector< std::vector< size_t > > symmetry_group( const game::Neighbourhood neighbourhood, const std::string_view& symmetries ) {
+    const size_t ring = neighbourhood == game::Neighbourhood::Moore ? 8 : 4;
+    const bool moore = ring == 8;
+
+    size_t step{};
+    bool reflect = false;
+
+    if( symmetries == "none" ) {
+      step = ring;
+    }
+    else if( symmetries == "rotate4" ) {
+      step = ring / 4;
+    }
+    else if( symmetries == "rotate8" && moore ) {
+      step = 1;
+    }
+    else if( symmetries == "reflect_horizontal" ) {
+      step = ring;
+      reflect = true;
+    }
+    else if( symmetries == "rotate4reflect" ) {
+      step = ring / 4;
+      reflect = true;
+    }
+    else if( symmetries == "rotate8reflect" && moore ) {
+      step = 1;
+      reflect = true;
+    }
+    else {
+      return {};
+    }
+
+    std::vector< std::vector< size_t > > group;
+
+    for( const bool reflected : { false, true } ) {
+      if( reflected && !reflect ) {
+        break;
+      }
+
+      for( size_t shift{}; shift < ring; shift += step ) {
+        auto& image = group.emplace_back( ring );
+
+        for( size_t i{}; i < ring; ++i ) {
+          // Reflecting keeps north in place and swaps east and west.
+          image[ i ] = ( ( reflected ? ring - i : i ) + shift ) % ring;
+        }
+      }
+    }
+
+    return group;
+  }
+
+  //
+  // Adds the rows of one transition, tokens holds the cells of the neighbourhood followed by the next state.
+  // Every value of a bound variable makes rows of its own, then every row stands for its images under the
+  // symmetries.
+  //
+  bool expand( const std::vector< Token >& tokens, const game::Neighbourhood neighbourhood, const std::string& symmetries,
+    std::vector< game::RuleTable::Row >& rows, std::string& error ) {
+    const size_t cells = tokens.size() - 1;
+
+    std::map< std::string, size_t > occurrences;
+    for( const auto& token : tokens ) {
+      if( !token.variable.empty() ) {
+        ++occurrences[ token.variable ];
+      }
+    }
+
+    std::vector< std::string > bound;
+    for( const auto& [ variable, count ] : occurrences ) {
+      if( count > 1 ) {
+        bound.push_back( variable );
+      }
+    }
+
+    const Token& output = tokens.back();
+    const bool output_bound = std::find( bound.begin(), bound.end(), output.variable ) != bound.end();
+
+    if( !output_bound && output.states.count() != 1 ) {
+      error = "the next state has to be a single state or a variable that also is a neighbour";
+      return false;
+    }
+
+    const auto group = symmetry_group( neighbourhood, symmetries );
+    const bool permute = symmetries == "permute";
+
+    if( group.empty() && !permute ) {
+      error = "unknown symmetries " + symmetries;
+      return false;
+    }
+
+    std::map< std::string, size_t > values;
+
+    const auto add = [ & ]( const game::RuleTable::Row& row ) {
+      const size_t first = rows.size();
+
+      if( permute ) {
+        // Every distinct order of the neighbours, next_permutation skips orders that are the same.
+        std::vector< States > neighbours( row.inputs.begin() + 1, row.inputs.end() );
+        std::sort( neighbours.begin(), neighbours.end(), less );
+
+        do {
+          auto& image = rows.emplace_back( game::RuleTable::Row{ { row.inputs[ 0 ] }, row.output } );
+          image.inputs.insert( image.inputs.end(), neighbours.begin(), neighbours.end() );
+        } while( std::next_permutation( neighbours.begin(), neighbours.end(), less ) && rows.size() <= k_max_rows );
+
+        return;
+      }
+
+      for( const auto& permutation : group ) {
+        game::RuleTable::Row image{ { row.inputs[ 0 ] }, row.output };
+
+        for( const size_t neighbour : permutation ) {
+          image.inputs.push_back( row.inputs[ 1 + neighbour ] );
+        }
+
+        // Symmetric transitions are their own image under some of the symmetries.
+        const bool seen = std::any_of( rows.begin() + first, rows.end(), [ & ]( const game::RuleTable::Row& other ) {
+          return other.inputs == image.inputs;
+        } );
+
+        if( !seen ) {
+          rows.push_back( std::move( image ) );
+        }
+      }
+    };
+
+    const auto bind = [ & ]( const auto& self, const size_t variable ) -> void {
+      if( rows.size() > k_max_rows ) {
+        return;
+      }
+
+      if( variable < bound.size() ) {
+        const auto& states = std::find_if( tokens.begin(), tokens.end(), [ & ]( const Token& token ) {
+          return token.variable == bound[ variable ];
+        } )->states;
+
+        for( size_t state{}; state < 256; ++state ) {
+          if( states[ state ] ) {
+            values[ bound[ variable ] ] = state;
+            self( self, variable + 1 );
+          }
+        }
+
+        return;
+      }
+
+      game::RuleTable::Row row{};
+
+      for( size_t cell{}; cell < cells; ++cell ) {
+        const auto found = values.find( tokens[ cell ].variable );
+
+        if( found == values.end() ) {
+          row.inputs.push_back( tokens[ cell ].states );
+        }
+        else {
+          row.inputs.emplace_back().set( found->second );
+        }
+      }
+
+      if( output_bound ) {
+        row.output = ( uint8_t ) values[ output.variable ];
+      }
+      else {
+        for( size_t state{}; state < 256; ++state ) {
+          if( output.states[ state ] ) {
+            row.output = ( uint8_t ) state;
+          }
+        }
+      }
+
+      add( row );
+    };
+
+    bind( bind, 0 );
+
+    if( rows.size() > k_max_rows ) {
+      error = "more than " + std::to_string( k_max_rows ) + " transitions after expanding the variables and symmetries";
+      return false;
+    }
+
+    return true;
+  }
+
+  constexpr const char* k_wireworld = R"(@RULE WireWorld
+
+Brian Silverman's WireWorld, electrons of a head and a tail run along wires.
+0 empty, 1 electron head, 2 electron tail, 3 wire
+
+@TABLE
+n_states:4
+neighborhood:Moore
+symmetries:permute
+
+var a={0,1,2,3}
+var b=a
+var c=a
+var d=a
+var e=a
+var f=a
+var g=a
+var h=a
+
+# Anything but a head
+var i={0,2,3}
+var j=i
+var k=i
+var l=i
+var m=i
+var n=i
+var o=i
+
+# A head becomes a tail, a tail becomes wire
+1,a,b,c,d,e,f,g,h,2
+2,a,b,c,d,e,f,g,h,3
+
+# Wire with one or two heads next to it becomes a head
+3,1,i,j,k,l,m,n,o,1
+3,1,1,i,j,k,l,m,n,1
+
+@COLORS
+1 0 128 255
+2 255 255 255
+3 255 128 0
+)";
+
+  struct BuiltinTable {
+    const char* name;
+    const char* text;
+  };
+
+  constexpr BuiltinTable k_builtin_tables[] = {
+    { "WireWorld", k_wireworld }
+  };
+
+}
+
+game::RuleTable::RuleTable() :
+  m_states{},
+  m_neighbourhood( Neighbourhood::Moore ),
+  m_state_bits{},
+  m_memory( app::MemoryCategory::Rules )
+{
+}
+
+std::shared_ptr< const game::RuleTable > game::RuleTable::parse( const std::string_view& text, std::string& error ) {
+  auto table = std::make_shared< RuleTable >();
+
+  enum class Section {
+    Table,
+    Colours,
+    Other
+  };
+
+  // Files with only the table don't start with a section.
+  Section section = Section::Table;
+  bool tree = false;
+
+  std::map< std::string, States, std::less<> > variables;
+  std::string symmetries = "none";
+  bool transitions = false;
+
+  // A state or a variable.
+  const auto parse_item = [ & ]( const std::string_view& item, States& out ) {
+    size_t state{};
+    if( parse_number( item, state ) ) {
+      out.reset();
+      out.set( state );
+      return state < table->m_states;
+    }
+
+    const auto found = variables.find( item );
+    if( found == variables.end() ) {
+      return false;
+    }
+
+    out = found->second;
+    return true;
+  };
+
+  // A state, a variable or a set of them such as {0,1,a}.
+  const auto parse_set = [ & ]( const std::string_view& value, States& out ) {
+    if( value.size() < 2 || value.front() != '{' || value.back() != '}' ) {
+      return parse_item( value, out );
+    }
+
+    out.reset();
+    for( const auto& item : split( value.substr( 1, value.size() - 2 ) ) ) {
+      States states;
+      if( !parse_item( item, states ) ) {
+        return false;
+      }
+
+      out |= states;
+    }
+
+    return out.any();
+  };
+
+  size_t line_number{};
+  size_t begin{};
+
+  while( begin < text.size() ) {
+    const size_t end = std::min( text.find( '\n', begin ), text.size() );
+    std::string_view line = text.substr( begin, end - begin );
+    begin = end + 1;
+    ++line_number;
+
+    line = trim( line.substr( 0, line.find( '#' ) ) );
+    if( line.empty() ) {
+      continue;
+    }
+
+    const auto fail = [ & ]( const std::string& reason ) {
+      error = "line " + std::to_string( line_number ) + ": " + reason;
+      return nullptr;
+    };
+
+    if( line[ 0 ] == '@' ) {
+      const std::string_view keyword = line.substr( 0, line.find_first_of( " \t" ) );
+
+      section = Section::Other;
+
+      if( keyword == "@RULE" ) {
+        table->m_name = std::string( trim( line.substr( keyword.size() ) ) );
+      }
+      else if( keyword == "@TABLE" ) {
+        section = Section::Table;
+      }
+      else if( keyword == "@COLORS" ) {
+        section = Section::Colours;
+      }
+      else if( keyword == "@TREE" ) {
+        tree = true;
+      }
+
+      continue;
+    }
+
+    if( section == Section::Other ) {
+      continue;
+    }
+
+    if( section == Section::Colours ) {
+      // "state red green blue", other kinds of lines such as gradients are left out.
+      size_t values[ 4 ]{};
+      size_t count{};
+
+      for( size_t i{}; i < line.size() && count < 4; ) {
+        const size_t next = std::min( line.find_first_of( " \t", i ), line.size() );
+        if( next > i && parse_number( line.substr( i, next - i ), values[ count ] ) ) {
+          ++count;
+        }
+
+        i = next + 1;
+      }
+
+      if( count == 4 && std::all_of( values, values + 4, []( const size_t value ) { return value < 256; } ) ) {
+        table->m_colours.resize( std::max( table->m_colours.size(), values[ 0 ] + 1 ) );
+        table->m_colours[ values[ 0 ] ] = 0xFF000000 | ( uint32_t ) ( values[ 1 ] << 16 ) | ( uint32_t ) ( values[ 2 ] << 8 ) | ( uint32_t ) values[ 3 ];
+      }
+
+      continue;
+    }
+
+    //
+    // Settings, which have to come before the transitions.
+    //
+    const size_t colon = line.find( ':' );
+    if( colon != std::string_view::npos ) {
+      const std::string key( trim( line.substr( 0, colon ) ) );
+      const std::string value( trim( line.substr( colon + 1 ) ) );
+
+      if( transitions ) {
+        return fail( key + " has to come before the transitions" );
+      }
+
+      if( key == "n_states" ) {
+        size_t states{};
+        if( !parse_number( value, states ) || states < 2 || states > 256 ) {
+          return fail( "n_states has to be 2 .. 256" );
+        }
+
+        table->m_states = states;
+      }
+      else if( key == "neighborhood" ) {
+        if( value == "Moore" ) {
+          table->m_neighbourhood = Neighbourhood::Moore;
+        }
+        else if( value == "vonNeumann" ) {
+          table->m_neighbourhood = Neighbourhood::VonNeumann;
+        }
+        else {
+          return fail( "the " + value + " neighborhood isn't supported, only Moore and vonNeumann are" );
+        }
+      }
+      else if( key == "symmetries" ) {
+        symmetries = value;
+      }
+      else {
+        return fail( "unknown setting " + key );
+      }
+
+      continue;
+    }
+
+    if( table->m_states == 0 ) {
+      return fail( "n_states has to come first" );
+    }
+
+    //
+    // var name={0,1,2}
+    //
+    if( line.size() > 4 && line.substr( 0, 3 ) == "var" && std::isspace( ( unsigned char ) line[ 3 ] ) ) {
+      const std::string_view definition = line.substr( 4 );
+      const size_t equals = definition.find( '=' );
+      if( equals == std::string_view::npos ) {
+        return fail( "expected var name={...}" );
+      }
+
+      const std::string name( trim( definition.substr( 0, equals ) ) );
+
+      size_t number{};
+      if( name.empty() || name.find_first_of( ",{} \t" ) != std::string::npos || parse_number( name, number ) ) {
+        return fail( "invalid variable name " + name );
+      }
+
+      States states;
+      if( !parse_set( trim( definition.substr( equals + 1 ) ), states ) ) {
+        return fail( "invalid states of variable " + name );
+      }
+
+      variables[ name ] = states;
+      continue;
+    }
+
+    //
+    // A transition, separated by commas or spaces or one digit per state if there are at most 10.
+    //
+    std::vector< std::string > parts;
+
+    if( line.find_first_of( ",{" ) != std::string_view::npos ) {
+      parts = split( line );
+    }
+    else if( line.find_first_of( " \t" ) != std::string_view::npos ) {
+      for( size_t i{}; i < line.size(); ) {
+        const size_t next = std::min( line.find_first_of( " \t", i ), line.size() );
+        if( next > i ) {
+          parts.emplace_back( line.substr( i, next - i ) );
+        }
+
+        i = next + 1;
+      }
+    }
+    else if( table->m_states <= 10 ) {
+      for( const char c : line ) {
+        parts.emplace_back( 1, c );
+      }
+    }
+
+    if( parts.size() != table->cells() + 1 ) {
+      return fail( "expected a transition of " + std::to_string( table->cells() + 1 ) + " states" );
+    }
+
+    std::vector< Token > tokens;
+    for( const auto& part : parts ) {
+      Token& token = tokens.emplace_back();
+      if( !parse_set( part, token.states ) ) {
+        return fail( "unknown state or variable " + part );
+      }
+
+      if( variables.count( part ) != 0 ) {
+        token.variable = part;
+      }
+    }
+
+    transitions = true;
+
+    std::string reason;
+    if( !expand( tokens, table->m_neighbourhood, symmetries, table->m_rows, reason ) ) {
+      return fail( reason );
+    }
+  }
+
+  if( table->m_states == 0 ) {
+    error = tree ? "only @TABLE rules are supported, not @TREE" : "not a rule table, n_states is missing";
+    return nullptr;
+  }
+
+  if( table->m_name.empty() ) {
+    table->m_name = "Table";
+  }
+
+  table->compile();
+  return table;
+}
+
+void game::RuleTable::compile() {
+  m_state_bits = std::max< size_t >( 1, std::bit_width( m_states - 1 ) );
+
+  const size_t bits = cells() * m_state_bits;
+  if( bits > k_max_lookup_bits ) {
+    m_lookup.clear();
+    m_memory.set( 0 );
+    return;
+  }
+
+  // Where the state of every cell of the neighbourhood in file order goes in an index.
+  size_t shifts[ 9 ]{};
+  for( size_t cell{}; cell < cells(); ++cell ) {
+    shifts[ cell ] = ( m_neighbourhood == Neighbourhood::Moore ? k_moore_blocks[ cell ] : cell ) * m_state_bits;
+  }
+
+  m_lookup.resize( ( size_t ) 1 << bits );
+  m_memory.set( m_lookup.size() );
+
+  // Cells that match no row keep their state.
+  const size_t mask = ( ( size_t ) 1 << m_state_bits ) - 1;
+  for( size_t index{}; index < m_lookup.size(); ++index ) {
+    m_lookup[ index ] = ( uint8_t ) ( ( index >> shifts[ 0 ] ) & mask );
+  }
+
+  // The first row that matches wins, so the rows are written from the last to the first.
+  for( auto row = m_rows.rbegin(); row != m_rows.rend(); ++row ) {
+    const auto fill = [ & ]( const auto& self, const size_t cell, const size_t index ) -> void {
+      if( cell == cells() ) {
+        m_lookup[ index ] = row->output;
+        return;
+      }
+
+      for( size_t state{}; state < m_states; ++state ) {
+        if( row->inputs[ cell ][ state ] ) {
+          self( self, cell + 1, index | ( state << shifts[ cell ] ) );
+        }
+      }
+    };
+
+    fill( fill, 0, 0 );
+  }
+}
+
+const uint8_t game::RuleTable::match( const uint8_t* states ) const {
+  for( const auto& row : m_rows ) {
+    bool matches = true;
+
+    for( size_t cell{}; cell < row.inputs.size() && matches; ++cell ) {
+      matches = row.inputs[ cell ][ states[ cell ] ];
+    }
+
+    if( matches ) {
+      return row.output;
+    }
+  }
+
+  return states[ 0 ];
+}
+
+const game::Rule game::make_rule( const std::shared_ptr< const RuleTable >& table ) {
+  Rule rule{ 0, 0, ( uint16_t ) table->states() };
+  rule.rule_table = table;
+  return rule;
+}
+
+bool game::load_rule_file( const std::string& path, Rule& out, std::string& error ) {
+  std::ifstream file{ path, std::ios::binary };
+  if( !file ) {
+    error = "can't open " + path;
+    return false;
+  }
+
+  const std::string text{ std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() };
+
+  const auto table = RuleTable::parse( text, error );
+  if( table == nullptr ) {
+    return false;
+  }
+
+  out = make_rule( table );
+  return true;
+}
+
+bool game::find_builtin_table( const std::string_view& name, Rule& out ) {
+  // Parsed once, so that the same name always gives the same rule.
+  static const auto tables = []() {
+    std::vector< std::shared_ptr< const RuleTable > > tables;
+
+    for( const auto& builtin : k_builtin_tables ) {
+      std::string error;
+      tables.push_back( RuleTable::parse( builtin.text, error ) );
+    }
+
+    return tables;
+  }();
+
+  const std::string_view trimmed = trim( name );
+
+  for( size_t i{}; i < std::size( k_builtin_tables ); ++i ) {
+    const std::string_view builtin = k_builtin_tables[ i ].name;
+
+    const bool same = builtin.size() == trimmed.size() && std::equal( builtin.begin(), builtin.end(), trimmed.begin(), []( const char a, const char b ) {
+      return std::tolower( ( unsigned char ) a ) == std::tolower( ( unsigned char ) b );
+    } );
+
+    if( same && tables[ i ] != nullptr ) {
+      out = make_rule( tables[ i ] );
+      return true;
+    }
+  }
+
+  return false;
+}
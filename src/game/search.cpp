@@ -0,0 +1,367 @@
+#include <game/search.hpp>
+#include <game/random.hpp>
+
+#include <trace.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+  // Generations a cell can travel at the speed of light between two looks at the edge.
+  constexpr size_t k_contain_interval = 4;
+
+  //
+  // Generations between two hashes. A soup of period p is found once the hash comes back after the least multiple
+  // of p that is one of the interval, so hashing less often finds odd periods later but costs a pass over the
+  // universe only every few generations.
+  //
+  constexpr size_t k_hash_interval = 8;
+
+  // Cells a universe grows by in either direction when something comes close to the edge.
+  constexpr size_t k_growth = 32;
+
+  bool parse_count( const std::string_view& text, uint64_t& out ) {
+    const char* end = text.data() + text.size();
+    const auto result = std::from_chars( text.data(), end, out );
+    return !text.empty() && result.ec == std::errc{} && result.ptr == end;
+  }
+
+  // Splits the first word of a line off, the rest is returned without the space in between and may be the line.
+  const std::string_view first_word( const std::string_view line, std::string_view& rest ) {
+    const size_t space = std::min( line.find( ' ' ), line.size() );
+    rest = line.substr( std::min( space + 1, line.size() ) );
+    return line.substr( 0, space );
+  }
+
+}
+
+const uint64_t game::hash_seed( const std::string_view& seed ) {
+  // FNV-1a, finished with a mix so that seeds that differ in one character give unrelated soups.
+  uint64_t hash = 0xCBF29CE484222325ULL;
+
+  for( const char c : seed ) {
+    hash = ( hash ^ ( uint8_t ) c ) * 0x100000001B3ULL;
+  }
+
+  return mix64( hash );
+}
+
+void game::SearchTally::merge( const SearchTally& other ) {
+  soups += other.soups;
+  unsettled += other.unsettled;
+  generations += other.generations;
+
+  for( const auto& [ code, count ] : other.objects ) {
+    objects[ code ] += count;
+  }
+}
+
+bool game::save_checkpoint( const std::string& path, const SearchCheckpoint& checkpoint, std::string& error ) {
+  std::vector< std::pair< std::string, size_t > > objects( checkpoint.tally.objects.begin(), checkpoint.tally.objects.end() );
+
+  std::sort( objects.begin(), objects.end(), []( const auto& a, const auto& b ) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  } );
+
+  const std::string temporary = path + ".tmp";
+
+  {
+    std::ofstream file{ temporary };
+    if( !file ) {
+      error = "can't write " + temporary;
+      return false;
+    }
+
+    const SearchTally& tally = checkpoint.tally;
+
+    file << "seed " << checkpoint.seed << "\n";
+    file << "rule " << checkpoint.rule << "\n";
+    file << "size " << checkpoint.soup_size.x << "x" << checkpoint.soup_size.y << "\n";
+    file << "soups " << tally.soups << " unsettled " << tally.unsettled << " generations " << tally.generations << "\n";
+
+    for( const auto& [ code, count ] : objects ) {
+      file << code << " " << count << "\n";
+    }
+
+    if( !file.flush() ) {
+      error = "can't write " + temporary;
+      return false;
+    }
+  }
+
+  // Replaces the old checkpoint in one step.
+  std::remove( path.c_str() );
+
+  if( std::rename( temporary.c_str(), path.c_str() ) != 0 ) {
+    error = "can't replace " + path + ": " + std::strerror( errno );
+    return false;
+  }
+
+  return true;
+}
+
+bool game::load_checkpoint( const std::string& path, SearchCheckpoint& out, std::string& error ) {
+  std::ifstream file{ path };
+  if( !file ) {
+    error = "can't open " + path;
+    return false;
+  }
+
+  SearchCheckpoint checkpoint{};
+
+  std::string text;
+  size_t number{};
+
+  while( std::getline( file, text ) ) {
+    ++number;
+
+    std::string_view rest;
+    const std::string_view line = text;
+    const std::string_view key = first_word( line, rest );
+
+    bool valid = true;
+
+    if( number == 1 ) {
+      valid = key == "seed";
+      checkpoint.seed = rest;
+    }
+    else if( number == 2 ) {
+      valid = key == "rule";
+      checkpoint.rule = rest;
+    }
+    else if( number == 3 ) {
+      const size_t separator = rest.find( 'x' );
+      uint64_t x{};
+      uint64_t y{};
+
+      valid = key == "size" && separator != std::string_view::npos &&
+        parse_count( rest.substr( 0, separator ), x ) && parse_count( rest.substr( separator + 1 ), y );
+
+      checkpoint.soup_size = { ( size_t ) x, ( size_t ) y };
+    }
+    else if( number == 4 ) {
+      uint64_t soups{};
+      uint64_t unsettled{};
+      uint64_t generations{};
+
+      std::string_view values[ 6 ];
+      values[ 0 ] = key;
+      for( size_t i{ 1 }; i < 6; ++i ) {
+        values[ i ] = first_word( rest, rest );
+      }
+
+      valid = values[ 0 ] == "soups" && values[ 2 ] == "unsettled" && values[ 4 ] == "generations" && rest.empty() &&
+        parse_count( values[ 1 ], soups ) && parse_count( values[ 3 ], unsettled ) && parse_count( values[ 5 ], generations );
+
+      checkpoint.tally.soups = ( size_t ) soups;
+      checkpoint.tally.unsettled = ( size_t ) unsettled;
+      checkpoint.tally.generations = generations;
+    }
+    else if( !line.empty() ) {
+      uint64_t count{};
+      valid = !key.empty() && parse_count( rest, count );
+      checkpoint.tally.objects[ std::string( key ) ] += ( size_t ) count;
+    }
+
+    if( !valid ) {
+      error = path + ":" + std::to_string( number ) + ": malformed line";
+      return false;
+    }
+  }
+
+  if( number < 4 ) {
+    error = path + " is cut short";
+    return false;
+  }
+
+  out = std::move( checkpoint );
+  return true;
+}
+
+game::SoupSearch::SoupSearch( const Rule& rule, const Vec2< size_t >& soup_size, const double density, const size_t max_generations ) :
+  m_rule( rule ),
+  m_soup_size( soup_size ),
+  m_threshold( density_threshold( density ) ),
+  m_max_generations( max_generations ),
+  m_engine( make_engine( rule ) ),
+  m_pool( 1 ),
+  m_census( rule ),
+  m_history{},
+  m_recorded{},
+  m_interval( k_contain_interval )
+{
+  // Nothing comes closer to the edge than the cells can travel between two looks, at a cell per generation and radius.
+  const size_t range = rule.larger() ? rule.radius : 1;
+  m_edge = 2 * m_interval * range;
+}
+
+void game::SoupSearch::run( const uint64_t seed, const uint64_t index, SearchTally& tally ) {
+  place_soup( seed, index );
+
+  bool settled = false;
+  bool contained = true;
+
+  m_recorded = 0;
+
+  for( size_t generation{}; generation <= m_max_generations; ++generation ) {
+    if( generation % m_interval == 0 && !contain( tally ) ) {
+      contained = false;
+      break;
+    }
+
+    if( generation % k_hash_interval == 0 ) {
+      const uint64_t hash = this->hash();
+      const size_t sample = generation / k_hash_interval;
+
+      for( size_t back{ 1 }; back <= std::min( m_recorded, k_history - 1 ); ++back ) {
+        if( m_history[ ( sample - back ) % k_history ] == hash ) {
+          settled = true;
+          break;
+        }
+      }
+
+      if( settled ) {
+        break;
+      }
+
+      m_history[ sample % k_history ] = hash;
+      ++m_recorded;
+    }
+
+    if( generation != m_max_generations ) {
+      m_engine->step( m_universe, m_pool );
+      ++tally.generations;
+    }
+  }
+
+  if( !settled || !contained ) {
+    ++tally.unsettled;
+  }
+
+  const Census census = m_census.take( m_universe, m_pool );
+  for( const auto& object : census.objects ) {
+    tally.objects[ object.code ] += object.count;
+  }
+
+  ++tally.soups;
+}
+
+void game::SoupSearch::place_soup( const uint64_t seed, const uint64_t index ) {
+  // Room for the soup to spread before the first look at the edge.
+  const size_t margin = 4 * m_edge;
+  const Vec2< size_t > bounds = { m_soup_size.x + 2 * margin, m_soup_size.y + 2 * margin };
+
+  // Keeps the buffers of a larger universe of an earlier soup.
+  m_universe.resize( bounds, Anchor::TopLeft );
+  m_universe.clear();
+
+  Xoshiro256 generator{ seed, index };
+
+  for( size_t y{}; y < m_soup_size.y; ++y ) {
+    for( size_t x{}; x < m_soup_size.x; x += 64 ) {
+      const uint64_t live = bernoulli_bits( generator, m_threshold );
+      const size_t count = std::min< size_t >( 64, m_soup_size.x - x );
+
+      for( size_t i{}; i < count; ++i ) {
+        if( ( live >> i ) & 1 ) {
+          m_universe.set_states( margin + y + 1, margin + x + i + 1, 1 );
+        }
+      }
+    }
+  }
+}
+
+const bool game::SoupSearch::contain( SearchTally& tally ) {
+  const size_t columns = m_universe.bounds().x;
+  const size_t rows = m_universe.bounds().y;
+  const size_t stride = m_universe.stride();
+  const uint8_t* current = m_universe.current();
+
+  const auto near_edge = [ & ]( const size_t x, const size_t y ) {
+    return x < m_edge || y < m_edge || x + m_edge >= columns || y + m_edge >= rows;
+  };
+
+  // Most looks find nothing close to the edge, so the rows and columns along it are checked first.
+  bool touched = false;
+
+  for( size_t y{}; y < rows && !touched; ++y ) {
+    const uint8_t* row = current + ( y + 1 ) * stride + 1;
+
+    if( y < m_edge || y + m_edge >= rows ) {
+      touched = std::any_of( row, row + columns, []( const uint8_t cell ) { return cell != 0; } );
+    }
+    else {
+      const size_t edge = std::min( m_edge, columns );
+      touched = std::any_of( row, row + edge, []( const uint8_t cell ) { return cell != 0; } ) ||
+        std::any_of( row + columns - edge, row + columns, []( const uint8_t cell ) { return cell != 0; } );
+    }
+  }
+
+  if( !touched ) {
+    return true;
+  }
+
+  app::TraceZone zone( "SoupSearch::contain" );
+
+  bool grow = false;
+
+  for( const auto& island : m_census.islands( m_universe, m_pool ) ) {
+    if( std::none_of( island.begin(), island.end(), [ & ]( const CellPosition& cell ) { return near_edge( ( size_t ) cell.x, ( size_t ) cell.y ); } ) ) {
+      continue;
+    }
+
+    // Nothing is further out than the edge, so a spaceship there never comes back.
+    const CensusObject object = m_census.classify( island );
+
+    if( object.kind != ObjectKind::Spaceship ) {
+      grow = true;
+      continue;
+    }
+
+    for( const auto& cell : island ) {
+      m_universe.set_states( ( size_t ) cell.y + 1, ( size_t ) cell.x + 1, 0 );
+    }
+
+    ++tally.objects[ object.code ];
+  }
+
+  if( !grow ) {
+    return true;
+  }
+
+  if( columns >= k_max_side && rows >= k_max_side ) {
+    return false;
+  }
+
+  m_universe.resize( { std::min( columns + 2 * k_growth, k_max_side ), std::min( rows + 2 * k_growth, k_max_side ) }, Anchor::Centre );
+
+  // The cells moved in the buffer, so no earlier hash can come back.
+  m_recorded = 0;
+  return true;
+}
+
+const uint64_t game::SoupSearch::hash() const {
+  const uint8_t* cells = m_universe.current();
+  const size_t size = m_universe.size();
+
+  uint64_t hash = size;
+  size_t i{};
+
+  for( ; i + 8 <= size; i += 8 ) {
+    uint64_t word;
+    std::memcpy( &word, cells + i, 8 );
+    hash = mix64( hash ^ word );
+  }
+
+  for( ; i < size; ++i ) {
+    hash = mix64( hash ^ cells[ i ] );
+  }
+
+  return hash;
+}
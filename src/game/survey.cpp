@@ -0,0 +1,333 @@
+#include <game/survey.hpp>
+
+#include <game/random.hpp>
+#include <game/search.hpp>
+
+#include <trace.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+  // Generations a cell can travel at the speed of light between two looks at the edge, like SoupSearch.
+  constexpr size_t k_contain_interval = 4;
+
+  // Cells from the edge that a lane is looked at for, room for a spaceship to move before the next look.
+  constexpr size_t k_edge = 2 * k_contain_interval;
+
+  // Cells between a soup and the edge of its universe on every side, as much as SoupSearch leaves before it grows.
+  constexpr size_t k_margin = 4 * k_edge;
+
+}
+
+const game::Rule game::life_like_rule( const size_t index ) {
+  return { ( uint16_t ) ( index & 0x1FF ), ( uint16_t ) ( ( index >> 9 ) & 0x1FF ), 2 };
+}
+
+const std::vector< game::Rule > game::sample_life_like_rules( const size_t count, const uint64_t seed ) {
+  std::vector< uint32_t > indices( k_life_like_rules );
+  std::iota( indices.begin(), indices.end(), 0U );
+
+  const size_t picked = std::min( count, k_life_like_rules );
+  Xoshiro256 generator{ seed };
+
+  // The first rules of a shuffle that stops once it has enough of them.
+  for( size_t i{}; i < picked; ++i ) {
+    const size_t other = i + ( size_t ) ( generator() % ( k_life_like_rules - i ) );
+    std::swap( indices[ i ], indices[ other ] );
+  }
+
+  std::sort( indices.begin(), indices.begin() + picked );
+
+  std::vector< Rule > rules;
+  for( size_t i{}; i < picked; ++i ) {
+    rules.push_back( life_like_rule( indices[ i ] ) );
+  }
+
+  return rules;
+}
+
+const std::string game::survey_header() {
+  std::string header = "rule,soups,died,escaped,spaceships,growth,density";
+
+  for( size_t bucket{}; bucket < k_period_buckets; ++bucket ) {
+    const size_t last = ( size_t ) 1 << bucket;
+    const size_t first = bucket < 2 ? last : last / 2 + 1;
+
+    header += first == last ? ",p" + std::to_string( last ) : ",p" + std::to_string( first ) + "-" + std::to_string( last );
+  }
+
+  return header + ",unsettled";
+}
+
+const std::string game::survey_row( const SurveyResult& result ) {
+  char numbers[ 64 ];
+  std::snprintf( numbers, sizeof( numbers ), "%.6g,%.6g", result.growth, result.density );
+
+  // Left empty rather than zero where spaceships weren't looked for.
+  std::string row = result.rule.to_string() + "," + std::to_string( result.soups ) + "," + std::to_string( result.died ) + "," +
+    std::to_string( result.escaped ) + "," + ( result.censused ? std::to_string( result.spaceships ) : "" ) + "," + numbers;
+
+  for( const size_t count : result.periods ) {
+    row += "," + std::to_string( count );
+  }
+
+  return row + "," + std::to_string( result.unsettled );
+}
+
+game::RuleSurvey::RuleSurvey( const Vec2< size_t >& soup_size, const size_t generations, const size_t soups, const double density ) :
+  m_soup_size( soup_size ),
+  m_generations( std::max< size_t >( generations, 1 ) ),
+  m_batches( std::max< size_t >( ( soups + Multiverse::k_lanes - 1 ) / Multiverse::k_lanes, 1 ) ),
+  m_threshold( density_threshold( density ) ),
+  m_pool( 1 ),
+  m_memory( app::MemoryCategory::Cells )
+{
+  m_multiverse.init( { soup_size.x + 2 * k_margin, soup_size.y + 2 * k_margin } );
+
+  const Vec2< size_t >& bounds = m_multiverse.bounds();
+  m_edge_cells.resize( 2 * k_edge * ( bounds.x + bounds.y - 2 * k_edge ) );
+
+  m_history.resize( k_max_period * m_multiverse.size() );
+  m_memory.set( ( m_history.size() + m_edge_cells.size() ) * sizeof( uint64_t ) );
+}
+
+const game::SurveyResult game::RuleSurvey::run( const Rule& rule ) {
+  app::TraceZone zone( "RuleSurvey::run" );
+
+  SurveyResult result{ rule, soups(), 0, 0, 0, census_supports( rule ), {}, 0, 0.0, 0.0 };
+
+  m_engine.set_rule( rule );
+
+  // Spaceships are only looked for in lanes that reach the edge, so the taker is only ever used for a few islands.
+  CensusTaker census( rule, k_max_spaceship_period );
+
+  const uint64_t seed = hash_seed( rule.to_string() );
+  const size_t half = m_generations / 2;
+  const size_t size = m_multiverse.size();
+
+  double gained{};
+  double live_cells{};
+
+  for( size_t batch{}; batch < m_batches; ++batch ) {
+    place_soups( seed, batch );
+
+    uint64_t watched = UINT64_MAX;
+    uint64_t escaped{};
+    uint64_t spaceships{};
+
+    uint64_t half_population = half == 0 ? population( m_multiverse.current() ) : 0;
+
+    if( m_generations <= k_max_period ) {
+      std::memcpy( m_history.data(), m_multiverse.current(), size * sizeof( uint64_t ) );
+    }
+
+    bool settled = false;
+
+    for( size_t generation{ 1 }; generation <= m_generations; ++generation ) {
+      m_engine.step( m_multiverse, m_pool );
+
+      if( generation == half ) {
+        half_population = population( m_multiverse.current() );
+      }
+
+      if( generation % k_contain_interval == 0 && watched != 0 ) {
+        const uint64_t lanes = changed_near_edge() & watched;
+
+        if( lanes != 0 ) {
+          escaped |= contain( lanes, census, spaceships );
+          watched &= ~escaped;
+        }
+      }
+
+      const size_t left = m_generations - generation;
+
+      // The last generation itself would take the slot of the earliest one that is compared with it.
+      if( left != 0 && left <= k_max_period ) {
+        std::memcpy( m_history.data() + ( generation % k_max_period ) * size, m_multiverse.current(), size * sizeof( uint64_t ) );
+      }
+
+      // Every lane alternates between the last two generations, so the last one is the current one or the one before.
+      if( m_multiverse.changed_twice() == 0 && left % 2 == 0 && left != 0 ) {
+        if( generation < half ) {
+          half_population = population( ( half - generation ) % 2 == 0 ? m_multiverse.current() : m_multiverse.next() );
+        }
+
+        settled = true;
+        break;
+      }
+    }
+
+    const uint64_t live = m_multiverse.live();
+    const uint64_t final_population = population( m_multiverse.current() );
+
+    result.died += Multiverse::k_lanes - ( size_t ) std::popcount( live );
+    result.escaped += ( size_t ) std::popcount( escaped );
+    result.spaceships += ( size_t ) std::popcount( spaceships );
+
+    gained += ( double ) final_population - ( double ) half_population;
+    live_cells += ( double ) final_population;
+
+    tally_periods( live, settled, result );
+  }
+
+  const Vec2< size_t >& bounds = m_multiverse.bounds();
+
+  result.growth = gained / ( double ) ( m_generations - half ) / ( double ) result.soups;
+  result.density = live_cells / ( ( double ) bounds.x * ( double ) bounds.y ) / ( double ) result.soups;
+
+  return result;
+}
+
+void game::RuleSurvey::place_soups( const uint64_t seed, const size_t batch ) {
+  m_multiverse.clear();
+  std::fill( m_edge_cells.begin(), m_edge_cells.end(), 0 );
+
+  uint64_t* current = m_multiverse.current();
+  const size_t stride = m_multiverse.stride();
+
+  // A word of random bits per cell is a cell of every soup of the batch, a stream per row like Multiverse::randomise.
+  for( size_t y{}; y < m_soup_size.y; ++y ) {
+    Xoshiro256 generator{ mix64( seed + batch ), y };
+
+    uint64_t* row = current + ( k_margin + y + 1 ) * stride + k_margin + 1;
+
+    for( size_t x{}; x < m_soup_size.x; ++x ) {
+      row[ x ] = bernoulli_bits( generator, m_threshold );
+    }
+  }
+
+  std::memcpy( m_multiverse.next(), current, m_multiverse.size() * sizeof( uint64_t ) );
+}
+
+const uint64_t game::RuleSurvey::changed_near_edge() {
+  const Vec2< size_t >& bounds = m_multiverse.bounds();
+  const size_t stride = m_multiverse.stride();
+  const uint64_t* current = m_multiverse.current();
+
+  uint64_t lanes{};
+  uint64_t* seen = m_edge_cells.data();
+
+  const auto look = [ & ]( const uint64_t cell ) {
+    lanes |= cell ^ *seen;
+    *seen++ = cell;
+  };
+
+  for( size_t y{}; y < bounds.y; ++y ) {
+    const uint64_t* row = current + ( y + 1 ) * stride + 1;
+
+    if( y < k_edge || y + k_edge >= bounds.y ) {
+      for( size_t x{}; x < bounds.x; ++x ) {
+        look( row[ x ] );
+      }
+    }
+    else {
+      for( size_t x{}; x < k_edge; ++x ) {
+        look( row[ x ] );
+        look( row[ bounds.x - 1 - x ] );
+      }
+    }
+  }
+
+  return lanes;
+}
+
+const uint64_t game::RuleSurvey::contain( const uint64_t lanes, CensusTaker& census, uint64_t& spaceships ) {
+  app::TraceZone zone( "RuleSurvey::contain" );
+
+  // Without a census there is no telling a spaceship from anything else.
+  if( !census_supports( census.rule() ) ) {
+    return lanes;
+  }
+
+  const Vec2< size_t >& bounds = m_multiverse.bounds();
+  const size_t stride = m_multiverse.stride();
+
+  const auto near = [ & ]( const CellPosition& cell ) {
+    return ( size_t ) cell.x < k_edge || ( size_t ) cell.y < k_edge || ( size_t ) cell.x + k_edge >= bounds.x || ( size_t ) cell.y + k_edge >= bounds.y;
+  };
+
+  uint64_t escaped{};
+
+  for( uint64_t remaining{ lanes }; remaining != 0; remaining &= remaining - 1 ) {
+    const size_t lane = ( size_t ) std::countr_zero( remaining );
+    const uint64_t bit = ( uint64_t ) 1 << lane;
+
+    m_multiverse.extract( lane, m_lane );
+
+    for( const auto& island : census.islands( m_lane, m_pool ) ) {
+      if( std::none_of( island.begin(), island.end(), near ) ) {
+        continue;
+      }
+
+      const ObjectKind kind = island.size() > k_max_spaceship_cells ? ObjectKind::Pathological : census.classify( island ).kind;
+
+      // Ash that settled close to the edge stays where it is, the lane is looked at again once it changes.
+      if( kind == ObjectKind::StillLife || kind == ObjectKind::Oscillator || kind == ObjectKind::Dying ) {
+        continue;
+      }
+
+      if( kind != ObjectKind::Spaceship ) {
+        escaped |= bit;
+        break;
+      }
+
+      spaceships |= bit;
+
+      // From both generations, so that the lane doesn't seem to change for the removal.
+      for( const auto& cell : island ) {
+        const size_t index = ( ( size_t ) cell.y + 1 ) * stride + ( size_t ) cell.x + 1;
+
+        m_multiverse.current()[ index ] &= ~bit;
+        m_multiverse.next()[ index ] &= ~bit;
+      }
+    }
+  }
+
+  return escaped;
+}
+
+const uint64_t game::RuleSurvey::population( const uint64_t* cells ) const {
+  uint64_t population{};
+
+  // The border is dead, so the whole buffer can be counted.
+  for( size_t cell{}; cell < m_multiverse.size(); ++cell ) {
+    population += ( uint64_t ) std::popcount( cells[ cell ] );
+  }
+
+  return population;
+}
+
+void game::RuleSurvey::tally_periods( const uint64_t live, const bool settled, SurveyResult& result ) const {
+  if( settled ) {
+    result.periods[ 0 ] += ( size_t ) std::popcount( live & ~m_multiverse.changed() );
+    result.periods[ 1 ] += ( size_t ) std::popcount( live & m_multiverse.changed() );
+    return;
+  }
+
+  const size_t size = m_multiverse.size();
+  const uint64_t* current = m_multiverse.current();
+
+  uint64_t remaining = live;
+
+  for( size_t period{ 1 }; period <= std::min( k_max_period, m_generations ) && remaining != 0; ++period ) {
+    const uint64_t* earlier = m_history.data() + ( ( m_generations - period ) % k_max_period ) * size;
+
+    uint64_t differ{};
+    for( size_t cell{}; cell < size; ++cell ) {
+      differ |= current[ cell ] ^ earlier[ cell ];
+    }
+
+    const uint64_t found = remaining & ~differ;
+    const size_t bucket = ( size_t ) std::bit_width( period - 1 );
+
+    result.periods[ bucket ] += ( size_t ) std::popcount( found );
+    remaining &= differ;
+  }
+
+  result.unsettled += ( size_t ) std::popcount( remaining );
+}
@@ -0,0 +1,405 @@
+#include <game/universe.hpp>
+
+#include <game/random.hpp>
+#include <game/pattern.hpp>
+
+#include <thread_pool.hpp>
+
+#include <array>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+  // Maps 8 packed bits to 8 cells, so random words can be written out a byte-octet at a time.
+  constexpr auto k_expand_bits = []() {
+    std::array< std::array< uint8_t, 8 >, 256 > table{};
+    for( size_t value{}; value < 256; ++value ) {
+      for( size_t bit{}; bit < 8; ++bit ) {
+        table[ value ][ bit ] = ( value >> bit ) & 1;
+      }
+    }
+    return table;
+  }();
+
+  //
+  // Works out which part of an axis survives a resize.
+  //
+  //    from: old length of the axis
+  //    to: new length of the axis
+  //    source: first surviving cell in the old universe
+  //    destination: where that cell ends up in the new universe
+  //    length: number of surviving cells
+  //
+  void anchor_axis( const size_t from, const size_t to, const game::Anchor anchor, size_t& source, size_t& destination, size_t& length ) {
+    length = std::min( from, to );
+    source = 0;
+    destination = 0;
+
+    if( anchor == game::Anchor::Centre ) {
+      if( to > from ) {
+        destination = ( to - from ) / 2;
+      }
+      else {
+        source = ( from - to ) / 2;
+      }
+    }
+  }
+
+}
+
+game::Universe::Universe() :
+  m_bounds{},
+  m_capacity{},
+  m_generation{},
+  m_memory( app::MemoryCategory::Cells )
+{
+}
+
+void game::Universe::reset() {
+  m_bounds = {};
+  m_capacity = 0;
+  m_generation = 0;
+  m_cells_current.reset();
+  m_cells_next.reset();
+  m_memory.set( 0 );
+  m_planes.reset();
+}
+
+void game::Universe::init( const Vec2< size_t >& bounds ) {
+  m_bounds = bounds;
+  m_capacity = size();
+  m_generation = 0;
+
+  // Release the old buffers first so the peak isn't both of them.
+  m_cells_current.reset();
+  m_cells_next.reset();
+  m_planes.reset();
+
+  m_cells_current = std::make_unique< uint8_t[] >( m_capacity );
+  m_cells_next = std::make_unique< uint8_t[] >( m_capacity );
+  m_memory.set( bytes_required( bounds ) );
+}
+
+void game::Universe::resize( const Vec2< size_t >& bounds, const Anchor anchor ) {
+  if( !m_cells_current ) {
+    init( bounds );
+    return;
+  }
+
+  if( bounds == m_bounds ) {
+    return;
+  }
+
+  detach( false );
+  detach( true );
+
+  const Vec2< size_t > old_bounds = m_bounds;
+  const size_t old_stride = stride();
+
+  m_bounds = bounds;
+
+  //
+  // The pattern is copied into a buffer laid out for the new bounds, which is either the next generation
+  // (it is about to be overwritten anyway) or a fresh allocation when the bounds outgrow the capacity.
+  //
+  std::unique_ptr< uint8_t[] > target;
+  const bool grow = size() > m_capacity;
+
+  if( grow ) {
+    m_capacity = size();
+    target = std::make_unique< uint8_t[] >( m_capacity );
+  }
+  else {
+    target = std::move( m_cells_next );
+    memset( target.get(), 0, size() );
+  }
+
+  size_t source_x, destination_x, width;
+  size_t source_y, destination_y, height;
+  anchor_axis( old_bounds.x, m_bounds.x, anchor, source_x, destination_x, width );
+  anchor_axis( old_bounds.y, m_bounds.y, anchor, source_y, destination_y, height );
+
+  for( size_t row{}; row < height; ++row ) {
+    memcpy(
+      target.get() + ( destination_y + row + 1 ) * stride() + destination_x + 1,
+      m_cells_current.get() + ( source_y + row + 1 ) * old_stride + source_x + 1,
+      width
+    );
+  }
+
+  if( grow ) {
+    m_cells_next = std::make_unique_for_overwrite< uint8_t[] >( m_capacity );
+    m_memory.set( bytes_required( bounds ) );
+  }
+  else {
+    m_cells_next = std::move( m_cells_current );
+  }
+
+  m_cells_current = std::move( target );
+
+  // Both generations start out identical.
+  memcpy( m_cells_next.get(), m_cells_current.get(), size() );
+}
+
+void game::Universe::clear() {
+  detach( false );
+  detach( true );
+
+  m_generation = 0;
+
+  if( m_cells_current ) {
+    memset( m_cells_current.get(), 0, size() );
+  }
+
+  if( m_cells_next ) {
+    memset( m_cells_next.get(), 0, size() );
+  }
+}
+
+void game::Universe::restrict_states( const size_t states ) {
+  if( !m_cells_current ) {
+    return;
+  }
+
+  detach( false );
+  detach( true );
+
+  // The border is dead, so the whole buffers can be swept.
+  for( size_t i{}; i < size(); ++i ) {
+    if( m_cells_current[ i ] >= states ) {
+      m_cells_current[ i ] = 0;
+    }
+
+    if( m_cells_next[ i ] >= states ) {
+      m_cells_next[ i ] = 0;
+    }
+  }
+}
+
+void game::Universe::copy( const Universe& other ) {
+  if( other.current() == nullptr ) {
+    reset();
+    return;
+  }
+
+  detach( false );
+  detach( true );
+
+  if( other.size() > m_capacity ) {
+    init( other.bounds() );
+  }
+
+  m_bounds = other.bounds();
+  m_generation = other.generation();
+
+  memcpy( m_cells_current.get(), other.current(), size() );
+  memcpy( m_cells_next.get(), other.next(), size() );
+}
+
+void game::Universe::place( const Pattern& pattern, const Vec2i& origin ) {
+  const auto& size = pattern.bounds();
+
+  for( size_t y{}; y < size.y; ++y ) {
+    const int row = origin.y + ( int ) y;
+    if( row < 0 || row >= ( int ) m_bounds.y ) {
+      continue;
+    }
+
+    for( size_t x{}; x < size.x; ++x ) {
+      const int column = origin.x + ( int ) x;
+      if( column < 0 || column >= ( int ) m_bounds.x ) {
+        continue;
+      }
+
+      const uint8_t state = pattern.get( x, y );
+      if( state != 0 ) {
+        set_states( ( size_t ) row + 1, ( size_t ) column + 1, state );
+      }
+    }
+  }
+}
+
+void game::Universe::randomise( app::ThreadPool& pool, const uint64_t seed, const double density ) {
+  if( !m_cells_current ) {
+    return;
+  }
+
+  const size_t rows = m_bounds.y;
+  const size_t columns = m_bounds.x;
+  const uint32_t threshold = density_threshold( density );
+
+  detach( false );
+  detach( true );
+
+  m_generation = 0;
+
+  uint8_t* cells = m_cells_current.get();
+
+  //
+  // Every row draws from its own generator stream that is derived from the seed and the row index alone,
+  // so the result does not depend on how the rows are distributed over the workers.
+  //
+  pool.parallel_for( rows, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t row{ begin }; row < end; ++row ) {
+      Xoshiro256 generator{ seed, row };
+
+      uint8_t* out = cells + ( row + 1 ) * stride() + 1;
+
+      for( size_t column{}; column < columns; column += 64 ) {
+        const uint64_t bits = bernoulli_bits( generator, threshold );
+        const size_t count = std::min< size_t >( 64, columns - column );
+
+        size_t i{};
+        for( ; i + 8 <= count; i += 8 ) {
+          memcpy( out + column + i, k_expand_bits[ ( bits >> i ) & 0xFF ].data(), 8 );
+        }
+
+        for( ; i < count; ++i ) {
+          out[ column + i ] = ( bits >> i ) & 1;
+        }
+      }
+    }
+  } );
+
+  // Both generations start out identical.
+  memcpy( m_cells_next.get(), m_cells_current.get(), size() );
+}
+
+const game::Region game::Universe::apply( const std::vector< Span >& spans ) {
+  detach( false );
+  detach( true );
+
+  Region region{};
+
+  for( const auto& span : spans ) {
+    const size_t offset = ( span.row + 1 ) * stride() + span.begin + 1;
+    const size_t length = span.end - span.begin;
+
+    memset( m_cells_current.get() + offset, span.state, length );
+    memset( m_cells_next.get() + offset, span.state, length );
+
+    region.merge( { span.begin, span.row, span.end, span.row + 1 } );
+  }
+
+  return region;
+}
+
+void game::Universe::swap() {
+  catch_up( false );
+  catch_up( true );
+
+  std::swap( m_cells_current, m_cells_next );
+  ++m_generation;
+}
+
+game::BitPlanes& game::Universe::planes( const size_t digits, app::ThreadPool& pool ) {
+  if( m_planes == nullptr ) {
+    m_planes = std::make_unique< BitPlanes >();
+  }
+
+  BitPlanes& planes = *m_planes;
+
+  if( !planes.m_valid.load( std::memory_order_relaxed ) || !( planes.bounds() == m_bounds ) || planes.digits() != digits ) {
+    // Laying the planes out again loses whatever the bytes are behind on.
+    catch_up( false );
+    catch_up( true );
+
+    planes.layout( m_bounds, digits );
+    planes.pack( m_cells_current.get(), stride(), pool );
+    planes.m_valid.store( true, std::memory_order_relaxed );
+  }
+
+  return planes;
+}
+
+void game::Universe::step_planes() {
+  // The bytes of the generation that was current are the one before it now, behind the planes or not.
+  std::swap( m_cells_current, m_cells_next );
+  ++m_generation;
+
+  m_planes->m_previous_ahead.store( m_planes->m_current_ahead.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+  m_planes->m_current_ahead.store( true, std::memory_order_release );
+}
+
+void game::Universe::write_back( const bool previous ) const {
+  std::lock_guard< std::mutex > lock( m_planes->m_catch_up );
+
+  std::atomic< bool >& ahead = previous ? m_planes->m_previous_ahead : m_planes->m_current_ahead;
+
+  // Another thread may have caught up while this one waited.
+  if( ahead.load( std::memory_order_relaxed ) ) {
+    m_planes->unpack( previous ? m_cells_next.get() : m_cells_current.get(), stride(), previous );
+    ahead.store( false, std::memory_order_release );
+  }
+}
+
+const uint8_t game::Universe::get_state( const size_t row, const size_t column ) const {
+  catch_up( false );
+  return m_cells_current[ row * stride() + column ];
+}
+
+void game::Universe::set_state( const size_t row, const size_t column, const uint8_t state ) {
+  detach( true );
+  m_cells_next[ row * stride() + column ] = state;
+}
+
+void game::Universe::set_states( const size_t row, const size_t column, const uint8_t state ) {
+  detach( false );
+  detach( true );
+
+  m_cells_current[ row * stride() + column ] = state;
+  m_cells_next[ row * stride() + column ] = state;
+}
+
+const size_t game::Universe::num_alive_neighbors( const size_t row, const size_t column ) const {
+  catch_up( false );
+
+  const size_t stride = this->stride();
+
+  const auto alive = [ & ]( const size_t r, const size_t c ) -> size_t {
+    return m_cells_current[ r * stride + c ] == 1;
+  };
+
+  return alive( row - 1, column ) +
+    alive( row, column - 1 ) +
+    alive( row - 1, column - 1 ) +
+    alive( row + 1, column ) +
+    alive( row, column + 1 ) +
+    alive( row + 1, column + 1 ) +
+    alive( row + 1, column - 1 ) +
+    alive( row - 1, column + 1 );
+}
+
+const size_t game::Universe::live_block( const size_t row, const size_t column ) const {
+  catch_up( false );
+
+  const size_t stride = this->stride();
+
+  size_t block{};
+  for( size_t dx{}; dx < 3; ++dx ) {
+    for( size_t dy{}; dy < 3; ++dy ) {
+      if( m_cells_current[ ( row + dy - 1 ) * stride + column + dx - 1 ] == 1 ) {
+        block |= ( size_t ) 1 << ( 3 * dx + dy );
+      }
+    }
+  }
+
+  return block;
+}
+
+const size_t game::Universe::population() const {
+  catch_up( false );
+
+  size_t population{};
+
+  for( size_t row{ 1 }; row <= m_bounds.y; ++row ) {
+    const uint8_t* cells = m_cells_current.get() + row * stride();
+
+    for( size_t column{ 1 }; column <= m_bounds.x; ++column ) {
+      population += cells[ column ] != 0;
+    }
+  }
+
+  return population;
+}
@@ -0,0 +1,208 @@
+#include <game/volume.hpp>
+#include <game/random.hpp>
+
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstring>
+
+namespace {
+
+  bool parse_count( const std::string_view& text, uint32_t& out ) {
+    if( text.empty() || text.size() > 2 ) {
+      return false;
+    }
+
+    out = 0;
+    for( const char c : text ) {
+      if( !std::isdigit( ( unsigned char ) c ) ) {
+        return false;
+      }
+
+      out = out * 10 + ( uint32_t ) ( c - '0' );
+    }
+
+    return out <= game::VolumeRule::k_neighbours;
+  }
+
+}
+
+const std::string game::VolumeRule::to_string() const {
+  const uint32_t counts[ 4 ] = { survival.min, survival.max, birth.min, birth.max };
+  const bool digits = std::all_of( std::begin( counts ), std::end( counts ), []( const uint32_t count ) { return count <= 9; } );
+
+  std::string text;
+  for( const uint32_t count : counts ) {
+    if( !digits && !text.empty() ) {
+      text.push_back( '/' );
+    }
+
+    text += std::to_string( count );
+  }
+
+  return text;
+}
+
+bool game::parse_volume_rule( const std::string_view& text, VolumeRule& out ) {
+  std::vector< std::string_view > parts;
+
+  if( text.find( '/' ) == std::string_view::npos ) {
+    if( text.size() != 4 ) {
+      return false;
+    }
+
+    for( size_t i{}; i < 4; ++i ) {
+      parts.push_back( text.substr( i, 1 ) );
+    }
+  }
+  else {
+    size_t begin{};
+    while( begin <= text.size() ) {
+      const size_t end = std::min( text.find( '/', begin ), text.size() );
+      parts.push_back( text.substr( begin, end - begin ) );
+      begin = end + 1;
+    }
+  }
+
+  uint32_t counts[ 4 ]{};
+  if( parts.size() != 4 ) {
+    return false;
+  }
+
+  for( size_t i{}; i < 4; ++i ) {
+    if( !parse_count( parts[ i ], counts[ i ] ) ) {
+      return false;
+    }
+  }
+
+  if( counts[ 0 ] > counts[ 1 ] || counts[ 2 ] > counts[ 3 ] ) {
+    return false;
+  }
+
+  out = { { counts[ 0 ], counts[ 1 ] }, { counts[ 2 ], counts[ 3 ] } };
+  return true;
+}
+
+const std::vector< game::NamedRule >& game::named_volume_rules() {
+  static const std::vector< NamedRule > rules = {
+    { "Life 4555", "4555" },
+    { "Life 5766", "5766" }
+  };
+
+  return rules;
+}
+
+game::Volume::Volume() :
+  m_bounds{},
+  m_row_words{},
+  m_words{},
+  m_memory( app::MemoryCategory::Cells )
+{
+}
+
+void game::Volume::reset() {
+  m_bounds = {};
+  m_row_words = 0;
+  m_words = 0;
+  m_words_current.reset();
+  m_words_next.reset();
+  m_memory.set( 0 );
+}
+
+void game::Volume::init( const Vec3< size_t >& bounds ) {
+  m_bounds = bounds;
+  m_row_words = row_words( bounds.x );
+  m_words = m_row_words * bounds.y * bounds.z;
+
+  // Release the old buffers first so the peak isn't both of them.
+  m_words_current.reset();
+  m_words_next.reset();
+
+  m_words_current = std::make_unique< uint64_t[] >( m_words );
+  m_words_next = std::make_unique< uint64_t[] >( m_words );
+  m_memory.set( bytes_required( bounds ) );
+}
+
+void game::Volume::clear() {
+  if( m_words_current ) {
+    std::fill_n( m_words_current.get(), m_words, 0 );
+    std::fill_n( m_words_next.get(), m_words, 0 );
+  }
+}
+
+void game::Volume::randomise( app::ThreadPool& pool, const uint64_t seed, const double density ) {
+  if( !m_words_current ) {
+    return;
+  }
+
+  const uint32_t threshold = density_threshold( density );
+  const uint64_t mask = last_word_mask();
+
+  // Every row draws from its own stream, like the rows of Universe::randomise.
+  pool.parallel_for( m_bounds.y * m_bounds.z, [ & ]( const size_t begin, const size_t end ) {
+    for( size_t index{ begin }; index < end; ++index ) {
+      Xoshiro256 generator{ seed, index };
+
+      uint64_t* words = m_words_current.get() + index * m_row_words;
+      for( size_t i{}; i < m_row_words; ++i ) {
+        words[ i ] = bernoulli_bits( generator, threshold );
+      }
+
+      words[ m_row_words - 1 ] &= mask;
+    }
+  } );
+
+  // Both generations start out identical.
+  std::copy_n( m_words_current.get(), m_words, m_words_next.get() );
+}
+
+const game::Region game::Volume::apply( const std::vector< Span >& spans, const size_t z ) {
+  Region region{};
+
+  if( z >= m_bounds.z ) {
+    return region;
+  }
+
+  for( const auto& span : spans ) {
+    for( size_t x{ span.begin }; x < span.end; ++x ) {
+      set( x, span.row, z, span.state != 0 );
+    }
+
+    region.merge( { span.begin, span.row, span.end, span.row + 1 } );
+  }
+
+  return region;
+}
+
+void game::Volume::swap() {
+  std::swap( m_words_current, m_words_next );
+}
+
+const bool game::Volume::get( const ptrdiff_t x, const ptrdiff_t y, const ptrdiff_t z ) const {
+  if( x < 0 || y < 0 || z < 0 || ( size_t ) x >= m_bounds.x || ( size_t ) y >= m_bounds.y || ( size_t ) z >= m_bounds.z ) {
+    return false;
+  }
+
+  return ( row( ( size_t ) y, ( size_t ) z )[ ( size_t ) x / 64 ] >> ( ( size_t ) x % 64 ) ) & 1;
+}
+
+void game::Volume::set( const size_t x, const size_t y, const size_t z, const bool alive ) {
+  const size_t index = ( z * m_bounds.y + y ) * m_row_words + x / 64;
+  const uint64_t bit = ( uint64_t ) 1 << ( x % 64 );
+
+  for( uint64_t* words : { m_words_current.get(), m_words_next.get() } ) {
+    words[ index ] = alive ? words[ index ] | bit : words[ index ] & ~bit;
+  }
+}
+
+const size_t game::Volume::population() const {
+  size_t population{};
+
+  for( size_t i{}; i < m_words; ++i ) {
+    population += ( size_t ) std::popcount( m_words_current[ i ] );
+  }
+
+  return population;
+}
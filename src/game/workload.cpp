@@ -0,0 +1,141 @@
+#include <game/workload.hpp>
+
+#include <game/universe.hpp>
+#include <game/pattern.hpp>
+#include <game/random.hpp>
+
+namespace {
+
+  // Still lifes of the still life field, none is larger than 4x4 cells.
+  constexpr const char* k_still_lifes[] = {
+    "2o$2o!",
+    "b2o$o2bo$b2o!",
+    "b2o$o2bo$bobo$2bo!",
+    "2o$obo$bo!",
+    "bo$obo$bo!"
+  };
+
+  // Every still life sits in its own tile, so there are at least two dead cells between any two of them.
+  constexpr size_t k_still_life_tile = 6;
+
+  bool load_still_life_field( game::Universe& universe ) {
+    std::vector< game::Pattern > still_lifes;
+    for( const auto rle : k_still_lifes ) {
+      if( !still_lifes.emplace_back().load_rle( rle ) ) {
+        return false;
+      }
+    }
+
+    const auto& bounds = universe.bounds();
+
+    // Only whole tiles are filled, a still life that is cut off by the border wouldn't be still.
+    for( size_t y{}; y + k_still_life_tile <= bounds.y; y += k_still_life_tile ) {
+      for( size_t x{}; x + k_still_life_tile <= bounds.x; x += k_still_life_tile ) {
+        const uint64_t hash = game::mix64( ( ( uint64_t ) y << 32 ) | x );
+        const auto& still_life = still_lifes[ hash % still_lifes.size() ];
+
+        universe.place( still_life, { ( int ) x + 1, ( int ) y + 1 } );
+      }
+    }
+
+    return true;
+  }
+
+}
+
+const std::vector< game::Workload >& game::workloads() {
+  static const std::vector< Workload > workloads = {
+    {
+      "r-pentomino", "R-pentomino, a methuselah that settles after 1103 generations",
+      WorkloadKind::Pattern, "b2o$2o$bo!", 0.0, 0, { 512, 512 },
+      { { { 0, 5 }, { 100, 121 }, { 500, 174 } } }
+    },
+    {
+      "acorn", "Acorn, a methuselah that settles after 5206 generations",
+      WorkloadKind::Pattern, "bo5b$3bo3b$2o2b3o!", 0.0, 0, { 512, 512 },
+      { { { 0, 7 }, { 100, 76 }, { 500, 276 } } }
+    },
+    {
+      "gosper-gun", "Gosper glider gun, emits a glider every 30 generations",
+      WorkloadKind::Pattern, "24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o4bobo$10bo5bo7bo$11bo3bo$12b2o!", 0.0, 0, { 512, 512 },
+      { { { 0, 36 }, { 100, 63 }, { 500, 134 } } }
+    },
+    {
+      "switch-engine", "10 cell seed of a block laying switch engine, grows forever",
+      WorkloadKind::Pattern, "6bob$4bob2o$4bobo$4bo$2bo$obo!", 0.0, 0, { 512, 512 },
+      { { { 0, 10 }, { 100, 102 }, { 500, 166 } } }
+    },
+    {
+      "max", "Max, the smallest known spacefiller, grows quadratically",
+      WorkloadKind::Pattern, "18bo8b$17b3o7b$12b3o4b2o6b$11bo2b3o2bob2o4b$10bo3bobo2bobo5b$10bo4bobobobob2o2b$12bo4bobo3b2o2b$4o5bobo4bo3bob3o2b$o3b2obob3ob2o9b2ob$o5b2o5bo13b$bo2b2obo2bo2bob2o10b$7bobobobobobo5b4o$bo2b2obo2bo2bo2b2obob2o3bo$o5b2o3bobobo3b2o5bo$o3b2obob2o2bo2bo2bob2o2bob$4o5bobobobobobo7b$10b2obo2bo2bob2o2bob$13bo5b2o5bo$b2o9b2ob3obob2o3bo$2b3obo3bo4bobo5b4o$2b2o3bobo4bo12b$2b2obobobobo4bo10b$5bobo2bobo3bo10b$4b2obo2b3o2bo11b$6b2o4b3o12b$7b3o17b$8bo!", 0.0, 0, { 640, 640 },
+      { { { 0, 187 }, { 100, 3645 }, { 500, 67445 } } }
+    },
+    {
+      "still-life-field", "Still lifes in every 6x6 tile, nothing ever changes",
+      WorkloadKind::StillLifeField, nullptr, 0.0, 0, { 512, 512 },
+      { { { 0, 37629 }, { 100, 37629 }, { 500, 37629 } } }
+    },
+    {
+      "soup-10", "Random soup, 10% alive",
+      WorkloadKind::Soup, nullptr, 0.10, 1, { 512, 512 },
+      { { { 0, 26341 }, { 100, 12444 }, { 500, 10492 } } }
+    },
+    {
+      "soup-35", "Random soup, 35% alive",
+      WorkloadKind::Soup, nullptr, 0.35, 1, { 512, 512 },
+      { { { 0, 91691 }, { 100, 25463 }, { 500, 14351 } } }
+    },
+    {
+      "soup-50", "Random soup, 50% alive",
+      WorkloadKind::Soup, nullptr, 0.50, 1, { 512, 512 },
+      { { { 0, 130766 }, { 100, 24303 }, { 500, 14101 } } }
+    }
+  };
+
+  return workloads;
+}
+
+const game::Workload* game::find_workload( const std::string_view& id ) {
+  for( const auto& workload : workloads() ) {
+    if( id == workload.id ) {
+      return &workload;
+    }
+  }
+
+  return nullptr;
+}
+
+bool game::load_workload( const Workload& workload, Universe& universe, app::ThreadPool& pool ) {
+  return load_workload( workload, workload.size, universe, pool );
+}
+
+bool game::load_workload( const Workload& workload, const Vec2< size_t >& size, Universe& universe, app::ThreadPool& pool ) {
+  universe.init( size );
+
+  switch( workload.kind ) {
+    case WorkloadKind::Pattern: {
+      Pattern pattern;
+      if( !pattern.load_rle( workload.rle ) ) {
+        return false;
+      }
+
+      const Vec2i origin = {
+        ( ( int ) size.x - ( int ) pattern.bounds().x ) / 2,
+        ( ( int ) size.y - ( int ) pattern.bounds().y ) / 2
+      };
+
+      universe.place( pattern, origin );
+      return true;
+    }
+
+    case WorkloadKind::Soup:
+      universe.randomise( pool, workload.seed, workload.density );
+      return true;
+
+    case WorkloadKind::StillLifeField:
+      return load_still_life_field( universe );
+
+    default:
+      return false;
+  }
+}
@@ -1,9 +1,15 @@
 #include <iostream>
 
+#define NOMINMAX
+#include <windows.h>
+#include <windowsx.h>
+
 #include <window.hpp>
 #include <application.hpp>
 #include <renderer.hpp>
 #include <audio.hpp>
+#include <profiler.hpp>
+#include <trace.hpp>
 
 #include <imgui/imgui_impl_win32.hpp>
 
@@ -15,6 +21,11 @@ app::Window g_window;
 game::Game g_game{ &g_app, &g_window };
 
 bool window_message_handler( UINT message, WPARAM wparam, LPARAM lparam ) {
+  // Forward every mouse move so fast brush strokes don't depend on the frame rate.
+  if( message == WM_MOUSEMOVE ) {
+    g_game.on_mouse_move( GET_X_LPARAM( lparam ), GET_Y_LPARAM( lparam ) );
+  }
+
   if( g_window.imgui_message_handler( message, wparam, lparam ) ) {
     return false;
   }
@@ -39,6 +50,9 @@ void render( app::Application& app, const double dt ) {
   // Window::draw invokes internal renderer.begin / end between the callback
   // maybe just omit the function all together and manually handle that here.
   g_window.draw( window_draw );
+
+  app::Profiler::get()->end_frame();
+  app::Tracer::get()->end_frame();
 }
 
 void update( app::Application& app, const double t, const double dt ) {
@@ -46,6 +60,8 @@ void update( app::Application& app, const double t, const double dt ) {
 }
 
 int main( int argc, char* argv[] ) {
+  app::Tracer::get()->set_thread_name( "Main" );
+
   // Create the main window.
   g_window = app::Window( TEXT( "GameOfLifeApp001" ), TEXT( "Game of Life" ), 1920, 1080 );
   g_window.set_message_handler( window_message_handler );
@@ -0,0 +1,112 @@
+#include <memory.hpp>
+
+#if defined( _WIN32 )
+#define NOMINMAX
+#include <windows.h>
+#elif defined( __linux__ )
+#include <fstream>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <iterator>
+
+app::MemoryTracker::MemoryTracker() :
+  m_bytes{}
+{
+}
+
+const char* app::MemoryTracker::name( const MemoryCategory category ) {
+  switch( category ) {
+    case MemoryCategory::Cells: return "Cells";
+    case MemoryCategory::Pixels: return "Pixels";
+    case MemoryCategory::Textures: return "Textures";
+    case MemoryCategory::Rules: return "Rules";
+    default: return "Unknown";
+  }
+}
+
+const uint64_t app::MemoryTracker::available_physical() {
+#if defined( _WIN32 )
+  MEMORYSTATUSEX status{};
+  status.dwLength = sizeof( status );
+
+  if( GlobalMemoryStatusEx( &status ) == 0 ) {
+    return 0;
+  }
+
+  return status.ullAvailPhys;
+#elif defined( __linux__ )
+  // MemAvailable includes the page cache that the kernel would give up, free memory alone undercounts.
+  std::ifstream meminfo{ "/proc/meminfo" };
+
+  std::string key;
+  uint64_t kilobytes{};
+  std::string unit;
+
+  while( meminfo >> key >> kilobytes >> unit ) {
+    if( key == "MemAvailable:" ) {
+      return kilobytes * 1024;
+    }
+  }
+
+  return ( uint64_t ) sysconf( _SC_AVPHYS_PAGES ) * ( uint64_t ) sysconf( _SC_PAGESIZE );
+#else
+  return 0;
+#endif
+}
+
+const uint64_t app::MemoryTracker::total_physical() {
+#if defined( _WIN32 )
+  MEMORYSTATUSEX status{};
+  status.dwLength = sizeof( status );
+
+  if( GlobalMemoryStatusEx( &status ) == 0 ) {
+    return 0;
+  }
+
+  return status.ullTotalPhys;
+#elif defined( __linux__ )
+  return ( uint64_t ) sysconf( _SC_PHYS_PAGES ) * ( uint64_t ) sysconf( _SC_PAGESIZE );
+#else
+  return 0;
+#endif
+}
+
+const uint64_t app::MemoryTracker::total() const {
+  uint64_t total{};
+
+  for( size_t category{}; category < k_memory_category_count; ++category ) {
+    total += bytes( ( MemoryCategory ) category );
+  }
+
+  return total;
+}
+
+const bool app::fits_in_memory( const uint64_t required ) {
+  const uint64_t available = MemoryTracker::available_physical();
+  if( available == 0 ) {
+    return true;
+  }
+
+  const uint64_t held = MemoryTracker::get()->total();
+
+  return required <= held || required - held <= available / 10 * 9;
+}
+
+std::string app::format_bytes( const uint64_t bytes ) {
+  constexpr const char* k_units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+
+  double value = ( double ) bytes;
+  size_t unit{};
+
+  while( value >= 1024.0 && unit + 1 < std::size( k_units ) ) {
+    value /= 1024.0;
+    ++unit;
+  }
+
+  char buffer[ 32 ];
+  std::snprintf( buffer, sizeof( buffer ), unit == 0 ? "%.0f %s" : "%.2f %s", value, k_units[ unit ] );
+
+  return buffer;
+}
@@ -0,0 +1,136 @@
+#include <perf_counters.hpp>
+
+#if defined( __linux__ )
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace {
+
+#if defined( __linux__ )
+  struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+  };
+
+  constexpr uint64_t cache_miss( const uint64_t cache ) {
+    return cache | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+  }
+
+  // Event of every counter, in the order of app::HardwareCounter.
+  constexpr EventConfig k_events[ app::k_hardware_counter_count ] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, cache_miss( PERF_COUNT_HW_CACHE_L1D ) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HW_CACHE, cache_miss( PERF_COUNT_HW_CACHE_DTLB ) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+  };
+
+  int open_event( const EventConfig& event ) {
+    perf_event_attr attributes;
+    memset( &attributes, 0, sizeof( attributes ) );
+
+    attributes.size = sizeof( attributes );
+    attributes.type = event.type;
+    attributes.config = event.config;
+    attributes.disabled = 1;
+    attributes.inherit = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return ( int ) syscall( SYS_perf_event_open, &attributes, 0, -1, -1, 0 );
+  }
+#endif
+
+}
+
+app::PerfCounters::PerfCounters() {
+  m_fds.fill( -1 );
+
+#if defined( __linux__ )
+  for( size_t i{}; i < k_hardware_counter_count; ++i ) {
+    m_fds[ i ] = open_event( k_events[ i ] );
+  }
+#endif
+}
+
+app::PerfCounters::~PerfCounters() {
+#if defined( __linux__ )
+  for( const int fd : m_fds ) {
+    if( fd >= 0 ) {
+      close( fd );
+    }
+  }
+#endif
+}
+
+const char* app::PerfCounters::name( const HardwareCounter counter ) {
+  switch( counter ) {
+    case HardwareCounter::Cycles: return "cycles";
+    case HardwareCounter::Instructions: return "instructions";
+    case HardwareCounter::L1DMisses: return "L1D misses";
+    case HardwareCounter::LLCMisses: return "LLC misses";
+    case HardwareCounter::DTLBMisses: return "dTLB misses";
+    case HardwareCounter::BranchMisses: return "branch misses";
+    default: return "unknown";
+  }
+}
+
+const bool app::PerfCounters::available() const {
+  for( const int fd : m_fds ) {
+    if( fd >= 0 ) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void app::PerfCounters::start() {
+#if defined( __linux__ )
+  for( const int fd : m_fds ) {
+    if( fd >= 0 ) {
+      ioctl( fd, PERF_EVENT_IOC_RESET, 0 );
+      ioctl( fd, PERF_EVENT_IOC_ENABLE, 0 );
+    }
+  }
+#endif
+}
+
+const app::CounterSample app::PerfCounters::stop() {
+  CounterSample sample{};
+
+#if defined( __linux__ )
+  for( size_t i{}; i < k_hardware_counter_count; ++i ) {
+    if( m_fds[ i ] >= 0 ) {
+      ioctl( m_fds[ i ], PERF_EVENT_IOC_DISABLE, 0 );
+    }
+  }
+
+  for( size_t i{}; i < k_hardware_counter_count; ++i ) {
+    if( m_fds[ i ] < 0 ) {
+      continue;
+    }
+
+    // value, time enabled, time running
+    uint64_t values[ 3 ]{};
+    if( read( m_fds[ i ], values, sizeof( values ) ) != ( ssize_t ) sizeof( values ) || values[ 2 ] == 0 ) {
+      continue;
+    }
+
+    sample.values[ i ] = values[ 2 ] < values[ 1 ]
+      ? ( uint64_t ) ( ( double ) values[ 0 ] * ( ( double ) values[ 1 ] / ( double ) values[ 2 ] ) )
+      : values[ 0 ];
+
+    sample.valid[ i ] = true;
+  }
+#endif
+
+  return sample;
+}
@@ -0,0 +1,125 @@
+#include <profiler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+
+app::Profiler::Profiler() :
+  m_accumulators{},
+  m_history{},
+  m_frames{}
+{
+}
+
+const char* app::Profiler::name( const Phase phase ) {
+  switch( phase ) {
+    case Phase::Update: return "Update";
+    case Phase::PixelBuffer: return "Pixel Buffer";
+    case Phase::TextureMap: return "Texture Map";
+    case Phase::TextureCopy: return "Texture Copy";
+    case Phase::ImGui: return "ImGui";
+    case Phase::Present: return "Present";
+    default: return "Unknown";
+  }
+}
+
+void app::Profiler::end_frame() {
+  if( !enabled() ) {
+    return;
+  }
+
+  const size_t frame = m_frames.load( std::memory_order_relaxed );
+  const size_t index = frame % k_history;
+
+  for( size_t phase{}; phase < k_phase_count; ++phase ) {
+    const int64_t nanoseconds = m_accumulators[ phase ].exchange( 0, std::memory_order_relaxed );
+    m_history[ phase ][ index ].store( ( float ) ( ( double ) nanoseconds / 1e6 ), std::memory_order_relaxed );
+  }
+
+  m_frames.store( frame + 1, std::memory_order_release );
+}
+
+void app::Profiler::clear() {
+  for( auto& accumulator : m_accumulators ) {
+    accumulator.store( 0, std::memory_order_relaxed );
+  }
+
+  m_frames.store( 0, std::memory_order_release );
+}
+
+const size_t app::Profiler::samples() const {
+  return std::min( m_frames.load( std::memory_order_acquire ), k_history );
+}
+
+void app::Profiler::history( const Phase phase, std::vector< float >& out ) const {
+  const size_t frames = m_frames.load( std::memory_order_acquire );
+  const size_t count = std::min( frames, k_history );
+
+  out.resize( count );
+
+  for( size_t i{}; i < count; ++i ) {
+    const size_t index = ( frames - count + i ) % k_history;
+    out[ i ] = m_history[ ( size_t ) phase ][ index ].load( std::memory_order_relaxed );
+  }
+}
+
+const app::PhaseStatistics app::Profiler::statistics( const Phase phase ) const {
+  std::vector< float > values;
+  history( phase, values );
+
+  if( values.empty() ) {
+    return {};
+  }
+
+  PhaseStatistics statistics{};
+  statistics.last = values.back();
+
+  std::sort( values.begin(), values.end() );
+
+  const auto& percentile = [ & ]( const float p ) {
+    const size_t index = ( size_t ) std::ceil( p * ( float ) values.size() ) - 1;
+    return values[ std::min( index, values.size() - 1 ) ];
+  };
+
+  statistics.p50 = percentile( 0.50F );
+  statistics.p95 = percentile( 0.95F );
+  statistics.p99 = percentile( 0.99F );
+  statistics.max = values.back();
+
+  return statistics;
+}
+
+bool app::Profiler::dump_csv( const std::string_view& path ) const {
+  std::ofstream file{ std::string( path ) };
+  if( !file ) {
+    return false;
+  }
+
+  std::array< std::vector< float >, k_phase_count > columns;
+  for( size_t phase{}; phase < k_phase_count; ++phase ) {
+    history( ( Phase ) phase, columns[ phase ] );
+  }
+
+  // Frames may have been committed between the copies, only write what every column has.
+  size_t rows = SIZE_MAX;
+  for( const auto& column : columns ) {
+    rows = std::min( rows, column.size() );
+  }
+
+  file << "frame";
+  for( size_t phase{}; phase < k_phase_count; ++phase ) {
+    file << "," << name( ( Phase ) phase ) << " (ms)";
+  }
+  file << "\n";
+
+  for( size_t row{}; row < rows; ++row ) {
+    file << row;
+    for( size_t phase{}; phase < k_phase_count; ++phase ) {
+      file << "," << columns[ phase ][ columns[ phase ].size() - rows + row ];
+    }
+    file << "\n";
+  }
+
+  return ( bool ) file;
+}
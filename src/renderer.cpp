@@ -1,6 +1,8 @@
 #include <renderer.hpp>
 
 #include <window.hpp>
+#include <profiler.hpp>
+#include <trace.hpp>
 
 #include <ext/imgui/imgui.h>
 #include <imgui/imgui_impl_win32.hpp>
@@ -177,10 +179,20 @@ void app::Renderer::begin() {
 }
 
 void app::Renderer::end() {
-  ImGui::Render();
-  ImGui_ImplDX11_RenderDrawData( ImGui::GetDrawData() );
+  {
+    ProfileScope scope( Phase::ImGui );
+    TraceZone zone( "ImGui" );
 
-  m_swapchain->Present( 1, 0 );
+    ImGui::Render();
+    ImGui_ImplDX11_RenderDrawData( ImGui::GetDrawData() );
+  }
+
+  {
+    ProfileScope scope( Phase::Present );
+    TraceZone zone( "Present" );
+
+    m_swapchain->Present( 1, 0 );
+  }
 }
 
 void app::Renderer::set_clear_color( const float* clear_color ) {
@@ -0,0 +1,119 @@
+#include <thread_pool.hpp>
+
+#include <trace.hpp>
+
+#include <algorithm>
+#include <string>
+
+app::ThreadPool::ThreadPool() :
+  ThreadPool( std::max( 1U, std::thread::hardware_concurrency() ) ) {}
+
+app::ThreadPool::ThreadPool( const size_t threads ) :
+  m_routine{},
+  m_count{},
+  m_grain{ 1 },
+  m_next{},
+  m_pending{},
+  m_generation{},
+  m_stopping{ false }
+{
+  for( size_t i{ 1 }; i < threads; ++i ) {
+    m_workers.emplace_back( [ this, i ]() {
+      Tracer::get()->set_thread_name( "Worker " + std::to_string( i ) );
+      worker();
+    } );
+  }
+}
+
+app::ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_stopping = true;
+  }
+
+  m_wake.notify_all();
+
+  for( auto& worker : m_workers ) {
+    worker.join();
+  }
+}
+
+void app::ThreadPool::worker() {
+  size_t generation{};
+
+  for( ;; ) {
+    {
+      std::unique_lock< std::mutex > lock( m_mutex );
+      m_wake.wait( lock, [ & ]() { return m_stopping || m_generation != generation; } );
+
+      if( m_stopping ) {
+        return;
+      }
+
+      generation = m_generation;
+    }
+
+    {
+      TraceZone zone( "ThreadPool::run" );
+      run();
+    }
+
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      if( --m_pending == 0 ) {
+        m_done.notify_one();
+      }
+    }
+  }
+}
+
+void app::ThreadPool::run() {
+  for( ;; ) {
+    const size_t begin = m_next.fetch_add( m_grain, std::memory_order_relaxed );
+    if( begin >= m_count ) {
+      break;
+    }
+
+    ( *m_routine )( begin, std::min( begin + m_grain, m_count ) );
+  }
+}
+
+void app::ThreadPool::parallel_for( const size_t count, const range_routine_t& routine, const size_t grain ) {
+  if( count == 0 ) {
+    return;
+  }
+
+  const size_t chunk = grain != 0 ? grain : std::max< size_t >( 1, count / ( threads() * 4 ) );
+
+  // Not worth waking anybody up for.
+  if( m_workers.empty() || count <= chunk ) {
+    routine( 0, count );
+    return;
+  }
+
+  std::lock_guard< std::mutex > dispatch( m_dispatch_mutex );
+
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_routine = &routine;
+    m_count = count;
+    m_grain = chunk;
+    m_next.store( 0, std::memory_order_relaxed );
+    m_pending = m_workers.size();
+    ++m_generation;
+  }
+
+  m_wake.notify_all();
+
+  {
+    TraceZone zone( "ThreadPool::run" );
+    run();
+  }
+
+  TraceZone zone( "ThreadPool::wait" );
+
+  std::unique_lock< std::mutex > lock( m_mutex );
+  m_done.wait( lock, [ & ]() { return m_pending == 0; } );
+
+  m_routine = nullptr;
+}
@@ -0,0 +1,320 @@
+#include <tools/baseline.hpp>
+#include <tools/options.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace {
+
+  constexpr int k_version = 1;
+
+  // Scales the MAD of normally distributed samples to their standard deviation.
+  constexpr double k_mad_to_sigma = 1.4826;
+
+  //
+  // Just enough of a JSON reader for the files save_baseline writes: objects, arrays, strings without
+  // escapes other than \" and \\, and numbers.
+  //
+  class Reader {
+  private:
+    std::string_view m_text;
+    size_t m_position;
+
+  public:
+    Reader( const std::string_view& text ) :
+      m_text( text ),
+      m_position( 0 )
+    {
+    }
+
+    void skip_whitespace() {
+      while( m_position < m_text.size() && std::isspace( ( unsigned char ) m_text[ m_position ] ) ) {
+        ++m_position;
+      }
+    }
+
+    const char peek() {
+      skip_whitespace();
+      return m_position < m_text.size() ? m_text[ m_position ] : '\0';
+    }
+
+    // Consumes the character if it is next.
+    bool accept( const char c ) {
+      if( peek() != c ) {
+        return false;
+      }
+
+      ++m_position;
+      return true;
+    }
+
+    bool string( std::string& out ) {
+      if( !accept( '"' ) ) {
+        return false;
+      }
+
+      out.clear();
+
+      while( m_position < m_text.size() ) {
+        char c = m_text[ m_position++ ];
+        if( c == '"' ) {
+          return true;
+        }
+
+        if( c == '\\' ) {
+          if( m_position >= m_text.size() ) {
+            return false;
+          }
+
+          c = m_text[ m_position++ ];
+        }
+
+        out.push_back( c );
+      }
+
+      return false;
+    }
+
+    bool number( double& out ) {
+      skip_whitespace();
+
+      const size_t begin = m_position;
+      while( m_position < m_text.size() && std::strchr( "+-.0123456789eE", m_text[ m_position ] ) != nullptr ) {
+        ++m_position;
+      }
+
+      return tools::parse_number( m_text.substr( begin, m_position - begin ), out );
+    }
+
+    //
+    // Walks the members of an object, calling member( key ) with the reader at the value of each.
+    //
+    template< typename F >
+    bool object( F&& member ) {
+      if( !accept( '{' ) ) {
+        return false;
+      }
+
+      if( accept( '}' ) ) {
+        return true;
+      }
+
+      do {
+        std::string key;
+        if( !string( key ) || !accept( ':' ) || !member( key ) ) {
+          return false;
+        }
+      } while( accept( ',' ) );
+
+      return accept( '}' );
+    }
+
+    template< typename F >
+    bool array( F&& element ) {
+      if( !accept( '[' ) ) {
+        return false;
+      }
+
+      if( accept( ']' ) ) {
+        return true;
+      }
+
+      do {
+        if( !element() ) {
+          return false;
+        }
+      } while( accept( ',' ) );
+
+      return accept( ']' );
+    }
+
+    // Skips a string or number, e.g. of a member a newer version added.
+    bool skip() {
+      std::string text;
+      double value;
+
+      return peek() == '"' ? string( text ) : number( value );
+    }
+  };
+
+  bool read_entry( Reader& reader, tools::BaselineEntry& entry ) {
+    std::string size;
+
+    const bool valid = reader.object( [ & ]( const std::string& key ) {
+      double value{};
+
+      if( key == "engine" ) return reader.string( entry.engine );
+      if( key == "workload" ) return reader.string( entry.workload );
+      if( key == "size" ) return reader.string( size );
+
+      if( key == "threads" && reader.number( value ) ) {
+        entry.threads = ( size_t ) value;
+        return true;
+      }
+
+      if( key == "repetitions" && reader.number( value ) ) {
+        entry.repetitions = ( size_t ) value;
+        return true;
+      }
+
+      if( key == "memory" && reader.number( value ) ) {
+        entry.memory = ( uint64_t ) value;
+        return true;
+      }
+
+      if( key == "median" ) return reader.number( entry.median );
+      if( key == "mad" ) return reader.number( entry.mad );
+
+      return reader.skip();
+    } );
+
+    return valid && !entry.engine.empty() && !entry.workload.empty() && tools::parse_size( size, entry.size );
+  }
+
+  const double percent( const double current, const double baseline ) {
+    return baseline == 0.0 ? 0.0 : ( current - baseline ) / baseline * 100.0;
+  }
+
+}
+
+double tools::median( std::vector< double >& values ) {
+  if( values.empty() ) {
+    return 0.0;
+  }
+
+  std::sort( values.begin(), values.end() );
+
+  const size_t middle = values.size() / 2;
+  return values.size() % 2 == 1 ? values[ middle ] : ( values[ middle - 1 ] + values[ middle ] ) / 2.0;
+}
+
+double tools::median_absolute_deviation( std::vector< double >& values ) {
+  const double centre = median( values );
+
+  std::vector< double > deviations;
+  deviations.reserve( values.size() );
+
+  for( const double value : values ) {
+    deviations.push_back( std::abs( value - centre ) );
+  }
+
+  return median( deviations );
+}
+
+const std::string tools::BaselineEntry::key() const {
+  return engine + "/" + workload + "/" + std::to_string( size.x ) + "x" + std::to_string( size.y ) + "/" + std::to_string( threads );
+}
+
+bool tools::save_baseline( const std::string_view& path, const std::vector< BaselineEntry >& entries ) {
+  std::ofstream file{ std::string( path ) };
+  if( !file ) {
+    return false;
+  }
+
+  file << std::fixed << std::setprecision( 3 );
+  file << "{\n  \"version\": " << k_version << ",\n  \"results\": [";
+
+  for( size_t i{}; i < entries.size(); ++i ) {
+    const auto& entry = entries[ i ];
+
+    file << ( i == 0 ? "\n" : ",\n" );
+    file << "    { \"engine\": \"" << entry.engine << "\", \"workload\": \"" << entry.workload
+         << "\", \"size\": \"" << entry.size.x << "x" << entry.size.y << "\", \"threads\": " << entry.threads
+         << ", \"repetitions\": " << entry.repetitions << ", \"median\": " << entry.median << ", \"mad\": " << entry.mad
+         << ", \"memory\": " << entry.memory << " }";
+  }
+
+  file << "\n  ]\n}\n";
+
+  return ( bool ) file;
+}
+
+bool tools::load_baseline( const std::string_view& path, std::vector< BaselineEntry >& entries ) {
+  std::ifstream file{ std::string( path ) };
+  if( !file ) {
+    return false;
+  }
+
+  std::stringstream contents;
+  contents << file.rdbuf();
+
+  const std::string text = contents.str();
+  Reader reader( text );
+
+  double version{};
+  entries.clear();
+
+  const bool valid = reader.object( [ & ]( const std::string& key ) {
+    if( key == "version" ) {
+      return reader.number( version );
+    }
+
+    if( key == "results" ) {
+      return reader.array( [ & ]() {
+        return read_entry( reader, entries.emplace_back() );
+      } );
+    }
+
+    return reader.skip();
+  } );
+
+  return valid && ( int ) version == k_version;
+}
+
+bool tools::compare_baseline( const std::vector< BaselineEntry >& baseline, const std::vector< BaselineEntry >& current, const Thresholds& thresholds ) {
+  std::map< std::string, const BaselineEntry* > previous;
+  for( const auto& entry : baseline ) {
+    previous[ entry.key() ] = &entry;
+  }
+
+  std::printf( "\n%-44s %10s %10s %8s %10s %10s %8s  %s\n",
+    "configuration", "Mcells/s", "was", "change", "memory", "was", "change", "result" );
+
+  bool passed = true;
+
+  for( const auto& entry : current ) {
+    const auto key = entry.key();
+    const auto it = previous.find( key );
+
+    if( it == previous.end() ) {
+      std::printf( "%-44s %10.1f %10s %8s %10llu %10s %8s  new\n", key.c_str(), entry.median, "-", "-",
+        ( unsigned long long ) entry.memory, "-", "-" );
+      continue;
+    }
+
+    const auto& before = *it->second;
+
+    const double drop = before.median - entry.median;
+    const double noise = thresholds.noise * k_mad_to_sigma * std::sqrt( before.mad * before.mad + entry.mad * entry.mad );
+
+    const bool slower = drop > before.median * thresholds.slowdown / 100.0 && drop > noise;
+    const bool larger = ( double ) entry.memory > ( double ) before.memory * ( 1.0 + thresholds.memory_growth / 100.0 );
+
+    const char* result = "ok";
+    if( slower && larger ) {
+      result = "SLOWER, LARGER";
+    }
+    else if( slower ) {
+      result = "SLOWER";
+    }
+    else if( larger ) {
+      result = "LARGER";
+    }
+
+    passed = passed && !slower && !larger;
+
+    std::printf( "%-44s %10.1f %10.1f %+7.1f%% %10llu %10llu %+7.1f%%  %s\n", key.c_str(),
+      entry.median, before.median, percent( entry.median, before.median ),
+      ( unsigned long long ) entry.memory, ( unsigned long long ) before.memory, percent( ( double ) entry.memory, ( double ) before.memory ),
+      result );
+  }
+
+  return passed;
+}
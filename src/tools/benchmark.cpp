@@ -0,0 +1,341 @@
+//
+// Measures the throughput of every engine over a set of workloads and thread counts, next to the
+// hardware counters per cell so that layout changes come with evidence.
+//
+// Results can be saved as a baseline and later runs compared against it, e.g. before and after a change
+//    benchmark --save baseline.json
+//    benchmark --compare baseline.json
+// which exits with 1 if any configuration got slower or takes more memory than the thresholds allow.
+//
+// Builds with the same sources as the headless runner plus src/tools/baseline.cpp, see CMakeLists.txt.
+//
+
+#include <game/universe.hpp>
+#include <game/engine.hpp>
+#include <game/workload.hpp>
+
+#include <thread_pool.hpp>
+#include <perf_counters.hpp>
+#include <memory.hpp>
+
+#include <tools/options.hpp>
+#include <tools/baseline.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  struct Options {
+    std::vector< std::string_view > engines;
+    std::vector< std::string_view > workloads = { "soup-50", "still-life-field", "acorn" };
+
+    // Every workload is run at every size, or at its own size if there are none.
+    std::vector< Vec2< size_t > > sizes;
+
+    std::vector< size_t > threads;
+
+    // Cell updates per repetition, the number of generations is derived from it for every size.
+    size_t cells = 1 << 26;
+
+    size_t repetitions = 5;
+
+    std::string_view save;
+    std::string_view compare;
+
+    tools::Thresholds thresholds;
+  };
+
+  struct Result {
+    // Median throughput over the repetitions and its median absolute deviation.
+    double mcells_per_second;
+    double mad;
+
+    // Peak of the memory tracked for the engine and universe of the configuration.
+    uint64_t memory;
+
+    // Counters summed over every repetition.
+    app::CounterSample counters;
+
+    double cell_updates;
+  };
+
+  void usage() {
+    std::printf(
+      "usage: benchmark [options]\n"
+      "  --engines A,B,...    engines to run (default all)\n"
+      "  --workloads A,B,...  workloads to run (default soup-50,still-life-field,acorn), one of:"
+    );
+
+    for( const auto& workload : game::workloads() ) {
+      std::printf( " %s", workload.id );
+    }
+
+    std::printf(
+      "\n"
+      "  --sizes WxH,...      grid sizes to load the workloads at (default the size of every workload)\n"
+      "  --threads N,...      thread counts (default 1 and one per core)\n"
+      "  --cells N            cell updates per repetition (default 67108864)\n"
+      "  --repetitions N      repetitions per configuration (default 5)\n"
+      "  --save FILE          save the results as a baseline\n"
+      "  --compare FILE       compare the results against a baseline, exit with 1 on a regression\n"
+      "  --max-slowdown P     largest drop in median throughput that passes, in percent (default 5)\n"
+      "  --max-memory P       largest growth in memory that passes, in percent (default 0)\n"
+      "  --noise N            a drop also has to exceed N MADs of both runs (default 3)\n"
+    );
+  }
+
+  bool parse( const int argc, char* argv[], Options& options ) {
+    tools::Arguments arguments( argc, argv );
+
+    while( arguments.next() ) {
+      std::string_view value;
+
+      if( arguments.is( "--help" ) ) {
+        return false;
+      }
+
+      if( !arguments.value( value ) ) {
+        std::fprintf( stderr, "missing value for %.*s\n", ( int ) arguments.name().size(), arguments.name().data() );
+        return false;
+      }
+
+      bool valid = true;
+
+      if( arguments.is( "--engines" ) ) {
+        options.engines = tools::split( value );
+      }
+      else if( arguments.is( "--workloads" ) ) {
+        options.workloads = tools::split( value );
+      }
+      else if( arguments.is( "--sizes" ) ) {
+        options.sizes.clear();
+        for( const auto& part : tools::split( value ) ) {
+          valid = valid && tools::parse_size( part, options.sizes.emplace_back() );
+        }
+      }
+      else if( arguments.is( "--threads" ) ) {
+        options.threads.clear();
+        for( const auto& part : tools::split( value ) ) {
+          valid = valid && tools::parse_number( part, options.threads.emplace_back() ) && options.threads.back() != 0;
+        }
+      }
+      else if( arguments.is( "--cells" ) ) {
+        valid = tools::parse_number( value, options.cells );
+      }
+      else if( arguments.is( "--repetitions" ) ) {
+        valid = tools::parse_number( value, options.repetitions ) && options.repetitions != 0;
+      }
+      else if( arguments.is( "--save" ) ) {
+        options.save = value;
+      }
+      else if( arguments.is( "--compare" ) ) {
+        options.compare = value;
+      }
+      else if( arguments.is( "--max-slowdown" ) ) {
+        valid = tools::parse_number( value, options.thresholds.slowdown ) && options.thresholds.slowdown >= 0.0;
+      }
+      else if( arguments.is( "--max-memory" ) ) {
+        valid = tools::parse_number( value, options.thresholds.memory_growth ) && options.thresholds.memory_growth >= 0.0;
+      }
+      else if( arguments.is( "--noise" ) ) {
+        valid = tools::parse_number( value, options.thresholds.noise ) && options.thresholds.noise >= 0.0;
+      }
+      else {
+        std::fprintf( stderr, "unknown option %.*s\n", ( int ) arguments.name().size(), arguments.name().data() );
+        return false;
+      }
+
+      if( !valid ) {
+        std::fprintf( stderr, "invalid value %.*s\n", ( int ) value.size(), value.data() );
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  const Result run( game::Engine& engine, const game::Workload& workload, const Vec2< size_t >& size, const size_t threads, const Options& options ) {
+    // The workers only inherit the counters if they are created after them.
+    app::PerfCounters counters;
+    app::ThreadPool pool( threads );
+
+    const double cells = ( double ) size.x * ( double ) size.y;
+    const size_t generations = std::max< size_t >( 1, ( size_t ) ( ( double ) options.cells / cells ) );
+
+    game::Universe universe;
+
+    // Whatever else is still held, e.g. by the engines of earlier configurations, isn't part of this one.
+    const uint64_t held = app::MemoryTracker::get()->total();
+
+    Result result{};
+    std::vector< double > throughputs;
+
+    for( size_t repetition{}; repetition < options.repetitions; ++repetition ) {
+      // Every repetition starts from scratch so that they do the same work.
+      game::load_workload( workload, size, universe, pool );
+
+      // One untimed generation to fault in the next buffer and wake the workers up.
+      engine.step( universe, pool );
+
+      // Engines allocate their own buffers on their first step.
+      result.memory = std::max( result.memory, app::MemoryTracker::get()->total() - held );
+
+      const auto start = std::chrono::steady_clock::now();
+      counters.start();
+
+      for( size_t generation{}; generation < generations; ++generation ) {
+        engine.step( universe, pool );
+      }
+
+      const auto sample = counters.stop();
+      const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+      throughputs.push_back( ( double ) generations * cells / seconds / 1e6 );
+
+      for( size_t i{}; i < app::k_hardware_counter_count; ++i ) {
+        result.counters.values[ i ] += sample.values[ i ];
+        result.counters.valid[ i ] = sample.valid[ i ] && ( repetition == 0 || result.counters.valid[ i ] );
+      }
+    }
+
+    result.mcells_per_second = tools::median( throughputs );
+    result.mad = tools::median_absolute_deviation( throughputs );
+    result.cell_updates = ( double ) generations * cells * ( double ) options.repetitions;
+
+    return result;
+  }
+
+  void print_per_cell( const Result& result, const app::HardwareCounter counter ) {
+    if( !result.counters.has( counter ) ) {
+      std::printf( " %10s", "-" );
+      return;
+    }
+
+    std::printf( " %10.4f", ( double ) result.counters[ counter ] / result.cell_updates );
+  }
+
+  void print_row( const game::Engine& engine, const game::Workload& workload, const Vec2< size_t >& size, const size_t threads, const Result& result ) {
+    const std::string dimensions = std::to_string( size.x ) + "x" + std::to_string( size.y );
+
+    std::printf( "%-10s %-18s %7zu %11s %10.1f %8.1f", engine.name(), workload.id, threads, dimensions.c_str(), result.mcells_per_second, result.mad );
+
+    print_per_cell( result, app::HardwareCounter::Cycles );
+
+    if( result.counters.has( app::HardwareCounter::Cycles ) && result.counters.has( app::HardwareCounter::Instructions ) ) {
+      std::printf( " %10.2f", ( double ) result.counters[ app::HardwareCounter::Instructions ] / ( double ) result.counters[ app::HardwareCounter::Cycles ] );
+    }
+    else {
+      std::printf( " %10s", "-" );
+    }
+
+    print_per_cell( result, app::HardwareCounter::L1DMisses );
+    print_per_cell( result, app::HardwareCounter::LLCMisses );
+    print_per_cell( result, app::HardwareCounter::DTLBMisses );
+    print_per_cell( result, app::HardwareCounter::BranchMisses );
+
+    std::printf( "\n" );
+    std::fflush( stdout );
+  }
+
+}
+
+int main( int argc, char* argv[] ) {
+  Options options;
+  if( !parse( argc, argv, options ) ) {
+    usage();
+    return 1;
+  }
+
+  if( options.engines.empty() ) {
+    options.engines = game::engine_names();
+  }
+
+  if( options.threads.empty() ) {
+    const size_t cores = std::max( 1U, std::thread::hardware_concurrency() );
+
+    options.threads.push_back( 1 );
+    if( cores > 1 ) {
+      options.threads.push_back( cores );
+    }
+  }
+
+  {
+    app::PerfCounters counters;
+    if( !counters.available() ) {
+      std::printf( "hardware counters unavailable, only reporting throughput\n\n" );
+    }
+  }
+
+  std::vector< const game::Workload* > workloads;
+  for( const auto& id : options.workloads ) {
+    const game::Workload* workload = game::find_workload( id );
+    if( workload == nullptr ) {
+      std::fprintf( stderr, "unknown workload %.*s\n", ( int ) id.size(), id.data() );
+      return 1;
+    }
+
+    workloads.push_back( workload );
+  }
+
+  std::vector< tools::BaselineEntry > baseline;
+  if( !options.compare.empty() && !tools::load_baseline( options.compare, baseline ) ) {
+    std::fprintf( stderr, "couldn't read baseline %.*s\n", ( int ) options.compare.size(), options.compare.data() );
+    return 1;
+  }
+
+  std::printf( "%-10s %-18s %7s %11s %10s %8s %10s %10s %10s %10s %10s %10s\n",
+    "engine", "workload", "threads", "size", "Mcells/s", "MAD", "cycles", "IPC", "L1D", "LLC", "dTLB", "branch" );
+
+  std::printf( "%-10s %-18s %7s %11s %10s %8s %10s %10s %10s %10s %10s %10s\n",
+    "", "", "", "", "(median)", "", "per cell", "", "per cell", "per cell", "per cell", "per cell" );
+
+  std::vector< tools::BaselineEntry > entries;
+
+  for( const auto& name : options.engines ) {
+    auto engine = game::make_engine( name );
+    if( engine == nullptr ) {
+      std::fprintf( stderr, "unknown engine %.*s\n", ( int ) name.size(), name.data() );
+      return 1;
+    }
+
+    // The workloads are Life patterns, engines for other kinds of rules are measured with Headless instead.
+    if( !engine->supports( engine->rule() ) ) {
+      std::printf( "%-10s skipped, doesn't support %s\n", engine->name(), engine->rule().to_string().c_str() );
+      continue;
+    }
+
+    for( const size_t threads : options.threads ) {
+      for( const auto workload : workloads ) {
+        const auto& sizes = options.sizes.empty() ? std::vector< Vec2< size_t > >{ workload->size } : options.sizes;
+
+        for( const auto& size : sizes ) {
+          // A fresh engine per configuration, so that buffers sized for an earlier one don't count towards it.
+          const auto result = run( *game::make_engine( name ), *workload, size, threads, options );
+          print_row( *engine, *workload, size, threads, result );
+
+          entries.push_back( {
+            engine->name(), workload->id, size, threads,
+            result.mcells_per_second, result.mad, options.repetitions, result.memory
+          } );
+        }
+      }
+    }
+  }
+
+  if( !options.save.empty() && !tools::save_baseline( options.save, entries ) ) {
+    std::fprintf( stderr, "couldn't write baseline %.*s\n", ( int ) options.save.size(), options.save.data() );
+    return 1;
+  }
+
+  if( !options.compare.empty() && !tools::compare_baseline( baseline, entries, options.thresholds ) ) {
+    std::printf( "\nregression against %.*s\n", ( int ) options.compare.size(), options.compare.data() );
+    return 1;
+  }
+
+  return 0;
+}
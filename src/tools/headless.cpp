@@ -0,0 +1,967 @@
+//
+// Steps a universe without a window and reports the throughput and hardware counters of the engine.
+// With --volume a volume of three dimensional cells is stepped instead, and with --lenia-rule a field of continuous
+// cells, both starting from the soup of the workload. With --census the objects the universe settled into are
+// tallied after the last generation. With --search many small random soups are run until they settle, on every
+// thread at once, and their censuses are added up and written to a checkpoint now and then. With --engine multiverse
+// 64 universes of the size are stepped at once in the bit lanes of a multiverse and then once more one by one. With
+// --activity the changed cells of every tile are counted while stepping, which is timed along with the steps. With
+// --find every occurrence of a pattern in any orientation is looked for after the last generation. With --survey
+// the soups of many life-like rules are run on every thread at once, and what became of them is written to a CSV.
+//
+// Only depends on the portable parts of the tree, so besides the Headless project it builds anywhere with the CMake
+// build at the root of the tree, along with the benchmark and the differential check.
+//
+
+#include <game/universe.hpp>
+#include <game/engine.hpp>
+#include <game/workload.hpp>
+#include <game/rule.hpp>
+#include <game/rule_table.hpp>
+#include <game/census.hpp>
+#include <game/search.hpp>
+#include <game/volume.hpp>
+#include <game/engines/volume.hpp>
+#include <game/field.hpp>
+#include <game/engines/lenia.hpp>
+#include <game/multiverse.hpp>
+#include <game/engines/multiverse.hpp>
+#include <game/activity.hpp>
+#include <game/finder.hpp>
+#include <game/survey.hpp>
+
+#include <thread_pool.hpp>
+#include <perf_counters.hpp>
+#include <memory.hpp>
+
+#include <tools/options.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  struct Options {
+    // Empty for banded, sliced for volumes or auto for fields, multiverse to step 64 universes at once.
+    std::string_view engine;
+    std::string_view workload = "soup-50";
+    game::Rule rule = game::Rule::life();
+
+    // Zero to use the size of the workload.
+    Vec2< size_t > size = {};
+
+    // Zero to step a universe instead.
+    Vec3< size_t > volume = {};
+    game::VolumeRule volume_rule = game::VolumeRule::bays_4555();
+
+    // Whether to step a field of continuous cells instead.
+    bool field = false;
+    game::LeniaRule lenia_rule = game::LeniaRule::orbium();
+
+    size_t generations = 500;
+    size_t threads = 0;
+
+    // Number of objects of the census to print, zero to skip the census.
+    size_t census = 0;
+
+    // Number of the most active tiles to print, zero to step without counting activity.
+    size_t activity = 0;
+
+    // Pattern to find after the last generation in run length encoding, empty to find nothing.
+    std::string_view find;
+    size_t margin = 1;
+
+    // Seed of a soup search, empty to step a workload instead.
+    std::string_view search;
+    Vec2< size_t > soup_size = { 16, 16 };
+
+    // Soups to run in total, resumed ones included, zero to run until stopped.
+    size_t soups = 0;
+
+    std::string_view checkpoint;
+    size_t checkpoint_interval = 60;
+
+    // Rules of a survey, empty to run none: all of the life-like ones, a number of them or a file of rules.
+    std::string_view survey;
+    std::string_view csv = "survey.csv";
+  };
+
+  void usage() {
+    std::printf(
+      "usage: headless [options]\n"
+      "  --engine NAME       stepping engine (default banded):"
+    );
+
+    for( const auto& name : game::engine_names() ) {
+      std::printf( " %.*s", ( int ) name.size(), name.data() );
+    }
+
+    std::printf( "\n                      or for volumes (default sliced):" );
+
+    for( const auto& name : game::volume_engine_names() ) {
+      std::printf( " %.*s", ( int ) name.size(), name.data() );
+    }
+
+    std::printf( "\n                      or multiverse to step 64 universes of the size at once and compare" );
+    std::printf( "\n                      or for fields (default auto):" );
+
+    for( const auto& name : game::lenia_engine_names() ) {
+      std::printf( " %.*s", ( int ) name.size(), name.data() );
+    }
+
+    std::printf( "\n  --workload ID       workload to start from (default soup-50):" );
+
+    for( const auto& workload : game::workloads() ) {
+      std::printf( " %s", workload.id );
+    }
+
+    std::printf(
+      "\n"
+      "  --rule RULE         rule in B/S, Larger than Life or block notation, e.g. B2/S/C3, B2/S34H or MS,D15;1;2;3;4;5;6;7;8;9;10;11;12;13;14;0,\n"
+      "                      stochastic like B3/S23/N0.001 or a .rule file (default B3/S23)\n"
+      "  --size WxH          grid size (default the size of the workload)\n"
+      "  --volume WxHxD      step a volume of that size instead, from the soup of the workload\n"
+      "  --volume-rule RULE  rule of the volume in Bays' notation, e.g. 5766 (default 4555)\n"
+      "  --lenia-rule RULE   step a field of continuous cells under the rule instead, e.g. R13,T10,M0.15,S0.015,B1\n"
+      "  --generations N     generations to step (default 500)\n"
+      "  --threads N         threads to step with, 0 for one per core (default 0)\n"
+      "  --census N          tally the objects after the last generation and print the N most common (default 0)\n"
+      "  --activity N        count the changed cells of every tile while stepping and print the N most active (default 0)\n"
+      "  --find RLE          find every occurrence of the pattern in any orientation after the last generation, e.g. bo$2bo$3o!\n"
+      "  --margin N          dead cells that have to surround an occurrence (default 1)\n"
+      "  --search SEED       run random soups seeded from the text until they settle and tally their objects instead\n"
+      "  --soup-size WxH     size of the soups of a search (default 16x16)\n"
+      "  --soups N           soups to run in total, 0 to run until stopped (default 0)\n"
+      "  --checkpoint FILE   resume a search from the file if it exists and write its tally to it now and then\n"
+      "  --checkpoint-interval S  seconds between checkpoints (default 60)\n"
+      "  --survey RULES      run soups of the size under every life-like rule (all), a sample of N of them or the rules\n"
+      "                      of a file, a line each, for the generations and write a line per rule to the CSV instead\n"
+      "                      (--soups per rule, default 64)\n"
+      "  --csv FILE          file the results of a survey are written to (default survey.csv)\n"
+    );
+  }
+
+  bool parse( const int argc, char* argv[], Options& options ) {
+    tools::Arguments arguments( argc, argv );
+
+    while( arguments.next() ) {
+      std::string_view value;
+
+      if( arguments.is( "--help" ) ) {
+        return false;
+      }
+
+      if( !arguments.value( value ) ) {
+        std::fprintf( stderr, "missing value for %.*s\n", ( int ) arguments.name().size(), arguments.name().data() );
+        return false;
+      }
+
+      bool valid = true;
+
+      if( arguments.is( "--engine" ) ) {
+        options.engine = value;
+      }
+      else if( arguments.is( "--workload" ) ) {
+        options.workload = value;
+      }
+      else if( arguments.is( "--rule" ) ) {
+        std::string error;
+        valid = game::parse_rule( value, options.rule ) ||
+          ( value.ends_with( ".rule" ) && game::load_rule_file( std::string( value ), options.rule, error ) );
+
+        if( !error.empty() ) {
+          std::fprintf( stderr, "%s\n", error.c_str() );
+        }
+      }
+      else if( arguments.is( "--size" ) ) {
+        valid = tools::parse_size( value, options.size );
+      }
+      else if( arguments.is( "--volume" ) ) {
+        valid = tools::parse_size( value, options.volume );
+      }
+      else if( arguments.is( "--volume-rule" ) ) {
+        valid = game::parse_volume_rule( value, options.volume_rule );
+      }
+      else if( arguments.is( "--lenia-rule" ) ) {
+        valid = game::parse_lenia_rule( value, options.lenia_rule );
+        options.field = true;
+      }
+      else if( arguments.is( "--generations" ) ) {
+        valid = tools::parse_number( value, options.generations );
+      }
+      else if( arguments.is( "--threads" ) ) {
+        valid = tools::parse_number( value, options.threads );
+      }
+      else if( arguments.is( "--census" ) ) {
+        valid = tools::parse_number( value, options.census );
+      }
+      else if( arguments.is( "--activity" ) ) {
+        valid = tools::parse_number( value, options.activity );
+      }
+      else if( arguments.is( "--find" ) ) {
+        options.find = value;
+      }
+      else if( arguments.is( "--margin" ) ) {
+        valid = tools::parse_number( value, options.margin );
+      }
+      else if( arguments.is( "--search" ) ) {
+        options.search = value;
+      }
+      else if( arguments.is( "--soup-size" ) ) {
+        valid = tools::parse_size( value, options.soup_size );
+      }
+      else if( arguments.is( "--soups" ) ) {
+        valid = tools::parse_number( value, options.soups );
+      }
+      else if( arguments.is( "--checkpoint" ) ) {
+        options.checkpoint = value;
+      }
+      else if( arguments.is( "--checkpoint-interval" ) ) {
+        valid = tools::parse_number( value, options.checkpoint_interval );
+      }
+      else if( arguments.is( "--survey" ) ) {
+        options.survey = value;
+      }
+      else if( arguments.is( "--csv" ) ) {
+        options.csv = value;
+      }
+      else {
+        std::fprintf( stderr, "unknown option %.*s\n", ( int ) arguments.name().size(), arguments.name().data() );
+        return false;
+      }
+
+      if( !valid ) {
+        std::fprintf( stderr, "invalid value %.*s\n", ( int ) value.size(), value.data() );
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Only printed after stepping since engines allocate their own buffers on their first step.
+  void print_memory( const double cells ) {
+    for( size_t i{}; i < app::k_memory_category_count; ++i ) {
+      const auto category = ( app::MemoryCategory ) i;
+      const uint64_t bytes = app::MemoryTracker::get()->bytes( category );
+
+      if( bytes != 0 ) {
+        std::printf( "memory %s %s, %.2f bytes/cell\n", app::MemoryTracker::name( category ), app::format_bytes( bytes ).c_str(), ( double ) bytes / cells );
+      }
+    }
+  }
+
+  void print_counters( const app::PerfCounters& counters, const app::CounterSample& sample, const double generations, const double cells ) {
+    if( !counters.available() ) {
+      std::printf( "hardware counters unavailable\n" );
+      return;
+    }
+
+    std::printf( "\n%-16s %18s %18s %12s\n", "counter", "total", "per generation", "per cell" );
+
+    for( size_t i{}; i < app::k_hardware_counter_count; ++i ) {
+      const auto counter = ( app::HardwareCounter ) i;
+
+      if( !sample.has( counter ) ) {
+        std::printf( "%-16s %18s %18s %12s\n", app::PerfCounters::name( counter ), "-", "-", "-" );
+        continue;
+      }
+
+      const double value = ( double ) sample[ counter ];
+      std::printf( "%-16s %18.0f %18.0f %12.4f\n", app::PerfCounters::name( counter ), value, value / generations, value / ( generations * cells ) );
+    }
+
+    if( sample.has( app::HardwareCounter::Cycles ) && sample.has( app::HardwareCounter::Instructions ) ) {
+      std::printf( "\nIPC %.2f\n", ( double ) sample[ app::HardwareCounter::Instructions ] / ( double ) sample[ app::HardwareCounter::Cycles ] );
+    }
+  }
+
+  void print_activity( const game::Activity& activity, const bool counted, const size_t rows ) {
+    const auto tiles = activity.hottest( rows );
+
+    std::printf( "\nactivity over %zu generations, %s, %zux%zu tiles\n", activity.window(), counted ? "counted while stepping" : "compared after stepping", activity.tiles().x, activity.tiles().y );
+    std::printf( "%-12s %-24s %12s\n", "tile", "cells", "changes" );
+
+    for( const auto& tile : tiles ) {
+      const game::Region region = activity.region( tile.tile );
+      const std::string position = std::to_string( tile.tile.x ) + "," + std::to_string( tile.tile.y );
+      const std::string cells = std::to_string( region.left ) + "," + std::to_string( region.top ) + " - " + std::to_string( region.right ) + "," + std::to_string( region.bottom );
+
+      std::printf( "%-12s %-24s %12u\n", position.c_str(), cells.c_str(), tile.changes );
+    }
+  }
+
+  // Returns false if the pattern doesn't parse or can't be found.
+  bool print_matches( const game::Universe& universe, const std::string_view& rle, const size_t margin, app::ThreadPool& pool ) {
+    game::Pattern pattern;
+    if( !pattern.load_rle( rle ) ) {
+      std::fprintf( stderr, "couldn't parse the pattern %.*s\n", ( int ) rle.size(), rle.data() );
+      return false;
+    }
+
+    game::PatternFinder finder;
+
+    std::string error;
+    if( !finder.compile( pattern, margin, error ) ) {
+      std::fprintf( stderr, "%s\n", error.c_str() );
+      return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto matches = finder.find( universe, pool );
+    const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+    size_t counts[ game::k_orientations ]{};
+    for( const auto& match : matches ) {
+      ++counts[ match.orientation ];
+    }
+
+    std::printf( "\nfind %.3f s, %zu matches in %zu orientations with a margin of %zu\n", seconds, matches.size(), finder.orientations(), margin );
+    std::printf( "%-12s %10s\n", "orientation", "count" );
+
+    for( size_t orientation{}; orientation < game::k_orientations; ++orientation ) {
+      if( counts[ orientation ] != 0 ) {
+        std::printf( "%-12zu %10zu\n", orientation, counts[ orientation ] );
+      }
+    }
+
+    return true;
+  }
+
+  void print_census( const game::Universe& universe, const game::Rule& rule, app::ThreadPool& pool, const size_t rows ) {
+    if( !game::census_supports( rule ) ) {
+      std::printf( "\nno census under %s\n", rule.to_string().c_str() );
+      return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const game::Census census = game::take_census( universe, rule, pool );
+    const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+    std::printf( "\ncensus %.3f s, %zu islands of %zu cells, %zu kinds of objects\n", seconds, census.islands, census.cells, census.objects.size() );
+    std::printf( "%-32s %10s %8s %12s\n", "object", "count", "period", "displacement" );
+
+    for( size_t i{}; i < std::min( rows, census.objects.size() ); ++i ) {
+      const auto& object = census.objects[ i ];
+      const std::string displacement = std::to_string( object.displacement.x ) + "," + std::to_string( object.displacement.y );
+
+      std::printf( "%-32s %10zu %8zu %12s\n", object.code.c_str(), object.count, object.period, displacement.c_str() );
+    }
+  }
+
+  void print_tally( const game::SearchTally& tally, const size_t rows ) {
+    std::vector< std::pair< std::string, size_t > > objects( tally.objects.begin(), tally.objects.end() );
+
+    std::sort( objects.begin(), objects.end(), []( const auto& a, const auto& b ) {
+      return a.second != b.second ? a.second > b.second : a.first < b.first;
+    } );
+
+    std::printf( "\n%zu soups, %zu unsettled, %llu generations, %zu kinds of objects\n", tally.soups, tally.unsettled, ( unsigned long long ) tally.generations, objects.size() );
+    std::printf( "%-32s %12s\n", "object", "count" );
+
+    for( size_t i{}; i < std::min( rows, objects.size() ); ++i ) {
+      std::printf( "%-32s %12zu\n", objects[ i ].first.c_str(), objects[ i ].second );
+    }
+  }
+
+  //
+  // Runs soups in batches on every thread, each thread with its own search so nothing is shared while a soup runs.
+  // Batches are sized to take about a second, between them the progress is printed and checkpoints written.
+  //
+  int run_search( const Options& options ) {
+    if( !game::census_supports( options.rule ) ) {
+      std::fprintf( stderr, "no census under %s, a search needs two states on the square grid and empty space that stays empty\n", options.rule.to_string().c_str() );
+      return 1;
+    }
+
+    game::SearchCheckpoint checkpoint = { std::string( options.search ), options.rule.to_string(), options.soup_size, {} };
+
+    if( !options.checkpoint.empty() ) {
+      const std::string path( options.checkpoint );
+
+      game::SearchCheckpoint resumed;
+      std::string error;
+
+      if( game::load_checkpoint( path, resumed, error ) ) {
+        if( resumed.seed != checkpoint.seed || resumed.rule != checkpoint.rule || !( resumed.soup_size == checkpoint.soup_size ) ) {
+          std::fprintf( stderr, "%s is of another search: seed %s, rule %s, %zux%zu soups\n", path.c_str(), resumed.seed.c_str(), resumed.rule.c_str(), resumed.soup_size.x, resumed.soup_size.y );
+          return 1;
+        }
+
+        checkpoint.tally = std::move( resumed.tally );
+        std::printf( "resuming after %zu soups\n", checkpoint.tally.soups );
+      }
+      else if( error.rfind( "can't open", 0 ) != 0 ) {
+        std::fprintf( stderr, "%s\n", error.c_str() );
+        return 1;
+      }
+    }
+
+    const size_t threads = options.threads != 0 ? options.threads : std::max( 1U, std::thread::hardware_concurrency() );
+    app::ThreadPool pool( threads );
+
+    const uint64_t seed = game::hash_seed( options.search );
+
+    std::vector< std::unique_ptr< game::SoupSearch > > searches;
+    for( size_t i{}; i < threads; ++i ) {
+      searches.push_back( std::make_unique< game::SoupSearch >( options.rule, options.soup_size ) );
+    }
+
+    std::printf( "search %s, rule %s, %zux%zu soups, %zu threads\n", checkpoint.seed.c_str(), checkpoint.rule.c_str(), options.soup_size.x, options.soup_size.y, threads );
+
+    // Handed out to the chunks of a batch, at most one chunk per thread runs at a time.
+    std::mutex mutex;
+    std::vector< game::SoupSearch* > idle;
+    for( const auto& search : searches ) {
+      idle.push_back( search.get() );
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto last_checkpoint = start;
+    const size_t resumed = checkpoint.tally.soups;
+
+    size_t batch = threads * 16;
+
+    while( options.soups == 0 || checkpoint.tally.soups < options.soups ) {
+      const size_t first = checkpoint.tally.soups;
+      const size_t count = options.soups == 0 ? batch : std::min( batch, options.soups - first );
+
+      const auto batch_start = std::chrono::steady_clock::now();
+      game::SearchTally tally;
+
+      pool.parallel_for( count, [ & ]( const size_t begin, const size_t end ) {
+        game::SoupSearch* search;
+        {
+          std::lock_guard< std::mutex > lock( mutex );
+          search = idle.back();
+          idle.pop_back();
+        }
+
+        game::SearchTally local;
+        for( size_t i{ begin }; i < end; ++i ) {
+          search->run( seed, first + i, local );
+        }
+
+        std::lock_guard< std::mutex > lock( mutex );
+        idle.push_back( search );
+        tally.merge( local );
+      } );
+
+      checkpoint.tally.merge( tally );
+
+      const auto now = std::chrono::steady_clock::now();
+      const double seconds = std::chrono::duration< double >( now - start ).count();
+      const double batch_seconds = std::chrono::duration< double >( now - batch_start ).count();
+
+      std::printf( "%zu soups, %.1f soups/s, %zu unsettled, %zu kinds of objects\n", checkpoint.tally.soups,
+        ( double ) ( checkpoint.tally.soups - resumed ) / seconds, checkpoint.tally.unsettled, checkpoint.tally.objects.size() );
+      std::fflush( stdout );
+
+      // The next batch takes about a second.
+      batch = std::max( threads * 16, ( size_t ) ( ( double ) count / std::max( batch_seconds, 1e-3 ) ) );
+
+      const bool done = options.soups != 0 && checkpoint.tally.soups >= options.soups;
+      const double since_checkpoint = std::chrono::duration< double >( now - last_checkpoint ).count();
+
+      if( !options.checkpoint.empty() && ( done || since_checkpoint >= ( double ) options.checkpoint_interval ) ) {
+        std::string error;
+        if( !game::save_checkpoint( std::string( options.checkpoint ), checkpoint, error ) ) {
+          std::fprintf( stderr, "%s\n", error.c_str() );
+          return 1;
+        }
+
+        last_checkpoint = now;
+      }
+    }
+
+    print_tally( checkpoint.tally, 40 );
+    return 0;
+  }
+
+  // All life-like rules, a sample of them seeded from the count or the rules of a file with one per line.
+  bool survey_rules( const std::string_view& text, std::vector< game::Rule >& out ) {
+    size_t count{};
+
+    if( text == "all" ) {
+      for( size_t index{}; index < game::k_life_like_rules; ++index ) {
+        out.push_back( game::life_like_rule( index ) );
+      }
+
+      return true;
+    }
+
+    if( tools::parse_number( text, count ) ) {
+      out = game::sample_life_like_rules( count, game::hash_seed( text ) );
+      return true;
+    }
+
+    std::ifstream file{ std::string( text ) };
+    if( !file ) {
+      std::fprintf( stderr, "can't open %.*s\n", ( int ) text.size(), text.data() );
+      return false;
+    }
+
+    std::string line;
+    while( std::getline( file, line ) ) {
+      if( line.empty() || line[ 0 ] == '#' ) {
+        continue;
+      }
+
+      game::Rule rule;
+      if( !game::parse_rule( line, rule ) || !game::RuleSurvey::supports( rule ) ) {
+        std::fprintf( stderr, "%s isn't a life-like rule\n", line.c_str() );
+        return false;
+      }
+
+      out.push_back( rule );
+    }
+
+    return true;
+  }
+
+  //
+  // Hands the rules out to every thread a rule at a time, each thread with its own survey. Rows are written in the
+  // order of the rules as soon as every rule before them is done, so a survey that is stopped keeps what it has.
+  //
+  int run_survey( const Options& options ) {
+    std::vector< game::Rule > rules;
+    if( !survey_rules( options.survey, rules ) ) {
+      return 1;
+    }
+
+    const std::string path( options.csv );
+    std::FILE* csv = std::fopen( path.c_str(), "w" );
+    if( csv == nullptr ) {
+      std::fprintf( stderr, "can't write %s\n", path.c_str() );
+      return 1;
+    }
+
+    const size_t threads = options.threads != 0 ? options.threads : std::max( 1U, std::thread::hardware_concurrency() );
+    app::ThreadPool pool( threads );
+
+    const size_t soups = options.soups != 0 ? options.soups : game::Multiverse::k_lanes;
+
+    std::vector< std::unique_ptr< game::RuleSurvey > > surveys;
+    for( size_t i{}; i < threads; ++i ) {
+      surveys.push_back( std::make_unique< game::RuleSurvey >( options.soup_size, options.generations, soups ) );
+    }
+
+    std::printf( "survey of %zu rules, %zu %zux%zu soups each, %zu generations, %zu threads\n", rules.size(), surveys.front()->soups(),
+      options.soup_size.x, options.soup_size.y, options.generations, threads );
+
+    std::fprintf( csv, "%s\n", game::survey_header().c_str() );
+
+    std::mutex mutex;
+    std::vector< game::RuleSurvey* > idle;
+    for( const auto& survey : surveys ) {
+      idle.push_back( survey.get() );
+    }
+
+    // Rows of rules that are done but wait for one before them, empty otherwise.
+    std::vector< std::string > rows( rules.size() );
+    size_t written{};
+
+    const auto start = std::chrono::steady_clock::now();
+    auto last_progress = start;
+
+    pool.parallel_for( rules.size(), [ & ]( const size_t begin, const size_t end ) {
+      game::RuleSurvey* survey;
+      {
+        std::lock_guard< std::mutex > lock( mutex );
+        survey = idle.back();
+        idle.pop_back();
+      }
+
+      for( size_t i{ begin }; i < end; ++i ) {
+        std::string row = game::survey_row( survey->run( rules[ i ] ) );
+
+        std::lock_guard< std::mutex > lock( mutex );
+        rows[ i ] = std::move( row );
+
+        for( ; written < rows.size() && !rows[ written ].empty(); ++written ) {
+          std::fprintf( csv, "%s\n", rows[ written ].c_str() );
+          std::string().swap( rows[ written ] );
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if( std::chrono::duration< double >( now - last_progress ).count() >= 1.0 ) {
+          const double seconds = std::chrono::duration< double >( now - start ).count();
+
+          std::printf( "%zu of %zu rules written, %.1f rules/s\n", written, rules.size(), ( double ) written / seconds );
+          std::fflush( stdout );
+          std::fflush( csv );
+
+          last_progress = now;
+        }
+      }
+
+      std::lock_guard< std::mutex > lock( mutex );
+      idle.push_back( survey );
+    }, 1 );
+
+    const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+    if( std::fclose( csv ) != 0 ) {
+      std::fprintf( stderr, "can't write %s\n", path.c_str() );
+      return 1;
+    }
+
+    std::printf( "%zu rules in %.1f s, %.1f rules/s, written to %s\n", rules.size(), seconds, ( double ) rules.size() / seconds, path.c_str() );
+    return 0;
+  }
+
+  // Steps a field filled like the soup of the workload, there are no checkpoints for continuous rules either.
+  int run_field( const Options& options, const game::Workload& workload ) {
+    const std::string_view name = options.engine.empty() ? "auto" : options.engine;
+
+    auto engine = game::make_lenia_engine( name );
+    if( engine == nullptr ) {
+      std::fprintf( stderr, "unknown continuous engine %.*s\n", ( int ) name.size(), name.data() );
+      return 1;
+    }
+
+    engine->set_rule( options.lenia_rule );
+
+    if( workload.kind != game::WorkloadKind::Soup ) {
+      std::fprintf( stderr, "fields can only start from a soup, %s isn't one\n", workload.id );
+      return 1;
+    }
+
+    const Vec2< size_t > size = options.size.x == 0 ? workload.size : options.size;
+    const size_t threads = options.threads != 0 ? options.threads : std::max( 1U, std::thread::hardware_concurrency() );
+
+    // The workers only inherit the counters if they are created after them.
+    app::PerfCounters counters;
+    app::ThreadPool pool( threads );
+
+    const uint64_t required = game::Field::bytes_required( size );
+    if( !app::fits_in_memory( required ) ) {
+      std::fprintf( stderr, "%zux%zu needs %s, only %s is available\n", size.x, size.y,
+        app::format_bytes( required ).c_str(), app::format_bytes( app::MemoryTracker::available_physical() ).c_str() );
+      return 1;
+    }
+
+    game::Field field;
+    field.init( size );
+    field.randomise( pool, workload.seed, workload.density );
+
+    const double cells = ( double ) size.x * ( double ) size.y;
+    const char* convolution = engine->convolution( size ) == game::Convolution::Direct ? "direct" : "fourier";
+
+    std::printf( "engine %s (%s convolution), rule %s, workload %s, %zux%zu, %zu threads, %zu generations\n", engine->name(), convolution, options.lenia_rule.to_string().c_str(), workload.id, size.x, size.y, threads, options.generations );
+
+    const auto start = std::chrono::steady_clock::now();
+    counters.start();
+
+    for( size_t generation{}; generation < options.generations; ++generation ) {
+      engine->step( field, pool );
+    }
+
+    const auto sample = counters.stop();
+    const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+    const double generations = ( double ) options.generations;
+
+    std::printf( "time %.3f s, %.1f generations/s, %.1f Mcells/s\n", seconds, generations / seconds, generations * cells / seconds / 1e6 );
+    print_memory( cells );
+    std::printf( "mass %.1f\n", field.mass() );
+
+    print_counters( counters, sample, generations, cells );
+    return 0;
+  }
+
+  //
+  // Steps the 64 lanes of a multiverse filled like the soup of the workload, then every lane on its own with the
+  // fastest engine for the rule on the same threads, and checks that both end up the same.
+  //
+  int run_multiverse( const Options& options, const game::Workload& workload ) {
+    if( !game::MultiverseEngine::supports( options.rule ) ) {
+      std::fprintf( stderr, "multiverse doesn't support %s\n", options.rule.to_string().c_str() );
+      return 1;
+    }
+
+    if( workload.kind != game::WorkloadKind::Soup ) {
+      std::fprintf( stderr, "multiverses can only start from a soup, %s isn't one\n", workload.id );
+      return 1;
+    }
+
+    const Vec2< size_t > size = options.size.x != 0 ? options.size : workload.size;
+    const size_t lanes = game::Multiverse::k_lanes;
+    const size_t threads = options.threads != 0 ? options.threads : std::max( 1U, std::thread::hardware_concurrency() );
+
+    app::PerfCounters counters;
+    app::ThreadPool pool( threads );
+
+    const uint64_t required = game::Multiverse::bytes_required( size ) + lanes * game::Universe::bytes_required( size );
+    if( !app::fits_in_memory( required ) ) {
+      std::fprintf( stderr, "%zu times %zux%zu needs %s, only %s is available\n", lanes, size.x, size.y,
+        app::format_bytes( required ).c_str(), app::format_bytes( app::MemoryTracker::available_physical() ).c_str() );
+      return 1;
+    }
+
+    game::MultiverseEngine engine;
+    engine.set_rule( options.rule );
+
+    game::Multiverse multiverse;
+    multiverse.init( size );
+    multiverse.randomise( pool, workload.seed, workload.density );
+
+    // The same soups, to be stepped one by one.
+    std::vector< game::Universe > universes( lanes );
+    for( size_t lane{}; lane < lanes; ++lane ) {
+      multiverse.extract( lane, universes[ lane ] );
+    }
+
+    const double cells = ( double ) lanes * ( double ) size.x * ( double ) size.y;
+    const double generations = ( double ) options.generations;
+
+    std::printf( "engine multiverse, rule %s, workload %s, %zu times %zux%zu, %zu threads, %zu generations\n", options.rule.to_string().c_str(), workload.id, lanes, size.x, size.y, threads, options.generations );
+
+    auto start = std::chrono::steady_clock::now();
+    counters.start();
+
+    for( size_t generation{}; generation < options.generations; ++generation ) {
+      engine.step( multiverse, pool );
+    }
+
+    const auto sample = counters.stop();
+    const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+    std::printf( "time %.3f s, %.1f generations/s, %.1f Mcells/s\n", seconds, generations / seconds, generations * cells / seconds / 1e6 );
+    print_memory( cells );
+    std::printf( "%d lanes alive, %d stable\n", std::popcount( multiverse.live() ), std::popcount( multiverse.stable() ) );
+    print_counters( counters, sample, generations, cells );
+
+    auto single = game::make_engine( options.rule );
+
+    start = std::chrono::steady_clock::now();
+
+    for( auto& universe : universes ) {
+      for( size_t generation{}; generation < options.generations; ++generation ) {
+        single->step( universe, pool );
+      }
+    }
+
+    const double single_seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+    std::printf( "one by one with %s: time %.3f s, %.1f Mcells/s, the multiverse is %.1fx as fast\n", single->name(), single_seconds, generations * cells / single_seconds / 1e6, single_seconds / seconds );
+
+    game::Universe lane_universe;
+
+    for( size_t lane{}; lane < lanes; ++lane ) {
+      multiverse.extract( lane, lane_universe );
+
+      if( std::memcmp( lane_universe.current(), universes[ lane ].current(), lane_universe.size() ) != 0 ) {
+        std::printf( "MISMATCH lane %zu differs from stepping it on its own\n", lane );
+        return 1;
+      }
+    }
+
+    return 0;
+  }
+
+  // Steps a volume filled like the soup of the workload, there are no checkpoints in three dimensions.
+  int run_volume( const Options& options, const game::Workload& workload ) {
+    const std::string_view name = options.engine.empty() ? "sliced" : options.engine;
+
+    auto engine = game::make_volume_engine( name );
+    if( engine == nullptr ) {
+      std::fprintf( stderr, "unknown volume engine %.*s\n", ( int ) name.size(), name.data() );
+      return 1;
+    }
+
+    engine->set_rule( options.volume_rule );
+
+    if( workload.kind != game::WorkloadKind::Soup ) {
+      std::fprintf( stderr, "volumes can only start from a soup, %s isn't one\n", workload.id );
+      return 1;
+    }
+
+    const Vec3< size_t >& size = options.volume;
+    const size_t threads = options.threads != 0 ? options.threads : std::max( 1U, std::thread::hardware_concurrency() );
+
+    // The workers only inherit the counters if they are created after them.
+    app::PerfCounters counters;
+    app::ThreadPool pool( threads );
+
+    const uint64_t required = game::Volume::bytes_required( size );
+    if( !app::fits_in_memory( required ) ) {
+      std::fprintf( stderr, "%zux%zux%zu needs %s, only %s is available\n", size.x, size.y, size.z,
+        app::format_bytes( required ).c_str(), app::format_bytes( app::MemoryTracker::available_physical() ).c_str() );
+      return 1;
+    }
+
+    game::Volume volume;
+    volume.init( size );
+    volume.randomise( pool, workload.seed, workload.density );
+
+    const double cells = ( double ) size.x * ( double ) size.y * ( double ) size.z;
+
+    std::printf( "engine %s, rule %s, workload %s, %zux%zux%zu, %zu threads, %zu generations\n", engine->name(), options.volume_rule.to_string().c_str(), workload.id, size.x, size.y, size.z, threads, options.generations );
+
+    const auto start = std::chrono::steady_clock::now();
+    counters.start();
+
+    for( size_t generation{}; generation < options.generations; ++generation ) {
+      engine->step( volume, pool );
+    }
+
+    const auto sample = counters.stop();
+    const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+    const double generations = ( double ) options.generations;
+
+    std::printf( "time %.3f s, %.1f generations/s, %.1f Mcells/s\n", seconds, generations / seconds, generations * cells / seconds / 1e6 );
+    print_memory( cells );
+    std::printf( "population %zu\n", volume.population() );
+
+    print_counters( counters, sample, generations, cells );
+    return 0;
+  }
+
+}
+
+int main( int argc, char* argv[] ) {
+  Options options;
+  if( !parse( argc, argv, options ) ) {
+    usage();
+    return 1;
+  }
+
+  const game::Workload* workload = game::find_workload( options.workload );
+  if( workload == nullptr ) {
+    std::fprintf( stderr, "unknown workload %.*s\n", ( int ) options.workload.size(), options.workload.data() );
+    return 1;
+  }
+
+  if( !options.search.empty() ) {
+    return run_search( options );
+  }
+
+  if( !options.survey.empty() ) {
+    return run_survey( options );
+  }
+
+  if( options.volume.x != 0 ) {
+    return run_volume( options, *workload );
+  }
+
+  if( options.field ) {
+    return run_field( options, *workload );
+  }
+
+  if( options.engine == "multiverse" ) {
+    return run_multiverse( options, *workload );
+  }
+
+  const std::string_view name = options.engine.empty() ? "banded" : options.engine;
+
+  auto engine = game::make_engine( name );
+  if( engine == nullptr ) {
+    std::fprintf( stderr, "unknown engine %.*s\n", ( int ) name.size(), name.data() );
+    return 1;
+  }
+
+  if( !engine->supports( options.rule ) ) {
+    std::fprintf( stderr, "%s doesn't support %s\n", engine->name(), options.rule.to_string().c_str() );
+    return 1;
+  }
+
+  engine->set_rule( options.rule );
+
+  const bool default_size = options.size.x == 0 || options.size == workload->size;
+  const Vec2< size_t > size = default_size ? workload->size : options.size;
+
+  const size_t threads = options.threads != 0 ? options.threads : std::max( 1U, std::thread::hardware_concurrency() );
+
+  // The workers only inherit the counters if they are created after them.
+  app::PerfCounters counters;
+  app::ThreadPool pool( threads );
+
+  const uint64_t required = game::Universe::bytes_required( size );
+  if( !app::fits_in_memory( required ) ) {
+    std::fprintf( stderr, "%zux%zu needs %s, only %s is available\n", size.x, size.y,
+      app::format_bytes( required ).c_str(), app::format_bytes( app::MemoryTracker::available_physical() ).c_str() );
+    return 1;
+  }
+
+  game::Universe universe;
+  if( !game::load_workload( *workload, size, universe, pool ) ) {
+    std::fprintf( stderr, "couldn't load workload %s\n", workload->id );
+    return 1;
+  }
+
+  const double cells = ( double ) size.x * ( double ) size.y;
+
+  game::Activity activity;
+  if( options.activity != 0 ) {
+    activity.init( size );
+    engine->set_activity( &activity );
+  }
+
+  std::printf( "engine %s, rule %s, workload %s, %zux%zu, %zu threads, %zu generations\n", engine->name(), options.rule.to_string().c_str(), workload->id, size.x, size.y, threads, options.generations );
+
+  const auto start = std::chrono::steady_clock::now();
+  counters.start();
+
+  for( size_t generation{}; generation < options.generations; ++generation ) {
+    engine->step( universe, pool );
+
+    if( options.activity != 0 ) {
+      activity.advance( universe, pool, engine->counts_activity() );
+    }
+  }
+
+  const auto sample = counters.stop();
+  const double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+  const double generations = ( double ) options.generations;
+
+  std::printf( "time %.3f s, %.1f generations/s, %.1f Mcells/s\n", seconds, generations / seconds, generations * cells / seconds / 1e6 );
+
+  print_memory( cells );
+
+  const size_t population = universe.population();
+  std::printf( "population %zu\n", population );
+
+  // Results are only trusted if the run ends on a checkpoint and still reaches the expected population.
+  int status = 0;
+
+  for( const auto& checkpoint : workload->checkpoints ) {
+    if( !default_size || !( options.rule == game::Rule::life() ) || checkpoint.generation != options.generations ) {
+      continue;
+    }
+
+    if( checkpoint.population != population ) {
+      std::printf( "MISMATCH expected a population of %zu at generation %zu\n", checkpoint.population, checkpoint.generation );
+      status = 1;
+    }
+    else {
+      std::printf( "matches the checkpoint at generation %zu\n", checkpoint.generation );
+    }
+  }
+
+  print_counters( counters, sample, generations, cells );
+
+  if( options.activity != 0 ) {
+    print_activity( activity, engine->counts_activity(), options.activity );
+  }
+
+  if( !options.find.empty() && !print_matches( universe, options.find, options.margin, pool ) ) {
+    status = 1;
+  }
+
+  if( options.census != 0 ) {
+    print_census( universe, options.rule, pool, options.census );
+  }
+
+  return status;
+}
@@ -0,0 +1,1609 @@
+//
+// Differential check of every engine against the reference engine.
+//
+// Runs every workload over many grid sizes (non-square and degenerate ones included) followed by randomly
+// generated cases, and exits with 1 if any engine disagrees with the reference. A failing generated case is
+// reported with the seed, size and density needed to reproduce it. Generated cases are then repeated under
+// every other well known rule, see game::named_rules, and under randomly generated isotropic non-totalistic,
+// Larger than Life, hexagonal, triangular, rule table, block and stochastic rules. Under rules with more than two states the live cells of the generated
+// cases take any of the states. Volumes are checked the same way with every volume engine, under the well known
+// rules in three dimensions and randomly generated ones. Continuous engines are checked a generation at a time
+// from the state the reference reached, within a tolerance since the Fourier transform rounds differently.
+// The census has to find well known objects placed in random orientations and phases, and tally a settled soup the
+// same way on any number of threads. Every lane of a multiverse has to step like the reference engine steps it on its
+// own, with the lanes that changed and settled flagged as such. The activity engines count while stepping has to match
+// the activity counted by comparing the generations afterwards. The pattern finder has to find what a cell by cell
+// comparison finds in soups strewn with copies of the pattern. A rule survey has to tally what running every soup on
+// its own with the reference engine gives. Finally every engine has to reach the checkpoints of
+// every workload.
+//
+// Builds with the same sources as the headless runner plus src/game/oracle.cpp, ctest runs it on the CMake build.
+//
+
+#include <game/universe.hpp>
+#include <game/engine.hpp>
+#include <game/oracle.hpp>
+#include <game/pattern.hpp>
+#include <game/random.hpp>
+#include <game/rule.hpp>
+#include <game/rule_table.hpp>
+#include <game/volume.hpp>
+#include <game/engines/volume.hpp>
+#include <game/field.hpp>
+#include <game/engines/lenia.hpp>
+#include <game/workload.hpp>
+#include <game/census.hpp>
+#include <game/multiverse.hpp>
+#include <game/engines/multiverse.hpp>
+#include <game/activity.hpp>
+#include <game/finder.hpp>
+#include <game/search.hpp>
+#include <game/survey.hpp>
+
+#include <thread_pool.hpp>
+
+#include <tools/options.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  struct Options {
+    std::vector< size_t > threads;
+    size_t generations = 64;
+    size_t iterations = 200;
+    size_t rule_iterations = 25;
+    size_t isotropic_rules = 8;
+    size_t larger_rules = 8;
+    size_t lattice_rules = 8;
+    size_t table_rules = 8;
+    size_t margolus_rules = 8;
+    size_t stochastic_rules = 8;
+    size_t volume_rules = 4;
+    size_t lenia_rules = 4;
+    size_t census_rounds = 8;
+    size_t multiverse_rules = 8;
+    size_t activity_rounds = 4;
+    size_t find_rounds = 16;
+    size_t survey_rules = 8;
+    uint64_t seed = 1;
+  };
+
+  constexpr Vec2< size_t > k_sizes[] = {
+    { 1, 1 }, { 2, 3 }, { 3, 2 }, { 1, 9 }, { 9, 1 }, { 8, 8 }, { 17, 5 }, { 5, 17 },
+    { 31, 33 }, { 64, 64 }, { 100, 37 }, { 37, 100 }, { 257, 129 }
+  };
+
+  constexpr Vec3< size_t > k_volume_sizes[] = {
+    { 1, 1, 1 }, { 2, 3, 1 }, { 1, 1, 9 }, { 64, 4, 3 }, { 65, 7, 9 }, { 3, 40, 2 }, { 130, 17, 6 }
+  };
+
+  // Largest difference of a cell between a continuous engine and the reference after a generation.
+  constexpr float k_field_tolerance = 1e-4F;
+
+  // Continuous cases are stepped for no more generations than this, the direct convolution is slow on large kernels.
+  constexpr size_t k_field_generations = 8;
+
+  void usage() {
+    std::printf(
+      "usage: verify [options]\n"
+      "  --threads N,...      thread counts to check every engine with (default 1,2,3 and one per core)\n"
+      "  --generations N      generations to step every case for (default 64)\n"
+      "  --iterations N       number of randomly generated cases (default 200)\n"
+      "  --rule-iterations N  number of randomly generated cases under every other rule (default 25)\n"
+      "  --isotropic-rules N  number of randomly generated isotropic non-totalistic rules (default 8)\n"
+      "  --larger-rules N     number of randomly generated Larger than Life rules (default 8)\n"
+      "  --lattice-rules N    number of randomly generated hexagonal and triangular rules (default 8)\n"
+      "  --table-rules N      number of randomly generated rule tables (default 8)\n"
+      "  --margolus-rules N   number of randomly generated block rules (default 8)\n"
+      "  --stochastic-rules N number of randomly generated stochastic rules (default 8)\n"
+      "  --volume-rules N     number of randomly generated rules in three dimensions (default 4)\n"
+      "  --lenia-rules N      number of randomly generated continuous rules (default 4)\n"
+      "  --census-rounds N    number of randomly laid out grids of known objects to take a census of (default 8)\n"
+      "  --multiverse-rules N number of randomly generated rules to step multiverses under (default 8)\n"
+      "  --activity-rounds N  number of randomly generated rules of every kind to count activity under (default 4)\n"
+      "  --find-rounds N      number of random soups with randomly placed patterns to find them in (default 16)\n"
+      "  --survey-rules N     number of randomly generated life-like rules to survey (default 8)\n"
+      "  --seed N             seed of the soups and generated cases (default 1)\n"
+    );
+  }
+
+  bool parse( const int argc, char* argv[], Options& options ) {
+    tools::Arguments arguments( argc, argv );
+
+    while( arguments.next() ) {
+      std::string_view value;
+
+      if( arguments.is( "--help" ) ) {
+        return false;
+      }
+
+      if( !arguments.value( value ) ) {
+        std::fprintf( stderr, "missing value for %.*s\n", ( int ) arguments.name().size(), arguments.name().data() );
+        return false;
+      }
+
+      bool valid = true;
+
+      if( arguments.is( "--threads" ) ) {
+        options.threads.clear();
+        for( const auto& part : tools::split( value ) ) {
+          valid = valid && tools::parse_number( part, options.threads.emplace_back() ) && options.threads.back() != 0;
+        }
+      }
+      else if( arguments.is( "--generations" ) ) {
+        valid = tools::parse_number( value, options.generations );
+      }
+      else if( arguments.is( "--iterations" ) ) {
+        valid = tools::parse_number( value, options.iterations );
+      }
+      else if( arguments.is( "--rule-iterations" ) ) {
+        valid = tools::parse_number( value, options.rule_iterations );
+      }
+      else if( arguments.is( "--isotropic-rules" ) ) {
+        valid = tools::parse_number( value, options.isotropic_rules );
+      }
+      else if( arguments.is( "--larger-rules" ) ) {
+        valid = tools::parse_number( value, options.larger_rules );
+      }
+      else if( arguments.is( "--lattice-rules" ) ) {
+        valid = tools::parse_number( value, options.lattice_rules );
+      }
+      else if( arguments.is( "--table-rules" ) ) {
+        valid = tools::parse_number( value, options.table_rules );
+      }
+      else if( arguments.is( "--margolus-rules" ) ) {
+        valid = tools::parse_number( value, options.margolus_rules );
+      }
+      else if( arguments.is( "--stochastic-rules" ) ) {
+        valid = tools::parse_number( value, options.stochastic_rules );
+      }
+      else if( arguments.is( "--volume-rules" ) ) {
+        valid = tools::parse_number( value, options.volume_rules );
+      }
+      else if( arguments.is( "--lenia-rules" ) ) {
+        valid = tools::parse_number( value, options.lenia_rules );
+      }
+      else if( arguments.is( "--census-rounds" ) ) {
+        valid = tools::parse_number( value, options.census_rounds );
+      }
+      else if( arguments.is( "--multiverse-rules" ) ) {
+        valid = tools::parse_number( value, options.multiverse_rules );
+      }
+      else if( arguments.is( "--activity-rounds" ) ) {
+        valid = tools::parse_number( value, options.activity_rounds );
+      }
+      else if( arguments.is( "--find-rounds" ) ) {
+        valid = tools::parse_number( value, options.find_rounds );
+      }
+      else if( arguments.is( "--survey-rules" ) ) {
+        valid = tools::parse_number( value, options.survey_rules );
+      }
+      else if( arguments.is( "--seed" ) ) {
+        valid = tools::parse_number( value, options.seed );
+      }
+      else {
+        std::fprintf( stderr, "unknown option %.*s\n", ( int ) arguments.name().size(), arguments.name().data() );
+        return false;
+      }
+
+      if( !valid ) {
+        std::fprintf( stderr, "invalid value %.*s\n", ( int ) value.size(), value.data() );
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  class Verifier {
+  private:
+    game::Oracle m_oracle;
+    size_t m_generations;
+
+    // Shared by all cases, a single pool is enough to lay out the soups.
+    app::ThreadPool m_pool;
+
+    game::Universe m_universe;
+    size_t m_states;
+
+    size_t m_cases;
+    size_t m_failures;
+
+  public:
+    Verifier( const Options& options ) :
+      m_oracle( options.threads ),
+      m_generations( options.generations ),
+      m_pool( 1 ),
+      m_states( 2 ),
+      m_cases{},
+      m_failures{}
+    {
+    }
+
+    game::Universe& universe() {
+      return m_universe;
+    }
+
+    app::ThreadPool& pool() {
+      return m_pool;
+    }
+
+    // Checks the current universe, the description is only used to report mismatches.
+    void check( const std::string& description ) {
+      ++m_cases;
+
+      for( const auto& mismatch : m_oracle.check( m_universe, m_generations ) ) {
+        ++m_failures;
+
+        std::printf(
+          "MISMATCH %s, %zu threads: %s %zux%zu, generation %zu, row %zu column %zu, expected %u actual %u\n",
+          mismatch.engine.c_str(),
+          mismatch.threads,
+          description.c_str(),
+          m_universe.bounds().x,
+          m_universe.bounds().y,
+          mismatch.generation,
+          mismatch.row,
+          mismatch.column,
+          ( unsigned ) mismatch.expected,
+          ( unsigned ) mismatch.actual
+        );
+      }
+    }
+
+    const size_t candidates() const {
+      return m_oracle.candidates();
+    }
+
+    void set_rule( const game::Rule& rule ) {
+      m_oracle.set_rule( rule );
+      m_states = rule.states;
+    }
+
+    const size_t states() const {
+      return m_states;
+    }
+
+    const size_t cases() const {
+      return m_cases;
+    }
+
+    const size_t failures() const {
+      return m_failures;
+    }
+
+    // Counts a case that was checked outside of the oracle.
+    void count() {
+      ++m_cases;
+    }
+
+    void fail() {
+      ++m_failures;
+    }
+  };
+
+  // Checks randomly generated cases, every one is reproducible from its own seed.
+  void check_generated( Verifier& verifier, game::Xoshiro256& random, const size_t iterations, const std::string& label ) {
+    auto& universe = verifier.universe();
+
+    for( size_t iteration{}; iteration < iterations; ++iteration ) {
+      const uint64_t seed = random();
+      const Vec2< size_t > size = { 1 + random() % 192, 1 + random() % 192 };
+      const double density = ( double ) ( random() % 1001 ) / 1000.0;
+
+      universe.init( size );
+      universe.randomise( verifier.pool(), seed, density );
+
+      if( verifier.states() > 2 ) {
+        game::Xoshiro256 states( seed, 0x7374617465 );
+
+        for( size_t row{ 1 }; row <= size.y; ++row ) {
+          for( size_t column{ 1 }; column <= size.x; ++column ) {
+            if( universe.get_state( row, column ) != 0 ) {
+              universe.set_states( row, column, ( uint8_t ) ( 1 + states() % ( verifier.states() - 1 ) ) );
+            }
+          }
+        }
+      }
+
+      verifier.check( label + "soup " + std::to_string( density ) + " seed " + std::to_string( seed ) );
+    }
+  }
+
+  // An isotropic non-totalistic rule in Hensel notation, every count is either left out, whole or picks letters.
+  const std::string random_isotropic_rule( game::Xoshiro256& random ) {
+    std::string text;
+
+    for( const char* part : { "B", "/S" } ) {
+      text += part;
+
+      for( size_t count{}; count <= 8; ++count ) {
+        if( random() % 2 == 0 ) {
+          continue;
+        }
+
+        text.push_back( ( char ) ( '0' + count ) );
+
+        const std::string_view letters = game::hensel_letters( count );
+        if( letters.empty() || random() % 3 == 0 ) {
+          continue;
+        }
+
+        if( random() % 2 == 0 ) {
+          text.push_back( '-' );
+        }
+
+        const size_t first = text.size();
+        for( const char letter : letters ) {
+          if( random() % 3 == 0 ) {
+            text.push_back( letter );
+          }
+        }
+
+        if( text.size() == first ) {
+          text.push_back( letters[ 0 ] );
+        }
+      }
+    }
+
+    return text + "/C" + std::to_string( 2 + random() % 3 );
+  }
+
+  // A Larger than Life rule with ranges around the middle of the possible counts, so that not everything dies.
+  const game::Rule random_larger_rule( game::Xoshiro256& random ) {
+    game::Rule rule{ 0, 0, ( uint16_t ) ( 2 + random() % 3 ) };
+
+    rule.radius = ( uint8_t ) ( 1 + random() % 8 );
+    rule.neighbourhood = random() % 2 == 0 ? game::Neighbourhood::Moore : game::Neighbourhood::VonNeumann;
+    rule.middle = random() % 2 == 0;
+
+    const size_t size = rule.neighbourhood == game::Neighbourhood::Moore ?
+      ( 2 * rule.radius + 1 ) * ( 2 * rule.radius + 1 ) :
+      2 * rule.radius * ( rule.radius + 1 ) + 1;
+
+    for( auto range : { &rule.birth_range, &rule.survival_range } ) {
+      range->min = ( uint32_t ) ( random() % ( size / 2 + 1 ) );
+      range->max = range->min + ( uint32_t ) ( random() % ( size / 2 + 1 ) );
+    }
+
+    return rule;
+  }
+
+  // A rule on the hexagonal or triangular grid, any count may be in either mask.
+  const game::Rule random_lattice_rule( game::Xoshiro256& random ) {
+    game::Rule rule{ 0, 0, ( uint16_t ) ( 2 + random() % 3 ) };
+
+    rule.topology = random() % 2 == 0 ? game::Topology::Hexagonal : game::Topology::Triangular;
+
+    const size_t neighbours = rule.topology == game::Topology::Hexagonal ? 6 : 12;
+    const uint16_t counts = ( uint16_t ) ( ( 1 << ( neighbours + 1 ) ) - 1 );
+
+    rule.birth = ( uint16_t ) random() & counts;
+    rule.survival = ( uint16_t ) random() & counts;
+
+    return rule;
+  }
+
+  // A block rule, half of them reversible ones that shuffle the blocks and the others any map of blocks.
+  const game::Rule random_margolus_rule( game::Xoshiro256& random ) {
+    game::Rule rule{ 0, 0, 2 };
+    rule.margolus = true;
+
+    for( size_t block{}; block < rule.blocks.size(); ++block ) {
+      rule.blocks[ block ] = ( uint8_t ) block;
+    }
+
+    if( random() % 2 == 0 ) {
+      for( size_t block{ rule.blocks.size() - 1 }; block > 0; --block ) {
+        std::swap( rule.blocks[ block ], rule.blocks[ random() % ( block + 1 ) ] );
+      }
+    }
+    else {
+      for( auto& block : rule.blocks ) {
+        block = ( uint8_t ) ( random() % 16 );
+      }
+    }
+
+    return rule;
+  }
+
+  //
+  // A stochastic rule with any counts in either mask but B0 and a seed of its own. Every chance is either certain or
+  // anywhere in between, noise stays low enough to leave the rule something to do.
+  //
+  const game::Rule random_stochastic_rule( game::Xoshiro256& random ) {
+    game::Rule rule{ ( uint16_t ) ( random() & 0x1FE ), ( uint16_t ) ( random() & 0x1FF ), 2 };
+
+    rule.birth_chance = random() % 2 == 0 ? game::Rule::k_certain : random() % game::Rule::k_certain;
+    rule.survival_chance = random() % 2 == 0 ? game::Rule::k_certain : random() % game::Rule::k_certain;
+    rule.noise = 1 + random() % ( game::Rule::k_certain / 16 );
+    rule.seed = random();
+
+    return rule;
+  }
+
+  // A rule in three dimensions with ranges around the lower counts, so that not everything dies or fills up.
+  const game::VolumeRule random_volume_rule( game::Xoshiro256& random ) {
+    game::VolumeRule rule;
+
+    for( auto range : { &rule.survival, &rule.birth } ) {
+      range->min = ( uint32_t ) ( random() % 12 );
+      range->max = range->min + ( uint32_t ) ( random() % 5 );
+    }
+
+    return rule;
+  }
+
+  // A continuous rule with a kernel of up to three rings and a growth bell anywhere a kernel could reach.
+  const game::LeniaRule random_lenia_rule( game::Xoshiro256& random ) {
+    game::LeniaRule rule;
+
+    rule.radius = ( uint32_t ) ( 1 + random() % 24 );
+    rule.time = ( uint32_t ) ( 1 + random() % 20 );
+    rule.mu = ( float ) ( 5 + random() % 36 ) / 100.F;
+    rule.sigma = ( float ) ( 5 + random() % 96 ) / 1000.F;
+
+    rule.peaks.resize( 1 + random() % 3 );
+    for( auto& peak : rule.peaks ) {
+      peak = ( float ) ( 1 + random() % 4 ) / 4.F;
+    }
+
+    return rule;
+  }
+
+  //
+  // A rule table with a few transitions of random states and variables, under random symmetries. The states
+  // are kept few, the reference engine goes through every transition for every cell.
+  //
+  const std::string random_rule_table( game::Xoshiro256& random, const size_t index ) {
+    const bool moore = random() % 2 == 0;
+    const size_t states = 2 + random() % 3;
+    const size_t cells = moore ? 9 : 5;
+
+    // Permutations of eight neighbours in different states expand into too many transitions to go through.
+    const std::vector< const char* > symmetries = moore ?
+      std::vector< const char* >{ "none", "rotate4", "rotate8", "reflect_horizontal", "rotate4reflect", "rotate8reflect" } :
+      std::vector< const char* >{ "none", "rotate4", "reflect_horizontal", "rotate4reflect", "permute" };
+
+    std::string text = "@RULE Random" + std::to_string( index ) + "\n@TABLE\n";
+    text += "n_states:" + std::to_string( states ) + "\n";
+    text += std::string( "neighborhood:" ) + ( moore ? "Moore" : "vonNeumann" ) + "\n";
+    text += std::string( "symmetries:" ) + symmetries[ random() % symmetries.size() ] + "\n";
+
+    for( const char* variable : { "a", "b", "c" } ) {
+      std::string values;
+      for( size_t state{}; state < states; ++state ) {
+        if( random() % 2 == 0 ) {
+          values += ( values.empty() ? "" : "," ) + std::to_string( state );
+        }
+      }
+
+      text += std::string( "var " ) + variable + "={" + ( values.empty() ? "0" : values ) + "}\n";
+    }
+
+    const size_t transitions = 1 + random() % 12;
+    for( size_t transition{}; transition < transitions; ++transition ) {
+      std::string variables;
+
+      for( size_t cell{}; cell < cells; ++cell ) {
+        if( random() % 4 == 0 ) {
+          variables.push_back( "abc"[ random() % 3 ] );
+          text.push_back( variables.back() );
+        }
+        else {
+          text += std::to_string( random() % states );
+        }
+
+        text += ",";
+      }
+
+      // A variable of the neighbourhood as the next state is bound to the state it matched.
+      if( !variables.empty() && random() % 3 == 0 ) {
+        text.push_back( variables[ random() % variables.size() ] );
+      }
+      else {
+        text += std::to_string( random() % states );
+      }
+
+      text += "\n";
+    }
+
+    return text;
+  }
+
+  //
+  // Steps a volume with the reference volume engine and every other volume engine on every thread count, and
+  // reports the first cell of every engine that disagreed. The reference generations are kept so that they're
+  // only stepped once.
+  //
+  void check_volume( Verifier& verifier, const Options& options, const game::VolumeRule& rule, const Vec3< size_t >& size, const uint64_t seed, const double density ) {
+    const auto& names = game::volume_engine_names();
+
+    const auto reference = game::make_volume_engine( names.front() );
+    reference->set_rule( rule );
+
+    game::Volume volume;
+    volume.init( size );
+    volume.randomise( verifier.pool(), seed, density );
+
+    const size_t words = volume.row_words() * size.y * size.z;
+
+    std::vector< std::vector< uint64_t > > expected;
+    for( size_t generation{}; generation < options.generations; ++generation ) {
+      reference->step( volume, verifier.pool() );
+      expected.emplace_back( volume.row( 0, 0 ), volume.row( 0, 0 ) + words );
+    }
+
+    verifier.count();
+
+    for( const size_t threads : options.threads ) {
+      app::ThreadPool pool( threads );
+
+      for( size_t i{ 1 }; i < names.size(); ++i ) {
+        const auto engine = game::make_volume_engine( names[ i ] );
+        engine->set_rule( rule );
+
+        volume.init( size );
+        volume.randomise( pool, seed, density );
+
+        for( size_t generation{}; generation < options.generations; ++generation ) {
+          engine->step( volume, pool );
+
+          const uint64_t* actual = volume.row( 0, 0 );
+          const auto& words_expected = expected[ generation ];
+
+          const size_t word = std::mismatch( actual, actual + words, words_expected.begin() ).first - actual;
+          if( word == words ) {
+            continue;
+          }
+
+          verifier.fail();
+
+          const size_t row = word / volume.row_words();
+          const size_t bit = ( size_t ) std::countr_zero( actual[ word ] ^ words_expected[ word ] );
+
+          std::printf(
+            "MISMATCH %s, %zu threads: %s soup %f seed %llu %zux%zux%zu, generation %zu, x %zu y %zu z %zu\n",
+            engine->name(),
+            threads,
+            rule.to_string().c_str(),
+            density,
+            ( unsigned long long ) seed,
+            size.x,
+            size.y,
+            size.z,
+            generation + 1,
+            ( word % volume.row_words() ) * 64 + bit,
+            row % size.y,
+            row / size.y
+          );
+
+          break;
+        }
+      }
+    }
+  }
+
+  // Checks randomly generated volumes under a rule in three dimensions, every one is reproducible from its own seed.
+  void check_volumes( Verifier& verifier, const Options& options, game::Xoshiro256& random, const game::VolumeRule& rule, const size_t iterations ) {
+    for( size_t iteration{}; iteration < iterations; ++iteration ) {
+      const uint64_t seed = random();
+      const Vec3< size_t > size = { 1 + random() % 160, 1 + random() % 24, 1 + random() % 24 };
+      const double density = ( double ) ( random() % 1001 ) / 1000.0;
+
+      check_volume( verifier, options, rule, size, seed, density );
+    }
+  }
+
+  //
+  // Steps a field with the reference continuous engine, and every other continuous engine on every thread count
+  // from the same state one generation at a time. Reports the first cell of every engine that is off by more than
+  // the tolerance.
+  //
+  void check_field( Verifier& verifier, const Options& options, const game::LeniaRule& rule, const Vec2< size_t >& size, const uint64_t seed, const double density ) {
+    const auto& names = game::lenia_engine_names();
+
+    const auto reference = game::make_lenia_engine( names.front() );
+    reference->set_rule( rule );
+
+    game::Field expected;
+    expected.init( size );
+    expected.randomise( verifier.pool(), seed, density );
+
+    std::vector< std::unique_ptr< game::LeniaEngine > > engines;
+    std::vector< std::unique_ptr< app::ThreadPool > > pools;
+    std::vector< bool > failed;
+
+    for( const size_t threads : options.threads ) {
+      for( size_t i{ 1 }; i < names.size(); ++i ) {
+        engines.push_back( game::make_lenia_engine( names[ i ] ) );
+        engines.back()->set_rule( rule );
+        pools.push_back( std::make_unique< app::ThreadPool >( threads ) );
+        failed.push_back( false );
+      }
+    }
+
+    verifier.count();
+
+    const size_t cells = size.x * size.y;
+
+    game::Field stepped;
+    stepped.init( size );
+
+    game::Field actual;
+    actual.init( size );
+
+    for( size_t generation{}; generation < std::min( options.generations, k_field_generations ); ++generation ) {
+      std::copy_n( expected.current(), cells, stepped.current() );
+      reference->step( stepped, verifier.pool() );
+
+      const float* truth = stepped.current();
+
+      for( size_t i{}; i < engines.size(); ++i ) {
+        if( failed[ i ] ) {
+          continue;
+        }
+
+        std::copy_n( expected.current(), cells, actual.current() );
+        engines[ i ]->step( actual, *pools[ i ] );
+
+        const float* candidate = actual.current();
+
+        for( size_t cell{}; cell < cells; ++cell ) {
+          if( std::fabs( candidate[ cell ] - truth[ cell ] ) <= k_field_tolerance ) {
+            continue;
+          }
+
+          verifier.fail();
+          failed[ i ] = true;
+
+          std::printf(
+            "MISMATCH %s, %zu threads: %s soup %f seed %llu %zux%zu, generation %zu, row %zu column %zu, expected %f actual %f\n",
+            engines[ i ]->name(),
+            pools[ i ]->threads(),
+            rule.to_string().c_str(),
+            density,
+            ( unsigned long long ) seed,
+            size.x,
+            size.y,
+            generation + 1,
+            cell / size.x,
+            cell % size.x,
+            truth[ cell ],
+            candidate[ cell ]
+          );
+
+          break;
+        }
+      }
+
+      std::copy_n( truth, cells, expected.current() );
+    }
+  }
+
+  struct KnownObject {
+    const char* code;
+    const char* rle;
+  };
+
+  // Objects with their codes on Catagolue under Conway's Game of Life, each fits into 16 x 16 cells in any phase.
+  constexpr KnownObject k_known_objects[] = {
+    { "xs4_33", "2o$2o!" },
+    { "xs6_696", "b2o$o2bo$b2o!" },
+    { "xs7_2596", "b2o$o2bo$bobo$2bo!" },
+    { "xp2_7", "3o!" },
+    { "xp2_318c", "2o$2o$2b2o$2b2o!" },
+    { "xq4_153", "bo$2bo$3o!" },
+    { "xq4_6frc", "bo2bo$o4b$o3bo$4o!" },
+    { "xp3_co9nas0san9oczgoldlo0oldlogz1047210127401",
+      "2b3o3b3o2$o4bobo4bo$o4bobo4bo$o4bobo4bo$2b3o3b3o2$2b3o3b3o$o4bobo4bo$o4bobo4bo$o4bobo4bo2$2b3o3b3o!" }
+  };
+
+  // Cells between the objects of a census grid, far enough apart that they neither touch nor meet in 8 generations.
+  constexpr size_t k_census_slot = 32;
+
+  void print_census_mismatch( const std::string& description, const std::map< std::string, size_t >& expected, const game::Census& census ) {
+    std::printf( "MISMATCH census of %s:", description.c_str() );
+
+    for( const auto& [ code, count ] : expected ) {
+      std::printf( " expected %zu %s", count, code.c_str() );
+    }
+
+    for( const auto& object : census.objects ) {
+      std::printf( " found %zu %s", object.count, object.code.c_str() );
+    }
+
+    std::printf( "\n" );
+  }
+
+  //
+  // Lays out known objects in random orientations on a grid of slots, steps them a few generations so they are in
+  // random phases, and checks that the census counts each of them by its code. A settled soup then has to be
+  // tallied the same on every thread count.
+  //
+  void check_census( Verifier& verifier, const Options& options, game::Xoshiro256& random ) {
+    const game::Rule rule = game::Rule::life();
+    const auto engine = game::make_engine( rule );
+
+    std::vector< std::unique_ptr< app::ThreadPool > > pools;
+    for( const size_t threads : options.threads ) {
+      pools.push_back( std::make_unique< app::ThreadPool >( threads ) );
+    }
+
+    game::Universe universe;
+
+    for( size_t round{}; round < options.census_rounds; ++round ) {
+      const uint64_t seed = random();
+      game::Xoshiro256 layout( seed, 0x63656e737573 );
+
+      const Vec2< size_t > slots = { 1 + layout() % 8, 1 + layout() % 8 };
+      universe.init( { slots.x * k_census_slot, slots.y * k_census_slot } );
+
+      std::map< std::string, size_t > expected;
+
+      for( size_t y{}; y < slots.y; ++y ) {
+        for( size_t x{}; x < slots.x; ++x ) {
+          const auto& known = k_known_objects[ layout() % std::size( k_known_objects ) ];
+          const size_t orientation = layout() % 8;
+
+          game::Pattern pattern;
+          pattern.load_rle( known.rle );
+
+          const game::Pattern oriented = game::orient( pattern, orientation );
+
+          universe.place( oriented, { ( int ) ( x * k_census_slot + 8 ), ( int ) ( y * k_census_slot + 8 ) } );
+          ++expected[ known.code ];
+        }
+      }
+
+      const size_t generations = layout() % 8;
+      for( size_t generation{}; generation < generations; ++generation ) {
+        engine->step( universe, *pools.front() );
+      }
+
+      const std::string description = "known objects seed " + std::to_string( seed );
+
+      for( const auto& pool : pools ) {
+        verifier.count();
+
+        const game::Census census = game::take_census( universe, rule, *pool );
+
+        bool matches = census.objects.size() == expected.size();
+        for( const auto& object : census.objects ) {
+          const auto it = expected.find( object.code );
+          matches = matches && it != expected.end() && it->second == object.count;
+        }
+
+        if( !matches ) {
+          verifier.fail();
+          print_census_mismatch( description + ", " + std::to_string( pool->threads() ) + " threads", expected, census );
+          break;
+        }
+      }
+    }
+
+    // Soups settle into pseudo objects and pathological leftovers as well, every thread count has to agree on them.
+    universe.init( { 384, 256 } );
+    universe.randomise( *pools.front(), options.seed, 0.35 );
+
+    for( size_t generation{}; generation < 2000; ++generation ) {
+      engine->step( universe, *pools.front() );
+    }
+
+    const game::Census reference = game::take_census( universe, rule, *pools.front() );
+
+    for( const auto& pool : pools ) {
+      verifier.count();
+
+      const game::Census census = game::take_census( universe, rule, *pool );
+
+      bool matches = census.islands == reference.islands && census.cells == reference.cells && census.objects.size() == reference.objects.size();
+      for( size_t i{}; matches && i < census.objects.size(); ++i ) {
+        matches = census.objects[ i ].code == reference.objects[ i ].code && census.objects[ i ].count == reference.objects[ i ].count;
+      }
+
+      if( !matches ) {
+        verifier.fail();
+        std::printf( "MISMATCH census of a settled soup seed %llu, %zu threads: %zu islands and %zu kinds of objects, expected %zu and %zu\n",
+          ( unsigned long long ) options.seed, pool->threads(), census.islands, census.objects.size(), reference.islands, reference.objects.size() );
+      }
+    }
+  }
+
+  //
+  // Surveys random life-like rules over a few generations and tallies the same soups stepped one by one with the
+  // reference engine. Nothing gets close enough to the edge in so few generations to be looked at, except under rules
+  // with B0, which are run for longer since their lanes are never changed for being at the edge.
+  //
+  void check_survey( Verifier& verifier, const Options& options, game::Xoshiro256& random ) {
+    const auto reference = game::make_engine( game::engine_names().front() );
+    game::Universe universe;
+
+    for( size_t round{}; round < options.survey_rules; ++round ) {
+      game::Rule rule = game::life_like_rule( ( size_t ) ( random() % game::k_life_like_rules ) );
+
+      //
+      // Small soups under rules without births on fewer than three neighbours mostly settle within the generations,
+      // which stops a batch early once all of its lanes did.
+      //
+      const bool settling = round % 2 == 1;
+      if( settling ) {
+        rule.birth &= ~7;
+      }
+
+      const bool b0 = ( rule.birth & 1 ) != 0;
+
+      const size_t generations = 1 + random() % ( b0 ? 100 : 20 );
+      const size_t side = settling ? 6 : 24;
+      const Vec2< size_t > soup_size = { 1 + random() % side, 1 + random() % side };
+
+      game::RuleSurvey survey( soup_size, generations, game::Multiverse::k_lanes * ( 1 + random() % 2 ) );
+      const game::SurveyResult result = survey.run( rule );
+
+      reference->set_rule( rule );
+
+      game::SurveyResult expected{ rule, survey.soups(), 0, 0, 0, result.censused, {}, 0, 0.0, 0.0 };
+      double gained{};
+      double live_cells{};
+
+      for( size_t batch{}; batch < survey.soups() / game::Multiverse::k_lanes; ++batch ) {
+        survey.place_soups( game::hash_seed( rule.to_string() ), batch );
+
+        for( size_t lane{}; lane < game::Multiverse::k_lanes; ++lane ) {
+          survey.multiverse().extract( lane, universe );
+
+          std::vector< std::vector< uint8_t > > states = { { universe.current(), universe.current() + universe.size() } };
+          size_t half_population = generations / 2 == 0 ? universe.population() : 0;
+
+          for( size_t generation{ 1 }; generation <= generations; ++generation ) {
+            reference->step( universe, verifier.pool() );
+            states.emplace_back( universe.current(), universe.current() + universe.size() );
+
+            if( generation == generations / 2 ) {
+              half_population = universe.population();
+            }
+          }
+
+          const size_t population = universe.population();
+          gained += ( double ) population - ( double ) half_population;
+          live_cells += ( double ) population;
+
+          if( population == 0 ) {
+            ++expected.died;
+            continue;
+          }
+
+          size_t period{};
+          for( size_t back{ 1 }; back <= std::min( game::RuleSurvey::k_max_period, generations ) && period == 0; ++back ) {
+            period = states[ generations - back ] == states.back() ? back : 0;
+          }
+
+          if( period == 0 ) {
+            ++expected.unsettled;
+          }
+          else {
+            ++expected.periods[ ( size_t ) std::bit_width( period - 1 ) ];
+          }
+        }
+      }
+
+      const Vec2< size_t >& bounds = survey.multiverse().bounds();
+      expected.growth = gained / ( double ) ( generations - generations / 2 ) / ( double ) expected.soups;
+      expected.density = live_cells / ( ( double ) bounds.x * ( double ) bounds.y ) / ( double ) expected.soups;
+
+      verifier.count();
+
+      // Lanes under B0 fill up to the edge at once, so only those may have escaped.
+      const bool same = result.died == expected.died && result.periods == expected.periods && result.unsettled == expected.unsettled &&
+        ( b0 || ( result.escaped == 0 && result.spaceships == 0 ) ) &&
+        std::abs( result.growth - expected.growth ) <= 1e-9 && std::abs( result.density - expected.density ) <= 1e-9;
+
+      if( same ) {
+        continue;
+      }
+
+      verifier.fail();
+
+      std::printf(
+        "MISMATCH survey: %s %zux%zu soups, %zu generations, expected %s actual %s\n",
+        rule.to_string().c_str(),
+        soup_size.x,
+        soup_size.y,
+        generations,
+        game::survey_row( expected ).c_str(),
+        game::survey_row( result ).c_str()
+      );
+    }
+  }
+
+  //
+  // Fills the 64 lanes of a multiverse with random cells, steps every lane on its own with the reference engine
+  // and the multiverse on every thread count, and reports the first generation and lane that disagreed, in the
+  // cells or in the lanes flagged as changed and live.
+  //
+  void check_multiverse( Verifier& verifier, const Options& options, const game::Rule& rule, const Vec2< size_t >& size, const uint64_t seed, const double density ) {
+    const size_t lanes = game::Multiverse::k_lanes;
+
+    game::Multiverse multiverse;
+    multiverse.init( size );
+    multiverse.randomise( verifier.pool(), seed, density );
+
+    const auto reference = game::make_engine( game::engine_names().front() );
+    reference->set_rule( rule );
+
+    // Every generation of every lane, the first one included.
+    std::vector< std::vector< std::vector< uint8_t > > > expected( lanes );
+    game::Universe universe;
+
+    for( size_t lane{}; lane < lanes; ++lane ) {
+      multiverse.extract( lane, universe );
+      expected[ lane ].emplace_back( universe.current(), universe.current() + universe.size() );
+
+      for( size_t generation{}; generation < options.generations; ++generation ) {
+        reference->step( universe, verifier.pool() );
+        expected[ lane ].emplace_back( universe.current(), universe.current() + universe.size() );
+      }
+    }
+
+    verifier.count();
+
+    game::MultiverseEngine engine;
+    engine.set_rule( rule );
+
+    for( const size_t threads : options.threads ) {
+      app::ThreadPool pool( threads );
+
+      multiverse.randomise( pool, seed, density );
+
+      for( size_t generation{ 1 }; generation <= options.generations; ++generation ) {
+        engine.step( multiverse, pool );
+
+        std::string problem;
+
+        for( size_t lane{}; lane < lanes && problem.empty(); ++lane ) {
+          const auto& cells = expected[ lane ];
+          const uint64_t bit = ( uint64_t ) 1 << lane;
+
+          // The generation before the first one is the first one.
+          const bool changed = cells[ generation ] != cells[ generation - 1 ];
+          const bool changed_twice = cells[ generation ] != cells[ generation < 2 ? 0 : generation - 2 ];
+          const bool live = std::any_of( cells[ generation ].begin(), cells[ generation ].end(), []( const uint8_t cell ) { return cell != 0; } );
+
+          multiverse.extract( lane, universe );
+
+          if( std::memcmp( universe.current(), cells[ generation ].data(), universe.size() ) != 0 ) {
+            problem = "cells of lane " + std::to_string( lane );
+          }
+          else if( changed != ( ( multiverse.changed() & bit ) != 0 ) || changed_twice != ( ( multiverse.changed_twice() & bit ) != 0 ) ) {
+            problem = "changes of lane " + std::to_string( lane );
+          }
+          else if( live != ( ( multiverse.live() & bit ) != 0 ) ) {
+            problem = "liveness of lane " + std::to_string( lane );
+          }
+        }
+
+        if( problem.empty() ) {
+          continue;
+        }
+
+        verifier.fail();
+
+        std::printf(
+          "MISMATCH multiverse, %zu threads: %s soup %f seed %llu %zux%zu, generation %zu, %s\n",
+          threads,
+          rule.to_string().c_str(),
+          density,
+          ( unsigned long long ) seed,
+          size.x,
+          size.y,
+          generation,
+          problem.c_str()
+        );
+
+        break;
+      }
+    }
+  }
+
+  // Checks randomly generated multiverses under a rule, every one is reproducible from its own seed.
+  void check_multiverses( Verifier& verifier, const Options& options, game::Xoshiro256& random, const game::Rule& rule, const size_t iterations ) {
+    for( size_t iteration{}; iteration < iterations; ++iteration ) {
+      const uint64_t seed = random();
+      const Vec2< size_t > size = { 1 + random() % 40, 1 + random() % 40 };
+      const double density = ( double ) ( random() % 1001 ) / 1000.0;
+
+      check_multiverse( verifier, options, rule, size, seed, density );
+    }
+  }
+
+  //
+  // Steps a soup with every engine that supports the rule, on every number of threads, and compares the activity the
+  // engine counted with the activity counted from the generations. The window is short so that buckets are dropped.
+  //
+  void check_activity( Verifier& verifier, const Options& options, const game::Rule& rule, const Vec2< size_t >& size, const uint64_t seed, const double density ) {
+    game::Universe universe;
+
+    game::Activity counted;
+    game::Activity compared;
+    counted.set_window( 3 * game::Activity::k_buckets );
+    compared.set_window( 3 * game::Activity::k_buckets );
+
+    for( const auto& name : game::engine_names() ) {
+      auto engine = game::make_engine( name );
+      if( !engine->supports( rule ) || !engine->counts_activity() ) {
+        continue;
+      }
+
+      engine->set_rule( rule );
+      engine->set_activity( &counted );
+
+      verifier.count();
+
+      for( const size_t threads : options.threads ) {
+        app::ThreadPool pool( threads );
+
+        universe.init( size );
+        universe.randomise( pool, seed, density );
+
+        counted.init( size );
+        compared.init( size );
+
+        for( size_t generation{ 1 }; generation <= options.generations; ++generation ) {
+          engine->step( universe, pool );
+
+          counted.advance( universe, pool, true );
+          compared.advance( universe, pool, false );
+
+          Tile mismatch{ -1, -1 };
+
+          for( size_t y{}; y < counted.tiles().y && mismatch.x < 0; ++y ) {
+            for( size_t x{}; x < counted.tiles().x && mismatch.x < 0; ++x ) {
+              if( counted.changes( x, y ) != compared.changes( x, y ) ) {
+                mismatch = { ( int ) x, ( int ) y };
+              }
+            }
+          }
+
+          if( mismatch.x < 0 ) {
+            continue;
+          }
+
+          verifier.fail();
+
+          std::printf(
+            "MISMATCH %s activity, %zu threads: %s soup %f seed %llu %zux%zu, generation %zu, tile %d,%d, expected %u actual %u\n",
+            engine->name(),
+            threads,
+            rule.to_string().c_str(),
+            density,
+            ( unsigned long long ) seed,
+            size.x,
+            size.y,
+            generation,
+            mismatch.x,
+            mismatch.y,
+            compared.changes( ( size_t ) mismatch.x, ( size_t ) mismatch.y ),
+            counted.changes( ( size_t ) mismatch.x, ( size_t ) mismatch.y )
+          );
+
+          break;
+        }
+      }
+    }
+  }
+
+  // Occurrences of a pattern found by comparing every cell of every orientation at every position.
+  const std::vector< game::PatternMatch > find_naively( const game::Universe& universe, const game::Pattern& pattern, const size_t margin ) {
+    std::vector< game::Pattern > orientations;
+
+    for( size_t orientation{}; orientation < game::k_orientations; ++orientation ) {
+      orientations.push_back( game::orient( pattern, orientation ) );
+    }
+
+    const auto same = []( const game::Pattern& a, const game::Pattern& b ) {
+      if( !( a.bounds() == b.bounds() ) ) {
+        return false;
+      }
+
+      for( size_t y{}; y < a.bounds().y; ++y ) {
+        for( size_t x{}; x < a.bounds().x; ++x ) {
+          if( ( a.get( x, y ) != 0 ) != ( b.get( x, y ) != 0 ) ) {
+            return false;
+          }
+        }
+      }
+
+      return true;
+    };
+
+    const Vec2< size_t >& bounds = universe.bounds();
+    std::vector< game::PatternMatch > matches;
+
+    for( size_t y{}; y < bounds.y; ++y ) {
+      for( size_t x{}; x < bounds.x; ++x ) {
+        for( size_t orientation{}; orientation < game::k_orientations; ++orientation ) {
+          const game::Pattern& oriented = orientations[ orientation ];
+          const Vec2< size_t >& size = oriented.bounds();
+
+          const bool repeated = std::any_of( orientations.begin(), orientations.begin() + ( ptrdiff_t ) orientation, [ & ]( const game::Pattern& other ) {
+            return same( other, oriented );
+          } );
+
+          if( repeated || x + size.x > bounds.x || y + size.y > bounds.y ) {
+            continue;
+          }
+
+          bool match = true;
+
+          for( int64_t row{ -( int64_t ) margin }; row < ( int64_t ) ( size.y + margin ) && match; ++row ) {
+            for( int64_t column{ -( int64_t ) margin }; column < ( int64_t ) ( size.x + margin ) && match; ++column ) {
+              const int64_t grid_x = ( int64_t ) x + column;
+              const int64_t grid_y = ( int64_t ) y + row;
+
+              const bool inside = grid_x >= 0 && grid_y >= 0 && grid_x < ( int64_t ) bounds.x && grid_y < ( int64_t ) bounds.y;
+              const bool alive = inside && universe.get_state( ( size_t ) grid_y + 1, ( size_t ) grid_x + 1 ) != 0;
+
+              const bool in_pattern = row >= 0 && column >= 0 && row < ( int64_t ) size.y && column < ( int64_t ) size.x;
+              const bool expected = in_pattern && oriented.get( ( size_t ) column, ( size_t ) row ) != 0;
+
+              match = alive == expected;
+            }
+          }
+
+          if( match ) {
+            matches.push_back( { { x, y }, size, ( uint8_t ) orientation } );
+          }
+        }
+      }
+    }
+
+    return matches;
+  }
+
+  //
+  // Strews copies of a known object or a random pattern in random orientations over a sparse soup, some of them
+  // across the edges, and checks that the finder finds what comparing cell by cell finds on every thread count.
+  //
+  void check_finder( Verifier& verifier, const Options& options, game::Xoshiro256& random ) {
+    game::Universe universe;
+
+    for( size_t round{}; round < options.find_rounds; ++round ) {
+      const uint64_t seed = random();
+      game::Xoshiro256 layout( seed, 0x66696e64 );
+
+      game::Pattern pattern;
+
+      if( layout() % 2 == 0 ) {
+        pattern.load_rle( k_known_objects[ layout() % std::size( k_known_objects ) ].rle );
+      }
+      else {
+        pattern = game::Pattern( { 1 + layout() % 6, 1 + layout() % 6 } );
+
+        for( size_t y{}; y < pattern.bounds().y; ++y ) {
+          for( size_t x{}; x < pattern.bounds().x; ++x ) {
+            pattern.set( x, y, ( uint8_t ) ( layout() % 2 ) );
+          }
+        }
+
+        pattern.set( 0, 0, 1 );
+      }
+
+      const size_t margin = layout() % 3;
+      const Vec2< size_t > size = { 1 + layout() % 200, 1 + layout() % 200 };
+
+      universe.init( size );
+      universe.randomise( verifier.pool(), seed, ( double ) ( layout() % 100 ) / 1000.0 );
+
+      const size_t copies = layout() % 24;
+      for( size_t copy{}; copy < copies; ++copy ) {
+        const game::Pattern oriented = game::orient( pattern, layout() % game::k_orientations );
+        universe.place( oriented, { ( int ) ( layout() % ( size.x + 4 ) ) - 2, ( int ) ( layout() % ( size.y + 4 ) ) - 2 } );
+      }
+
+      game::PatternFinder finder;
+
+      std::string error;
+      if( !finder.compile( pattern, margin, error ) ) {
+        verifier.fail();
+        std::printf( "MISMATCH finder refused a pattern of %zux%zu with a margin of %zu: %s\n", pattern.bounds().x, pattern.bounds().y, margin, error.c_str() );
+        continue;
+      }
+
+      const auto expected = find_naively( universe, pattern, margin );
+
+      verifier.count();
+
+      for( const size_t threads : options.threads ) {
+        app::ThreadPool pool( threads );
+        const auto matches = finder.find( universe, pool );
+
+        const bool same = matches.size() == expected.size() && std::equal( matches.begin(), matches.end(), expected.begin(), []( const game::PatternMatch& a, const game::PatternMatch& b ) {
+          return a.position == b.position && a.bounds == b.bounds && a.orientation == b.orientation;
+        } );
+
+        if( same ) {
+          continue;
+        }
+
+        verifier.fail();
+
+        std::printf(
+          "MISMATCH finder, %zu threads: seed %llu %zux%zu, pattern of %zux%zu with a margin of %zu, expected %zu matches actual %zu\n",
+          threads,
+          ( unsigned long long ) seed,
+          size.x,
+          size.y,
+          pattern.bounds().x,
+          pattern.bounds().y,
+          margin,
+          expected.size(),
+          matches.size()
+        );
+
+        break;
+      }
+    }
+  }
+
+  // Steps every workload with every engine up to its last checkpoint.
+  void check_checkpoints( Verifier& verifier, const size_t threads ) {
+    app::ThreadPool pool( threads );
+    game::Universe universe;
+
+    for( const auto& name : game::engine_names() ) {
+      auto engine = game::make_engine( name );
+
+      // The checkpoints are populations under Conway's Game of Life.
+      if( !engine->supports( game::Rule::life() ) ) {
+        continue;
+      }
+
+      for( const auto& workload : game::workloads() ) {
+        game::load_workload( workload, universe, pool );
+
+        size_t generation{};
+        for( const auto& checkpoint : workload.checkpoints ) {
+          while( generation < checkpoint.generation ) {
+            engine->step( universe, pool );
+            ++generation;
+          }
+
+          const size_t population = universe.population();
+          if( population != checkpoint.population ) {
+            verifier.fail();
+
+            std::printf(
+              "MISMATCH %s, %zu threads: %s, generation %zu, expected a population of %zu actual %zu\n",
+              engine->name(),
+              threads,
+              workload.id,
+              generation,
+              checkpoint.population,
+              population
+            );
+
+            break;
+          }
+        }
+      }
+    }
+  }
+
+}
+
+int main( int argc, char* argv[] ) {
+  Options options;
+  if( !parse( argc, argv, options ) ) {
+    usage();
+    return 1;
+  }
+
+  if( options.threads.empty() ) {
+    options.threads = { 1, 2, 3 };
+
+    const size_t cores = std::thread::hardware_concurrency();
+    if( cores > 3 ) {
+      options.threads.push_back( cores );
+    }
+  }
+
+  Verifier verifier( options );
+  auto& universe = verifier.universe();
+
+  if( verifier.candidates() == 0 ) {
+    std::printf( "only the reference engine is available, nothing to check\n" );
+    return 0;
+  }
+
+  //
+  // Every workload at its own size and on every other size. Patterns are also placed straddling the borders.
+  //
+  for( const auto& workload : game::workloads() ) {
+    game::load_workload( workload, universe, verifier.pool() );
+    verifier.check( workload.id );
+
+    game::Pattern pattern;
+    if( workload.kind == game::WorkloadKind::Pattern ) {
+      pattern.load_rle( workload.rle );
+    }
+
+    for( const auto& size : k_sizes ) {
+      game::load_workload( workload, size, universe, verifier.pool() );
+      verifier.check( workload.id );
+
+      if( workload.kind != game::WorkloadKind::Pattern ) {
+        continue;
+      }
+
+      const Vec2i origins[] = {
+        { -1, -1 },
+        { ( int ) size.x - ( int ) pattern.bounds().x + 1, ( int ) size.y - ( int ) pattern.bounds().y + 1 }
+      };
+
+      for( const auto& origin : origins ) {
+        universe.clear();
+        universe.place( pattern, origin );
+        verifier.check( std::string( workload.id ) + " at " + std::to_string( origin.x ) + "," + std::to_string( origin.y ) );
+      }
+    }
+  }
+
+  game::Xoshiro256 random( options.seed, 0x66757a7a );
+
+  check_generated( verifier, random, options.iterations, "" );
+
+  for( const auto& named : game::named_rules() ) {
+    game::Rule rule;
+    if( !game::parse_rule( named.rule, rule ) || rule == game::Rule::life() ) {
+      continue;
+    }
+
+    verifier.set_rule( rule );
+    check_generated( verifier, random, options.rule_iterations, rule.to_string() + " " );
+  }
+
+  for( size_t i{}; i < options.isotropic_rules; ++i ) {
+    const std::string text = random_isotropic_rule( random );
+
+    // The notation has to read back as the same rule.
+    game::Rule rule;
+    game::Rule written;
+    if( !game::parse_rule( text, rule ) || !game::parse_rule( rule.to_string(), written ) || !( written == rule ) ) {
+      verifier.fail();
+      std::printf( "MISMATCH %s doesn't read back as the same rule from %s\n", text.c_str(), rule.to_string().c_str() );
+      continue;
+    }
+
+    verifier.set_rule( rule );
+    check_generated( verifier, random, std::max< size_t >( 1, options.rule_iterations / 5 ), rule.to_string() + " " );
+  }
+
+  for( size_t i{}; i < options.larger_rules; ++i ) {
+    const game::Rule rule = random_larger_rule( random );
+
+    verifier.set_rule( rule );
+    check_generated( verifier, random, std::max< size_t >( 1, options.rule_iterations / 5 ), rule.to_string() + " " );
+  }
+
+  for( size_t i{}; i < options.lattice_rules; ++i ) {
+    const game::Rule rule = random_lattice_rule( random );
+
+    game::Rule written;
+    if( !game::parse_rule( rule.to_string(), written ) || !( written == rule ) ) {
+      verifier.fail();
+      std::printf( "MISMATCH %s doesn't read back as the same rule\n", rule.to_string().c_str() );
+      continue;
+    }
+
+    verifier.set_rule( rule );
+    check_generated( verifier, random, std::max< size_t >( 1, options.rule_iterations / 5 ), rule.to_string() + " " );
+  }
+
+  for( size_t i{}; i < options.table_rules; ++i ) {
+    const std::string text = random_rule_table( random, i );
+
+    std::string error;
+    const auto table = game::RuleTable::parse( text, error );
+    if( table == nullptr ) {
+      verifier.fail();
+      std::printf( "MISMATCH rule table %zu doesn't parse: %s\n%s", i, error.c_str(), text.c_str() );
+      continue;
+    }
+
+    verifier.set_rule( game::make_rule( table ) );
+    check_generated( verifier, random, std::max< size_t >( 1, options.rule_iterations / 5 ), table->name() + " " );
+  }
+
+  for( size_t i{}; i < options.margolus_rules; ++i ) {
+    const game::Rule rule = random_margolus_rule( random );
+
+    game::Rule written;
+    if( !game::parse_rule( rule.to_string(), written ) || !( written == rule ) ) {
+      verifier.fail();
+      std::printf( "MISMATCH %s doesn't read back as the same rule\n", rule.to_string().c_str() );
+      continue;
+    }
+
+    verifier.set_rule( rule );
+    check_generated( verifier, random, std::max< size_t >( 1, options.rule_iterations / 5 ), rule.to_string() + " " );
+  }
+
+  for( size_t i{}; i < options.stochastic_rules; ++i ) {
+    const game::Rule rule = random_stochastic_rule( random );
+
+    // The seed isn't part of the notation.
+    game::Rule written;
+    const bool parsed = game::parse_rule( rule.to_string(), written );
+    written.seed = rule.seed;
+
+    if( !parsed || !( written == rule ) ) {
+      verifier.fail();
+      std::printf( "MISMATCH %s doesn't read back as the same rule\n", rule.to_string().c_str() );
+      continue;
+    }
+
+    verifier.set_rule( rule );
+    check_generated( verifier, random, std::max< size_t >( 1, options.rule_iterations / 5 ), rule.to_string() + " seed " + std::to_string( rule.seed ) + " " );
+  }
+
+  // Chances typed with a few digits, down to one in a million, have to be written as the same number.
+  for( size_t i{}; i < options.stochastic_rules; ++i ) {
+    const double chance = ( double ) ( 1 + random() % 999 ) / std::pow( 10.0, ( double ) ( 3 + random() % 4 ) );
+
+    char typed[ 32 ];
+    const std::string text = "B3/S23/N" + std::string( typed, std::to_chars( typed, typed + sizeof( typed ), chance ).ptr );
+
+    game::Rule rule;
+    double written = -1.0;
+
+    if( game::parse_rule( text, rule ) ) {
+      const std::string notation = rule.to_string();
+      const size_t noise = notation.find( "/N" );
+
+      if( noise != std::string::npos ) {
+        std::from_chars( notation.data() + noise + 2, notation.data() + notation.size(), written );
+      }
+    }
+
+    if( written != chance ) {
+      verifier.fail();
+      std::printf( "MISMATCH %s is written as %s\n", text.c_str(), rule.to_string().c_str() );
+    }
+  }
+
+  for( const auto& size : k_volume_sizes ) {
+    check_volume( verifier, options, game::VolumeRule::bays_4555(), size, options.seed, 0.3 );
+  }
+
+  for( const auto& named : game::named_volume_rules() ) {
+    game::VolumeRule rule;
+    if( game::parse_volume_rule( named.rule, rule ) ) {
+      check_volumes( verifier, options, random, rule, std::max< size_t >( 1, options.rule_iterations / 5 ) );
+    }
+  }
+
+  for( size_t i{}; i < options.volume_rules; ++i ) {
+    const game::VolumeRule rule = random_volume_rule( random );
+
+    game::VolumeRule written;
+    if( !game::parse_volume_rule( rule.to_string(), written ) || !( written == rule ) ) {
+      verifier.fail();
+      std::printf( "MISMATCH %s doesn't read back as the same rule\n", rule.to_string().c_str() );
+      continue;
+    }
+
+    check_volumes( verifier, options, random, rule, std::max< size_t >( 1, options.rule_iterations / 5 ) );
+  }
+
+  for( const auto& named : game::named_lenia_rules() ) {
+    game::LeniaRule rule;
+    if( !game::parse_lenia_rule( named.rule, rule ) ) {
+      continue;
+    }
+
+    for( const auto& size : k_sizes ) {
+      check_field( verifier, options, rule, size, options.seed, 0.5 );
+    }
+  }
+
+  for( size_t i{}; i < options.lenia_rules; ++i ) {
+    const game::LeniaRule rule = random_lenia_rule( random );
+
+    game::LeniaRule written;
+    if( !game::parse_lenia_rule( rule.to_string(), written ) || !( written == rule ) ) {
+      verifier.fail();
+      std::printf( "MISMATCH %s doesn't read back as the same rule\n", rule.to_string().c_str() );
+      continue;
+    }
+
+    for( size_t iteration{}; iteration < std::max< size_t >( 1, options.rule_iterations / 5 ); ++iteration ) {
+      const uint64_t seed = random();
+      const Vec2< size_t > size = { 1 + random() % 192, 1 + random() % 192 };
+      const double density = ( double ) ( random() % 1001 ) / 1000.0;
+
+      check_field( verifier, options, rule, size, seed, density );
+    }
+  }
+
+  check_census( verifier, options, random );
+
+  check_finder( verifier, options, random );
+
+  for( const auto& size : k_sizes ) {
+    check_multiverse( verifier, options, game::Rule::life(), size, options.seed, 0.5 );
+  }
+
+  for( const auto& named : game::named_rules() ) {
+    game::Rule rule;
+    if( game::parse_rule( named.rule, rule ) && game::MultiverseEngine::supports( rule ) ) {
+      check_multiverses( verifier, options, random, rule, std::max< size_t >( 1, options.rule_iterations / 5 ) );
+    }
+  }
+
+  for( size_t i{}; i < options.multiverse_rules; ++i ) {
+    const game::Rule rule{ ( uint16_t ) ( random() & 0x1FF ), ( uint16_t ) ( random() & 0x1FF ), 2 };
+
+    check_multiverses( verifier, options, random, rule, std::max< size_t >( 1, options.rule_iterations / 5 ) );
+  }
+
+  check_survey( verifier, options, random );
+
+  for( const auto& size : k_sizes ) {
+    check_activity( verifier, options, game::Rule::life(), size, options.seed, 0.5 );
+  }
+
+  // A rule for every engine that counts activity, on grids of a few tiles with a partial one at the end.
+  for( size_t round{}; round < options.activity_rounds; ++round ) {
+    std::string error;
+    const auto table = game::RuleTable::parse( random_rule_table( random, round ), error );
+
+    std::vector< game::Rule > rules = {
+      random_larger_rule( random ),
+      random_lattice_rule( random ),
+      random_margolus_rule( random ),
+      random_stochastic_rule( random ),
+      game::Rule{ ( uint16_t ) ( random() & 0x1FE ), ( uint16_t ) ( random() & 0x1FF ), ( uint16_t ) ( 2 + random() % 6 ) }
+    };
+
+    if( table != nullptr ) {
+      rules.push_back( game::make_rule( table ) );
+    }
+
+    game::Rule isotropic;
+    if( game::parse_rule( random_isotropic_rule( random ), isotropic ) ) {
+      rules.push_back( isotropic );
+    }
+
+    for( const auto& rule : rules ) {
+      const uint64_t seed = random();
+      const Vec2< size_t > size = { 1 + random() % 300, 1 + random() % 300 };
+      const double density = ( double ) ( random() % 1001 ) / 1000.0;
+
+      check_activity( verifier, options, rule, size, seed, density );
+    }
+  }
+
+  verifier.set_rule( game::Rule::life() );
+
+  check_checkpoints( verifier, options.threads.back() );
+
+  std::printf(
+    "%zu cases, %zu engine / thread combinations, %zu generations each: %zu mismatches\n",
+    verifier.cases(),
+    verifier.candidates(),
+    options.generations,
+    verifier.failures()
+  );
+
+  return verifier.failures() == 0 ? 0 : 1;
+}
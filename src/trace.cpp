@@ -0,0 +1,160 @@
+#include <trace.hpp>
+
+#include <fstream>
+#include <iomanip>
+
+app::Tracer::Tracer() :
+  m_frames_left{},
+  m_started{ now() },
+  m_path{ "trace.json" }
+{
+}
+
+app::Tracer::ThreadBuffer* app::Tracer::buffer() {
+  if( t_buffer != nullptr ) {
+    return t_buffer;
+  }
+
+  auto buffer = std::make_unique< ThreadBuffer >();
+  buffer->events = std::make_unique_for_overwrite< Event[] >( k_events_per_thread );
+  buffer->count.store( 0, std::memory_order_relaxed );
+  buffer->dropped.store( 0, std::memory_order_relaxed );
+
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  buffer->id = ( uint32_t ) m_buffers.size() + 1;
+  buffer->name = "Thread " + std::to_string( buffer->id );
+
+  t_buffer = buffer.get();
+  m_buffers.push_back( std::move( buffer ) );
+
+  return t_buffer;
+}
+
+void app::Tracer::push( const Event& event ) {
+  // Zones that were opened before the recording stopped are let go.
+  if( !recording() ) {
+    return;
+  }
+
+  ThreadBuffer* buffer = this->buffer();
+
+  // Only the owning thread ever writes to a buffer, the release publishes the event to the flush.
+  const size_t count = buffer->count.load( std::memory_order_relaxed );
+  if( count == k_events_per_thread ) {
+    buffer->dropped.fetch_add( 1, std::memory_order_relaxed );
+    return;
+  }
+
+  buffer->events[ count ] = event;
+  buffer->count.store( count + 1, std::memory_order_release );
+}
+
+void app::Tracer::set_thread_name( const std::string_view& name ) {
+  ThreadBuffer* buffer = this->buffer();
+
+  std::lock_guard< std::mutex > lock( m_mutex );
+  buffer->name = name;
+}
+
+void app::Tracer::start( const std::string_view& path, const size_t frames ) {
+  if( recording() ) {
+    stop();
+  }
+
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    for( auto& buffer : m_buffers ) {
+      buffer->count.store( 0, std::memory_order_relaxed );
+      buffer->dropped.store( 0, std::memory_order_relaxed );
+    }
+  }
+
+  m_path = path;
+  m_frames_left = frames;
+  m_started = now();
+  m_status = "Recording...";
+
+  s_recording.store( true, std::memory_order_release );
+}
+
+void app::Tracer::stop() {
+  if( !recording() ) {
+    return;
+  }
+
+  s_recording.store( false, std::memory_order_release );
+
+  std::ofstream file{ m_path };
+  if( !file ) {
+    m_status = "Couldn't write " + m_path;
+    return;
+  }
+
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  size_t events{};
+  size_t dropped{};
+
+  // Timestamps are microseconds relative to the start of the recording.
+  file << std::fixed << std::setprecision( 3 );
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  bool first = true;
+  const auto& separator = [ & ]() {
+    if( !first ) {
+      file << ",\n";
+    }
+    first = false;
+  };
+
+  for( const auto& buffer : m_buffers ) {
+    separator();
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+         << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+
+    const size_t count = buffer->count.load( std::memory_order_acquire );
+
+    for( size_t i{}; i < count; ++i ) {
+      const Event& event = buffer->events[ i ];
+      const double timestamp = ( double ) ( event.start - m_started ) / 1e3;
+
+      separator();
+
+      if( event.duration >= 0 ) {
+        file << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+             << ",\"ts\":" << timestamp << ",\"dur\":" << ( double ) event.duration / 1e3 << "}";
+      }
+      else {
+        file << "{\"name\":\"" << event.name << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->id
+             << ",\"ts\":" << timestamp << ",\"args\":{\"value\":" << event.value << "}}";
+      }
+    }
+
+    events += count;
+    dropped += buffer->dropped.load( std::memory_order_relaxed );
+  }
+
+  file << "\n]}\n";
+
+  if( !file ) {
+    m_status = "Couldn't write " + m_path;
+    return;
+  }
+
+  m_status = "Wrote " + std::to_string( events ) + " events to " + m_path;
+  if( dropped != 0 ) {
+    m_status += " (" + std::to_string( dropped ) + " dropped)";
+  }
+}
+
+void app::Tracer::end_frame() {
+  if( !recording() || m_frames_left == 0 ) {
+    return;
+  }
+
+  if( --m_frames_left == 0 ) {
+    stop();
+  }
+}